@@ -109,6 +109,27 @@ factor_and_solve(int nrhs,
 }
 
 
+/**
+ * Solve a linear system with nrhs right-hand side vectors, with a
+ * structured::StructuredMatrix which was already factored during
+ * construction, see for instance
+ * structured::construct_and_factor_matrix_free.
+ */
+template<typename scalar_t> void
+solve_factored(int nrhs,
+               const DenseMatrix<scalar_t>& A,
+               const structured::StructuredMatrix<scalar_t>* H) {
+  DenseMatrix<scalar_t> B(H->rows(), nrhs), X(H->rows(), nrhs);
+  X.random();
+  // Compute the right-hand side B as B=A*X. H->mult cannot be used,
+  // since H now holds the factors.
+  gemm(Trans::N, Trans::N, scalar_t(1.), A, X, scalar_t(0.), B);
+  H->solve(B);
+  cout << "  - ||X-H\\(A*X)||_F/||X||_F = "
+       << B.sub(X).normF() / X.normF() << endl;
+}
+
+
 /**
  * Use the structured::StructuredMatrix as a preconditioner in an
  * iterative solver. Here we use the dense matrix for the exact
@@ -382,5 +403,49 @@ int main(int argc, char* argv[]) {
     }
   }
 
+
+  cout << endl << endl;
+  cout << "==================================" << endl;
+  cout << " Compression, fully matrix-free " << endl;
+  cout << "==================================" << endl;
+  for (auto type : {structured::Type::BLR, structured::Type::HSS,
+                    structured::Type::HODLR}) {
+    options.set_type(type);
+    try {
+      // Construct a StructuredMatrix using only the matrix-vector
+      // multiplication, no access to individual elements. This uses
+      // randomized peeling, see HODLR::HODLRMatrixNative. Here we
+      // count the number of matrix-vector products, which should
+      // be much smaller than n.
+      std::size_t nmv = 0;
+      auto Amult_count =
+        [&Amult, &nmv](Trans t, const DenseMatrix<double>& R,
+                       DenseMatrix<double>& S) {
+          nmv += R.cols();
+          Amult(t, R, S);
+        };
+      auto H = structured::construct_matrix_free<double>
+        (n, n, Amult_count, options);
+      print_info(H.get(), options);
+      cout << "  - matrix-vector products = " << nmv << endl;
+      check_accuracy(A, H.get());
+      if (type == structured::Type::BLR) {
+        // a BLR matrix can only be factored during construction, so
+        // compress (again matrix-free) and factor in a single step
+        nmv = 0;
+        auto F = structured::construct_and_factor_matrix_free<double>
+          (n, n, Amult_count, options);
+        cout << "  - matrix-vector products = " << nmv << endl;
+        solve_factored(nrhs, A, F.get());
+        continue;
+      }
+      factor_and_solve(nrhs, A, H.get());
+      preconditioned_solve(A, H.get());
+      test_shift(nrhs, A, H.get());
+    } catch (std::exception& e) {
+      cout << get_name(type) << " failed: " << e.what() << endl;
+    }
+  }
+
   return 0;
 }
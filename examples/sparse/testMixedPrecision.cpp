@@ -102,6 +102,35 @@ void test(CSRMatrix<working_t,int>& A,
     std::cout << "# RELATIVE ERROR = " << (nrm_error/nrm_x_exact) << std::endl;
   }
 
+  {
+    std::cout << std::endl;
+    std::cout << "### MIXED Precision Solver, bfloat16 factors ##" << std::endl;
+
+    SparseSolverMixedPrecision<float,double,int> spss;
+    /** GMRES-IR, with fallback to single precision factors */
+    spss.options().set_Krylov_solver(KrylovSolver::AUTO);
+    spss.options().set_rel_tol(1e-14);
+    spss.options().set_from_command_line(argc, argv);
+
+    spss.solver().options().set_from_command_line(argc, argv);
+    spss.set_factor_storage_precision(StoragePrecision::BFLOAT16);
+
+    spss.set_matrix(A);
+    spss.reorder();
+    spss.factor();
+    spss.solve(b, x);
+
+    std::cout << "# GMRES iterations = " << spss.Krylov_iterations()
+              << ", factors stored in "
+              << get_name(spss.factor_storage_precision()) << std::endl;
+    std::cout << "# COMPONENTWISE SCALED RESIDUAL = "
+              << A.max_scaled_residual(x.data(), b.data()) << std::endl;
+    strumpack::blas::axpy(N, -1., x_exact.data(), 1, x.data(), 1);
+    auto nrm_error = strumpack::blas::nrm2(N, x.data(), 1);
+    auto nrm_x_exact = strumpack::blas::nrm2(N, x_exact.data(), 1);
+    std::cout << "# RELATIVE ERROR = " << (nrm_error/nrm_x_exact) << std::endl;
+  }
+
   {
     std::cout << std::endl;
     std::cout << "### STANDARD solver ###########################" << std::endl;
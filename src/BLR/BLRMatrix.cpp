@@ -33,6 +33,7 @@
 
 #include "BLRMatrix.hpp"
 #include "BLRTileBLAS.hpp"
+#include "MBLRTile.hpp"
 #if defined(STRUMPACK_USE_GPU)
 #include "BLRBatch.hpp"
 #include "sparse/fronts/FrontGPUKernels.hpp" // for replace_pivots
@@ -137,7 +138,7 @@ namespace strumpack {
 #endif
           {
             create_dense_tile(i, i, A);
-            auto tpiv = tile(i, i).LU(opts.pivot_threshold());
+            auto tpiv = factor_diagonal_tile(i, opts);
             std::copy(tpiv.begin(), tpiv.end(), piv_.begin()+tileroff(i));
           }
           // COMPRESS and SOLVE
@@ -253,7 +254,7 @@ namespace strumpack {
       auto rb = rowblocks();
       for (std::size_t i=0; i<rb; i++) {
         create_dense_tile_left_looking(i, i, Aelem);
-        auto tpiv = tile(i, i).LU(opts.pivot_threshold());
+        auto tpiv = factor_diagonal_tile(i, opts);
         int ti = tileroff(i);
         for (std::size_t l=0; l<tilerows(i); l++)
           piv_[ti+l] = tpiv[l] + ti;
@@ -290,6 +291,36 @@ namespace strumpack {
       return nnz;
     }
 
+    template<typename scalar_t> typename RealType<scalar_t>::value_type
+    BLRMatrix<scalar_t>::normF_bound() const {
+      real_t nrm2 = 0.;
+      for (auto& b : blocks_) {
+        if (!b) continue;
+        real_t nb = b->is_low_rank() ?
+          b->U().normF() * b->V().normF() : b->normF();
+        nrm2 += nb * nb;
+      }
+      return std::sqrt(nrm2);
+    }
+
+    template<typename scalar_t> void
+    BLRMatrix<scalar_t>::reduce_precision(real_t tol,
+                                          StoragePrecision lowest) {
+      if (lowest == StoragePrecision::FULL) return;
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)
+#endif
+      for (std::size_t t=0; t<blocks_.size(); t++) {
+        auto& b = blocks_[t];
+        if (!b || !b->is_low_rank() || !b->rank()) continue;
+        auto& lr = static_cast<LRTile<scalar_t>&>(*b);
+        if (lr.precision() != StoragePrecision::FULL) continue;
+        lr.reduce_precision
+          (select_storage_precision
+           (lr.U().normF() * lr.V().normF(), tol, lowest));
+      }
+    }
+
     template<typename scalar_t> std::size_t
     BLRMatrix<scalar_t>::rank() const {
       std::size_t mrank = 0;
@@ -543,6 +574,18 @@ namespace strumpack {
       Aelem(ii, jj, tile(i, j).D());
     }
 
+    template<typename scalar_t> std::vector<int>
+    BLRMatrix<scalar_t>::factor_diagonal_tile(std::size_t i,
+                                              const Opts_t& opts) {
+      if (MBLRTile<scalar_t>::is_nested(tilerows(i), opts)) {
+        auto t = std::make_unique<MBLRTile<scalar_t>>(tile(i, i).D(), opts);
+        auto tpiv = t->piv();
+        block(i, i) = std::move(t);
+        return tpiv;
+      }
+      return tile(i, i).LU(opts.pivot_threshold());
+    }
+
     template<typename scalar_t> void
     BLRMatrix<scalar_t>::create_dense_tile_left_looking
     (std::size_t i, std::size_t j, const extract_t& Aelem) {
@@ -775,7 +818,7 @@ namespace strumpack {
 #endif
             {
               B11.create_dense_tile(i, i, A11);
-              auto tpiv = B11.tile(i, i).LU(opts.pivot_threshold());
+              auto tpiv = B11.factor_diagonal_tile(i, opts);
               std::copy(tpiv.begin(), tpiv.end(),
                         B11.piv_.begin()+B11.tileroff(i));
             }
@@ -1274,7 +1317,7 @@ namespace strumpack {
 #pragma omp task default(shared) firstprivate(i,ii) depend(inout:B[ii])
 #endif
             {
-              auto tpiv = B11.tile(i, i).LU(opts.pivot_threshold());
+              auto tpiv = B11.factor_diagonal_tile(i, opts);
               std::copy(tpiv.begin(), tpiv.end(),
                         B11.piv_.begin()+B11.tileroff(i));
             }
@@ -1431,7 +1474,7 @@ namespace strumpack {
                    B11.tile(j, k), B11.tile(k, i), scalar_t(1.),
                    B11.tile_dense(j, i).D());
           }
-          auto tpiv = B11.tile(i, i).LU(opts.pivot_threshold());
+          auto tpiv = B11.factor_diagonal_tile(i, opts);
           std::copy(tpiv.begin(), tpiv.end(),
                     B11.piv_.begin()+B11.tileroff(i));
 #pragma omp taskloop
@@ -1506,7 +1549,7 @@ namespace strumpack {
       auto rb2 = B21.rowblocks();
       for (std::size_t i=0; i<rb; i++) {
         B11.create_dense_tile_left_looking(i, i, A11);
-        auto tpiv = B11.tile(i, i).LU(opts.pivot_threshold());
+        auto tpiv = B11.factor_diagonal_tile(i, opts);
         std::copy(tpiv.begin(), tpiv.end(), B11.piv_.begin()+B11.tileroff(i));
         for (std::size_t j=i+1; j<rb; j++) {
           // these blocks have received all updates, compress now
@@ -1574,8 +1617,8 @@ namespace strumpack {
 #endif
             {
               DMW_t Bi(F1.tilerows(i), B1.cols(), B1, F1.tileroff(i), 0);
-              trsv(UpLo::L, Trans::N, Diag::U, F1.tile(i, i).D(), Bi,
-                   params::task_recursion_cutoff_level);
+              F1.tile(i, i).trsv_a(UpLo::L, Trans::N, Diag::U, Bi,
+                                   params::task_recursion_cutoff_level);
             }
             for (std::size_t j=i+1; j<rb; j++) {
 #if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
@@ -1654,8 +1697,8 @@ namespace strumpack {
 #endif
             {
               DMW_t Bi(F1.tilerows(i), B1.cols(), B1, F1.tileroff(i), 0);
-              trsv(UpLo::U, Trans::N, Diag::N, F1.tile(i, i).D(), Bi,
-                   params::task_recursion_cutoff_level);
+              F1.tile(i, i).trsv_a(UpLo::U, Trans::N, Diag::N, Bi,
+                                   params::task_recursion_cutoff_level);
             }
           }
         }
@@ -1726,8 +1769,8 @@ namespace strumpack {
               (ta, scalar_t(-1.),
                DMW_t(a.tilecols(j), b.cols(), b, a.tilecoff(j), 0),
                scalar_t(1.), bi);
-          trsv(ul, ta, d, a.tile(i, i).D(), bi,
-               params::task_recursion_cutoff_level);
+          a.tile(i, i).trsv_a(ul, ta, d, bi,
+                              params::task_recursion_cutoff_level);
         }
       } else {
         for (int i=int(a.rowblocks())-1; i>=0; i--) {
@@ -1737,8 +1780,8 @@ namespace strumpack {
               (ta, scalar_t(-1.),
                DMW_t(a.tilecols(j), b.cols(), b, a.tilecoff(j), 0),
                scalar_t(1.), bi);
-          trsv(ul, ta, d, a.tile(i, i).D(), bi,
-               params::task_recursion_cutoff_level);
+          a.tile(i, i).trsv_a(ul, ta, d, bi,
+                              params::task_recursion_cutoff_level);
         }
       }
     }
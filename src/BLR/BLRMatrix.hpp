@@ -49,6 +49,7 @@ namespace strumpack {
     // forward declarations
     template<typename scalar> class BLRTile;
     template<typename scalar_t,typename integer_t> class BLRExtendAdd;
+    template<typename scalar_t> class MBLRTile;
 
 
     /**
@@ -109,6 +110,32 @@ namespace strumpack {
       void compress_and_factor(const extract_t& Aelem, const adm_t& admissible,
                                const Opts_t& opts);
 
+      /**
+       * Upper bound on the Frobenius norm of this matrix, computed
+       * as sqrt(sum_t ||T||_F^2), using ||U||_F ||V||_F as bound for
+       * a low-rank tile T = U V.
+       */
+      real_t normF_bound() const;
+
+      /**
+       * Store the low-rank tiles in reduced precision. For each
+       * low-rank tile T, the lowest precision (but not lower than
+       * lowest) is selected for which the rounding error u ||T||_F
+       * stays below tol. Tiles with a small norm, ie, with small
+       * singular values, can thus be stored in single precision or
+       * bfloat16, while the dense (diagonal) tiles are kept in full
+       * precision.
+       *
+       * This should only be called on a factored matrix. Afterwards
+       * the matrix can only be used in the solve routines (trsv,
+       * trsm, gemv, gemm with a dense matrix), for element
+       * extraction or converted to dense.
+       *
+       * \param tol absolute tolerance per tile
+       * \param lowest lowest allowed precision
+       */
+      void reduce_precision(real_t tol, StoragePrecision lowest);
+
       void draw(std::ostream& of, std::size_t roff, std::size_t coff) const;
 
       void print(const std::string& name) const;
@@ -272,6 +299,15 @@ namespace strumpack {
                                        const extract_t& Aelem,
                                        const BLRM_t& B21, const BLRM_t& B12,
                                        const Opts_t& opts);
+      /**
+       * LU factorization of diagonal tile i, which should be a
+       * DenseTile. With multilevel BLR, a large diagonal tile is
+       * replaced by a (factored) MBLRTile. Returns the pivot vector,
+       * local to the tile.
+       */
+      std::vector<int> factor_diagonal_tile(std::size_t i,
+                                            const Opts_t& opts);
+
       void LUAR_B11(std::size_t i, std::size_t j, std::size_t kmax,
                     DenseM_t& A11, const Opts_t& opts, int* B);
       void LUAR_B12(std::size_t i, std::size_t j, std::size_t kmax,
@@ -284,6 +320,7 @@ namespace strumpack {
       template<typename T> friend
       void draw(const BLRMatrix<T>& H, const std::string& name);
       template<typename T,typename I> friend class BLRExtendAdd;
+      template<typename T> friend class MBLRTile;
 
       // suppress warnings
       using structured::StructuredMatrix<scalar_t>::mult;
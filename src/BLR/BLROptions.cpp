@@ -96,6 +96,9 @@ namespace strumpack {
          {"blr_BACA_blocksize",        required_argument, 0, 7},
          {"blr_factor_algorithm",      required_argument, 0, 8},
          {"blr_compression_kernel",    required_argument, 0, 9},
+         {"blr_storage_precision",     required_argument, 0, 10},
+         {"blr_mblr_levels",           required_argument, 0, 11},
+         {"blr_mblr_tile_ratio",       required_argument, 0, 12},
          {"blr_verbose",               no_argument, 0, 'v'},
          {"blr_quiet",                 no_argument, 0, 'q'},
          {"help",                      no_argument, 0, 'h'},
@@ -187,6 +190,30 @@ namespace strumpack {
                       << " recognized, use 'full' or 'half'."
                       << std::endl;
         } break;
+        case 10: {
+          std::istringstream iss(optarg);
+          std::string s; iss >> s;
+          if (s == "full")
+            set_storage_precision(StoragePrecision::FULL);
+          else if (s == "single")
+            set_storage_precision(StoragePrecision::SINGLE);
+          else if (s == "bfloat16")
+            set_storage_precision(StoragePrecision::BFLOAT16);
+          else
+            std::cerr << "# WARNING: storage precision not"
+                      << " recognized, use 'full', 'single' or 'bfloat16'."
+                      << std::endl;
+        } break;
+        case 11: {
+          std::istringstream iss(optarg);
+          iss >> mblr_levels_;
+          set_MBLR_levels(mblr_levels_);
+        } break;
+        case 12: {
+          std::istringstream iss(optarg);
+          iss >> mblr_ratio_;
+          set_MBLR_tile_ratio(mblr_ratio_);
+        } break;
         case 'v': this->set_verbose(true); break;
         case 'q': this->set_verbose(false); break;
         case 'h': describe_options(); break;
@@ -223,6 +250,18 @@ namespace strumpack {
                 << "#   --blr_compression_kernel (default "
                 << get_name(crn_krnl_) << ")" << std::endl
                 << "#      should be [full|half]" << std::endl
+                << "#   --blr_storage_precision (default "
+                << get_name(storage_prec_) << ")" << std::endl
+                << "#      lowest precision for low-rank factors,"
+                << " should be [full|single|bfloat16]" << std::endl
+                << "#   --blr_mblr_levels int (default "
+                << MBLR_levels() << ")" << std::endl
+                << "#      number of multilevel BLR levels,"
+                << " 1 is flat BLR" << std::endl
+                << "#   --blr_mblr_tile_ratio int (default "
+                << MBLR_tile_ratio() << ")" << std::endl
+                << "#      ratio of tile sizes of consecutive"
+                << " MBLR levels" << std::endl
                 << "#   --blr_BACA_blocksize int (default "
                 << BACA_blocksize() << ")" << std::endl
                 << "#   --blr_verbose or -v (default "
@@ -35,6 +35,7 @@
 #include <cassert>
 
 #include "dense/BLASLAPACKWrapper.hpp"
+#include "dense/ReducedPrecisionMatrix.hpp"
 #include "structured/StructuredOptions.hpp"
 
 namespace strumpack {
@@ -113,12 +114,53 @@ namespace strumpack {
       void set_compression_kernel(CompressionKernel a) {
         crn_krnl_ = a;
       }
+      /**
+       * Lowest precision allowed to store the factors of the
+       * low-rank tiles after factorization. The actual precision is
+       * selected per tile, based on the norm of the tile and the
+       * compression tolerance. The default is FULL, ie, no
+       * reduced precision storage.
+       */
+      void set_storage_precision(StoragePrecision p) {
+        storage_prec_ = p;
+      }
+      /**
+       * Number of levels for multilevel BLR (MBLR). With a single
+       * level (the default), all tiles are at most leaf_size(). With
+       * L > 1 levels, the matrix is first partitioned in tiles of
+       * size MBLR_leaf_size(), and the large diagonal tiles are
+       * themselves stored as BLR matrices with L-1 levels,
+       * recursively, see MBLRTile.
+       */
+      void set_MBLR_levels(int l) {
+        assert(l >= 1);
+        mblr_levels_ = l;
+      }
+      /**
+       * Ratio of the tile sizes between two consecutive MBLR levels.
+       */
+      void set_MBLR_tile_ratio(int r) {
+        assert(r >= 2);
+        mblr_ratio_ = r;
+      }
 
       LowRankAlgorithm low_rank_algorithm() const { return lr_algo_; }
       Admissibility admissibility() const { return adm_; }
       int BACA_blocksize() const { return BACA_blocksize_; }
       BLRFactorAlgorithm BLR_factor_algorithm() const { return blr_algo_; }
       CompressionKernel compression_kernel() const { return crn_krnl_; }
+      StoragePrecision storage_precision() const { return storage_prec_; }
+      int MBLR_levels() const { return mblr_levels_; }
+      int MBLR_tile_ratio() const { return mblr_ratio_; }
+      /**
+       * Tile size on the outermost MBLR level, this is leaf_size()
+       * times MBLR_tile_ratio()^(MBLR_levels()-1).
+       */
+      int MBLR_leaf_size() const {
+        int ls = this->leaf_size();
+        for (int l=1; l<mblr_levels_; l++) ls *= mblr_ratio_;
+        return ls;
+      }
 
       void set_from_command_line(int argc, const char* const* cargv) override;
 
@@ -131,6 +173,9 @@ namespace strumpack {
       Admissibility adm_ = Admissibility::WEAK;
       BLRFactorAlgorithm blr_algo_ = BLRFactorAlgorithm::RL;
       CompressionKernel crn_krnl_ = CompressionKernel::HALF;
+      StoragePrecision storage_prec_ = StoragePrecision::FULL;
+      int mblr_levels_ = 1;
+      int mblr_ratio_ = 4;
 
       void set_defaults() {
         this->rel_tol_ = default_BLR_rel_tol<real_t>();
@@ -139,6 +139,24 @@ namespace strumpack {
       virtual void trsm_b(gpu::Handle& handle, Side s, UpLo ul,
                           Trans ta, Diag d, scalar_t alpha, DenseM_t& a) = 0;
 #endif
+      /**
+       * Triangular solve with this (factored) diagonal tile as the
+       * triangular matrix, and b as the right-hand side. By default
+       * this uses the dense LU factors D().
+       */
+      virtual void trsm_a(Side s, UpLo ul, Trans ta, Diag d,
+                          scalar_t alpha, BLRTile<scalar_t>& b) const {
+        b.trsm_b(s, ul, ta, d, alpha, D());
+      }
+      virtual void trsm_a(Side s, UpLo ul, Trans ta, Diag d,
+                          scalar_t alpha, DenseM_t& b,
+                          int task_depth) const {
+        trsm(s, ul, ta, d, alpha, D(), b, task_depth);
+      }
+      virtual void trsv_a(UpLo ul, Trans ta, Diag d, DenseM_t& b,
+                          int task_depth) const {
+        trsv(ul, ta, d, D(), b, task_depth);
+      }
       virtual void gemv_a(Trans ta, scalar_t alpha, const DenseM_t& x,
                           scalar_t beta, DenseM_t& y) const = 0;
       virtual void gemm_a(Trans ta, Trans tb, scalar_t alpha,
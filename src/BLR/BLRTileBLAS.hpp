@@ -80,14 +80,14 @@ namespace strumpack {
     template<typename scalar_t> void
     trsm(Side s, UpLo ul, Trans ta, Diag d, scalar_t alpha,
          const BLRTile<scalar_t>& a, BLRTile<scalar_t>& b) {
-      b.trsm_b(s, ul, ta, d, alpha, a.D());
+      a.trsm_a(s, ul, ta, d, alpha, b);
     }
 
     template<typename scalar_t> void
     trsm(Side s, UpLo ul, Trans ta, Diag d, scalar_t alpha,
          const BLRTile<scalar_t>& a, DenseMatrix<scalar_t>& b,
          int task_depth) {
-      trsm(s, ul, ta, d, alpha, a.D(), b, task_depth);
+      a.trsm_a(s, ul, ta, d, alpha, b, task_depth);
     }
 #if defined(STRUMPACK_USE_GPU)
     template<typename scalar_t> void
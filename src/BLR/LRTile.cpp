@@ -196,10 +196,23 @@ namespace strumpack {
     template<typename scalar_t> void
     LRTile<scalar_t>::dense(DenseM_t& A) const {
       assert(A.rows() == rows() && A.cols() == cols());
+      if (Ur_) {
+        Ur_->gemm(Trans::N, scalar_t(1.), Vr_->dense(), scalar_t(0.), A);
+        return;
+      }
       gemm(Trans::N, Trans::N, scalar_t(1.), U(), V(), scalar_t(0.), A,
            params::task_recursion_cutoff_level);
     }
 
+    template<typename scalar_t> void
+    LRTile<scalar_t>::reduce_precision(StoragePrecision p) {
+      if (p == StoragePrecision::FULL || Ur_) return;
+      Ur_.reset(new ReducedPrecisionMatrix<scalar_t>(*U_, p));
+      Vr_.reset(new ReducedPrecisionMatrix<scalar_t>(*V_, p));
+      U_.reset(new DenseM_t());
+      V_.reset(new DenseM_t());
+    }
+
     template<typename scalar_t> DenseMatrix<scalar_t>
     LRTile<scalar_t>::dense() const {
       DenseM_t A(rows(), cols());
@@ -209,6 +222,12 @@ namespace strumpack {
 
     template<typename scalar_t> std::unique_ptr<BLRTile<scalar_t>>
     LRTile<scalar_t>::clone() const {
+      if (Ur_) {
+        auto t = std::make_unique<LRTile<scalar_t>>();
+        t->Ur_.reset(new ReducedPrecisionMatrix<scalar_t>(*Ur_));
+        t->Vr_.reset(new ReducedPrecisionMatrix<scalar_t>(*Vr_));
+        return t;
+      }
       return std::unique_ptr<BLRTile<scalar_t>>(new LRTile(U(), V()));
     }
 
@@ -230,6 +249,12 @@ namespace strumpack {
 
     template<typename scalar_t> scalar_t
     LRTile<scalar_t>::operator()(std::size_t i, std::size_t j) const {
+      if (Ur_) {
+        scalar_t r(0.);
+        for (std::size_t k=0; k<rank(); k++)
+          r += (*Ur_)(i, k) * (*Vr_)(k, j);
+        return r;
+      }
       return blas::dotu(rank(), U().ptr(i, 0), U().ld(), V().ptr(0, j), 1);
     }
 
@@ -237,6 +262,10 @@ namespace strumpack {
     LRTile<scalar_t>::extract(const std::vector<std::size_t>& I,
                               const std::vector<std::size_t>& J,
                               DenseM_t& B) const {
+      if (Ur_) {
+        BLRTile<scalar_t>::extract(I, J, B);
+        return;
+      }
       gemm(Trans::N, Trans::N, scalar_t(1.), U().extract_rows(I),
            V().extract_cols(J), scalar_t(0.), B,
            params::task_recursion_cutoff_level);
@@ -314,6 +343,12 @@ namespace strumpack {
     LRTile<scalar_t>::gemv_a(Trans ta, scalar_t alpha, const DenseM_t& x,
                              scalar_t beta, DenseM_t& y) const {
       DenseM_t tmp(rank(), x.cols());
+      if (Ur_) {
+        (ta==Trans::N ? Vr_ : Ur_)->gemm
+          (ta, scalar_t(1.), x, scalar_t(0.), tmp);
+        (ta==Trans::N ? Ur_ : Vr_)->gemm(ta, alpha, tmp, beta, y);
+        return;
+      }
       gemv(ta, scalar_t(1.), ta==Trans::N ? V() : U(), x, scalar_t(0.), tmp,
            params::task_recursion_cutoff_level);
       gemv(ta, alpha, ta==Trans::N ? U() : V(), tmp, beta, y,
@@ -332,6 +367,14 @@ namespace strumpack {
                              const DenseM_t& b, scalar_t beta,
                              DenseM_t& c, int task_depth) const {
       DenseM_t tmp(rank(), c.cols());
+      if (Ur_) {
+        // only used in the solve phase, with a non-transposed b
+        assert(tb == Trans::N);
+        (ta==Trans::N ? Vr_ : Ur_)->gemm
+          (ta, scalar_t(1.), b, scalar_t(0.), tmp);
+        (ta==Trans::N ? Ur_ : Vr_)->gemm(ta, alpha, tmp, beta, c);
+        return;
+      }
       gemm(ta, tb, scalar_t(1.), ta==Trans::N ? V() : U(), b,
            scalar_t(0.), tmp, task_depth);
       gemm(ta, Trans::N, alpha, ta==Trans::N ? U() : V(), tmp,
@@ -37,6 +37,7 @@
 #include "BLRTile.hpp"
 #include "BLROptions.hpp"
 #include "dense/DenseMatrix.hpp"
+#include "dense/ReducedPrecisionMatrix.hpp"
 
 #include "dense/GPUWrapper.hpp"
 
@@ -122,18 +123,54 @@ namespace strumpack {
       }
 #endif
 
-      std::size_t rows() const override { return U_->rows(); }
-      std::size_t cols() const override { return V_->cols(); }
-      std::size_t rank() const override { return U_->cols(); }
+      std::size_t rows() const override {
+        return Ur_ ? Ur_->rows() : U_->rows();
+      }
+      std::size_t cols() const override {
+        return Vr_ ? Vr_->cols() : V_->cols();
+      }
+      std::size_t rank() const override {
+        return Ur_ ? Ur_->cols() : U_->cols();
+      }
       int rank_1() const override { return rank(); }
       bool is_low_rank() const override { return true; };
 
-      std::size_t memory() const override { return U_->memory() + V_->memory(); }
-      std::size_t nonzeros() const override { return (rows()+cols())*rank(); }
-      std::size_t maximum_rank() const override { return U_->cols(); }
+      std::size_t memory() const override {
+        return Ur_ ? Ur_->memory() + Vr_->memory() :
+          U_->memory() + V_->memory();
+      }
+      /**
+       * When stored in reduced precision, this returns the number of
+       * scalar_t elements that fit in the memory used by this tile.
+       */
+      std::size_t nonzeros() const override {
+        return Ur_ ? memory() / sizeof(scalar_t) : (rows()+cols())*rank();
+      }
+      std::size_t maximum_rank() const override { return rank(); }
+
+      std::size_t subnormals() const override {
+        return Ur_ ? 0 : U_->subnormals() + V_->subnormals();
+      }
+      std::size_t zeros() const override {
+        return Ur_ ? 0 : U_->zeros() + V_->zeros();
+      }
+
+      /**
+       * Precision used to store the U and V factors.
+       */
+      StoragePrecision precision() const {
+        return Ur_ ? Ur_->precision() : StoragePrecision::FULL;
+      }
 
-      std::size_t subnormals() const override { return U_->subnormals() + V_->subnormals(); }
-      std::size_t zeros() const override { return U_->zeros() + V_->zeros(); }
+      /**
+       * Convert the U and V factors to (lower) precision p. After
+       * this, the tile can only be used in products with dense
+       * matrices (gemv_a, gemm_a with a DenseMatrix), in element
+       * extraction or be converted back to dense. This is meant to
+       * be called on a factored tile, before the solve phase. The
+       * accessors U() and V() can no longer be used.
+       */
+      void reduce_precision(StoragePrecision p);
 
       void dense(DenseM_t& A) const override;
       DenseM_t dense() const override;
@@ -156,12 +193,12 @@ namespace strumpack {
       void draw(std::ostream& of, std::size_t roff,
                 std::size_t coff) const override;
 
-      DenseM_t& D() override { return *U_; }
-      DenseM_t& U() override { return *U_; }
-      DenseM_t& V() override { return *V_; }
-      const DenseM_t& D() const override { return *U_; }
-      const DenseM_t& U() const override { return *U_; }
-      const DenseM_t& V() const override { return *V_; }
+      DenseM_t& D() override { assert(!Ur_); return *U_; }
+      DenseM_t& U() override { assert(!Ur_); return *U_; }
+      DenseM_t& V() override { assert(!Ur_); return *V_; }
+      const DenseM_t& D() const override { assert(!Ur_); return *U_; }
+      const DenseM_t& U() const override { assert(!Ur_); return *U_; }
+      const DenseM_t& V() const override { assert(!Ur_); return *V_; }
 
       void copy_to(scalar_t*& ptr) const override;
 
@@ -282,6 +319,7 @@ namespace strumpack {
 
     private:
       std::unique_ptr<DenseM_t> U_, V_;
+      std::unique_ptr<ReducedPrecisionMatrix<scalar_t>> Ur_, Vr_;
     };
 
 
@@ -0,0 +1,299 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <cassert>
+#include <cmath>
+
+#include "MBLRTile.hpp"
+#include "BLRTileBLAS.hpp"
+#include "structured/ClusterTree.hpp"
+
+namespace strumpack {
+  namespace BLR {
+
+    template<typename scalar_t> BLROptions<scalar_t>
+    MBLRTile<scalar_t>::nested_options(const Opts_t& opts) {
+      Opts_t nopts(opts);
+      nopts.set_MBLR_levels(opts.MBLR_levels()-1);
+      // compress_and_factor has no column-wise variant
+      if (nopts.BLR_factor_algorithm() == BLRFactorAlgorithm::COLWISE)
+        nopts.set_BLR_factor_algorithm(BLRFactorAlgorithm::RL);
+      return nopts;
+    }
+
+    template<typename scalar_t> bool
+    MBLRTile<scalar_t>::is_nested(std::size_t m, const Opts_t& opts) {
+      if (opts.MBLR_levels() < 2) return false;
+      return m >= 2 * std::size_t(nested_options(opts).MBLR_leaf_size());
+    }
+
+    template<typename scalar_t>
+    MBLRTile<scalar_t>::MBLRTile(const DenseM_t& A, const Opts_t& opts) {
+      assert(A.rows() == A.cols());
+      auto nopts = nested_options(opts);
+      auto tiles = structured::ClusterTree(A.rows()).refine
+        (nopts.MBLR_leaf_size()).template leaf_sizes<std::size_t>();
+      auto nt = tiles.size();
+      DenseMatrix<bool> adm(nt, nt);
+      adm.fill(true);
+      for (std::size_t t=0; t<nt; t++)
+        adm(t, t) = false;
+      B_ = BLRMatrix<scalar_t>(A.rows(), tiles, A.cols(), tiles);
+      B_.compress_and_factor(A, adm, nopts);
+    }
+
+    template<typename scalar_t> typename RealType<scalar_t>::value_type
+    MBLRTile<scalar_t>::normF() const {
+      real_t nrm2 = 0.;
+      for (std::size_t j=0; j<B_.colblocks(); j++)
+        for (std::size_t i=0; i<B_.rowblocks(); i++) {
+          auto nt = B_.tile(i, j).normF();
+          nrm2 += nt * nt;
+        }
+      return std::sqrt(nrm2);
+    }
+
+    template<typename scalar_t> std::unique_ptr<BLRTile<scalar_t>>
+    MBLRTile<scalar_t>::clone() const {
+      std::unique_ptr<MBLRTile<scalar_t>> t(new MBLRTile<scalar_t>());
+      std::vector<std::size_t> tiles(B_.rowblocks());
+      for (std::size_t i=0; i<tiles.size(); i++)
+        tiles[i] = B_.tilerows(i);
+      t->B_ = BLRMatrix<scalar_t>(rows(), tiles, cols(), tiles);
+      for (std::size_t j=0; j<B_.colblocks(); j++)
+        for (std::size_t i=0; i<B_.rowblocks(); i++)
+          t->B_.block(i, j) = B_.tile(i, j).clone();
+      t->B_.piv_ = B_.piv_;
+      return t;
+    }
+
+    template<typename scalar_t> std::unique_ptr<LRTile<scalar_t>>
+    MBLRTile<scalar_t>::compress(const Opts_t& opts) const {
+      return std::unique_ptr<LRTile<scalar_t>>
+        (new LRTile<scalar_t>(dense(), opts));
+    }
+
+    template<typename scalar_t> void
+    MBLRTile<scalar_t>::copy_to(scalar_t*& ptr) const {
+      auto A = dense();
+      std::copy(A.data(), A.end(), ptr);
+      ptr += rows()*cols();
+    }
+
+    template<typename scalar_t> LRTile<scalar_t>
+    MBLRTile<scalar_t>::multiply(const BLRTile<scalar_t>& a) const {
+      return dense_tile().multiply(a);
+    }
+    template<typename scalar_t> LRTile<scalar_t>
+    MBLRTile<scalar_t>::left_multiply(const LRTile<scalar_t>& a) const {
+      return dense_tile().left_multiply(a);
+    }
+    template<typename scalar_t> LRTile<scalar_t>
+    MBLRTile<scalar_t>::left_multiply(const DenseTile<scalar_t>& a) const {
+      return dense_tile().left_multiply(a);
+    }
+
+    template<typename scalar_t> void MBLRTile<scalar_t>::multiply
+    (const BLRTile<scalar_t>& a, DenseM_t& b, DenseM_t& c) const {
+      dense_tile().multiply(a, b, c);
+    }
+    template<typename scalar_t> void MBLRTile<scalar_t>::left_multiply
+    (const LRTile<scalar_t>& a, DenseM_t& b, DenseM_t& c) const {
+      dense_tile().left_multiply(a, b, c);
+    }
+    template<typename scalar_t> void MBLRTile<scalar_t>::left_multiply
+    (const DenseTile<scalar_t>& a, DenseM_t& b, DenseM_t& c) const {
+      dense_tile().left_multiply(a, b, c);
+    }
+
+    template<typename scalar_t> void
+    MBLRTile<scalar_t>::laswp(const std::vector<int>& piv, bool fwd) {
+      // the rows of a factored diagonal tile are never permuted
+      not_supported("laswp");
+    }
+
+#if defined(STRUMPACK_USE_GPU)
+    template<typename scalar_t> void
+    MBLRTile<scalar_t>::laswp(gpu::Handle& h, int* dpiv, bool fwd) {
+      not_supported("laswp");
+    }
+    template<typename scalar_t> void
+    MBLRTile<scalar_t>::move_to_cpu(gpu::Stream& s, scalar_t* pinned) {
+      not_supported("move_to_cpu");
+    }
+    template<typename scalar_t> void
+    MBLRTile<scalar_t>::move_to_gpu(gpu::Stream& s, scalar_t* dptr,
+                                    scalar_t* pinned) {
+      not_supported("move_to_gpu");
+    }
+    template<typename scalar_t> void
+    MBLRTile<scalar_t>::copy_from_device_to(scalar_t*& ptr) const {
+      not_supported("copy_from_device_to");
+    }
+    template<typename scalar_t> void
+    MBLRTile<scalar_t>::trsm_b(gpu::Handle& handle, Side s, UpLo ul,
+                               Trans ta, Diag d, scalar_t alpha,
+                               DenseM_t& a) {
+      not_supported("trsm_b");
+    }
+#endif
+
+    template<typename scalar_t> void MBLRTile<scalar_t>::trsm_a
+    (Side s, UpLo ul, Trans ta, Diag d, scalar_t alpha,
+     BLRTile<scalar_t>& b) const {
+      // for b = U V, solve with U from the left, or with V from the
+      // right
+      auto& X = b.is_low_rank() ? (s == Side::L ? b.U() : b.V()) : b.D();
+      trsm(s, ul, ta, d, alpha, B_, X, params::task_recursion_cutoff_level);
+    }
+
+    template<typename scalar_t> void MBLRTile<scalar_t>::trsm_a
+    (Side s, UpLo ul, Trans ta, Diag d, scalar_t alpha,
+     DenseM_t& b, int task_depth) const {
+      trsm(s, ul, ta, d, alpha, B_, b, task_depth);
+    }
+
+    template<typename scalar_t> void MBLRTile<scalar_t>::trsv_a
+    (UpLo ul, Trans ta, Diag d, DenseM_t& b, int task_depth) const {
+      if (b.cols() == 1) trsv(ul, ta, d, B_, b, task_depth);
+      else trsm(Side::L, ul, ta, d, scalar_t(1.), B_, b, task_depth);
+    }
+
+    template<typename scalar_t> void MBLRTile<scalar_t>::trsm_b
+    (Side s, UpLo ul, Trans ta, Diag d, scalar_t alpha,
+     const DenseM_t& a) {
+      // a factored diagonal tile is never the right-hand side
+      not_supported("trsm_b");
+    }
+
+    template<typename scalar_t> void MBLRTile<scalar_t>::gemv_a
+    (Trans ta, scalar_t alpha, const DenseM_t& x,
+     scalar_t beta, DenseM_t& y) const {
+      gemv(ta, alpha, B_, x, beta, y, params::task_recursion_cutoff_level);
+    }
+
+    template<typename scalar_t> void MBLRTile<scalar_t>::gemm_a
+    (Trans ta, Trans tb, scalar_t alpha, const BLRT_t& b,
+     scalar_t beta, DenseM_t& c) const {
+      dense_tile().gemm_a(ta, tb, alpha, b, beta, c);
+    }
+
+    template<typename scalar_t> void MBLRTile<scalar_t>::gemm_a
+    (Trans ta, Trans tb, scalar_t alpha, const DenseM_t& b,
+     scalar_t beta, DenseM_t& c, int task_depth) const {
+      gemm(ta, tb, alpha, B_, b, beta, c, task_depth);
+    }
+
+    template<typename scalar_t> void MBLRTile<scalar_t>::gemm_b
+    (Trans ta, Trans tb, scalar_t alpha, const LRTile<scalar_t>& a,
+     scalar_t beta, DenseM_t& c) const {
+      dense_tile().gemm_b(ta, tb, alpha, a, beta, c);
+    }
+
+    template<typename scalar_t> void MBLRTile<scalar_t>::gemm_b
+    (Trans ta, Trans tb, scalar_t alpha, const DenseTile<scalar_t>& a,
+     scalar_t beta, DenseM_t& c) const {
+      dense_tile().gemm_b(ta, tb, alpha, a, beta, c);
+    }
+
+    template<typename scalar_t> void MBLRTile<scalar_t>::gemm_b
+    (Trans ta, Trans tb, scalar_t alpha, const DenseM_t& a,
+     scalar_t beta, DenseM_t& c, int task_depth) const {
+      dense_tile().gemm_b(ta, tb, alpha, a, beta, c, task_depth);
+    }
+
+    template<typename scalar_t> void MBLRTile<scalar_t>::Schur_update_col_a
+    (std::size_t i, const BLRTile<scalar_t>& b,
+     scalar_t* c, scalar_t* work) const {
+      dense_tile().Schur_update_col_a(i, b, c, work);
+    }
+    template<typename scalar_t> void MBLRTile<scalar_t>::Schur_update_row_a
+    (std::size_t i, const BLRTile<scalar_t>& b,
+     scalar_t* c, scalar_t* work) const {
+      dense_tile().Schur_update_row_a(i, b, c, work);
+    }
+    template<typename scalar_t> void MBLRTile<scalar_t>::Schur_update_col_b
+    (std::size_t i, const LRTile<scalar_t>& a,
+     scalar_t* c, scalar_t* work) const {
+      dense_tile().Schur_update_col_b(i, a, c, work);
+    }
+    template<typename scalar_t> void MBLRTile<scalar_t>::Schur_update_col_b
+    (std::size_t i, const DenseTile<scalar_t>& a,
+     scalar_t* c, scalar_t* work) const {
+      dense_tile().Schur_update_col_b(i, a, c, work);
+    }
+    template<typename scalar_t> void MBLRTile<scalar_t>::Schur_update_row_b
+    (std::size_t i, const LRTile<scalar_t>& a,
+     scalar_t* c, scalar_t* work) const {
+      dense_tile().Schur_update_row_b(i, a, c, work);
+    }
+    template<typename scalar_t> void MBLRTile<scalar_t>::Schur_update_row_b
+    (std::size_t i, const DenseTile<scalar_t>& a,
+     scalar_t* c, scalar_t* work) const {
+      dense_tile().Schur_update_row_b(i, a, c, work);
+    }
+
+    template<typename scalar_t> void MBLRTile<scalar_t>::Schur_update_cols_a
+    (const std::vector<std::size_t>& cols, const BLRTile<scalar_t>& b,
+     DenseMatrix<scalar_t>& c, scalar_t* work) const {
+      dense_tile().Schur_update_cols_a(cols, b, c, work);
+    }
+    template<typename scalar_t> void MBLRTile<scalar_t>::Schur_update_rows_a
+    (const std::vector<std::size_t>& rows, const BLRTile<scalar_t>& b,
+     DenseMatrix<scalar_t>& c, scalar_t* work) const {
+      dense_tile().Schur_update_rows_a(rows, b, c, work);
+    }
+    template<typename scalar_t> void MBLRTile<scalar_t>::Schur_update_cols_b
+    (const std::vector<std::size_t>& cols, const LRTile<scalar_t>& a,
+     DenseMatrix<scalar_t>& c, scalar_t* work) const {
+      dense_tile().Schur_update_cols_b(cols, a, c, work);
+    }
+    template<typename scalar_t> void MBLRTile<scalar_t>::Schur_update_cols_b
+    (const std::vector<std::size_t>& cols, const DenseTile<scalar_t>& a,
+     DenseMatrix<scalar_t>& c, scalar_t* work) const {
+      dense_tile().Schur_update_cols_b(cols, a, c, work);
+    }
+    template<typename scalar_t> void MBLRTile<scalar_t>::Schur_update_rows_b
+    (const std::vector<std::size_t>& rows, const LRTile<scalar_t>& a,
+     DenseMatrix<scalar_t>& c, scalar_t* work) const {
+      dense_tile().Schur_update_rows_b(rows, a, c, work);
+    }
+    template<typename scalar_t> void MBLRTile<scalar_t>::Schur_update_rows_b
+    (const std::vector<std::size_t>& rows, const DenseTile<scalar_t>& a,
+     DenseMatrix<scalar_t>& c, scalar_t* work) const {
+      dense_tile().Schur_update_rows_b(rows, a, c, work);
+    }
+
+    // explicit template instantiations
+    template class MBLRTile<float>;
+    template class MBLRTile<double>;
+    template class MBLRTile<std::complex<float>>;
+    template class MBLRTile<std::complex<double>>;
+
+  } // end namespace BLR
+} // end namespace strumpack
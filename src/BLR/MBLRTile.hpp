@@ -0,0 +1,250 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/*! \file MBLRTile.hpp
+ * \brief Contains the MBLRTile class, subclass of BLRTile, for
+ * multilevel BLR.
+ */
+#ifndef MBLR_TILE_HPP
+#define MBLR_TILE_HPP
+
+#include <string>
+#include <stdexcept>
+
+#include "BLRMatrix.hpp"
+
+namespace strumpack {
+  namespace BLR {
+
+    /**
+     * \class MBLRTile
+     *
+     * \brief Factored diagonal tile of a multilevel BLR (MBLR)
+     * matrix, stored itself as a BLRMatrix.
+     *
+     * With BLROptions::MBLR_levels() > 1, the diagonal tiles of a
+     * BLRMatrix which are large enough are not factored as a
+     * DenseTile, but compressed and factored as a BLRMatrix with one
+     * level less, using BLRMatrix::compress_and_factor,
+     * recursively. The nested matrix uses weak admissibility and a
+     * regular bisection of the tile.
+     *
+     * This tile only appears on the diagonal of a factored
+     * BLRMatrix, where it is used in triangular solves, see
+     * trsm_a/trsv_a. The other BLRTile operations, which are never
+     * applied to a factored diagonal tile, go through a temporary
+     * dense copy. There is no dense storage, so D(), U() and V()
+     * cannot be used.
+     */
+    template<typename scalar_t> class MBLRTile
+      : public BLRTile<scalar_t> {
+      using real_t = typename RealType<scalar_t>::value_type;
+      using DenseM_t = DenseMatrix<scalar_t>;
+      using BLRT_t = BLRTile<scalar_t>;
+      using Opts_t = BLROptions<scalar_t>;
+
+    public:
+      /**
+       * Compress A as a BLR matrix with opts.MBLR_levels()-1
+       * levels, and factor it.
+       */
+      MBLRTile(const DenseM_t& A, const Opts_t& opts);
+
+      /**
+       * Should a diagonal tile of size m be stored as an MBLRTile?
+       * This requires at least 2 levels, and that the tile can be
+       * split in at least 2 tiles on the next level.
+       */
+      static bool is_nested(std::size_t m, const Opts_t& opts);
+
+      /**
+       * Pivot vector of the nested factorization, local to this
+       * tile, in the format returned by DenseTile::LU.
+       */
+      const std::vector<int>& piv() const { return B_.piv(); }
+
+      const BLRMatrix<scalar_t>& BLR() const { return B_; }
+
+      std::size_t rows() const override { return B_.rows(); }
+      std::size_t cols() const override { return B_.cols(); }
+      std::size_t rank() const override { return std::min(rows(), cols()); }
+
+      std::size_t memory() const override { return B_.memory(); }
+      std::size_t nonzeros() const override { return B_.nonzeros(); }
+      std::size_t maximum_rank() const override { return B_.rank(); }
+      bool is_low_rank() const override { return false; };
+
+      void dense(DenseM_t& A) const override { A = B_.dense(); }
+      DenseM_t dense() const override { return B_.dense(); }
+
+      std::size_t subnormals() const override { return B_.subnormals(); }
+      std::size_t zeros() const override { return B_.zeros(); }
+
+      real_t normF() const override;
+
+      std::unique_ptr<BLRTile<scalar_t>> clone() const override;
+
+      std::unique_ptr<LRTile<scalar_t>>
+      compress(const Opts_t& opts) const override;
+
+      void draw(std::ostream& of, std::size_t roff,
+                std::size_t coff) const override {
+        B_.draw(of, roff, coff);
+      }
+
+      DenseM_t& D() override { no_dense(); return D_; }
+      DenseM_t& U() override { no_dense(); return D_; }
+      DenseM_t& V() override { no_dense(); return D_; }
+      const DenseM_t& D() const override { no_dense(); return D_; }
+      const DenseM_t& U() const override { no_dense(); return D_; }
+      const DenseM_t& V() const override { no_dense(); return D_; }
+
+      void copy_to(scalar_t*& ptr) const override;
+
+      LRTile<scalar_t>
+      multiply(const BLRTile<scalar_t>& a) const override;
+      LRTile<scalar_t>
+      left_multiply(const LRTile<scalar_t>& a) const override;
+      LRTile<scalar_t>
+      left_multiply(const DenseTile<scalar_t>& a) const override;
+
+      void multiply(const BLRTile<scalar_t>& a,
+                    DenseM_t& b, DenseM_t& c) const override;
+      void left_multiply(const LRTile<scalar_t>& a,
+                         DenseM_t& b, DenseM_t& c) const override;
+      void left_multiply(const DenseTile<scalar_t>& a,
+                         DenseM_t& b, DenseM_t& c) const override;
+
+      scalar_t operator()(std::size_t i, std::size_t j) const override {
+        return B_(i, j);
+      }
+
+      void laswp(const std::vector<int>& piv, bool fwd) override;
+#if defined(STRUMPACK_USE_GPU)
+      void laswp(gpu::Handle& h, int* dpiv, bool fwd) override;
+      void move_to_cpu(gpu::Stream& s, scalar_t* pinned=nullptr) override;
+      void move_to_gpu(gpu::Stream& s, scalar_t* dptr,
+                       scalar_t* pinned=nullptr) override;
+      void copy_from_device_to(scalar_t*& ptr) const override;
+#endif
+
+      void trsm_a(Side s, UpLo ul, Trans ta, Diag d,
+                  scalar_t alpha, BLRTile<scalar_t>& b) const override;
+      void trsm_a(Side s, UpLo ul, Trans ta, Diag d, scalar_t alpha,
+                  DenseM_t& b, int task_depth) const override;
+      void trsv_a(UpLo ul, Trans ta, Diag d, DenseM_t& b,
+                  int task_depth) const override;
+
+      void trsm_b(Side s, UpLo ul, Trans ta, Diag d,
+                  scalar_t alpha, const DenseM_t& a) override;
+#if defined(STRUMPACK_USE_GPU)
+      void trsm_b(gpu::Handle& handle, Side s, UpLo ul,
+                  Trans ta, Diag d, scalar_t alpha,
+                  DenseM_t& a) override;
+#endif
+      void gemv_a(Trans ta, scalar_t alpha, const DenseM_t& x,
+                  scalar_t beta, DenseM_t& y) const override;
+      void gemm_a(Trans ta, Trans tb, scalar_t alpha, const BLRT_t& b,
+                  scalar_t beta, DenseM_t& c) const override;
+      void gemm_a(Trans ta, Trans tb, scalar_t alpha,
+                  const DenseM_t& b, scalar_t beta,
+                  DenseM_t& c, int task_depth) const override;
+      void gemm_b(Trans ta, Trans tb, scalar_t alpha,
+                  const LRTile<scalar_t>& a, scalar_t beta,
+                  DenseM_t& c) const override;
+      void gemm_b(Trans ta, Trans tb, scalar_t alpha,
+                  const DenseTile<scalar_t>& a, scalar_t beta,
+                  DenseM_t& c) const override;
+      void gemm_b(Trans ta, Trans tb, scalar_t alpha,
+                  const DenseM_t& a, scalar_t beta,
+                  DenseM_t& c, int task_depth) const override;
+
+      void Schur_update_col_a(std::size_t i, const BLRTile<scalar_t>& b,
+                              scalar_t* c, scalar_t* work) const override;
+      void Schur_update_row_a(std::size_t i, const BLRTile<scalar_t>& b,
+                              scalar_t* c, scalar_t* work) const override;
+      void Schur_update_col_b(std::size_t i, const LRTile<scalar_t>& a,
+                              scalar_t* c, scalar_t* work) const override;
+      void Schur_update_col_b(std::size_t i, const DenseTile<scalar_t>& a,
+                              scalar_t* c, scalar_t* work) const override;
+      void Schur_update_row_b(std::size_t i, const LRTile<scalar_t>& a,
+                              scalar_t* c, scalar_t* work) const override;
+      void Schur_update_row_b(std::size_t i, const DenseTile<scalar_t>& a,
+                              scalar_t* c, scalar_t* work) const override;
+
+      void Schur_update_cols_a(const std::vector<std::size_t>& cols,
+                               const BLRTile<scalar_t>& b,
+                               DenseMatrix<scalar_t>& c,
+                               scalar_t* work) const override;
+      void Schur_update_rows_a(const std::vector<std::size_t>& rows,
+                               const BLRTile<scalar_t>& b,
+                               DenseMatrix<scalar_t>& c,
+                               scalar_t* work) const override;
+      void Schur_update_cols_b(const std::vector<std::size_t>& cols,
+                               const LRTile<scalar_t>& a,
+                               DenseMatrix<scalar_t>& c,
+                               scalar_t* work) const override;
+      void Schur_update_cols_b(const std::vector<std::size_t>& cols,
+                               const DenseTile<scalar_t>& a,
+                               DenseMatrix<scalar_t>& c,
+                               scalar_t* work) const override;
+      void Schur_update_rows_b(const std::vector<std::size_t>& rows,
+                               const LRTile<scalar_t>& a,
+                               DenseMatrix<scalar_t>& c,
+                               scalar_t* work) const override;
+      void Schur_update_rows_b(const std::vector<std::size_t>& rows,
+                               const DenseTile<scalar_t>& a,
+                               DenseMatrix<scalar_t>& c,
+                               scalar_t* work) const override;
+
+    private:
+      BLRMatrix<scalar_t> B_;
+      DenseM_t D_; // always empty
+
+      MBLRTile() = default;
+
+      DenseTile<scalar_t> dense_tile() const {
+        return DenseTile<scalar_t>(dense());
+      }
+      void no_dense() const {
+        throw std::logic_error
+          ("MBLRTile does not store a dense matrix.");
+      }
+      void not_supported(const std::string& op) const {
+        throw std::logic_error
+          ("MBLRTile::" + op + " is not supported on a factored "
+           "diagonal tile.");
+      }
+
+      static Opts_t nested_options(const Opts_t& opts);
+    };
+
+  } // end namespace BLR
+} // end namespace strumpack
+
+#endif // MBLR_TILE_HPP
@@ -0,0 +1,617 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <cassert>
+#include <numeric>
+#include <algorithm>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "HODLRMatrixNative.hpp"
+#include "StrumpackParameters.hpp"
+#include "misc/RandomWrapper.hpp"
+
+namespace strumpack {
+  namespace HODLR {
+
+    /*
+     * Run f from a single thread, spawning its tasks in the
+     * enclosing team if called from a parallel region (for instance
+     * from a frontal matrix), or else in a new parallel region.
+     */
+    template<typename F> void run_tasks(const F& f) {
+#if defined(_OPENMP)
+      if (omp_in_parallel()) {
+        f();
+        return;
+      }
+#endif
+#pragma omp parallel default(shared)
+#pragma omp single nowait
+      f();
+    }
+
+    template<typename scalar_t> BLR::BLROptions<scalar_t>
+    HODLRMatrixNative<scalar_t>::BLR_options(const Opts_t& opts) {
+      BLROpts_t bopts(opts);
+      bopts.set_BACA_blocksize(opts.BACA_block_size());
+      return bopts;
+    }
+
+    template<typename scalar_t> HODLRMatrixNative<scalar_t>::HODLRMatrixNative
+    (const structured::ClusterTree& tree, const DenseM_t& A,
+     const Opts_t& opts) {
+      assert(std::size_t(tree.size) == A.rows() && A.rows() == A.cols());
+      auto bopts = BLR_options(opts);
+      bopts.set_low_rank_algorithm(BLR::LowRankAlgorithm::RRQR);
+      run_tasks([&]() {
+        *this = HODLRMatrixNative<scalar_t>(tree, A, bopts, 0);
+      });
+    }
+
+    template<typename scalar_t> HODLRMatrixNative<scalar_t>::HODLRMatrixNative
+    (const structured::ClusterTree& tree, const extract_t& Aelem,
+     const Opts_t& opts) {
+      auto bopts = BLR_options(opts);
+      bopts.set_low_rank_algorithm(BLR::LowRankAlgorithm::BACA);
+      run_tasks([&]() {
+        *this = HODLRMatrixNative<scalar_t>(tree, Aelem, 0, bopts, 0);
+      });
+    }
+
+    template<typename scalar_t> HODLRMatrixNative<scalar_t>::HODLRMatrixNative
+    (const structured::ClusterTree& tree, const DenseM_t& A,
+     const BLROpts_t& opts, int depth) : rows_(tree.size) {
+      if (tree.c.empty()) {
+        D_ = DenseM_t(A);
+        return;
+      }
+      ch_.resize(2);
+      std::size_t n0 = tree.c[0].size, n1 = tree.c[1].size;
+      auto A00 = ConstDenseMatrixWrapperPtr(n0, n0, A, 0, 0);
+      auto A01 = ConstDenseMatrixWrapperPtr(n0, n1, A, 0, n0);
+      auto A10 = ConstDenseMatrixWrapperPtr(n1, n0, A, n0, 0);
+      auto A11 = ConstDenseMatrixWrapperPtr(n1, n1, A, n0, n0);
+      bool tasked = depth < params::task_recursion_cutoff_level;
+      if (tasked) {
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        ch_[0] = HODLRMatrixNative<scalar_t>(tree.c[0], *A00, opts, depth+1);
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        ch_[1] = HODLRMatrixNative<scalar_t>(tree.c[1], *A11, opts, depth+1);
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        A01_ = std::make_unique<LRTile_t>(*A01, opts);
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        A10_ = std::make_unique<LRTile_t>(*A10, opts);
+#pragma omp taskwait
+      } else {
+        ch_[0] = HODLRMatrixNative<scalar_t>(tree.c[0], *A00, opts, depth);
+        ch_[1] = HODLRMatrixNative<scalar_t>(tree.c[1], *A11, opts, depth);
+        A01_ = std::make_unique<LRTile_t>(*A01, opts);
+        A10_ = std::make_unique<LRTile_t>(*A10, opts);
+      }
+    }
+
+    template<typename scalar_t> HODLRMatrixNative<scalar_t>::HODLRMatrixNative
+    (const structured::ClusterTree& tree, const extract_t& Aelem,
+     std::size_t r0, const BLROpts_t& opts, int depth) : rows_(tree.size) {
+      if (tree.c.empty()) {
+        std::vector<std::size_t> I(rows_);
+        std::iota(I.begin(), I.end(), r0);
+        D_ = DenseM_t(rows_, rows_);
+        Aelem(I, I, D_);
+        return;
+      }
+      ch_.resize(2);
+      std::size_t n0 = tree.c[0].size, n1 = tree.c[1].size;
+      // compress the off-diagonal block at rows rb, columns cb
+      auto compress_offdiag =
+        [&](std::size_t m, std::size_t rb, std::size_t n, std::size_t cb) {
+          std::vector<std::size_t> I(m), J(n);
+          std::iota(I.begin(), I.end(), rb);
+          std::iota(J.begin(), J.end(), cb);
+          auto Arow = [&](const std::vector<std::size_t>& rows,
+                          DenseM_t& c) {
+            std::vector<std::size_t> gI(rows.size());
+            std::transform(rows.begin(), rows.end(), gI.begin(),
+                           [&rb](std::size_t r) { return r + rb; });
+            Aelem(gI, J, c);
+          };
+          auto Acol = [&](const std::vector<std::size_t>& cols,
+                          DenseM_t& c) {
+            std::vector<std::size_t> gJ(cols.size());
+            std::transform(cols.begin(), cols.end(), gJ.begin(),
+                           [&cb](std::size_t c) { return c + cb; });
+            Aelem(I, gJ, c);
+          };
+          return std::make_unique<LRTile_t>(m, n, Arow, Acol, opts);
+        };
+      bool tasked = depth < params::task_recursion_cutoff_level;
+      if (tasked) {
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        ch_[0] = HODLRMatrixNative<scalar_t>
+          (tree.c[0], Aelem, r0, opts, depth+1);
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        ch_[1] = HODLRMatrixNative<scalar_t>
+          (tree.c[1], Aelem, r0+n0, opts, depth+1);
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        A01_ = compress_offdiag(n0, r0, n1, r0+n0);
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        A10_ = compress_offdiag(n1, r0+n0, n0, r0);
+#pragma omp taskwait
+      } else {
+        ch_[0] = HODLRMatrixNative<scalar_t>(tree.c[0], Aelem, r0, opts, depth);
+        ch_[1] = HODLRMatrixNative<scalar_t>
+          (tree.c[1], Aelem, r0+n0, opts, depth);
+        A01_ = compress_offdiag(n0, r0, n1, r0+n0);
+        A10_ = compress_offdiag(n1, r0+n0, n0, r0);
+      }
+    }
+
+    template<typename scalar_t> HODLRMatrixNative<scalar_t>::HODLRMatrixNative
+    (const structured::ClusterTree& tree, const mult_t& Amult,
+     const Opts_t& opts) {
+      using real_t = typename RealType<scalar_t>::value_type;
+      skeleton(tree);
+      const std::size_t n = rows_;
+      // the non-leaf nodes per level, and all leafs, with their
+      // first row
+      using node_t = std::pair<HODLRMatrixNative<scalar_t>*,std::size_t>;
+      std::vector<std::vector<node_t>> lvl;
+      std::vector<node_t> leafs;
+      std::function<void(HODLRMatrixNative<scalar_t>&,std::size_t,
+                         std::size_t)> collect =
+        [&](HODLRMatrixNative<scalar_t>& H, std::size_t r0, std::size_t l) {
+          if (H.leaf()) {
+            leafs.emplace_back(&H, r0);
+            return;
+          }
+          if (lvl.size() <= l) lvl.resize(l+1);
+          lvl[l].emplace_back(&H, r0);
+          collect(H.ch_[0], r0, l+1);
+          collect(H.ch_[1], r0+H.ch_[0].rows(), l+1);
+        };
+      collect(*this, 0, 0);
+      // S = op(A - H_l) R, where H_l are the off-diagonal blocks on
+      // the levels < l, which have already been compressed
+      auto sample = [&](Trans op, const DenseM_t& R, DenseM_t& S, int l) {
+        Amult(op, R, S);
+        run_tasks([&]() { mult_offdiag_rec(op, scalar_t(-1.), R, S, l, 0); });
+      };
+      auto rgen = random::make_default_random_generator<real_t>();
+      const real_t rtol = opts.rel_tol(), atol = opts.abs_tol();
+      const int max_rank = opts.max_rank();
+      // a sample with rank+oversampling columns is considered enough
+      const std::size_t p = 5;
+      // initial number of samples, per block, on the next level. The
+      // ranks on consecutive levels are typically similar, so after
+      // the top level, start from the largest rank of the previous
+      // level
+      std::size_t dguess = opts.rank_guess();
+      for (std::size_t l=0; l<lvl.size(); l++) {
+        auto& nodes = lvl[l];
+        const std::size_t nn = nodes.size();
+        std::size_t mmax = 0;
+        for (auto& nd : nodes)
+          mmax = std::max({mmax, nd.first->ch_[0].rows(),
+                           nd.first->ch_[1].rows()});
+        // Y01 (Y10) holds the samples of the A01 (A10) blocks of all
+        // nodes on this level, Q01 and Q10 are orthonormal bases for
+        // the column spaces of these blocks
+        DenseM_t Y01(n, 0), Y10(n, 0);
+        std::vector<DenseM_t> Q01(nn), Q10(nn);
+        std::size_t d = std::max(std::size_t(1), std::min(dguess, mmax));
+        while (d) {
+          DenseM_t R(n, 2*d), S(n, 2*d);
+          R.zero();
+          for (auto& nd : nodes) {
+            auto n0 = nd.first->ch_[0].rows(), n1 = nd.first->ch_[1].rows();
+            DenseMW_t R1(n1, d, R, nd.second+n0, 0),
+              R0(n0, d, R, nd.second, d);
+            R1.random(*rgen);
+            R0.random(*rgen);
+          }
+          sample(Trans::N, R, S, l);
+          Y01.hconcat(DenseMW_t(n, d, S, 0, 0));
+          Y10.hconcat(DenseMW_t(n, d, S, 0, d));
+          const std::size_t ds = Y01.cols();
+          std::size_t dnext = 0;
+          run_tasks([&]() {
+            for (std::size_t i=0; i<nn; i++) {
+#pragma omp task default(shared) firstprivate(i)
+              {
+                auto n0 = nodes[i].first->ch_[0].rows(),
+                  n1 = nodes[i].first->ch_[1].rows(), r0 = nodes[i].second;
+                DenseMW_t S01(n0, ds, Y01, r0, 0), S10(n1, ds, Y10, r0+n0, 0);
+                DenseM_t V;
+                S01.low_rank(Q01[i], V, rtol, atol, max_rank, 0);
+                S10.low_rank(Q10[i], V, rtol, atol, max_rank, 0);
+              }
+            }
+#pragma omp taskwait
+          });
+          for (std::size_t i=0; i<nn; i++) {
+            auto n0 = nodes[i].first->ch_[0].rows(),
+              n1 = nodes[i].first->ch_[1].rows();
+            // the sample is exact if it has as many columns as the
+            // block, otherwise it needs oversampling
+            if ((ds < n1 && Q01[i].cols() + p > ds) ||
+                (ds < n0 && Q10[i].cols() + p > ds))
+              dnext = std::size_t
+                (std::max(1., ds * (opts.rank_rate() - 1.)));
+          }
+          if (ds >= mmax || ds >= std::size_t(max_rank)) dnext = 0;
+          d = std::min(dnext, mmax - ds);
+        }
+        // V01 = Q01^* A01 and V10 = Q10^* A10, from a single product
+        // with (A - H_l)^*
+        std::size_t k = 0;
+        for (std::size_t i=0; i<nn; i++)
+          k = std::max({k, Q01[i].cols(), Q10[i].cols()});
+        dguess = k + p;
+        DenseM_t P(n, 2*k), Z(n, 2*k);
+        P.zero();
+        for (std::size_t i=0; i<nn; i++) {
+          auto n0 = nodes[i].first->ch_[0].rows(), r0 = nodes[i].second;
+          copy(Q01[i], P, r0, 0);
+          copy(Q10[i], P, r0+n0, k);
+        }
+        sample(Trans::C, P, Z, l);
+        for (std::size_t i=0; i<nn; i++) {
+          auto H = nodes[i].first;
+          auto n0 = H->ch_[0].rows(), n1 = H->ch_[1].rows();
+          auto r0 = nodes[i].second;
+          DenseMW_t Z01(n1, Q01[i].cols(), Z, r0+n0, 0),
+            Z10(n0, Q10[i].cols(), Z, r0, k);
+          H->A01_ = std::make_unique<LRTile_t>(Q01[i], Z01.conj_transpose());
+          H->A10_ = std::make_unique<LRTile_t>(Q10[i], Z10.conj_transpose());
+        }
+      }
+      // the diagonal blocks of the leafs, sampled with a block
+      // identity matrix
+      std::size_t mmax = 0;
+      for (auto& nd : leafs)
+        mmax = std::max(mmax, nd.first->rows());
+      DenseM_t R(n, mmax), S(n, mmax);
+      R.zero();
+      for (auto& nd : leafs)
+        for (std::size_t i=0; i<nd.first->rows(); i++)
+          R(nd.second+i, i) = scalar_t(1.);
+      sample(Trans::N, R, S, lvl.size());
+      for (auto& nd : leafs) {
+        auto m = nd.first->rows();
+        nd.first->D_ = DenseM_t(m, m, S, nd.second, 0);
+      }
+    }
+
+    template<typename scalar_t> void
+    HODLRMatrixNative<scalar_t>::skeleton(const structured::ClusterTree& tree) {
+      rows_ = tree.size;
+      if (tree.c.empty()) return;
+      ch_.resize(2);
+      ch_[0].skeleton(tree.c[0]);
+      ch_[1].skeleton(tree.c[1]);
+    }
+
+    template<typename scalar_t> std::size_t
+    HODLRMatrixNative<scalar_t>::memory() const {
+      std::size_t m = D_.memory() + LU_.memory() + Z0_.memory() +
+        Z1_.memory() + K_.memory() + Kpiv_.size()*sizeof(int) +
+        piv_.size()*sizeof(int);
+      if (A01_) m += A01_->memory();
+      if (A10_) m += A10_->memory();
+      for (auto& c : ch_) m += c.memory();
+      return m;
+    }
+
+    template<typename scalar_t> std::size_t
+    HODLRMatrixNative<scalar_t>::nonzeros() const {
+      std::size_t nnz = D_.nonzeros() + LU_.nonzeros() +
+        Z0_.nonzeros() + Z1_.nonzeros() + K_.nonzeros();
+      if (A01_) nnz += A01_->nonzeros();
+      if (A10_) nnz += A10_->nonzeros();
+      for (auto& c : ch_) nnz += c.nonzeros();
+      return nnz;
+    }
+
+    template<typename scalar_t> std::size_t
+    HODLRMatrixNative<scalar_t>::rank() const {
+      std::size_t r = 0;
+      if (A01_) r = std::max(r, A01_->rank());
+      if (A10_) r = std::max(r, A10_->rank());
+      for (auto& c : ch_) r = std::max(r, c.rank());
+      return r;
+    }
+
+    template<typename scalar_t> std::size_t
+    HODLRMatrixNative<scalar_t>::levels() const {
+      std::size_t l = 0;
+      for (auto& c : ch_) l = std::max(l, c.levels());
+      return l + 1;
+    }
+
+    template<typename scalar_t> DenseMatrix<scalar_t>
+    HODLRMatrixNative<scalar_t>::dense() const {
+      DenseM_t A(rows_, rows_);
+      dense_rec(A);
+      return A;
+    }
+
+    template<typename scalar_t> void
+    HODLRMatrixNative<scalar_t>::dense_rec(DenseM_t& A) const {
+      if (leaf()) {
+        copy(D_, A, 0, 0);
+        return;
+      }
+      std::size_t n0 = ch_[0].rows(), n1 = ch_[1].rows();
+      DenseMW_t A00(n0, n0, A, 0, 0), A01(n0, n1, A, 0, n0),
+        A10(n1, n0, A, n0, 0), A11(n1, n1, A, n0, n0);
+      ch_[0].dense_rec(A00);
+      ch_[1].dense_rec(A11);
+      A01_->dense(A01);
+      A10_->dense(A10);
+    }
+
+    template<typename scalar_t> void
+    HODLRMatrixNative<scalar_t>::extract
+    (const std::vector<std::size_t>& I, const std::vector<std::size_t>& J,
+     DenseM_t& B) const {
+      assert(B.rows() == I.size() && B.cols() == J.size());
+      std::vector<std::size_t> pI(I.size()), pJ(J.size());
+      std::iota(pI.begin(), pI.end(), 0);
+      std::iota(pJ.begin(), pJ.end(), 0);
+      extract_rec(I, pI, J, pJ, B);
+    }
+
+    template<typename scalar_t> void
+    HODLRMatrixNative<scalar_t>::extract_rec
+    (const std::vector<std::size_t>& I, const std::vector<std::size_t>& pI,
+     const std::vector<std::size_t>& J, const std::vector<std::size_t>& pJ,
+     DenseM_t& B) const {
+      if (I.empty() || J.empty()) return;
+      if (leaf()) {
+        for (std::size_t j=0; j<J.size(); j++)
+          for (std::size_t i=0; i<I.size(); i++)
+            B(pI[i], pJ[j]) = D_(I[i], J[j]);
+        return;
+      }
+      // split the indices (and their positions in B) over the
+      // children, indices in the second child are shifted
+      const std::size_t n0 = ch_[0].rows();
+      auto split = [&n0](const std::vector<std::size_t>& K,
+                         const std::vector<std::size_t>& pK,
+                         std::vector<std::size_t> (&Ks)[2],
+                         std::vector<std::size_t> (&pKs)[2]) {
+        for (std::size_t k=0; k<K.size(); k++) {
+          int c = K[k] >= n0;
+          Ks[c].push_back(K[k] - c * n0);
+          pKs[c].push_back(pK[k]);
+        }
+      };
+      std::vector<std::size_t> Is[2], pIs[2], Js[2], pJs[2];
+      split(I, pI, Is, pIs);
+      split(J, pJ, Js, pJs);
+      ch_[0].extract_rec(Is[0], pIs[0], Js[0], pJs[0], B);
+      ch_[1].extract_rec(Is[1], pIs[1], Js[1], pJs[1], B);
+      auto extract_lr = [&](const LRTile_t& T, int r, int c) {
+        if (Is[r].empty() || Js[c].empty()) return;
+        DenseM_t Br(Is[r].size(), Js[c].size());
+        gemm(Trans::N, Trans::N, scalar_t(1.), T.U().extract_rows(Is[r]),
+             T.V().extract_cols(Js[c]), scalar_t(0.), Br);
+        for (std::size_t j=0; j<Js[c].size(); j++)
+          for (std::size_t i=0; i<Is[r].size(); i++)
+            B(pIs[r][i], pJs[c][j]) = Br(i, j);
+      };
+      extract_lr(*A01_, 0, 1);
+      extract_lr(*A10_, 1, 0);
+    }
+
+    template<typename scalar_t> void
+    HODLRMatrixNative<scalar_t>::mult
+    (Trans op, const DenseM_t& x, DenseM_t& y) const {
+      assert(x.rows() == rows_ && y.rows() == rows_ && x.cols() == y.cols());
+      run_tasks([&]() { mult_rec(op, x, y, 0); });
+    }
+
+    template<typename scalar_t> void
+    HODLRMatrixNative<scalar_t>::mult_rec
+    (Trans op, const DenseM_t& x, DenseM_t& y, int depth) const {
+      if (leaf()) {
+        gemm(op, Trans::N, scalar_t(1.), D_, x, scalar_t(0.), y, depth);
+        return;
+      }
+      std::size_t n0 = ch_[0].rows(), n1 = ch_[1].rows(), nrhs = x.cols();
+      auto x0 = ConstDenseMatrixWrapperPtr(n0, nrhs, x, 0, 0);
+      auto x1 = ConstDenseMatrixWrapperPtr(n1, nrhs, x, n0, 0);
+      DenseMW_t y0(n0, nrhs, y, 0, 0), y1(n1, nrhs, y, n0, 0);
+      if (depth < params::task_recursion_cutoff_level) {
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        ch_[0].mult_rec(op, *x0, y0, depth+1);
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        ch_[1].mult_rec(op, *x1, y1, depth+1);
+#pragma omp taskwait
+      } else {
+        ch_[0].mult_rec(op, *x0, y0, depth);
+        ch_[1].mult_rec(op, *x1, y1, depth);
+      }
+      // op(A) = [op(A00) op(A10); op(A01) op(A11)] when transposed
+      const auto& B01 = (op == Trans::N) ? *A01_ : *A10_;
+      const auto& B10 = (op == Trans::N) ? *A10_ : *A01_;
+      B01.gemm_a(op, Trans::N, scalar_t(1.), *x1, scalar_t(1.), y0, depth);
+      B10.gemm_a(op, Trans::N, scalar_t(1.), *x0, scalar_t(1.), y1, depth);
+    }
+
+    template<typename scalar_t> void
+    HODLRMatrixNative<scalar_t>::mult_offdiag_rec
+    (Trans op, scalar_t alpha, const DenseM_t& x, DenseM_t& y,
+     int lvls, int depth) const {
+      if (leaf() || lvls <= 0) return;
+      std::size_t n0 = ch_[0].rows(), n1 = ch_[1].rows(), nrhs = x.cols();
+      auto x0 = ConstDenseMatrixWrapperPtr(n0, nrhs, x, 0, 0);
+      auto x1 = ConstDenseMatrixWrapperPtr(n1, nrhs, x, n0, 0);
+      DenseMW_t y0(n0, nrhs, y, 0, 0), y1(n1, nrhs, y, n0, 0);
+      if (depth < params::task_recursion_cutoff_level) {
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        ch_[0].mult_offdiag_rec(op, alpha, *x0, y0, lvls-1, depth+1);
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        ch_[1].mult_offdiag_rec(op, alpha, *x1, y1, lvls-1, depth+1);
+#pragma omp taskwait
+      } else {
+        ch_[0].mult_offdiag_rec(op, alpha, *x0, y0, lvls-1, depth);
+        ch_[1].mult_offdiag_rec(op, alpha, *x1, y1, lvls-1, depth);
+      }
+      const auto& B01 = (op == Trans::N) ? *A01_ : *A10_;
+      const auto& B10 = (op == Trans::N) ? *A10_ : *A01_;
+      B01.gemm_a(op, Trans::N, alpha, *x1, scalar_t(1.), y0, depth);
+      B10.gemm_a(op, Trans::N, alpha, *x0, scalar_t(1.), y1, depth);
+    }
+
+    template<typename scalar_t> void
+    HODLRMatrixNative<scalar_t>::factor() {
+      run_tasks([&]() { factor_rec(0); });
+    }
+
+    template<typename scalar_t> void
+    HODLRMatrixNative<scalar_t>::factor_rec(int depth) {
+      factored_ = true;
+      if (leaf()) {
+        if (rows_) {
+          LU_ = D_;
+          LU_.LU(piv_, depth);
+          STRUMPACK_FULL_RANK_FLOPS(LU_flops(LU_));
+        }
+        return;
+      }
+      auto factor_child = [&](int c, DenseM_t& Z, const LRTile_t& A, int d) {
+        ch_[c].factor_rec(d);
+        Z = A.U();
+        ch_[c].solve_rec(Z, d);
+      };
+      if (depth < params::task_recursion_cutoff_level) {
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        factor_child(0, Z0_, *A01_, depth+1);
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        factor_child(1, Z1_, *A10_, depth+1);
+#pragma omp taskwait
+      } else {
+        factor_child(0, Z0_, *A01_, depth);
+        factor_child(1, Z1_, *A10_, depth);
+      }
+      std::size_t r0 = A01_->rank(), r1 = A10_->rank();
+      K_ = DenseM_t(r0+r1, r0+r1);
+      K_.eye();
+      if (r0 + r1) {
+        DenseMW_t K01(r0, r1, K_, 0, r0), K10(r1, r0, K_, r0, 0);
+        gemm(Trans::N, Trans::N, scalar_t(1.), A01_->V(), Z1_,
+             scalar_t(0.), K01, depth);
+        gemm(Trans::N, Trans::N, scalar_t(1.), A10_->V(), Z0_,
+             scalar_t(0.), K10, depth);
+        K_.LU(Kpiv_, depth);
+        STRUMPACK_FULL_RANK_FLOPS
+          (gemm_flops(Trans::N, Trans::N, scalar_t(1.), A01_->V(), Z1_,
+                      scalar_t(0.)) +
+           gemm_flops(Trans::N, Trans::N, scalar_t(1.), A10_->V(), Z0_,
+                      scalar_t(0.)) + LU_flops(K_));
+      }
+    }
+
+    template<typename scalar_t> void
+    HODLRMatrixNative<scalar_t>::solve(DenseM_t& b) const {
+      assert(factored_ && b.rows() == rows_);
+      run_tasks([&]() { solve_rec(b, 0); });
+    }
+
+    template<typename scalar_t> void
+    HODLRMatrixNative<scalar_t>::solve_rec(DenseM_t& b, int depth) const {
+      if (leaf()) {
+        if (rows_) LU_.solve_LU_in_place(b, piv_, depth);
+        return;
+      }
+      std::size_t n0 = ch_[0].rows(), n1 = ch_[1].rows(), nrhs = b.cols();
+      DenseMW_t b0(n0, nrhs, b, 0, 0), b1(n1, nrhs, b, n0, 0);
+      // y = D^{-1} b
+      if (depth < params::task_recursion_cutoff_level) {
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        ch_[0].solve_rec(b0, depth+1);
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        ch_[1].solve_rec(b1, depth+1);
+#pragma omp taskwait
+      } else {
+        ch_[0].solve_rec(b0, depth);
+        ch_[1].solve_rec(b1, depth);
+      }
+      // x = y - Z K^{-1} V y
+      std::size_t r0 = A01_->rank(), r1 = A10_->rank();
+      if (r0 + r1 == 0) return;
+      DenseM_t w(r0+r1, nrhs);
+      DenseMW_t w0(r0, nrhs, w, 0, 0), w1(r1, nrhs, w, r0, 0);
+      gemm(Trans::N, Trans::N, scalar_t(1.), A01_->V(), b1,
+           scalar_t(0.), w0, depth);
+      gemm(Trans::N, Trans::N, scalar_t(1.), A10_->V(), b0,
+           scalar_t(0.), w1, depth);
+      K_.solve_LU_in_place(w, Kpiv_, depth);
+      gemm(Trans::N, Trans::N, scalar_t(-1.), Z0_, w0,
+           scalar_t(1.), b0, depth);
+      gemm(Trans::N, Trans::N, scalar_t(-1.), Z1_, w1,
+           scalar_t(1.), b1, depth);
+    }
+
+    template<typename scalar_t> void
+    HODLRMatrixNative<scalar_t>::shift(scalar_t s) {
+      if (leaf()) {
+        for (std::size_t i=0; i<rows_; i++)
+          D_(i, i) += s;
+        return;
+      }
+      for (auto& c : ch_) c.shift(s);
+    }
+
+    // explicit template instantiations
+    template class HODLRMatrixNative<float>;
+    template class HODLRMatrixNative<double>;
+    template class HODLRMatrixNative<std::complex<float>>;
+    template class HODLRMatrixNative<std::complex<double>>;
+
+  } // end namespace HODLR
+} // end namespace strumpack
@@ -0,0 +1,253 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/**
+ * \file HODLRMatrixNative.hpp
+ * \brief Shared memory HODLR matrix, not depending on ButterflyPACK.
+ */
+#ifndef STRUMPACK_HODLR_MATRIX_NATIVE_HPP
+#define STRUMPACK_HODLR_MATRIX_NATIVE_HPP
+
+#include <memory>
+#include <functional>
+
+#include "HODLROptions.hpp"
+#include "BLR/LRTile.hpp"
+#include "structured/ClusterTree.hpp"
+#include "structured/StructuredMatrix.hpp"
+
+namespace strumpack {
+  namespace HODLR {
+
+    /**
+     * \class HODLRMatrixNative
+     *
+     * \brief Hierarchically off-diagonal low-rank matrix, shared
+     * memory implementation.
+     *
+     * Unlike HODLRMatrix, this does not require MPI or
+     * ButterflyPACK. The matrix is partitioned recursively according
+     * to a structured::ClusterTree. The diagonal blocks of the leafs
+     * are stored as dense matrices, the two off-diagonal blocks of
+     * every non-leaf node as a low-rank BLR::LRTile. These are
+     * compressed with RRQR when constructed from a dense matrix,
+     * with (blocked) adaptive cross approximation when constructed
+     * from an element extraction routine, or with randomized
+     * peeling when constructed from a matrix-vector product.
+     *
+     * The factorization applies the Sherman-Morrison-Woodbury formula
+     * recursively: with D = diag(A0, A1) and the off-diagonal blocks
+     * written as U*V, A^{-1} = D^{-1} - Z (I + V Z)^{-1} V D^{-1},
+     * where Z = D^{-1} U. Construction, factorization, solve and
+     * multiplication are parallelized with OpenMP tasks over the
+     * cluster tree.
+     *
+     * Only square matrices with the same row and column partitioning
+     * are supported. Butterfly compression (HODBF) is not supported.
+     *
+     * \tparam scalar_t Can be float, double, std:complex<float> or
+     * std::complex<double>.
+     *
+     * \see HODLRMatrix, structured::StructuredMatrix
+     */
+    template<typename scalar_t> class HODLRMatrixNative
+      : public structured::StructuredMatrix<scalar_t> {
+      using DenseM_t = DenseMatrix<scalar_t>;
+      using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+      using LRTile_t = BLR::LRTile<scalar_t>;
+      using BLROpts_t = BLR::BLROptions<scalar_t>;
+      using Opts_t = HODLROptions<scalar_t>;
+      using extract_t = std::function
+        <void(const std::vector<std::size_t>&,
+              const std::vector<std::size_t>&, DenseM_t&)>;
+      using mult_t = std::function
+        <void(Trans, const DenseM_t&, DenseM_t&)>;
+
+    public:
+      /**
+       * Construct an empty (0 x 0) HODLR matrix.
+       */
+      HODLRMatrixNative() = default;
+
+      /**
+       * Construct an HODLR approximation of a dense matrix. The
+       * dense matrix is not modified.
+       *
+       * \param tree cluster tree, tree.size == A.rows() == A.cols()
+       * \param A dense matrix to compress
+       * \param opts options, the relative/absolute tolerance and
+       * maximum rank are used for the off-diagonal blocks
+       */
+      HODLRMatrixNative(const structured::ClusterTree& tree,
+                        const DenseM_t& A, const Opts_t& opts);
+
+      /**
+       * Construct an HODLR approximation of a matrix defined by an
+       * element extraction routine. The off-diagonal blocks are
+       * compressed using blocked adaptive cross approximation,
+       * extracting opts.BACA_block_size() rows/columns at a time.
+       *
+       * \param tree cluster tree, defines the size of the matrix
+       * \param Aelem routine to extract a submatrix A(I,J)
+       * \param opts options
+       */
+      HODLRMatrixNative(const structured::ClusterTree& tree,
+                        const extract_t& Aelem, const Opts_t& opts);
+
+      /**
+       * Construct an HODLR approximation of a matrix which is only
+       * available through products with (blocks of) vectors, using
+       * randomized peeling. The levels of the tree are compressed top
+       * down. For a given level, the random sketch is zero on one of
+       * the two children of every node, so that, after subtracting
+       * the product with the levels already compressed, the sample
+       * only contains the off-diagonal blocks of that level. All
+       * nodes on a level are sampled together, with a single call to
+       * Amult. The number of samples starts at opts.rank_guess() on
+       * the top level, and at the largest rank of the previous level
+       * on the other levels, and grows by a factor opts.rank_rate()
+       * until it exceeds the numerical rank of all off-diagonal
+       * blocks on the level. Finally, the dense diagonal blocks are
+       * sampled with a block identity matrix. The total number of
+       * products is roughly 4 times the rank for each level, plus
+       * the largest leaf size, instead of the matrix size for dense
+       * extraction.
+       *
+       * \param tree cluster tree, defines the size of the matrix
+       * \param Amult routine to compute S = op(A) R, with op N or C
+       * \param opts options
+       */
+      HODLRMatrixNative(const structured::ClusterTree& tree,
+                        const mult_t& Amult, const Opts_t& opts);
+
+      std::size_t rows() const override { return rows_; }
+      std::size_t cols() const override { return rows_; }
+
+      std::size_t memory() const override;
+      std::size_t nonzeros() const override;
+      /**
+       * Maximum rank of all off-diagonal blocks.
+       */
+      std::size_t rank() const override;
+
+      /**
+       * Number of levels in the hierarchy, 1 for a single dense
+       * leaf.
+       */
+      std::size_t levels() const;
+
+      /**
+       * Check whether this is a leaf, ie, a single dense block.
+       */
+      bool leaf() const { return ch_.empty(); }
+
+      /**
+       * Is the matrix factored, ie, has factor() been called?
+       */
+      bool factored() const { return factored_; }
+
+      /**
+       * Return a dense representation of this matrix.
+       */
+      DenseM_t dense() const;
+
+      /**
+       * Extract the submatrix B = A(I,J) from the compressed
+       * representation.
+       */
+      void extract(const std::vector<std::size_t>& I,
+                   const std::vector<std::size_t>& J, DenseM_t& B) const;
+
+      /**
+       * Multiply with a dense matrix, y = op(A) x.
+       */
+      void mult(Trans op, const DenseM_t& x, DenseM_t& y) const override;
+
+      /**
+       * Compute an LU factorization of the dense diagonal blocks, and
+       * the small Sherman-Morrison-Woodbury systems on every
+       * level. The dense diagonal blocks are kept, so the matrix
+       * can still be multiplied or shifted after factorization.
+       */
+      void factor() override;
+
+      /**
+       * Solve a linear system A x = b, in place. This requires the
+       * matrix to be factored.
+       */
+      void solve(DenseM_t& b) const override;
+
+      /**
+       * Add s to the diagonal. This does not update the factors, if
+       * the matrix was already factored, factor() needs to be
+       * called again.
+       */
+      void shift(scalar_t s) override;
+
+    private:
+      std::size_t rows_ = 0;
+      std::vector<HODLRMatrixNative<scalar_t>> ch_;
+      // dense diagonal block (leaf only), and its LU factors
+      DenseM_t D_, LU_;
+      std::vector<int> piv_;
+      // off-diagonal blocks A01 = U01 V01 and A10 = U10 V10
+      std::unique_ptr<LRTile_t> A01_, A10_;
+      // Z0 = A0^{-1} U01, Z1 = A1^{-1} U10 and the LU factors of
+      // K = I + [0 V01 Z1; V10 Z0 0]
+      DenseM_t Z0_, Z1_, K_;
+      std::vector<int> Kpiv_;
+      bool factored_ = false;
+
+      HODLRMatrixNative(const structured::ClusterTree& tree,
+                        const DenseM_t& A, const BLROpts_t& opts,
+                        int depth);
+      HODLRMatrixNative(const structured::ClusterTree& tree,
+                        const extract_t& Aelem, std::size_t r0,
+                        const BLROpts_t& opts, int depth);
+
+      void skeleton(const structured::ClusterTree& tree);
+      void dense_rec(DenseM_t& A) const;
+      void extract_rec(const std::vector<std::size_t>& I,
+                       const std::vector<std::size_t>& pI,
+                       const std::vector<std::size_t>& J,
+                       const std::vector<std::size_t>& pJ,
+                       DenseM_t& B) const;
+      void mult_rec(Trans op, const DenseM_t& x, DenseM_t& y,
+                    int depth) const;
+      void mult_offdiag_rec(Trans op, scalar_t alpha, const DenseM_t& x,
+                            DenseM_t& y, int lvls, int depth) const;
+      void factor_rec(int depth);
+      void solve_rec(DenseM_t& b, int depth) const;
+
+      static BLROpts_t BLR_options(const Opts_t& opts);
+    };
+
+  } // end namespace HODLR
+} // end namespace strumpack
+
+#endif // STRUMPACK_HODLR_MATRIX_NATIVE_HPP
@@ -30,8 +30,10 @@
 #define HSS_BASIS_ID_HPP
 
 #include <cassert>
+#include <memory>
 
 #include "dense/DenseMatrix.hpp"
+#include "dense/ReducedPrecisionMatrix.hpp"
 
 namespace strumpack {
   namespace HSS {
@@ -39,31 +41,80 @@ namespace strumpack {
     /**
      * The basis is represented as P [I; E],
      * where P is a permutation, I is the identity matrix.
+     * After factorization, E can be stored in reduced precision,
+     * see reduce_precision.
      */
     template<typename scalar_t> class HSSBasisID {
     private:
       // _P uses 1-based numbering!
       std::vector<int> _P; // TODO create a permutation class?
       DenseMatrix<scalar_t> _E;
+      // E in reduced precision, read-only, so it can be shared by
+      // copies of this basis
+      std::shared_ptr<const ReducedPrecisionMatrix<scalar_t>> _Er;
 
     public:
       HSSBasisID() {}
       HSSBasisID(std::size_t r);
-      inline std::size_t rows() const { return _E.cols()+_E.rows(); }
-      inline std::size_t cols() const { return _E.cols(); }
-      inline const DenseMatrix<scalar_t>& E() const { return _E; }
+      inline std::size_t rows() const {
+        return _Er ? _Er->cols()+_Er->rows() : _E.cols()+_E.rows();
+      }
+      inline std::size_t cols() const {
+        return _Er ? _Er->cols() : _E.cols();
+      }
+      inline const DenseMatrix<scalar_t>& E() const {
+        assert(!_Er); return _E;
+      }
       inline const std::vector<int>& P() const { return _P; }
-      inline DenseMatrix<scalar_t>& E() { return _E; }
+      inline DenseMatrix<scalar_t>& E() { assert(!_Er); return _E; }
       inline std::vector<int>& P() { return _P; }
 
+      /**
+       * Precision used to store E.
+       */
+      StoragePrecision precision() const {
+        return _Er ? _Er->precision() : StoragePrecision::FULL;
+      }
+
+      /**
+       * Store E in (lower) precision p. After this, E() can no
+       * longer be used, but apply, applyC and apply_E still work,
+       * with all arithmetic in scalar_t.
+       */
+      void reduce_precision(StoragePrecision p);
+
+      /**
+       * Compute y = alpha op(E) x + beta y, with E stored in full or
+       * reduced precision.
+       */
+      void apply_E(Trans op, scalar_t alpha, const DenseMatrix<scalar_t>& x,
+                   scalar_t beta, DenseMatrix<scalar_t>& y,
+                   int depth=0) const;
+
       void clear();
       void print() const { print("basis"); }
       void print(std::string name) const;
       inline void check() const;
 
       DenseMatrix<scalar_t> dense() const;
-      std::size_t memory() const { return E().memory()+sizeof(int)*P().size(); }
-      std::size_t nonzeros() const { return E().nonzeros()+P().size(); }
+      /**
+       * Return a copy of E, decoded to scalar_t if it is stored in
+       * reduced precision.
+       */
+      DenseMatrix<scalar_t> E_dense() const {
+        return _Er ? _Er->dense() : _E;
+      }
+      std::size_t memory() const {
+        return (_Er ? _Er->memory() : _E.memory()) + sizeof(int)*P().size();
+      }
+      /**
+       * When E is stored in reduced precision, this counts the
+       * number of scalar_t elements that fit in the memory used by E.
+       */
+      std::size_t nonzeros() const {
+        return (_Er ? _Er->memory() / sizeof(scalar_t) : _E.nonzeros())
+          + P().size();
+      }
 
       DenseMatrix<scalar_t> apply
       (const DenseMatrix<scalar_t>& b, int depth=0) const;
@@ -96,7 +147,8 @@ namespace strumpack {
         os.write((const char*)&Psize, sizeof(std::size_t));
         os.write((const char*)(B._P.data()),
                  sizeof(typename decltype(B._P)::value_type)*Psize);
-        os << B._E;
+        if (B._Er) os << B._Er->dense();
+        else os << B._E;
         return os;
       }
       friend std::ifstream& operator>>
@@ -124,6 +176,22 @@ namespace strumpack {
     HSSBasisID<scalar_t>::clear() {
       _P.clear();
       _E.clear();
+      _Er.reset();
+    }
+
+    template<typename scalar_t> void
+    HSSBasisID<scalar_t>::reduce_precision(StoragePrecision p) {
+      if (p == StoragePrecision::FULL || _Er || !_E.rows() || !_E.cols())
+        return;
+      _Er = std::make_shared<const ReducedPrecisionMatrix<scalar_t>>(_E, p);
+      _E = DenseMatrix<scalar_t>();
+    }
+
+    template<typename scalar_t> void HSSBasisID<scalar_t>::apply_E
+    (Trans op, scalar_t alpha, const DenseMatrix<scalar_t>& x,
+     scalar_t beta, DenseMatrix<scalar_t>& y, int depth) const {
+      if (_Er) _Er->gemm(op, alpha, x, beta, y);
+      else gemm(op, Trans::N, alpha, _E, x, beta, y, depth);
     }
 
     template<typename scalar_t> void
@@ -132,7 +200,8 @@ namespace strumpack {
                 << rows() << "x" << cols() << std::endl << "\tP = [";
       for (auto Pi : P()) std::cout << Pi << " ";
       std::cout << "]" << std::endl;
-      _E.print("\tE");
+      if (_Er) _Er->dense().print("\tE");
+      else _E.print("\tE");
       std::cout << "}" << std::endl;
     }
 
@@ -147,7 +216,8 @@ namespace strumpack {
     HSSBasisID<scalar_t>::dense() const {
       DenseMatrix<scalar_t> ret(rows(), cols());
       ret.eye();
-      copy(E(), ret, cols(), 0);
+      if (_Er) copy(_Er->dense(), ret, cols(), 0);
+      else copy(_E, ret, cols(), 0);
       ret.laswp(P(), false);
       return ret;
     }
@@ -161,9 +231,10 @@ namespace strumpack {
         return DenseMatrix<scalar_t>(rows(), b.cols());
       DenseMatrix<scalar_t> c(rows(), b.cols());
       copy(cols(), b.cols(), b, 0, 0, c, 0, 0);
-      if (E().rows())
-        gemm(Trans::N, Trans::N, scalar_t(1), E(), b,
-             scalar_t(0.), c.ptr(cols(), 0), c.ld());
+      if (rows() > cols()) {
+        DenseMatrixWrapper<scalar_t> c1(rows()-cols(), b.cols(), c, cols(), 0);
+        apply_E(Trans::N, scalar_t(1), b, scalar_t(0.), c1, depth);
+      }
       c.laswp(P(), false);
       return c;
     }
@@ -179,9 +250,10 @@ namespace strumpack {
     (const DenseMatrix<scalar_t>& b, DenseMatrix<scalar_t>& c,
      int depth) const {
       copy(cols(), b.cols(), b, 0, 0, c, 0, 0);
-      if (E().rows())
-        gemm(Trans::N, Trans::N, scalar_t(1), E(), b,
-             scalar_t(0.), c.ptr(cols(), 0), c.ld());
+      if (rows() > cols()) {
+        DenseMatrixWrapper<scalar_t> c1(rows()-cols(), b.cols(), c, cols(), 0);
+        apply_E(Trans::N, scalar_t(1), b, scalar_t(0.), c1, depth);
+      }
       c.laswp(P(), false);
     }
 
@@ -192,13 +264,13 @@ namespace strumpack {
       check();
       assert(rows() == b.rows());
       if (!cols() || !b.cols())
-        return DenseMatrix<scalar_t>(E().cols(), b.cols());
+        return DenseMatrix<scalar_t>(cols(), b.cols());
       DenseMatrix<scalar_t> PtB(b);
       PtB.laswp(P(), true);
-      if (!E().rows()) return PtB;
+      if (rows() == cols()) return PtB;
       DenseMatrix<scalar_t> c(cols(), b.cols(), PtB.ptr(0, 0), PtB.ld());
-      gemm(Trans::C, Trans::N, scalar_t(1.),
-           E(), PtB.ptr(cols(), 0), PtB.ld(), scalar_t(1.), c, depth);
+      DenseMatrixWrapper<scalar_t> PtB1(rows()-cols(), b.cols(), PtB, cols(), 0);
+      apply_E(Trans::C, scalar_t(1.), PtB1, scalar_t(1.), c, depth);
       return c;
     }
 
@@ -232,13 +304,13 @@ namespace strumpack {
     template<typename scalar_t> long long int
     HSSBasisID<scalar_t>::apply_flops(std::size_t nrhs) const {
       return blas::gemm_flops
-        (_E.rows(), nrhs, _E.cols(), scalar_t(1.), scalar_t(0.));
+        (rows()-cols(), nrhs, cols(), scalar_t(1.), scalar_t(0.));
     }
 
     template<typename scalar_t> long long int
     HSSBasisID<scalar_t>::applyC_flops(std::size_t nrhs) const {
       return blas::gemm_flops
-        (_E.cols(), nrhs, _E.rows(), scalar_t(1.), scalar_t(1.));
+        (cols(), nrhs, rows()-cols(), scalar_t(1.), scalar_t(1.));
     }
 
   } // end namespace HSS
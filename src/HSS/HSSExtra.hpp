@@ -210,6 +210,7 @@ namespace strumpack {
       std::vector<int> piv_;      // hold permutation from LU(D) at root
       template<typename T> friend class HSSMatrix;
       template<typename T> friend class HSSMatrixBase;
+      template<typename T> friend class HSSMatrixFrozen;
     };
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -226,6 +227,75 @@ namespace strumpack {
     };
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
+    template<typename scalar_t> class HSSMatrix;
+
+    /**
+     * \class WorkSolveLevels
+     * \brief Reusable workspace for the level-wise ULV solve.
+     *
+     * Stores the nodes of a factored HSSMatrix grouped by their
+     * height in the tree (all nodes with the same height are
+     * independent during the forward and backward sweeps), the
+     * offsets of the per-node intermediate vectors, and a single
+     * contiguous buffer holding those vectors. The layout is
+     * computed on first use with a given HSSMatrix and number of
+     * right-hand sides; subsequent solves with the same factorization
+     * and at most that many right-hand sides do not allocate. The
+     * layout is recomputed automatically when the matrix is
+     * refactored, see HSSMatrix::factor_id().
+     *
+     * A WorkSolveLevels object should not be shared between
+     * concurrent solves.
+     *
+     * \see HSSMatrix::solve(DenseM_t&, WorkSolveLevels<scalar_t>&)
+     */
+    template<typename scalar_t> class WorkSolveLevels {
+    public:
+      /**
+       * Release all memory and forget the layout.
+       */
+      void clear() {
+        nodes_.clear();
+        lvl_ptr_.clear();
+        buf_.clear();
+        buf_.shrink_to_fit();
+        H_ = nullptr;
+        factor_id_ = 0;
+        rows_ = 0;
+      }
+
+      /**
+       * Memory, in bytes, used by this workspace.
+       */
+      std::size_t memory() const {
+        return sizeof(*this) + nodes_.capacity() * sizeof(Node)
+          + lvl_ptr_.capacity() * sizeof(std::size_t)
+          + buf_.capacity() * sizeof(scalar_t);
+      }
+
+    private:
+      struct Node {
+        const HSSMatrix<scalar_t>* H;
+        int parent, c0, c1;
+        // row offsets (per right-hand side) in buf_ of f (fr rows),
+        // [z0; z1] from the children (zr rows) and x (xr rows)
+        std::size_t f, fr, zz, zr, x, xr;
+        // row offsets in the f and zz vectors of the parent, and the
+        // offset in the right-hand side (leaves only)
+        std::size_t pf, pz, b;
+      };
+      // nodes sorted by increasing height, nodes of height h are
+      // nodes_[lvl_ptr_[h]], ..., nodes_[lvl_ptr_[h+1]-1]
+      std::vector<Node> nodes_;
+      std::vector<std::size_t> lvl_ptr_;
+      std::vector<scalar_t> buf_;
+      const HSSMatrix<scalar_t>* H_ = nullptr;
+      // HSSMatrix::factor_id() of H_ when the layout was computed
+      std::size_t factor_id_ = 0;
+      std::size_t rows_ = 0;
+      template<typename T> friend class HSSMatrix;
+    };
+
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
     template<typename scalar_t> class AFunctor {
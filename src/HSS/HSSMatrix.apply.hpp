@@ -101,26 +101,26 @@ namespace strumpack {
         w.c[0].tmp2 = DenseM_t(child(0)->U_rank(), b.cols());
         w.c[1].tmp2 = DenseM_t(child(1)->U_rank(), b.cols());
         if (isroot || !U_.cols()) { // TODO these can be done in parallel
-          gemm(Trans::N, Trans::N, scalar_t(1.), B01_, w.c[1].tmp1,
-               scalar_t(0.), w.c[0].tmp2, depth);
-          gemm(Trans::N, Trans::N, scalar_t(1.), B10_, w.c[0].tmp1,
-               scalar_t(0.), w.c[1].tmp2, depth);
+          apply_B01(Trans::N, scalar_t(1.), w.c[1].tmp1,
+                    scalar_t(0.), w.c[0].tmp2, depth);
+          apply_B10(Trans::N, scalar_t(1.), w.c[0].tmp1,
+                    scalar_t(0.), w.c[1].tmp2, depth);
           flops +=
-            gemm_flops(Trans::N, Trans::N, scalar_t(1.), B01_, w.c[1].tmp1, scalar_t(0.)) +
-            gemm_flops(Trans::N, Trans::N, scalar_t(1.), B10_, w.c[0].tmp1, scalar_t(0.));
+            blas::gemm_flops(w.c[0].tmp2.rows(), b.cols(), w.c[1].tmp1.rows(), scalar_t(1.), scalar_t(0.)) +
+            blas::gemm_flops(w.c[1].tmp2.rows(), b.cols(), w.c[0].tmp1.rows(), scalar_t(1.), scalar_t(0.));
         } else {
           auto tmp = U_.apply(w.tmp2, depth);
           copy(child(0)->U_rank(), b.cols(), tmp,
                0, 0, w.c[0].tmp2, 0, 0);
           copy(child(1)->U_rank(), b.cols(), tmp,
                child(0)->U_rank(), 0, w.c[1].tmp2, 0, 0);
-          gemm(Trans::N, Trans::N, scalar_t(1.), B01_, w.c[1].tmp1,
-               scalar_t(1.), w.c[0].tmp2, depth);
-          gemm(Trans::N, Trans::N, scalar_t(1.), B10_, w.c[0].tmp1,
-               scalar_t(1.), w.c[1].tmp2, depth);
+          apply_B01(Trans::N, scalar_t(1.), w.c[1].tmp1,
+                    scalar_t(1.), w.c[0].tmp2, depth);
+          apply_B10(Trans::N, scalar_t(1.), w.c[0].tmp1,
+                    scalar_t(1.), w.c[1].tmp2, depth);
           flops +=
-            gemm_flops(Trans::N, Trans::N, scalar_t(1.), B01_, w.c[1].tmp1, scalar_t(1.)) +
-            gemm_flops(Trans::N, Trans::N, scalar_t(1.), B10_, w.c[0].tmp1, scalar_t(1.));
+            blas::gemm_flops(w.c[0].tmp2.rows(), b.cols(), w.c[1].tmp1.rows(), scalar_t(1.), scalar_t(1.)) +
+            blas::gemm_flops(w.c[1].tmp2.rows(), b.cols(), w.c[0].tmp1.rows(), scalar_t(1.), scalar_t(1.));
         }
         // TODO clear tmp1, tmp2??
 #pragma omp task default(shared)                                        \
@@ -187,25 +187,25 @@ namespace strumpack {
         w.c[0].tmp2 = DenseM_t(child(0)->V_rank(), b.cols());
         w.c[1].tmp2 = DenseM_t(child(1)->V_rank(), b.cols());
         if (isroot || !V_.cols()) {
-          gemm(Trans::C, Trans::N, scalar_t(1.), B10_, w.c[1].tmp1,
-               scalar_t(0.), w.c[0].tmp2, depth);
-          gemm(Trans::C, Trans::N, scalar_t(1.), B01_, w.c[0].tmp1,
-               scalar_t(0.), w.c[1].tmp2, depth);
+          apply_B10(Trans::C, scalar_t(1.), w.c[1].tmp1,
+                    scalar_t(0.), w.c[0].tmp2, depth);
+          apply_B01(Trans::C, scalar_t(1.), w.c[0].tmp1,
+                    scalar_t(0.), w.c[1].tmp2, depth);
           flops +=
-            gemm_flops(Trans::C, Trans::N, scalar_t(1.), B10_, w.c[1].tmp1, scalar_t(0.)) +
-            gemm_flops(Trans::C, Trans::N, scalar_t(1.), B01_, w.c[0].tmp1, scalar_t(0.));
+            blas::gemm_flops(w.c[0].tmp2.rows(), b.cols(), w.c[1].tmp1.rows(), scalar_t(1.), scalar_t(0.)) +
+            blas::gemm_flops(w.c[1].tmp2.rows(), b.cols(), w.c[0].tmp1.rows(), scalar_t(1.), scalar_t(0.));
         } else {
           auto tmp = V_.apply(w.tmp2, depth);
           copy(child(0)->V_rank(), b.cols(), tmp, 0, 0, w.c[0].tmp2, 0, 0);
           copy(child(1)->V_rank(), b.cols(), tmp,
                child(0)->V_rank(), 0, w.c[1].tmp2, 0, 0);
-          gemm(Trans::C, Trans::N, scalar_t(1.), B10_, w.c[1].tmp1,
-               scalar_t(1.), w.c[0].tmp2, depth);
-          gemm(Trans::C, Trans::N, scalar_t(1.), B01_, w.c[0].tmp1,
-               scalar_t(1.), w.c[1].tmp2, depth);
+          apply_B10(Trans::C, scalar_t(1.), w.c[1].tmp1,
+                    scalar_t(1.), w.c[0].tmp2, depth);
+          apply_B01(Trans::C, scalar_t(1.), w.c[0].tmp1,
+                    scalar_t(1.), w.c[1].tmp2, depth);
           flops +=
-            gemm_flops(Trans::C, Trans::N, scalar_t(1.), B10_, w.c[1].tmp1, scalar_t(1.)) +
-            gemm_flops(Trans::C, Trans::N, scalar_t(1.), B01_, w.c[0].tmp1, scalar_t(1.));
+            blas::gemm_flops(w.c[0].tmp2.rows(), b.cols(), w.c[1].tmp1.rows(), scalar_t(1.), scalar_t(1.)) +
+            blas::gemm_flops(w.c[1].tmp2.rows(), b.cols(), w.c[0].tmp1.rows(), scalar_t(1.), scalar_t(1.));
         }
 #pragma omp task default(shared)                                        \
   if(depth < params::task_recursion_cutoff_level)                       \
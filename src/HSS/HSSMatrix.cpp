@@ -119,6 +119,9 @@ namespace strumpack {
       D_ = other.D_;
       B01_ = other.B01_;
       B10_ = other.B10_;
+      B01r_ = other.B01r_;
+      B10r_ = other.B10r_;
+      factor_id_ = other.factor_id_;
     }
 
     template<typename scalar_t> HSSMatrix<scalar_t>&
@@ -129,6 +132,9 @@ namespace strumpack {
       D_ = other.D_;
       B01_ = other.B01_;
       B10_ = other.B10_;
+      B01r_ = other.B01r_;
+      B10r_ = other.B10r_;
+      factor_id_ = other.factor_id_;
       return *this;
     }
 
@@ -152,6 +158,8 @@ namespace strumpack {
     HSSMatrix<scalar_t>::delete_trailing_block() {
       B01_.clear();
       B10_.clear();
+      B01r_.reset();
+      B10r_.reset();
       HSSMatrixBase<scalar_t>::delete_trailing_block();
     }
 
@@ -191,6 +199,8 @@ namespace strumpack {
       D_.clear();
       B01_.clear();
       B10_.clear();
+      B01r_.reset();
+      B10r_.reset();
       HSSMatrixBase<scalar_t>::reset();
     }
 
@@ -309,6 +319,8 @@ namespace strumpack {
       if (!this->active()) return 0;
       std::size_t mem = sizeof(*this) + U_.memory() + V_.memory()
         + D_.memory() + B01_.memory() + B10_.memory();
+      if (B01r_) mem += B01r_->memory();
+      if (B10r_) mem += B10r_->memory();
       for (auto& c : this->ch_) mem += c->memory();
       return mem;
     }
@@ -318,6 +330,8 @@ namespace strumpack {
       if (!this->active()) return 0;
       std::size_t nnz = sizeof(*this) + U_.nonzeros() + V_.nonzeros()
         + D_.nonzeros() + B01_.nonzeros() + B10_.nonzeros();
+      if (B01r_) nnz += B01r_->memory() / sizeof(scalar_t);
+      if (B10r_) nnz += B10r_->memory() / sizeof(scalar_t);
       for (auto& c : this->ch_) nnz += c->nonzeros();
       return nnz;
     }
@@ -355,6 +369,59 @@ namespace strumpack {
       }
     }
 
+    template<typename scalar_t> void HSSMatrix<scalar_t>::reduce_precision
+    (real_t rel_tol, real_t abs_tol, StoragePrecision lowest) {
+      if (lowest == StoragePrecision::FULL) return;
+      reduce_precision_rec(rel_tol, abs_tol, lowest, real_t(-1.));
+    }
+
+    template<typename scalar_t> void HSSMatrix<scalar_t>::reduce_precision_rec
+    (real_t rel_tol, real_t abs_tol, StoragePrecision lowest, real_t Bnrm) {
+      if (!this->active()) return;
+      auto prec = [&](real_t nrm) {
+        return select_storage_precision
+          (nrm, std::max(rel_tol * nrm, abs_tol), lowest);
+      };
+      // the bases of a child only appear in the off-diagonal blocks
+      // of its parent, multiplied with B01 or B10 of the parent
+      if (Bnrm >= 0) {
+        if (U_.rows() > U_.cols() && U_.precision() == StoragePrecision::FULL)
+          U_.reduce_precision(prec(U_.E().normF() * Bnrm));
+        if (V_.rows() > V_.cols() && V_.precision() == StoragePrecision::FULL)
+          V_.reduce_precision(prec(V_.E().normF() * Bnrm));
+      }
+      if (this->leaf()) return;
+      const auto n01 = B01_.normF(), n10 = B10_.normF();
+      for (int c=0; c<2; c++)
+        child(c)->reduce_precision_rec
+          (rel_tol, abs_tol, lowest, std::max(n01, n10));
+      auto reduce = [&](DenseM_t& B, real_t nrm,
+                        std::shared_ptr<const ReducedPrecisionMatrix
+                        <scalar_t>>& Br) {
+        auto p = prec(nrm);
+        if (Br || p == StoragePrecision::FULL || !B.rows() || !B.cols())
+          return;
+        Br = std::make_shared<const ReducedPrecisionMatrix<scalar_t>>(B, p);
+        B = DenseM_t();
+      };
+      reduce(B01_, n01, B01r_);
+      reduce(B10_, n10, B10r_);
+    }
+
+    template<typename scalar_t> void HSSMatrix<scalar_t>::apply_B01
+    (Trans op, scalar_t alpha, const DenseM_t& x, scalar_t beta,
+     DenseM_t& y, int depth) const {
+      if (B01r_) B01r_->gemm(op, alpha, x, beta, y);
+      else gemm(op, Trans::N, alpha, B01_, x, beta, y, depth);
+    }
+
+    template<typename scalar_t> void HSSMatrix<scalar_t>::apply_B10
+    (Trans op, scalar_t alpha, const DenseM_t& x, scalar_t beta,
+     DenseM_t& y, int depth) const {
+      if (B10r_) B10r_->gemm(op, alpha, x, beta, y);
+      else gemm(op, Trans::N, alpha, B10_, x, beta, y, depth);
+    }
+
     template<typename scalar_t> void
     HSSMatrix<scalar_t>::shift(scalar_t sigma) {
       if (!this->active()) return;
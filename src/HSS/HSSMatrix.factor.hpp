@@ -34,6 +34,7 @@ namespace strumpack {
 
     template<typename scalar_t> void
     HSSMatrix<scalar_t>::factor() {
+      factor_id_ = new_factor_id();
       WorkFactor<scalar_t> w;
 #pragma omp parallel if(!omp_in_parallel())
 #pragma omp single nowait
@@ -42,6 +43,7 @@ namespace strumpack {
 
     template<typename scalar_t> void
     HSSMatrix<scalar_t>::partial_factor() {
+      factor_id_ = new_factor_id();
       this->ULV_ = HSSFactors<scalar_t>();
       WorkFactor<scalar_t> w;
       child(0)->factor_recursive
@@ -38,6 +38,7 @@
 #define HSS_MATRIX_HPP
 
 #include <cassert>
+#include <atomic>
 #include <functional>
 #include <string>
 
@@ -342,6 +343,32 @@ namespace strumpack {
        */
       void solve(DenseM_t& b) const override;
 
+      /**
+       * Solve a linear system with the ULV factorization of this
+       * HSSMatrix, reusing the workspace w. The HSS tree is
+       * traversed level by level, all nodes of the same height are
+       * processed concurrently. The layout of the workspace is
+       * computed the first time it is used with this matrix, after
+       * that, repeated solves (with at most as many right-hand sides)
+       * do not allocate any memory.
+       *
+       * \param b on input, the right hand side vector, on output the
+       * solution of A x = b (with A this HSS matrix). The vector b
+       * should be b.rows() == cols().
+       * \param w workspace, see WorkSolveLevels
+       * \see factor, solve
+       */
+      void solve(DenseM_t& b, WorkSolveLevels<scalar_t>& w) const;
+
+      /**
+       * Identifier of the last ULV factorization of this HSSMatrix,
+       * a new (unique) value is assigned by every call to factor()
+       * or partial_factor(), 0 if it was never factored. Used to
+       * detect that a WorkSolveLevels was set up for an older
+       * factorization.
+       */
+      std::size_t factor_id() const { return factor_id_; }
+
       /**
        * Perform only the forward phase of the ULV linear solve. This
        * is for advanced use only, typically to be used in combination
@@ -375,6 +402,29 @@ namespace strumpack {
        */
       void backward_solve(WorkSolve<scalar_t>& w, DenseM_t& x) const override;
 
+      /**
+       * Store the generators of this factored HSS matrix in reduced
+       * precision. For every node, the coupling matrices B01 and
+       * B10, and the E part of the interpolative bases U and V, are
+       * stored in the lowest precision (not lower than lowest) for
+       * which the rounding error stays below max(rel_tol ||G||,
+       * abs_tol), with ||G|| the (Frobenius) norm of the
+       * contribution of that generator to the off-diagonal blocks.
+       * The bases of this (top) node, and the diagonal blocks and
+       * ULV factors are kept in full precision.
+       *
+       * This should only be called after factorization. Afterwards,
+       * the matrix can only be used in the solve routines (solve,
+       * forward_solve, backward_solve).
+       *
+       * \param rel_tol relative tolerance, typically the
+       * compression tolerance
+       * \param abs_tol absolute tolerance
+       * \param lowest lowest allowed precision
+       */
+      void reduce_precision(real_t rel_tol, real_t abs_tol,
+                            StoragePrecision lowest);
+
       /**
        * Multiply this HSS matrix with a dense matrix (vector), ie,
        * compute x = this * b.
@@ -519,6 +569,15 @@ namespace strumpack {
 
       HSSBasisID<scalar_t> U_, V_;
       DenseM_t D_, B01_, B10_;
+      // B01 and B10 in reduced precision, see reduce_precision
+      std::shared_ptr<const ReducedPrecisionMatrix<scalar_t>> B01r_, B10r_;
+      // see factor_id()
+      std::size_t factor_id_ = 0;
+
+      static std::size_t new_factor_id() {
+        static std::atomic<std::size_t> id(0);
+        return ++id;
+      }
 
       void compress_original(const DenseM_t& A,
                              const opts_t& opts);
@@ -630,6 +689,31 @@ namespace strumpack {
       void solve_bwd(DenseM_t& x, WorkSolve<scalar_t>& w,
                      bool isroot, int depth) const override;
 
+      using SolveNode_t = typename WorkSolveLevels<scalar_t>::Node;
+      void solve_levels_setup(WorkSolveLevels<scalar_t>& w,
+                              std::size_t nrhs) const;
+      int solve_levels_layout(std::vector<SolveNode_t>& nodes,
+                              std::vector<int>& height, std::size_t& lrows,
+                              std::size_t boff, bool isroot) const;
+      void solve_levels_fwd(WorkSolveLevels<scalar_t>& w, std::size_t i,
+                            const DenseM_t& b, int depth) const;
+      void solve_levels_W1(WorkSolveLevels<scalar_t>& w, std::size_t i,
+                           DenseM_t& f, int depth) const;
+      void solve_levels_bwd(WorkSolveLevels<scalar_t>& w, std::size_t i,
+                            DenseM_t& x, int depth) const;
+
+      void reduce_precision_rec(real_t rel_tol, real_t abs_tol,
+                                StoragePrecision lowest, real_t Bnrm);
+      // copies of B01 and B10, decoded if stored in reduced precision
+      DenseM_t B01_dense() const { return B01r_ ? B01r_->dense() : B01_; }
+      DenseM_t B10_dense() const { return B10r_ ? B10r_->dense() : B10_; }
+      // y = alpha op(B01) x + beta y, or with B10, in full or
+      // reduced precision
+      void apply_B01(Trans op, scalar_t alpha, const DenseM_t& x,
+                     scalar_t beta, DenseM_t& y, int depth) const;
+      void apply_B10(Trans op, scalar_t alpha, const DenseM_t& x,
+                     scalar_t beta, DenseM_t& y, int depth) const;
+
       void extract_fwd(WorkExtract<scalar_t>& w,
                        bool odiag, int depth) const override;
       void extract_bwd(DenseM_t& B, WorkExtract<scalar_t>& w,
@@ -668,6 +752,7 @@ namespace strumpack {
       void write(std::ofstream& os) const override;
 
       friend class HSSMatrixMPI<scalar_t>;
+      template<typename T> friend class HSSMatrixFrozen;
 
       using HSSMatrixBase<scalar_t>::child;
 
@@ -39,13 +39,245 @@ namespace strumpack {
       // TODO assert that the ULV factorization has been performed and
       // is a valid one
       // assert(ULV._D.rows() == U_.rows());
-      WorkSolve<scalar_t> w;
+      WorkSolveLevels<scalar_t> w;
+      solve(b, w);
+    }
+
+    template<typename scalar_t> void HSSMatrix<scalar_t>::solve
+    (DenseMatrix<scalar_t>& b, WorkSolveLevels<scalar_t>& w) const {
+      assert(b.rows() == this->rows());
+      if (!b.cols()) return;
+      solve_levels_setup(w, b.cols());
+      const auto& lp = w.lvl_ptr_;
+      const auto nlvls = lp.size() - 1;
 #pragma omp parallel if(!omp_in_parallel())
 #pragma omp single nowait
       {
-        solve_fwd(b, w, false, true, this->openmp_task_depth_);
-        solve_bwd(b, w, true, this->openmp_task_depth_);
+        // a single node per level (near the root) uses the threaded
+        // BLAS, otherwise all nodes of a level are processed
+        // concurrently, each with sequential BLAS
+        for (std::size_t l=0; l<nlvls; l++) {
+          if (lp[l+1] - lp[l] == 1)
+            w.nodes_[lp[l]].H->solve_levels_fwd
+              (w, lp[l], b, this->openmp_task_depth_);
+          else {
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)
+#endif
+            for (std::size_t i=lp[l]; i<lp[l+1]; i++)
+              w.nodes_[i].H->solve_levels_fwd
+                (w, i, b, params::task_recursion_cutoff_level);
+          }
+        }
+        if (this->leaf()) {
+          const auto& r = w.nodes_.back();
+          DenseMW_t x(r.fr, b.cols(), w.buf_.data()+r.f*b.cols(), r.fr);
+          b.copy(x);
+        }
+        for (std::size_t l=nlvls-1; l-->0; ) {
+          if (lp[l+1] - lp[l] == 1)
+            w.nodes_[lp[l]].H->solve_levels_bwd
+              (w, lp[l], b, this->openmp_task_depth_);
+          else {
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)
+#endif
+            for (std::size_t i=lp[l]; i<lp[l+1]; i++)
+              w.nodes_[i].H->solve_levels_bwd
+                (w, i, b, params::task_recursion_cutoff_level);
+          }
+        }
+      }
+    }
+
+    template<typename scalar_t> void HSSMatrix<scalar_t>::solve_levels_setup
+    (WorkSolveLevels<scalar_t>& w, std::size_t nrhs) const {
+      if (w.H_ != this || w.factor_id_ != factor_id_) {
+        // build the nodes in post-order, then sort them by height
+        std::vector<SolveNode_t> po;
+        std::vector<int> height;
+        std::size_t lrows = 0;
+        solve_levels_layout(po, height, lrows, 0, true);
+        // the root is the last node, and has the largest height
+        w.lvl_ptr_.assign(height.back()+2, 0);
+        for (auto h : height) w.lvl_ptr_[h+1]++;
+        for (std::size_t l=1; l<w.lvl_ptr_.size(); l++)
+          w.lvl_ptr_[l] += w.lvl_ptr_[l-1];
+        std::vector<int> perm(po.size());
+        {
+          auto next = w.lvl_ptr_;
+          for (std::size_t i=0; i<po.size(); i++)
+            perm[i] = next[height[i]]++;
+        }
+        auto map = [&perm](int i) { return i < 0 ? i : perm[i]; };
+        w.nodes_.resize(po.size());
+        for (std::size_t i=0; i<po.size(); i++) {
+          auto& n = w.nodes_[perm[i]];
+          n = po[i];
+          n.parent = map(n.parent);
+          n.c0 = map(n.c0);
+          n.c1 = map(n.c1);
+        }
+        w.H_ = this;
+        w.factor_id_ = factor_id_;
+        w.rows_ = lrows;
+      }
+      if (w.buf_.size() < w.rows_ * nrhs)
+        w.buf_.resize(w.rows_ * nrhs);
+    }
+
+    template<typename scalar_t> int HSSMatrix<scalar_t>::solve_levels_layout
+    (std::vector<SolveNode_t>& nodes, std::vector<int>& height,
+     std::size_t& lrows, std::size_t boff, bool isroot) const {
+      SolveNode_t n;
+      n.H = this;
+      n.parent = n.c0 = n.c1 = -1;
+      n.pf = n.pz = 0;
+      n.b = boff;
+      int h = 0;
+      if (this->leaf()) {
+        n.fr = this->rows();
+        n.zr = 0;
+      } else {
+        n.c0 = child(0)->solve_levels_layout
+          (nodes, height, lrows, boff, false);
+        n.c1 = child(1)->solve_levels_layout
+          (nodes, height, lrows, boff+child(0)->cols(), false);
+        nodes[n.c1].pf = child(0)->U_rank();
+        nodes[n.c1].pz = child(0)->V_rank();
+        h = 1 + std::max(height[n.c0], height[n.c1]);
+        n.fr = child(0)->U_rank() + child(1)->U_rank();
+        n.zr = child(0)->V_rank() + child(1)->V_rank();
       }
+      n.xr = isroot ? 0 : this->U_rows();
+      n.f = lrows;  lrows += n.fr;
+      n.zz = lrows; lrows += n.zr;
+      n.x = lrows;  lrows += n.xr;
+      int id = nodes.size();
+      nodes.push_back(n);
+      height.push_back(h);
+      if (!this->leaf())
+        nodes[n.c0].parent = nodes[n.c1].parent = id;
+      return id;
+    }
+
+    template<typename scalar_t> void HSSMatrix<scalar_t>::solve_levels_fwd
+    (WorkSolveLevels<scalar_t>& w, std::size_t i,
+     const DenseMatrix<scalar_t>& b, int depth) const {
+      const auto& n = w.nodes_[i];
+      const auto nrhs = b.cols();
+      auto buf = w.buf_.data();
+      DenseMW_t f(n.fr, nrhs, buf+n.f*nrhs, n.fr);
+      if (this->leaf())
+        copy(n.fr, nrhs, b, n.b, 0, f, 0, 0);
+      else {
+        DenseMW_t zz(n.zr, nrhs, buf+n.zz*nrhs, n.zr),
+          f0(child(0)->U_rank(), nrhs, f, 0, 0),
+          f1(child(1)->U_rank(), nrhs, f, f0.rows(), 0),
+          z0(child(0)->V_rank(), nrhs, zz, 0, 0),
+          z1(child(1)->V_rank(), nrhs, zz, z0.rows(), 0);
+        apply_B01(Trans::N, scalar_t(-1.), z1, scalar_t(1.), f0, depth);
+        apply_B10(Trans::N, scalar_t(-1.), z0, scalar_t(1.), f1, depth);
+        STRUMPACK_HSS_SOLVE_FLOPS
+          (blas::gemm_flops(f0.rows(), nrhs, z1.rows(),
+                            scalar_t(-1.), scalar_t(1.)) +
+           blas::gemm_flops(f1.rows(), nrhs, z0.rows(),
+                            scalar_t(-1.), scalar_t(1.)));
+        child(0)->solve_levels_W1(w, n.c0, f0, depth);
+        child(1)->solve_levels_W1(w, n.c1, f1, depth);
+      }
+      if (n.parent < 0) {
+        // at the root, overwrite f with x = D^{-1} f
+        if (n.fr) {
+          this->ULV_.D_.solve_LU_in_place(f, this->ULV_.piv_, depth);
+          STRUMPACK_HSS_SOLVE_FLOPS(solve_flops(f));
+        }
+        return;
+      }
+      // write ft1 to f of the parent, z to [z0; z1] of the parent
+      const auto& p = w.nodes_[n.parent];
+      auto rk = this->U_rank();
+      f.laswp(U_.P(), true);
+      DenseMW_t ft1(rk, nrhs, f, 0, 0),
+        z(this->V_rank(), nrhs, buf+p.zz*nrhs+n.pz, p.zr);
+      if (!this->leaf()) {
+        // z = V^* [z0; z1] = [I E^*] P^t [z0; z1]
+        DenseMW_t zz(n.zr, nrhs, buf+n.zz*nrhs, n.zr),
+          zz1(V_.rows()-V_.cols(), nrhs, zz, V_.cols(), 0);
+        zz.laswp(V_.P(), true);
+        copy(z.rows(), nrhs, zz, 0, 0, z, 0, 0);
+        V_.apply_E(Trans::C, scalar_t(1.), zz1, scalar_t(1.), z, depth);
+        STRUMPACK_HSS_SOLVE_FLOPS(V_.applyC_flops(nrhs));
+      } else z.zero();
+      if (this->U_rows() > rk) {
+        DenseMW_t y(this->U_rows()-rk, nrhs, f, rk, 0);
+        U_.apply_E(Trans::N, scalar_t(-1.), ft1, scalar_t(1.), y, depth);
+        trsm(Side::L, UpLo::L, Trans::N, Diag::N,
+             scalar_t(1.), this->ULV_.L_, y, depth);
+        gemm(Trans::C, Trans::N, scalar_t(1.),
+             this->ULV_.Vt0_, y, scalar_t(1.), z, depth);
+        STRUMPACK_HSS_SOLVE_FLOPS
+          (U_.apply_flops(nrhs) +
+           trsm_flops(Side::L, scalar_t(1.), this->ULV_.L_, y) +
+           gemm_flops(Trans::C, Trans::N, scalar_t(1.),
+                      this->ULV_.Vt0_, y, scalar_t(1.)));
+      }
+      DenseMW_t pf(p.fr, nrhs, buf+p.f*nrhs, p.fr);
+      copy(ft1, pf, n.pf, 0);
+    }
+
+    template<typename scalar_t> void HSSMatrix<scalar_t>::solve_levels_W1
+    (WorkSolveLevels<scalar_t>& w, std::size_t i,
+     DenseMatrix<scalar_t>& f, int depth) const {
+      // f -= W1 * Q0^* y, with y stored below ft1 in f of this node,
+      // and using x of this node as temporary storage
+      auto rk = this->U_rank();
+      if (this->U_rows() == rk) return;
+      const auto& n = w.nodes_[i];
+      const auto nrhs = f.cols();
+      auto buf = w.buf_.data();
+      DenseMW_t y(this->U_rows()-rk, nrhs, buf+n.f*nrhs+rk, n.fr),
+        tmp(n.xr, nrhs, buf+n.x*nrhs, n.xr),
+        Q0(y.rows(), this->U_rows(),
+           const_cast<DenseM_t&>(this->ULV_.Q_), 0, 0);
+      gemm(Trans::C, Trans::N, scalar_t(1.), Q0, y, scalar_t(0.), tmp, depth);
+      gemm(Trans::N, Trans::N, scalar_t(-1.),
+           this->ULV_.W1_, tmp, scalar_t(1.), f, depth);
+      STRUMPACK_HSS_SOLVE_FLOPS
+        (gemm_flops(Trans::C, Trans::N, scalar_t(1.), Q0, y, scalar_t(0.)) +
+         gemm_flops(Trans::N, Trans::N, scalar_t(-1.),
+                    this->ULV_.W1_, tmp, scalar_t(1.)));
+    }
+
+    template<typename scalar_t> void HSSMatrix<scalar_t>::solve_levels_bwd
+    (WorkSolveLevels<scalar_t>& w, std::size_t i,
+     DenseMatrix<scalar_t>& x, int depth) const {
+      const auto& n = w.nodes_[i];
+      if (n.parent < 0) return;
+      const auto& p = w.nodes_[n.parent];
+      const auto nrhs = x.cols();
+      auto buf = w.buf_.data();
+      auto rk = this->U_rank();
+      // the root stores its solution in f, other nodes in x
+      DenseMW_t xp = (p.parent < 0) ?
+        DenseMW_t(p.fr, nrhs, buf+p.f*nrhs, p.fr) :
+        DenseMW_t(p.xr, nrhs, buf+p.x*nrhs, p.xr);
+      DenseMW_t xi(rk, nrhs, xp, n.pf, 0);
+      DenseMW_t xn = this->leaf() ?
+        DenseMW_t(n.xr, nrhs, x, n.b, 0) :
+        DenseMW_t(n.xr, nrhs, buf+n.x*nrhs, n.xr);
+      if (this->U_rows() > rk) {
+        // xn = Q^* [y; xi]
+        auto r = this->U_rows() - rk;
+        auto& Q = const_cast<DenseM_t&>(this->ULV_.Q_);
+        DenseMW_t y(r, nrhs, buf+n.f*nrhs+rk, n.fr),
+          Q0(r, Q.cols(), Q, 0, 0), Q1(rk, Q.cols(), Q, r, 0);
+        gemm(Trans::C, Trans::N, scalar_t(1.), Q0, y, scalar_t(0.), xn, depth);
+        gemm(Trans::C, Trans::N, scalar_t(1.), Q1, xi, scalar_t(1.), xn, depth);
+        STRUMPACK_HSS_SOLVE_FLOPS
+          (gemm_flops(Trans::C, Trans::N, scalar_t(1.), Q0, y, scalar_t(0.)) +
+           gemm_flops(Trans::C, Trans::N, scalar_t(1.), Q1, xi, scalar_t(1.)));
+      } else xn.copy(xi);
     }
 
     // TODO do not pass work, just return the reduced_rhs, and w.x at the root
@@ -87,15 +319,15 @@ namespace strumpack {
 #pragma omp taskwait
         DenseM_t& f0 = w.c[0].ft1;
         DenseM_t& f1 = w.c[1].ft1;
-        gemm(Trans::N, Trans::N, scalar_t(-1.),
-             B01_, w.c[1].z, scalar_t(1.), f0, depth);
-        gemm(Trans::N, Trans::N, scalar_t(-1.),
-             B10_, w.c[0].z, scalar_t(1.), f1, depth);
+        apply_B01(Trans::N, scalar_t(-1.), w.c[1].z,
+                  scalar_t(1.), f0, depth);
+        apply_B10(Trans::N, scalar_t(-1.), w.c[0].z,
+                  scalar_t(1.), f1, depth);
         STRUMPACK_HSS_SOLVE_FLOPS
-          (gemm_flops(Trans::N, Trans::N, scalar_t(-1.),
-                      B01_, w.c[1].z, scalar_t(1.)) +
-           gemm_flops(Trans::N, Trans::N, scalar_t(-1.),
-                      B10_, w.c[0].z, scalar_t(1.)));
+          (blas::gemm_flops(f0.rows(), b.cols(), w.c[1].z.rows(),
+                            scalar_t(-1.), scalar_t(1.)) +
+           blas::gemm_flops(f1.rows(), b.cols(), w.c[0].z.rows(),
+                            scalar_t(-1.), scalar_t(1.)));
         if (child(0)->U_rows() > child(0)->U_rank()) {
           auto Q00 = ConstDenseMatrixWrapperPtr
             (child(0)->U_rows()-child(0)->U_rank(),
@@ -155,13 +387,11 @@ namespace strumpack {
           w.ft1 = DenseM_t(this->U_rank(), f.cols(), f, 0, 0);
           w.y = DenseM_t    // put ft0 in w.y
             (this->U_rows()-this->U_rank(), f.cols(), f, this->U_rank(), 0);
-          gemm(Trans::N, Trans::N, scalar_t(-1.),
-               U_.E(), w.ft1, scalar_t(1.), w.y, depth);
+          U_.apply_E(Trans::N, scalar_t(-1.), w.ft1, scalar_t(1.), w.y, depth);
           trsm(Side::L, UpLo::L, Trans::N, Diag::N,
                scalar_t(1.), this->ULV_.L_, w.y, depth);
           STRUMPACK_HSS_SOLVE_FLOPS
-            (gemm_flops(Trans::N, Trans::N, scalar_t(-1.),
-                        U_.E(), w.ft1, scalar_t(1.)) +
+            (U_.apply_flops(w.ft1.cols()) +
              trsm_flops(Side::L, scalar_t(1.), this->ULV_.L_, w.y));
           if (!this->leaf()) {
             w.z = V_.applyC(vconcat(w.c[0].z, w.c[1].z), depth);
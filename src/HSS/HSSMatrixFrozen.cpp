@@ -0,0 +1,419 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <algorithm>
+
+#include "HSSMatrixFrozen.hpp"
+
+namespace strumpack {
+  namespace HSS {
+
+    template<typename scalar_t>
+    HSSMatrixFrozen<scalar_t>::HSSMatrixFrozen(const HSSMatrix<scalar_t>& H)
+      : rows_(H.rows()), cols_(H.cols()) {
+      // collect the nodes in post-order, then sort them by height
+      std::vector<const HSSMatrix<scalar_t>*> po;
+      std::vector<Node> pn;
+      flatten(H, po, pn, 0, 0);
+      auto nlvls = pn.back().lvl + 1;
+      lvl_ptr_.assign(nlvls+1, 0);
+      for (auto& n : pn) lvl_ptr_[n.lvl+1]++;
+      for (std::size_t l=1; l<=nlvls; l++) lvl_ptr_[l] += lvl_ptr_[l-1];
+      std::vector<int> perm(pn.size());
+      {
+        auto next = lvl_ptr_;
+        for (std::size_t i=0; i<pn.size(); i++)
+          perm[i] = next[pn[i].lvl]++;
+      }
+      auto map = [&perm](int i) { return i < 0 ? i : perm[i]; };
+      std::vector<const HSSMatrix<scalar_t>*> hs(pn.size());
+      nodes_.resize(pn.size());
+      for (std::size_t i=0; i<pn.size(); i++) {
+        auto& n = nodes_[perm[i]];
+        n = pn[i];
+        n.parent = map(n.parent);
+        n.c0 = map(n.c0);
+        n.c1 = map(n.c1);
+        hs[perm[i]] = po[i];
+      }
+      const auto& R = *hs.back();
+      auto& r = nodes_.back();
+      factored_ = R.ULV_.piv_.size() == r.fr && R.ULV_.D_.rows() == r.fr;
+      for (std::size_t i=0; i+1<nodes_.size(); i++)
+        if (nodes_[i].urows > nodes_[i].ur &&
+            hs[i]->ULV_.Q_.rows() != nodes_[i].urows)
+          factored_ = false;
+      // copy the generators, level by level, and assign the work
+      // offsets, nodes of the same level are contiguous in memory
+      data_.resize(nlvls);
+      std::size_t mrows = 0, srows = 0;
+      for (std::size_t i=0; i<nodes_.size(); i++) {
+        auto& n = nodes_[i];
+        const auto& h = *hs[i];
+        auto l = n.lvl;
+        bool root = n.parent < 0;
+        if (h.leaf()) n.D = store(l, h.D_);
+        else {
+          n.B01 = store(l, h.B01_dense());
+          n.B10 = store(l, h.B10_dense());
+          n.t1 = mrows; mrows += n.tr;
+          n.t2 = mrows; mrows += n.tr;
+        }
+        if (!root) {
+          n.U = store(l, h.U_.dense());
+          n.V = store(l, h.V_.dense());
+        }
+        n.f = srows;  srows += n.fr;
+        n.zz = srows; srows += n.zr;
+        if (!root) { n.x = srows; srows += n.urows; }
+        if (!factored_) continue;
+        if (root) {
+          n.LU = store(l, h.ULV_.D_);
+          n.P = piv_.size();
+          piv_.insert(piv_.end(), h.ULV_.piv_.begin(), h.ULV_.piv_.end());
+        } else {
+          n.UE = store(l, h.U_.E_dense());
+          n.P = piv_.size();
+          piv_.insert(piv_.end(), h.U_.P().begin(), h.U_.P().end());
+          if (n.urows > n.ur) {
+            n.Q = store(l, h.ULV_.Q_);
+            n.W1 = store(l, h.ULV_.W1_);
+            n.L = store(l, h.ULV_.L_);
+            n.Vt0 = store(l, h.ULV_.Vt0_);
+          }
+        }
+      }
+      for (auto& d : data_) d.shrink_to_fit();
+      wrows_ = std::max(mrows, srows);
+    }
+
+    template<typename scalar_t> int HSSMatrixFrozen<scalar_t>::flatten
+    (const HSSMatrix<scalar_t>& H,
+     std::vector<const HSSMatrix<scalar_t>*>& po,
+     std::vector<Node>& nodes, std::size_t roff, std::size_t coff) {
+      Node n;
+      n.rows = H.rows();
+      n.cols = H.cols();
+      n.roff = roff;
+      n.coff = coff;
+      n.urows = H.U_rows();
+      n.ur = H.U_rank();
+      n.vrows = H.V_rows();
+      n.vr = H.V_rank();
+      if (H.leaf()) n.fr = n.rows;
+      else {
+        n.c0 = flatten(*H.child(0), po, nodes, roff, coff);
+        n.c1 = flatten(*H.child(1), po, nodes, roff+H.child(0)->rows(),
+                       coff+H.child(0)->cols());
+        auto& n0 = nodes[n.c0];
+        auto& n1 = nodes[n.c1];
+        n1.pu = n0.ur;
+        n1.pv = n0.vr;
+        n.lvl = 1 + std::max(n0.lvl, n1.lvl);
+        n.fr = n0.ur + n1.ur;
+        n.zr = n0.vr + n1.vr;
+        n.tr = std::max(n.fr, n.zr);
+      }
+      int id = nodes.size();
+      if (!H.leaf()) nodes[n.c0].parent = nodes[n.c1].parent = id;
+      nodes.push_back(n);
+      po.push_back(&H);
+      return id;
+    }
+
+    template<typename scalar_t> std::size_t
+    HSSMatrixFrozen<scalar_t>::store(std::size_t lvl, const DenseM_t& A) {
+      auto& d = data_[lvl];
+      auto off = d.size();
+      for (std::size_t j=0; j<A.cols(); j++)
+        d.insert(d.end(), A.ptr(0, j), A.ptr(0, j)+A.rows());
+      return off;
+    }
+
+    template<typename scalar_t> DenseMatrixWrapper<scalar_t>
+    HSSMatrixFrozen<scalar_t>::gen
+    (const Node& n, std::size_t off, std::size_t m, std::size_t k) const {
+      return DenseMW_t
+        (m, k, const_cast<scalar_t*>(data_[n.lvl].data())+off, m);
+    }
+
+    template<typename scalar_t> std::size_t
+    HSSMatrixFrozen<scalar_t>::memory() const {
+      std::size_t mem = sizeof(*this) + nodes_.capacity()*sizeof(Node)
+        + lvl_ptr_.capacity()*sizeof(std::size_t)
+        + piv_.capacity()*sizeof(int);
+      for (auto& d : data_) mem += d.capacity()*sizeof(scalar_t);
+      return mem;
+    }
+
+    template<typename scalar_t> std::size_t
+    HSSMatrixFrozen<scalar_t>::nonzeros() const {
+      std::size_t nnz = 0;
+      for (auto& d : data_) nnz += d.size();
+      return nnz;
+    }
+
+    template<typename scalar_t> template<typename F> void
+    HSSMatrixFrozen<scalar_t>::sweep(bool up, const F& f) const {
+      // a single node per level (near the root) uses the threaded
+      // BLAS, otherwise all nodes of a level are processed
+      // concurrently, each with sequential BLAS
+      auto nlvls = data_.size();
+      for (std::size_t s=0; s<nlvls; s++) {
+        auto l = up ? s : nlvls - 1 - s;
+        auto lo = lvl_ptr_[l], hi = lvl_ptr_[l+1];
+        if (hi - lo == 1) f(nodes_[lo], 0);
+        else {
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)
+#endif
+          for (std::size_t i=lo; i<hi; i++)
+            f(nodes_[i], params::task_recursion_cutoff_level);
+        }
+      }
+    }
+
+    template<typename scalar_t> void HSSMatrixFrozen<scalar_t>::mult
+    (Trans op, const DenseM_t& x, DenseM_t& y) const {
+      std::vector<scalar_t> work(work_size(x.cols()));
+      mult(op, x, y, work.data());
+    }
+
+    template<typename scalar_t> void HSSMatrixFrozen<scalar_t>::mult
+    (Trans op, const DenseM_t& x, DenseM_t& y, scalar_t* work) const {
+      assert(x.rows() == (op == Trans::N ? cols_ : rows_));
+      assert(y.rows() == (op == Trans::N ? rows_ : cols_));
+      assert(x.cols() == y.cols());
+      if (nodes_.empty() || !x.cols()) return;
+#pragma omp parallel if(!omp_in_parallel())
+#pragma omp single nowait
+      {
+        sweep(true, [&](const Node& n, int d) {
+          mult_up(op, n, x, work, d); });
+        sweep(false, [&](const Node& n, int d) {
+          mult_down(op, n, x, y, work, d); });
+      }
+    }
+
+    template<typename scalar_t> void HSSMatrixFrozen<scalar_t>::mult_up
+    (Trans op, const Node& n, const DenseM_t& x,
+     scalar_t* w, int depth) const {
+      // t1 = V^* x (or U^* x for op != N), stored in t1 of the parent
+      if (n.parent < 0) return;
+      const auto& p = nodes_[n.parent];
+      const auto nrhs = x.cols();
+      bool opN = op == Trans::N;
+      auto r = opN ? n.vr : n.ur;
+      DenseMW_t t1(r, nrhs, w+p.t1*nrhs+(opN ? n.pv : n.pu), p.tr);
+      auto B = opN ? gen(n, n.V, n.vrows, n.vr) : gen(n, n.U, n.urows, n.ur);
+      if (n.c0 < 0) {
+        auto& xl = const_cast<DenseM_t&>(x);
+        DenseMW_t xn(B.rows(), nrhs, xl, opN ? n.coff : n.roff, 0);
+        gemm(Trans::C, Trans::N, scalar_t(1.), B, xn,
+             scalar_t(0.), t1, depth);
+      } else {
+        DenseMW_t t1c(B.rows(), nrhs, w+n.t1*nrhs, n.tr);
+        gemm(Trans::C, Trans::N, scalar_t(1.), B, t1c,
+             scalar_t(0.), t1, depth);
+      }
+    }
+
+    template<typename scalar_t> void HSSMatrixFrozen<scalar_t>::mult_down
+    (Trans op, const Node& n, const DenseM_t& x, DenseM_t& y,
+     scalar_t* w, int depth) const {
+      const auto nrhs = x.cols();
+      bool opN = op == Trans::N;
+      auto opC = opN ? Trans::N : Trans::C;
+      // t2 of this node, stored in t2 of the parent
+      DenseMW_t t2;
+      scalar_t beta(0.);
+      if (n.parent >= 0 && (opN ? n.ur : n.vr)) {
+        const auto& p = nodes_[n.parent];
+        t2 = DenseMW_t(opN ? n.ur : n.vr, nrhs,
+                       w+p.t2*nrhs+(opN ? n.pu : n.pv), p.tr);
+        beta = scalar_t(1.);
+      }
+      auto B = opN ? gen(n, n.U, n.urows, n.ur) : gen(n, n.V, n.vrows, n.vr);
+      if (n.c0 < 0) {
+        // y = op(D) x + B t2
+        auto& xl = const_cast<DenseM_t&>(x);
+        DenseMW_t xn(opN ? n.cols : n.rows, nrhs, xl,
+                     opN ? n.coff : n.roff, 0),
+          yn(opN ? n.rows : n.cols, nrhs, y, opN ? n.roff : n.coff, 0);
+        if (beta != scalar_t(0.))
+          gemm(Trans::N, Trans::N, scalar_t(1.), B, t2,
+               scalar_t(0.), yn, depth);
+        gemm(opC, Trans::N, scalar_t(1.), gen(n, n.D, n.rows, n.cols),
+             xn, beta, yn, depth);
+        return;
+      }
+      // [t2_0; t2_1] = B t2 + [0 B01; B10 0] [t1_0; t1_1]
+      const auto& n0 = nodes_[n.c0];
+      const auto& n1 = nodes_[n.c1];
+      auto r0 = opN ? n0.ur : n0.vr, r1 = opN ? n1.ur : n1.vr,
+        s0 = opN ? n0.vr : n0.ur, s1 = opN ? n1.vr : n1.ur;
+      DenseMW_t t2c(r0+r1, nrhs, w+n.t2*nrhs, n.tr),
+        t2c0(r0, nrhs, t2c, 0, 0), t2c1(r1, nrhs, t2c, r0, 0),
+        t1c0(s0, nrhs, w+n.t1*nrhs, n.tr),
+        t1c1(s1, nrhs, w+n.t1*nrhs+s0, n.tr);
+      if (beta != scalar_t(0.))
+        gemm(Trans::N, Trans::N, scalar_t(1.), B, t2,
+             scalar_t(0.), t2c, depth);
+      auto B01 = gen(n, n.B01, n0.ur, n1.vr),
+        B10 = gen(n, n.B10, n1.ur, n0.vr);
+      gemm(opC, Trans::N, scalar_t(1.), opN ? B01 : B10, t1c1,
+           beta, t2c0, depth);
+      gemm(opC, Trans::N, scalar_t(1.), opN ? B10 : B01, t1c0,
+           beta, t2c1, depth);
+    }
+
+    template<typename scalar_t> void
+    HSSMatrixFrozen<scalar_t>::solve(DenseM_t& b) const {
+      std::vector<scalar_t> work(work_size(b.cols()));
+      solve(b, work.data());
+    }
+
+    template<typename scalar_t> void
+    HSSMatrixFrozen<scalar_t>::solve(DenseM_t& b, scalar_t* work) const {
+      assert(factored_);
+      assert(b.rows() == rows_);
+      if (nodes_.empty() || !b.cols()) return;
+#pragma omp parallel if(!omp_in_parallel())
+#pragma omp single nowait
+      {
+        sweep(true, [&](const Node& n, int d) {
+          solve_fwd(n, b, work, d); });
+        sweep(false, [&](const Node& n, int d) {
+          solve_bwd(n, b, work, d); });
+      }
+    }
+
+    template<typename scalar_t> void HSSMatrixFrozen<scalar_t>::solve_fwd
+    (const Node& n, const DenseM_t& b, scalar_t* w, int depth) const {
+      const auto nrhs = b.cols();
+      DenseMW_t f(n.fr, nrhs, w+n.f*nrhs, n.fr);
+      if (n.c0 < 0)
+        copy(n.fr, nrhs, b, n.coff, 0, f, 0, 0);
+      else {
+        const auto& n0 = nodes_[n.c0];
+        const auto& n1 = nodes_[n.c1];
+        DenseMW_t zz(n.zr, nrhs, w+n.zz*nrhs, n.zr),
+          f0(n0.ur, nrhs, f, 0, 0), f1(n1.ur, nrhs, f, n0.ur, 0),
+          z0(n0.vr, nrhs, zz, 0, 0), z1(n1.vr, nrhs, zz, n0.vr, 0);
+        gemm(Trans::N, Trans::N, scalar_t(-1.),
+             gen(n, n.B01, n0.ur, n1.vr), z1, scalar_t(1.), f0, depth);
+        gemm(Trans::N, Trans::N, scalar_t(-1.),
+             gen(n, n.B10, n1.ur, n0.vr), z0, scalar_t(1.), f1, depth);
+        for (auto c : {n.c0, n.c1}) {
+          // fc -= W1 * Q0^* y, using x of the child as temporary
+          const auto& nc = nodes_[c];
+          if (nc.urows == nc.ur) continue;
+          auto r = nc.urows - nc.ur;
+          DenseMW_t fc(nc.ur, nrhs, f, nc.pu, 0),
+            y(r, nrhs, w+nc.f*nrhs+nc.ur, nc.fr),
+            tmp(nc.urows, nrhs, w+nc.x*nrhs, nc.urows);
+          auto Q = gen(nc, nc.Q, nc.urows, nc.urows);
+          DenseMW_t Q0(r, nc.urows, Q, 0, 0);
+          gemm(Trans::C, Trans::N, scalar_t(1.), Q0, y,
+               scalar_t(0.), tmp, depth);
+          gemm(Trans::N, Trans::N, scalar_t(-1.),
+               gen(nc, nc.W1, nc.ur, nc.urows), tmp,
+               scalar_t(1.), fc, depth);
+        }
+      }
+      if (n.parent < 0) {
+        // at the root, overwrite f with x = D^{-1} f
+        if (n.fr)
+          gen(n, n.LU, n.fr, n.fr).solve_LU_in_place
+            (f, piv_.data()+n.P, depth);
+        return;
+      }
+      // write ft1 to f of the parent, z to [z0; z1] of the parent
+      const auto& p = nodes_[n.parent];
+      f.laswp(piv_.data()+n.P, true);
+      DenseMW_t ft1(n.ur, nrhs, f, 0, 0),
+        z(n.vr, nrhs, w+p.zz*nrhs+n.pv, p.zr);
+      if (n.c0 >= 0) {
+        DenseMW_t zz(n.zr, nrhs, w+n.zz*nrhs, n.zr);
+        gemm(Trans::C, Trans::N, scalar_t(1.),
+             gen(n, n.V, n.vrows, n.vr), zz, scalar_t(0.), z, depth);
+      } else z.zero();
+      if (n.urows > n.ur) {
+        auto r = n.urows - n.ur;
+        DenseMW_t y(r, nrhs, f, n.ur, 0);
+        gemm(Trans::N, Trans::N, scalar_t(-1.), gen(n, n.UE, r, n.ur),
+             ft1, scalar_t(1.), y, depth);
+        trsm(Side::L, UpLo::L, Trans::N, Diag::N, scalar_t(1.),
+             gen(n, n.L, r, r), y, depth);
+        gemm(Trans::C, Trans::N, scalar_t(1.), gen(n, n.Vt0, r, n.vr),
+             y, scalar_t(1.), z, depth);
+      }
+      DenseMW_t pf(p.fr, nrhs, w+p.f*nrhs, p.fr);
+      copy(ft1, pf, n.pu, 0);
+    }
+
+    template<typename scalar_t> void HSSMatrixFrozen<scalar_t>::solve_bwd
+    (const Node& n, DenseM_t& x, scalar_t* w, int depth) const {
+      const auto nrhs = x.cols();
+      if (n.parent < 0) {
+        if (n.c0 < 0) {
+          DenseMW_t f(n.fr, nrhs, w+n.f*nrhs, n.fr);
+          x.copy(f);
+        }
+        return;
+      }
+      const auto& p = nodes_[n.parent];
+      // the root stores its solution in f, other nodes in x
+      DenseMW_t xp = (p.parent < 0) ?
+        DenseMW_t(p.fr, nrhs, w+p.f*nrhs, p.fr) :
+        DenseMW_t(p.urows, nrhs, w+p.x*nrhs, p.urows);
+      DenseMW_t xi(n.ur, nrhs, xp, n.pu, 0);
+      DenseMW_t xn = (n.c0 < 0) ?
+        DenseMW_t(n.urows, nrhs, x, n.coff, 0) :
+        DenseMW_t(n.urows, nrhs, w+n.x*nrhs, n.urows);
+      if (n.urows > n.ur) {
+        // xn = Q^* [y; xi]
+        auto r = n.urows - n.ur;
+        auto Q = gen(n, n.Q, n.urows, n.urows);
+        DenseMW_t y(r, nrhs, w+n.f*nrhs+n.ur, n.fr),
+          Q0(r, n.urows, Q, 0, 0), Q1(n.ur, n.urows, Q, r, 0);
+        gemm(Trans::C, Trans::N, scalar_t(1.), Q0, y,
+             scalar_t(0.), xn, depth);
+        gemm(Trans::C, Trans::N, scalar_t(1.), Q1, xi,
+             scalar_t(1.), xn, depth);
+      } else xn.copy(xi);
+    }
+
+    // explicit template instantiations
+    template class HSSMatrixFrozen<float>;
+    template class HSSMatrixFrozen<double>;
+    template class HSSMatrixFrozen<std::complex<float>>;
+    template class HSSMatrixFrozen<std::complex<double>>;
+
+  } // end namespace HSS
+} // end namespace strumpack
@@ -0,0 +1,225 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/**
+ * \file HSSMatrixFrozen.hpp
+ *
+ * \brief Flattened, read-only copy of an HSSMatrix for repeated
+ * products and solves.
+ */
+#ifndef HSS_MATRIX_FROZEN_HPP
+#define HSS_MATRIX_FROZEN_HPP
+
+#include <vector>
+
+#include "HSSMatrix.hpp"
+
+namespace strumpack {
+  namespace HSS {
+
+    /**
+     * \class HSSMatrixFrozen
+     *
+     * \brief Flattened (frozen) representation of an HSSMatrix.
+     *
+     * The constructor copies all generators of an HSSMatrix (and, if
+     * the matrix was factored with HSSMatrix::factor, the ULV
+     * factors) into one contiguous array per level of the HSS
+     * tree. The HSS bases are stored as dense matrices, so the
+     * product only requires plain GEMM calls. Levels are defined by
+     * the height of a node in the tree, all nodes with the same
+     * height are independent and are processed concurrently.
+     *
+     * The offsets of all intermediate vectors are precomputed, so
+     * mult and solve do not allocate when a work array (of size
+     * work_size(nrhs)) is provided. A frozen matrix is never
+     * modified after construction, so mult and solve can be called
+     * from multiple threads at once, as long as each caller uses
+     * its own work array.
+     *
+     * The frozen matrix does not refer to the original HSSMatrix,
+     * which can be modified or deleted afterwards. Generators stored
+     * in reduced precision (see HSSMatrix::reduce_precision) are
+     * decoded, the frozen matrix is always stored in scalar_t.
+     *
+     * \tparam scalar_t Can be float, double, std:complex<float> or
+     * std::complex<double>.
+     *
+     * \see HSSMatrix
+     */
+    template<typename scalar_t> class HSSMatrixFrozen {
+      using DenseM_t = DenseMatrix<scalar_t>;
+      using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+
+    public:
+      /**
+       * Default constructor, constructs an empty 0 x 0 matrix.
+       */
+      HSSMatrixFrozen() = default;
+
+      /**
+       * Flatten the HSS matrix H. If H has been factored (see
+       * HSSMatrix::factor), the ULV factors are copied as well, and
+       * solve can be used.
+       *
+       * \param H compressed HSS matrix
+       */
+      HSSMatrixFrozen(const HSSMatrix<scalar_t>& H);
+
+      /**
+       * Number of rows of this matrix.
+       */
+      std::size_t rows() const { return rows_; }
+
+      /**
+       * Number of columns of this matrix.
+       */
+      std::size_t cols() const { return cols_; }
+
+      /**
+       * Number of levels (height of the HSS tree + 1).
+       */
+      std::size_t levels() const { return data_.size(); }
+
+      /**
+       * Whether the ULV factors were copied, ie, whether solve can be
+       * called.
+       */
+      bool factored() const { return factored_; }
+
+      /**
+       * Memory, in bytes, used by the generators, the factors and the
+       * metadata of this frozen matrix.
+       */
+      std::size_t memory() const;
+
+      /**
+       * Number of nonzeros stored for the generators and factors.
+       */
+      std::size_t nonzeros() const;
+
+      /**
+       * Size (number of scalars) of the work array required by mult
+       * and solve for nrhs right-hand sides.
+       */
+      std::size_t work_size(std::size_t nrhs) const {
+        return wrows_ * nrhs;
+      }
+
+      /**
+       * Compute y = op(A) x. This allocates a temporary work array,
+       * see mult(Trans, const DenseM_t&, DenseM_t&, scalar_t*) const
+       * for an allocation-free version.
+       *
+       * \param op Transpose, conjugate or none.
+       * \param x input, should have cols() (op(A) == A) or rows()
+       * rows
+       * \param y output, should have rows() (op(A) == A) or cols()
+       * rows, and x.cols() columns
+       */
+      void mult(Trans op, const DenseM_t& x, DenseM_t& y) const;
+
+      /**
+       * Compute y = op(A) x, using the work array work, which should
+       * hold at least work_size(x.cols()) elements.
+       *
+       * \see mult(Trans, const DenseM_t&, DenseM_t&) const
+       */
+      void mult(Trans op, const DenseM_t& x, DenseM_t& y,
+                scalar_t* work) const;
+
+      /**
+       * Solve A x = b using the ULV factors, b is overwritten with
+       * the solution. This allocates a temporary work array, see
+       * solve(DenseM_t&, scalar_t*) const for an allocation-free
+       * version. Requires factored().
+       *
+       * \param b right-hand side, should have rows() rows.
+       */
+      void solve(DenseM_t& b) const;
+
+      /**
+       * Solve A x = b using the ULV factors, using the work array
+       * work, which should hold at least work_size(b.cols())
+       * elements. Requires factored().
+       *
+       * \see solve(DenseM_t&) const
+       */
+      void solve(DenseM_t& b, scalar_t* work) const;
+
+    private:
+      struct Node {
+        int parent = -1, c0 = -1, c1 = -1;
+        std::size_t lvl = 0;
+        // dimensions, row and column offset in the full matrix
+        std::size_t rows = 0, cols = 0, roff = 0, coff = 0;
+        // size and rank of the U and V bases, and offset of the U/V
+        // rank part of this node in the vectors of the parent
+        std::size_t urows = 0, ur = 0, vrows = 0, vr = 0, pu = 0, pv = 0;
+        // offsets of the generators and factors in data_[lvl], and
+        // of the U basis permutation (or the pivots of LU at the
+        // root) in piv_
+        std::size_t D = 0, U = 0, V = 0, B01 = 0, B10 = 0,
+          UE = 0, Q = 0, W1 = 0, L = 0, Vt0 = 0, LU = 0, P = 0;
+        // offsets (per right-hand side) in the work array: mult uses
+        // t1 and t2 (both tr rows), solve uses f, zz and x
+        std::size_t tr = 0, t1 = 0, t2 = 0,
+          fr = 0, zr = 0, f = 0, zz = 0, x = 0;
+      };
+
+      std::size_t rows_ = 0, cols_ = 0, wrows_ = 0;
+      bool factored_ = false;
+      std::vector<Node> nodes_;
+      std::vector<std::size_t> lvl_ptr_;
+      std::vector<std::vector<scalar_t>> data_;
+      std::vector<int> piv_;
+
+      int flatten(const HSSMatrix<scalar_t>& H,
+                  std::vector<const HSSMatrix<scalar_t>*>& po,
+                  std::vector<Node>& nodes, std::size_t roff,
+                  std::size_t coff);
+      std::size_t store(std::size_t lvl, const DenseM_t& A);
+      DenseMW_t gen(const Node& n, std::size_t off,
+                    std::size_t m, std::size_t k) const;
+
+      template<typename F> void sweep(bool up, const F& f) const;
+
+      void mult_up(Trans op, const Node& n, const DenseM_t& x,
+                   scalar_t* w, int depth) const;
+      void mult_down(Trans op, const Node& n, const DenseM_t& x,
+                     DenseM_t& y, scalar_t* w, int depth) const;
+      void solve_fwd(const Node& n, const DenseM_t& b,
+                     scalar_t* w, int depth) const;
+      void solve_bwd(const Node& n, DenseM_t& x,
+                     scalar_t* w, int depth) const;
+    };
+
+  } // end namespace HSS
+} // end namespace strumpack
+
+#endif // HSS_MATRIX_FROZEN_HPP
@@ -97,6 +97,7 @@ namespace strumpack {
          {"hss_enable_sync",           no_argument, 0, 19},
          {"hss_disable_sync",          no_argument, 0, 20},
          {"hss_log_ranks",             no_argument, 0, 21},
+         {"hss_storage_precision",     required_argument, 0, 22},
          {"hss_verbose",               no_argument, 0, 'v'},
          {"hss_quiet",                 no_argument, 0, 'q'},
          {"help",                      no_argument, 0, 'h'},
@@ -228,6 +229,20 @@ namespace strumpack {
         case 19: { set_synchronized_compression(true); } break;
         case 20: { set_synchronized_compression(false); } break;
         case 21: { set_log_ranks(true); } break;
+        case 22: {
+          std::istringstream iss(optarg);
+          std::string s; iss >> s;
+          if (s == "full")
+            set_storage_precision(StoragePrecision::FULL);
+          else if (s == "single")
+            set_storage_precision(StoragePrecision::SINGLE);
+          else if (s == "bfloat16")
+            set_storage_precision(StoragePrecision::BFLOAT16);
+          else
+            std::cerr << "# WARNING: storage precision not"
+                      << " recognized, use 'full', 'single' or 'bfloat16'."
+                      << std::endl;
+        } break;
         case 'v': this->set_verbose(true); break;
         case 'q': this->set_verbose(false); break;
         case 'h': describe_options(); break;
@@ -281,6 +296,11 @@ namespace strumpack {
                 << (!synchronized_compression()) << ")" << std::endl
                 << "#   --hss_log_ranks (default "
                 << log_ranks() << ")" << std::endl
+                << "#   --hss_storage_precision (default "
+                << get_name(storage_prec_) << ")" << std::endl
+                << "#      lowest precision for the generators after"
+                << " factorization, should be [full|single|bfloat16]"
+                << std::endl
                 << "#   --hss_verbose or -v (default "
                 << this->verbose() << ")" << std::endl
                 << "#   --hss_quiet or -q (default "
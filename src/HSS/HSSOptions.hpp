@@ -34,6 +34,7 @@
 #define HSS_OPTIONS_HPP
 
 #include "clustering/Clustering.hpp"
+#include "dense/ReducedPrecisionMatrix.hpp"
 #include "structured/StructuredOptions.hpp"
 
 namespace strumpack {
@@ -305,6 +306,18 @@ namespace strumpack {
        */
       void set_log_ranks(bool log_ranks) { log_ranks_ = log_ranks; }
 
+      /**
+       * Lowest precision allowed to store the HSS generators (B01,
+       * B10 and the interpolative bases) after factorization. The
+       * actual precision is selected per generator, based on its
+       * norm and the compression tolerance, see
+       * HSSMatrix::reduce_precision. The default is FULL, ie, no
+       * reduced precision storage.
+       */
+      void set_storage_precision(StoragePrecision p) {
+        storage_prec_ = p;
+      }
+
 
       /**
        * Get the initial number of random vector that will be used in
@@ -445,6 +458,13 @@ namespace strumpack {
        */
       bool log_ranks() const { return log_ranks_; }
 
+      /**
+       * Lowest precision allowed to store the HSS generators after
+       * factorization.
+       * \see set_storage_precision
+       */
+      StoragePrecision storage_precision() const { return storage_prec_; }
+
       /**
        * Parse the command line options given by argc and argv.  The
        * options will not be modified. Run with --help to see an
@@ -480,6 +500,7 @@ namespace strumpack {
       ClusteringAlgorithm clustering_algo_ = ClusteringAlgorithm::TWO_MEANS;
       int approximate_neighbors_ = 64;
       int ann_iterations_ = 5;
+      StoragePrecision storage_prec_ = StoragePrecision::FULL;
 
       void set_defaults() {
         this->type_ = structured::Type::HSS;
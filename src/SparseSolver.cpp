@@ -26,6 +26,8 @@
  *             Division).
  */
 
+#include <algorithm>
+
 #include "StrumpackSparseSolver.hpp"
 
 #if defined(STRUMPACK_USE_PAPI)
@@ -59,7 +61,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   SparseSolver<scalar_t,integer_t>::setup_tree() {
     tree_.reset(new EliminationTree<scalar_t,integer_t>
-                (opts_, *mat_, nd_->tree()));
+                (opts_, *mat_, nd_->tree(), !interface_.empty()));
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -71,9 +73,94 @@ namespace strumpack {
   SparseSolver<scalar_t,integer_t>::compute_reordering
   (const int* p, int base, int nx, int ny, int nz,
    int components, int width) {
-    if (p) return nd_->set_permutation(opts_, *mat_, p, base);
-    return nd_->nested_dissection
-      (opts_, *mat_, nx, ny, nz, components, width);
+    user_perm_ = p != nullptr;
+    int ierr = p ? nd_->set_permutation(opts_, *mat_, p, base) :
+      nd_->nested_dissection(opts_, *mat_, nx, ny, nz, components, width);
+    if (!ierr && !interface_.empty())
+      nd_->separate_interface(interface_);
+    return ierr;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::set_interface
+  (const std::vector<integer_t>& I) {
+    if (reordered_) {
+      if (is_root_)
+        std::cerr << "# ERROR: set_interface should be called"
+                  << " before reorder" << std::endl;
+      return ReturnCode::REORDERING_ERROR;
+    }
+    if (!I.empty()) {
+      integer_t N = mat_ ? mat_->size() :
+        *std::max_element(I.begin(), I.end()) + 1;
+      std::vector<bool> mark(N, false);
+      for (auto i : I) {
+        if (i < 0 || i >= N || mark[i]) {
+          if (is_root_)
+            std::cerr << "# ERROR: invalid or duplicate interface"
+                      << " index " << i << std::endl;
+          return ReturnCode::REORDERING_ERROR;
+        }
+        mark[i] = true;
+      }
+      // the column permutation from the matching would move the
+      // interface columns, so the root front would no longer hold
+      // A_II
+      if (opts_.matching() != MatchingJob::NONE) {
+        if (is_root_)
+          std::cerr << "# ERROR: matching is not supported with an"
+                    << " interface, disable it with"
+                    << " options().set_matching(MatchingJob::NONE)"
+                    << std::endl;
+        return ReturnCode::REORDERING_ERROR;
+      }
+    }
+    interface_ = I;
+    factored_ = false;
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::Schur_complement(DenseM_t& S) {
+    if (!mat_) return ReturnCode::MATRIX_NOT_SET;
+    if (interface_.empty()) {
+      S = DenseM_t(0, 0);
+      return ReturnCode::SUCCESS;
+    }
+    if (!reordered_) {
+      ReturnCode ierr = this->reorder();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    if (matching_.job != MatchingJob::NONE) {
+      if (is_root_)
+        std::cerr << "# ERROR: matching is not supported with an"
+                  << " interface, the matching was enabled after"
+                  << " set_interface" << std::endl;
+      return ReturnCode::REORDERING_ERROR;
+    }
+    TaskTimer t("Schur-complement");
+    t.start();
+    factored_ = false;
+    auto ierr = tree_->Schur_complement(*mat_, opts_, S);
+    if (ierr != ReturnCode::SUCCESS) return ierr;
+    // undo the row/column scaling from the equilibration
+    std::size_t nI = interface_.size();
+    if (equil_.type == EquilibrationType::ROW ||
+        equil_.type == EquilibrationType::BOTH)
+      for (std::size_t j=0; j<nI; j++)
+        for (std::size_t i=0; i<nI; i++)
+          S(i, j) /= equil_.R[interface_[i]];
+    if (equil_.type == EquilibrationType::COLUMN ||
+        equil_.type == EquilibrationType::BOTH)
+      for (std::size_t j=0; j<nI; j++)
+        for (std::size_t i=0; i<nI; i++)
+          S(i, j) /= equil_.C[interface_[j]];
+    t.stop();
+    if (opts_.verbose() && is_root_)
+      std::cout << "# Schur complement of " << nI
+                << " interface unknowns, time = "
+                << t.elapsed() << std::endl;
+    return ReturnCode::SUCCESS;
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -81,11 +168,17 @@ namespace strumpack {
     nd_->separator_reordering(opts_, *mat_, tree_->root());
   }
 
+  template<typename scalar_t,typename integer_t> void
+  SparseSolver<scalar_t,integer_t>::setup_assembly_maps() {
+    tree_->setup_assembly_maps(*mat_);
+  }
+
   template<typename scalar_t,typename integer_t> void
   SparseSolver<scalar_t,integer_t>::set_matrix
   (const CSRMatrix<scalar_t,integer_t>& A) {
     mat_.reset(new CSRMatrix<scalar_t,integer_t>(A));
     factored_ = reordered_ = false;
+    clear_low_rank_update();
   }
 
   template <typename scalar_t, typename integer_t>
@@ -112,6 +205,7 @@ namespace strumpack {
         integer_t(mat_ptr.size() - 1), mat_ptr.data(), mat_ind.data(),
         mat_val.data()));
     factored_ = reordered_ = false;
+    clear_low_rank_update();
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -122,8 +216,11 @@ namespace strumpack {
       this->print_wrong_sparsity_error();
       return;
     }
+    std::unique_ptr<CSRMatrix<scalar_t,integer_t>> old(std::move(mat_));
     mat_.reset(new CSRMatrix<scalar_t,integer_t>(A));
     permute_matrix_values();
+    check_pattern(*old);
+    clear_low_rank_update();
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -133,6 +230,7 @@ namespace strumpack {
     mat_.reset(new CSRMatrix<scalar_t,integer_t>
                (N, row_ptr, col_ind, values, symmetric_pattern));
     factored_ = reordered_ = false;
+    clear_low_rank_update();
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -144,9 +242,31 @@ namespace strumpack {
       this->print_wrong_sparsity_error();
       return;
     }
+    std::unique_ptr<CSRMatrix<scalar_t,integer_t>> old(std::move(mat_));
     mat_.reset(new CSRMatrix<scalar_t,integer_t>
                (N, row_ptr, col_ind, values, symmetric_pattern));
     permute_matrix_values();
+    check_pattern(*old);
+    clear_low_rank_update();
+  }
+
+  /**
+   * The front assembly maps, computed in the symbolic phase, can only
+   * be reused if the (permuted) sparsity pattern is exactly the same
+   * as before, otherwise they are recomputed.
+   */
+  template<typename scalar_t,typename integer_t> void
+  SparseSolver<scalar_t,integer_t>::check_pattern
+  (const CSRMatrix<scalar_t,integer_t>& old) {
+    if (!tree_ || !reordered_) return;
+    auto N = mat_->size();
+    if (old.size() != N || old.nnz() != mat_->nnz() ||
+        !std::equal(mat_->ptr(), mat_->ptr()+N+1, old.ptr()) ||
+        !std::equal(mat_->ind(), mat_->ind()+mat_->nnz(), old.ind())) {
+      tree_->clear_assembly_maps();
+      if (opts_.use_assembly_maps())
+        setup_assembly_maps();
+    }
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -155,9 +275,9 @@ namespace strumpack {
       matrix()->apply_matching(matching_);
       matrix()->equilibrate(equil_);
       matrix()->symmetrize_sparsity();
+      // the permutation already includes the separator reordering
+      // for the compressed fronts, so that is not recomputed
       matrix()->permute(reordering()->iperm(), reordering()->perm());
-      if (opts_.compression() != CompressionType::NONE)
-        separator_reordering();
     }
     factored_ = false;
   }
@@ -173,7 +293,7 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   SparseSolver<scalar_t,integer_t>::transform_x0
-  (DenseM_t& x, DenseM_t& xtmp) {
+  (DenseM_t& x, DenseM_t& xtmp) const {
     integer_t N = matrix()->size(), d = x.cols();
     auto& P = reordering()->iperm();
     if (opts_.matching() == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
@@ -202,7 +322,7 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   SparseSolver<scalar_t,integer_t>::transform_x
-  (DenseM_t& x, DenseM_t& xtmp) {
+  (DenseM_t& x, DenseM_t& xtmp) const {
     integer_t N = matrix()->size(), d = x.cols();
     auto& Pi = reordering()->perm();
     for (integer_t j=0; j<d; j++)
@@ -232,7 +352,7 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   SparseSolver<scalar_t,integer_t>::transform_b
-  (const DenseM_t& b, DenseM_t& bloc) {
+  (const DenseM_t& b, DenseM_t& bloc) const {
     using real_t = typename RealType<scalar_t>::value_type;
     integer_t N = matrix()->size(), d = b.cols();
     auto& P = reordering()->iperm();
@@ -275,15 +395,57 @@ namespace strumpack {
     TaskTimer t("solve");
     this->perf_counters_start();
     t.start();
-    assert(b.cols() == x.cols());
+    SolveContext<scalar_t> ctx;
+    auto ierr = solve_internal(b, x, ctx, use_initial_guess);
+    if (lrW_.cols()) low_rank_correction(x);
+    Krylov_its_ = ctx.Krylov_its_;
+    t.stop();
+    this->perf_counters_stop("DIRECT/GMRES solve");
+    this->print_solve_stats(t);
+    return ierr;
+  }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::solve
+  (const scalar_t* b, scalar_t* x, SolveContext<scalar_t>& ctx,
+   bool use_initial_guess) const {
+    if (!matrix()) return ReturnCode::MATRIX_NOT_SET;
+    auto N = matrix()->size();
+    auto B = ConstDenseMatrixWrapperPtr(N, 1, b, N);
+    DenseMW_t X(N, 1, x, N);
+    return solve(*B, X, ctx, use_initial_guess);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::solve
+  (const DenseM_t& b, DenseM_t& x, SolveContext<scalar_t>& ctx,
+   bool use_initial_guess) const {
+    if (!matrix() || !this->reordered_)
+      return ReturnCode::MATRIX_NOT_SET;
+    if (!this->factored_ &&
+        (opts_.Krylov_solver() != KrylovSolver::GMRES) &&
+        (opts_.Krylov_solver() != KrylovSolver::BICGSTAB))
+      return ReturnCode::MATRIX_NOT_SET;
+    auto ierr = solve_internal(b, x, ctx, use_initial_guess);
+    if (lrW_.cols()) low_rank_correction(x);
+    return ierr;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::solve_internal
+  (const DenseM_t& b, DenseM_t& x, SolveContext<scalar_t>& ctx,
+   bool use_initial_guess) const {
+    assert(b.cols() == x.cols());
     integer_t d = b.cols();
     assert(matrix()->size() < std::numeric_limits<int>::max());
-    DenseM_t bloc(b.rows(), d);
+    auto& bloc = ctx.bloc_;
+    if (bloc.rows() != b.rows() || bloc.cols() != std::size_t(d))
+      bloc = DenseM_t(b.rows(), d);
+    auto& Krylov_its = ctx.Krylov_its_;
 
     auto spmv = [&](const scalar_t* x, scalar_t* y)
                 { matrix()->spmv(x, y); };
-    Krylov_its_ = 0;
+    Krylov_its = 0;
 
     if (use_initial_guess &&
         opts_.Krylov_solver() != KrylovSolver::DIRECT)
@@ -312,14 +474,14 @@ namespace strumpack {
       if (opts_.compression() != CompressionType::NONE && x.cols() == 1)
         iterative::GMRes<scalar_t>
           (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
-           opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+           opts_.rel_tol(), opts_.abs_tol(), Krylov_its, opts_.maxit(),
            opts_.gmres_restart(), opts_.GramSchmidt_type(),
            use_initial_guess, opts_.verbose() && is_root_);
       else
         iterative::IterativeRefinement<scalar_t,integer_t>
           (*matrix(), [&](DenseM_t& w) { tree()->multifrontal_solve(w); },
            x, bloc, opts_.rel_tol(), opts_.abs_tol(),
-           Krylov_its_, opts_.maxit(), use_initial_guess,
+           Krylov_its, opts_.maxit(), use_initial_guess,
            opts_.verbose() && is_root_);
     }; break;
     case KrylovSolver::DIRECT: {
@@ -330,14 +492,14 @@ namespace strumpack {
       iterative::IterativeRefinement<scalar_t,integer_t>
         (*matrix(), [&](DenseM_t& w) { tree()->multifrontal_solve(w); },
          x, bloc, opts_.rel_tol(), opts_.abs_tol(),
-         Krylov_its_, opts_.maxit(), use_initial_guess,
+         Krylov_its, opts_.maxit(), use_initial_guess,
          opts_.verbose() && is_root_);
     }; break;
     case KrylovSolver::PREC_GMRES: {
       assert(x.cols() == 1);
       iterative::GMRes<scalar_t>
         (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+         opts_.rel_tol(), opts_.abs_tol(), Krylov_its, opts_.maxit(),
          opts_.gmres_restart(), opts_.GramSchmidt_type(),
          use_initial_guess, opts_.verbose() && is_root_);
     }; break;
@@ -345,14 +507,14 @@ namespace strumpack {
       assert(x.cols() == 1);
       iterative::BiCGStab<scalar_t>
         (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+         opts_.rel_tol(), opts_.abs_tol(), Krylov_its, opts_.maxit(),
          use_initial_guess, opts_.verbose() && is_root_);
     }; break;
     case KrylovSolver::GMRES: { // see above
       assert(x.cols() == 1);
       iterative::GMRes<scalar_t>
         (spmv, [](scalar_t* x) {}, x.rows(), x.data(), bloc.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+         opts_.rel_tol(), opts_.abs_tol(), Krylov_its, opts_.maxit(),
          opts_.gmres_restart(), opts_.GramSchmidt_type(),
          use_initial_guess, opts_.verbose() && is_root_);
     }; break;
@@ -360,18 +522,196 @@ namespace strumpack {
       assert(x.cols() == 1);
       iterative::BiCGStab<scalar_t>
         (spmv, [](scalar_t* x) {}, x.rows(), x.data(), bloc.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+         opts_.rel_tol(), opts_.abs_tol(), Krylov_its, opts_.maxit(),
          use_initial_guess, opts_.verbose() && is_root_);
     }
     }
     transform_x(x, bloc);
+    return ReturnCode::SUCCESS;
+  }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::set_low_rank_update
+  (const DenseM_t& U, const DenseM_t& V) {
+    clear_low_rank_update();
+    return add_low_rank_update(U, V);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::add_low_rank_update
+  (const DenseM_t& U, const DenseM_t& V) {
+    if (!mat_) return ReturnCode::MATRIX_NOT_SET;
+    std::size_t N = mat_->size(), k = U.cols();
+    assert(U.rows() == N && V.rows() == N && V.cols() == k);
+    if (!k) return ReturnCode::SUCCESS;
+    if (!factored_) {
+      ReturnCode ierr = this->factor();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    TaskTimer t("low-rank-update");
+    t.start();
+    // W = A^{-1} U, only for the new columns. The non-preconditioned
+    // and the Krylov solvers only support a single right-hand side
+    DenseM_t W(N, k);
+    SolveContext<scalar_t> ctx;
+    auto solver = opts_.Krylov_solver();
+    if (solver == KrylovSolver::DIRECT || solver == KrylovSolver::REFINE ||
+        solver == KrylovSolver::AUTO)
+      solve_internal(U, W, ctx, false);
+    else
+      for (std::size_t j=0; j<k; j++) {
+        auto Uj = ConstDenseMatrixWrapperPtr(N, 1, U, 0, j);
+        DenseMW_t Wj(N, 1, W, 0, j);
+        solve_internal(*Uj, Wj, ctx, false);
+      }
+    if (lrU_.cols()) {
+      lrU_.hconcat(U);
+      lrV_.hconcat(V);
+      lrW_.hconcat(W);
+    } else {
+      lrU_ = U;
+      lrV_ = V;
+      lrW_ = std::move(W);
+    }
+    // capacitance matrix C = I + V^T W
+    auto r = lrU_.cols();
+    lrC_ = DenseM_t(r, r);
+    lrC_.eye();
+    gemm(Trans::T, Trans::N, scalar_t(1.), lrV_, lrW_, scalar_t(1.), lrC_);
+    if (lrC_.LU(lrpiv_)) {
+      if (is_root_)
+        std::cerr << "# ERROR: the capacitance matrix I + V^T A^{-1} U"
+                  << " is singular, A + U V^T is singular" << std::endl;
+      clear_low_rank_update();
+      return ReturnCode::ZERO_PIVOT;
+    }
     t.stop();
-    this->perf_counters_stop("DIRECT/GMRES solve");
-    this->print_solve_stats(t);
+    if (opts_.verbose() && is_root_)
+      std::cout << "# low-rank update, rank = " << r
+                << ", time = " << t.elapsed() << std::endl;
+    merge_low_rank_update();
     return ReturnCode::SUCCESS;
   }
 
+  template<typename scalar_t,typename integer_t> void
+  SparseSolver<scalar_t,integer_t>::clear_low_rank_update() {
+    lrU_.clear();
+    lrV_.clear();
+    lrW_.clear();
+    lrC_.clear();
+    lrpiv_.clear();
+  }
+
+  /**
+   * x = x - W (I + V^T W)^{-1} V^T x, with on input x = A^{-1} b, so
+   * that on output x = (A + U V^T)^{-1} b.
+   */
+  template<typename scalar_t,typename integer_t> void
+  SparseSolver<scalar_t,integer_t>::low_rank_correction
+  (DenseM_t& x) const {
+    DenseM_t t(lrV_.cols(), x.cols());
+    gemm(Trans::T, Trans::N, scalar_t(1.), lrV_, x, scalar_t(0.), t);
+    lrC_.solve_LU_in_place(t, lrpiv_);
+    gemm(Trans::N, Trans::N, scalar_t(-1.), lrW_, t, scalar_t(1.), x);
+  }
+
+  /**
+   * Applying the low-rank correction costs O(N r) per right-hand
+   * side. Once that is more than the cost of the sparse triangular
+   * solves, ie, when N r exceeds the number of nonzeros in the
+   * factors, add U V^T to the sparse matrix, and start over with a
+   * new reordering and factorization. This is only done when U V^T
+   * does not add more nonzeros than the matrix already has, and not
+   * for the symmetric solver, which only stores the lower triangle.
+   * It is also not done for a geometric or a user supplied
+   * ordering, since the mesh dimensions or the permutation passed to
+   * reorder are not available to redo the reordering.
+   * The sparse matrix is stored permuted and scaled, so first undo
+   * the matching, equilibration and nested dissection permutation,
+   * see transform_b and transform_x.
+   */
+  template<typename scalar_t,typename integer_t> bool
+  SparseSolver<scalar_t,integer_t>::merge_low_rank_update() {
+    using real_t = typename RealType<scalar_t>::value_type;
+    integer_t N = mat_->size(), r = lrU_.cols();
+    if (is_symmetric(opts_) || user_perm_ ||
+        opts_.reordering_method() == ReorderingStrategy::GEOMETRIC ||
+        std::size_t(N) * r <= this->factor_nonzeros())
+      return false;
+    auto nonzero_rows = [&](const DenseM_t& X) {
+      std::vector<integer_t> rows;
+      for (integer_t i=0; i<N; i++)
+        for (integer_t j=0; j<r; j++)
+          if (X(i, j) != scalar_t(0.)) {
+            rows.push_back(i);
+            break;
+          }
+      return rows;
+    };
+    auto rU = nonzero_rows(lrU_), rV = nonzero_rows(lrV_);
+    if (rU.size() * rV.size() > std::size_t(mat_->nnz()))
+      return false;
+    auto& iP = reordering()->iperm();
+    bool mc64 = matching_.job != MatchingJob::NONE,
+      mc64scale = matching_.job == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING;
+    bool Rscale = equil_.type == EquilibrationType::ROW ||
+      equil_.type == EquilibrationType::BOTH;
+    bool Cscale = equil_.type == EquilibrationType::COLUMN ||
+      equil_.type == EquilibrationType::BOTH;
+    std::vector<std::vector<std::pair<integer_t,scalar_t>>> rows(N);
+    auto ptr = mat_->ptr();
+    auto ind = mat_->ind();
+    auto val = mat_->val();
+    for (integer_t ri=0; ri<N; ri++) {
+      auto p = iP[ri];
+      real_t sr = 1.;
+      if (Rscale) sr *= equil_.R[p];
+      if (mc64scale) sr *= matching_.R[p];
+      for (integer_t jj=ptr[ri]; jj<ptr[ri+1]; jj++) {
+        auto i = iP[ind[jj]];
+        auto k = mc64 ? matching_.Q[i] : i;
+        real_t s = sr;
+        if (Cscale) s *= equil_.C[i];
+        if (mc64scale) s *= matching_.C[k];
+        rows[p].emplace_back(k, val[jj] / s);
+      }
+    }
+    for (auto i : rU)
+      for (auto k : rV) {
+        scalar_t v(0.);
+        for (integer_t l=0; l<r; l++) v += lrU_(i, l) * lrV_(k, l);
+        rows[i].emplace_back(k, v);
+      }
+    std::vector<integer_t> Aptr(N+1), Aind;
+    std::vector<scalar_t> Aval;
+    Aind.reserve(mat_->nnz() + rU.size() * rV.size());
+    Aval.reserve(mat_->nnz() + rU.size() * rV.size());
+    for (integer_t i=0; i<N; i++) {
+      auto& row = rows[i];
+      std::sort(row.begin(), row.end(),
+                [](const std::pair<integer_t,scalar_t>& a,
+                   const std::pair<integer_t,scalar_t>& b) {
+                  return a.first < b.first; });
+      for (std::size_t j=0; j<row.size(); j++) {
+        if (j && row[j].first == row[j-1].first)
+          Aval.back() += row[j].second;
+        else {
+          Aind.push_back(row[j].first);
+          Aval.push_back(row[j].second);
+        }
+      }
+      Aptr[i+1] = Aind.size();
+      std::vector<std::pair<integer_t,scalar_t>>().swap(row);
+    }
+    if (opts_.verbose() && is_root_)
+      std::cout << "# low-rank update of rank " << r
+                << " merged in the sparse matrix, refactoring"
+                << std::endl;
+    set_matrix(CSRMatrix<scalar_t,integer_t>
+               (N, Aptr.data(), Aind.data(), Aval.data()));
+    return true;
+  }
+
   template<typename scalar_t,typename integer_t> void
   SparseSolver<scalar_t,integer_t>::delete_factors_internal() {
     tree_.reset(nullptr);
@@ -326,11 +326,15 @@ namespace strumpack {
                 << std::endl;
     if (opts_.matching() != MatchingJob::NONE) {
       try {
-        t1.time([&](){ matching_ = matrix()->matching(opts_.matching()); });
+        t1.time([&](){ matching_ = matrix()->matching
+              (opts_.matching(), true, opts_.use_auction_matching()); });
       } catch (std::exception& e) {
         if (is_root_) std::cerr << e.what() << std::endl;
         return ReturnCode::REORDERING_ERROR;
       }
+      if (opts_.use_auction_matching() && opts_.verbose() && is_root_)
+        std::cout << "#   - matching algorithm: "
+                  << (matching_.auction ? "auction" : "MC64") << std::endl;
     }
 
     // TODO(Jie): disable equilibration for sym temperately
@@ -389,6 +393,7 @@ namespace strumpack {
     // reordering()->clear_tree_data();
     if (opts_.verbose()) {
       auto fc = tree()->front_counter();
+      auto pmem = tree()->peak_memory();
       if (is_root_) {
         std::cout << "# symbolic factorization:" << std::endl;
         std::cout << "#   - nr of dense Frontal matrices = "
@@ -428,6 +433,9 @@ namespace strumpack {
         case CompressionType::NONE:
         default: break;
         }
+        std::cout << "#   - predicted peak active memory = "
+                  << double(pmem) * sizeof(scalar_t) / 1.e6
+                  << " MB" << std::endl;
         std::cout << "#   - symb-factor time = " << t0.elapsed() << std::endl;
       }
     }
@@ -435,22 +443,13 @@ namespace strumpack {
 
     if (opts_.compression() != CompressionType::NONE) {
       if (is_root_) {
-#if !defined(STRUMPACK_USE_BPACK)
+#if defined(STRUMPACK_USE_MPI) && !defined(STRUMPACK_USE_BPACK)
         if (opts_.compression() == CompressionType::HODLR ||
             opts_.compression() == CompressionType::BLR_HODLR ||
             opts_.compression() == CompressionType::ZFP_BLR_HODLR) {
-          std::cerr << "WARNING: Compression type requires ButterflyPACK, "
-            "but STRUMPACK was not configured with ButterflyPACK support!"
-                    << std::endl;
-        }
-#endif
-#if !defined(STRUMPACK_USE_ZFP)
-        if (opts_.compression() == CompressionType::ZFP_BLR_HODLR ||
-            opts_.compression() == CompressionType::LOSSLESS ||
-            opts_.compression() == CompressionType::LOSSY) {
-          std::cerr << "WARNING: Compression type requires ZFP, "
-            "but STRUMPACK was not configured with ZFP support!"
-                    << std::endl;
+          std::cerr << "WARNING: STRUMPACK was not configured with "
+            "ButterflyPACK support, distributed fronts will not use "
+            "HODLR compression!" << std::endl;
         }
 #endif
       }
@@ -462,6 +461,8 @@ namespace strumpack {
                   << t4.elapsed() << std::endl;
       perf_counters_stop("separator reordering");
     }
+    if (opts_.use_assembly_maps())
+      setup_assembly_maps();
 
     reordered_ = true;
     return ReturnCode::SUCCESS;
@@ -579,6 +580,9 @@ namespace strumpack {
     }
     perf_counters_start();
     flop_breakdown_reset();
+    params::CB_memory = 0;
+    params::CB_compressed_memory = 0;
+    params::assembly_map_fronts = 0;
     ReturnCode err_code;
     TaskTimer t1("Sparse-factorization", [&]() {
       err_code = tree()->multifrontal_factorization(*matrix(), opts_);
@@ -597,6 +601,12 @@ namespace strumpack {
                   << number_format_with_commas(fnnz) << std::endl;
         std::cout << "#   - factor memory = "
                   << float(fnnz) * sizeof(scalar_t) / 1.e6 << " MB" << std::endl;
+        if (opts_.CB_compression() && params::CB_memory)
+          std::cout << "#   - contribution block compression = "
+                    << params::CB_memory / 1.e6 << " MB -> "
+                    << params::CB_compressed_memory / 1.e6 << " MB ("
+                    << double(params::CB_compressed_memory) /
+            params::CB_memory * 100. << " %)" << std::endl;
 #if defined(STRUMPACK_COUNT_FLOPS)
         std::cout << "#   - factor flops = " << double(ftot_) << " min = "
                   << double(fmin_) << " max = " << double(fmax_)
@@ -635,8 +645,12 @@ namespace strumpack {
                       << opts_.BLR_options().rel_tol() << std::endl;
             std::cout << "#   - BLR absolute compression tolerance = "
                       << opts_.BLR_options().abs_tol() << std::endl;
+            if (opts_.BLR_options().MBLR_levels() > 1)
+              std::cout << "#   - MBLR levels = "
+                        << opts_.BLR_options().MBLR_levels()
+                        << ", outer tile size = "
+                        << opts_.BLR_options().MBLR_leaf_size() << std::endl;
           }
-#if defined(STRUMPACK_USE_BPACK)
           if (opts_.compression() == CompressionType::HODLR) {
             std::cout << "#   - maximum HODLR rank = " << max_rank << std::endl;
             std::cout << "#   - relative compression tolerance = "
@@ -654,9 +668,6 @@ namespace strumpack {
             std::cout << "#   - BLR absolute compression tolerance = "
                       << opts_.BLR_options().abs_tol() << std::endl;
           }
-#endif
-#if defined(STRUMPACK_USE_BPACK)
-#if defined(STRUMPACK_USE_ZFP)
           if (opts_.compression() == CompressionType::ZFP_BLR_HODLR) {
             std::cout << "#   - maximum HODLR rank = " << max_rank << std::endl;
             std::cout << "#   - HODLR relative compression tolerance = "
@@ -668,15 +679,11 @@ namespace strumpack {
             std::cout << "#   - BLR absolute compression tolerance = "
                       << opts_.BLR_options().abs_tol() << std::endl;
           }
-#endif
-#endif
-#if defined(STRUMPACK_USE_ZFP)
           if (opts_.compression() == CompressionType::LOSSY)
             std::cout << "#   - lossy compression precision = "
                       << opts_.lossy_precision() << " bitplanes" << std::endl
                       << "#   - lossy compression accuracy = "
                       << opts_.lossy_accuracy() << std::endl;
-#endif
         }
       }
     }
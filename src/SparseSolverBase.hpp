@@ -397,6 +397,11 @@ namespace strumpack {
                            int nx, int ny, int nz,
                            int components, int width) = 0;
     virtual void separator_reordering() = 0;
+    /**
+     * Called at the end of the symbolic phase, when
+     * SPOptions::use_assembly_maps() is set.
+     */
+    virtual void setup_assembly_maps() {}
 
     virtual SpMat_t* matrix() = 0;
     virtual Reord_t* reordering() = 0;
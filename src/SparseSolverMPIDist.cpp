@@ -227,6 +227,8 @@ namespace strumpack {
   SparseSolverMPIDist<scalar_t,integer_t>::setup_tree() {
     if (opts_.replace_tiny_pivots() && opts_.matching() == MatchingJob::NONE) {
       auto shifted_mat = mat_mpi_->add_missing_diagonal(opts_.pivot_threshold());
+      // the subgraph values were collected without the added diagonal
+      nd_mpi_->clear_sub_matrix();
       tree_mpi_dist_.reset
         (new EliminationTreeMPIDist<scalar_t,integer_t>
          (opts_, *shifted_mat, *nd_mpi_, comm_));
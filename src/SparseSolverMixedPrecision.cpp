@@ -26,6 +26,9 @@
  *             Division).
  */
 
+#include <iomanip>
+#include <limits>
+
 #include "StrumpackSparseSolverMixedPrecision.hpp"
 
 #if defined(STRUMPACK_USE_PAPI)
@@ -60,17 +63,20 @@ namespace strumpack {
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   ~SparseSolverMixedPrecision() = default;
 
+  template<typename factor_t,typename refine_t,typename integer_t> void
+  SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
+  inner_solve(DenseMatrix<refine_t>& w) {
+    DenseMatrix<factor_t> new_x(w.rows(), w.cols()),
+      cast_b = cast_matrix<refine_t,factor_t>(w);
+    solver_.solve(cast_b, new_x);
+    copy(new_x, w);
+  }
+
   template<typename factor_t,typename refine_t,typename integer_t> ReturnCode
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   solve(const DenseMatrix<refine_t>& b, DenseMatrix<refine_t>& x,
         bool use_initial_guess) {
-    auto solve_func =
-      [&](DenseMatrix<refine_t>& w) {
-        DenseMatrix<factor_t> new_x(w.rows(), w.cols()),
-          cast_b = cast_matrix<refine_t,factor_t>(w);
-        solver_.solve(cast_b, new_x);
-        copy(new_x, w);
-      };
+    auto solve_func = [&](DenseMatrix<refine_t>& w) { inner_solve(w); };
     auto solve_func_ptr =
       [&](refine_t* w) {
         DenseMatrixWrapper<refine_t> wx(x.rows(), 1, w, x.rows());
@@ -81,9 +87,13 @@ namespace strumpack {
     auto old_verbose = solver_.options().verbose();
     solver_.options().set_verbose(false);
     Krylov_its_ = 0;
+    ReturnCode ret = ReturnCode::SUCCESS;
     switch (opts_.Krylov_solver()) {
     case KrylovSolver::AUTO: {
-      if (opts_.compression() != CompressionType::NONE && x.cols() == 1)
+      if (fprec_ != StoragePrecision::FULL)
+        ret = GMRES_IR(b, x, use_initial_guess);
+      else if (opts_.compression() != CompressionType::NONE &&
+                 x.cols() == 1)
         iterative::GMRes<refine_t>
           (spmv, solve_func_ptr, x.rows(), x.data(), b.data(),
            opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
@@ -124,9 +134,109 @@ namespace strumpack {
         "as outer solver in mixed-precision solver." << std::endl;
     }
     }
-    // TODO check convergence, return whether or not this converged
     solver_.options().set_verbose(old_verbose);
-    return ReturnCode::SUCCESS;
+    return ret;
+  }
+
+  template<typename factor_t,typename refine_t,typename integer_t> ReturnCode
+  SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
+  GMRES_IR(const DenseMatrix<refine_t>& b, DenseMatrix<refine_t>& x,
+           bool use_initial_guess) {
+    using real_t = typename RealType<refine_t>::value_type;
+    // The correction equation only needs to be solved to a modest
+    // relative accuracy. The refinement is considered stalled when
+    // an iteration does not halve the residual.
+    const real_t inner_rtol = 1e-4, stall = .5;
+    const std::size_t n = x.rows();
+    auto spmv = [&](const refine_t* v, refine_t* w) { mat_.spmv(v, w); };
+    auto prec = [&](refine_t* w) {
+      DenseMatrixWrapper<refine_t> W(n, 1, w, n);
+      inner_solve(W);
+    };
+    DenseMatrix<refine_t> r(n, 1), d(n, 1);
+    bool converged = true;
+    for (std::size_t c=0; c<x.cols(); c++) {
+      DenseMatrixWrapper<refine_t> xc(n, 1, x, 0, c);
+      if (!use_initial_guess) xc.zero();
+      auto bnrm = blas::nrm2(n, b.ptr(0, c), 1);
+      auto rnrm_prev = std::numeric_limits<real_t>::max();
+      bool conv = false;
+      for (int it=0; it<opts_.maxit(); it++) {
+        mat_.spmv(xc.data(), r.data());
+        for (std::size_t i=0; i<n; i++)
+          r(i, 0) = b(i, c) - r(i, 0);
+        auto rnrm = r.normF();
+        if (opts_.verbose())
+          std::cout << "# GMRES-IR it. " << it << "\tres = "
+                    << std::setw(12) << rnrm << "\trel.res = "
+                    << std::setw(12) << rnrm / bnrm << "\tfactors "
+                    << get_name(fprec_) << std::endl;
+        if (rnrm <= opts_.rel_tol() * bnrm || rnrm <= opts_.abs_tol()) {
+          conv = true;
+          break;
+        }
+        if (rnrm > stall * rnrm_prev && !increase_factor_precision())
+          break;
+        rnrm_prev = rnrm;
+        int its = 0;
+        iterative::GMRes<refine_t>
+          (spmv, prec, n, d.data(), r.data(), inner_rtol, real_t(0.),
+           its, opts_.gmres_restart(), opts_.gmres_restart(),
+           opts_.GramSchmidt_type(), false, false);
+        Krylov_its_ += its;
+        xc.add(d);
+      }
+      converged = converged && conv;
+    }
+    return converged ? ReturnCode::SUCCESS : ReturnCode::NO_CONVERGENCE;
+  }
+
+  template<typename factor_t,typename refine_t,typename integer_t> bool
+  SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
+  increase_factor_precision() {
+    if (fprec_ == StoragePrecision::FULL) return false;
+    if (opts_.verbose())
+      std::cout << "# GMRES-IR stalled, refactoring with the factors "
+                << "stored in full precision" << std::endl;
+    fprec_ = StoragePrecision::FULL;
+    // the front types are selected in the symbolic factorization, so
+    // setting the matrix again is needed to get dense fronts
+    solver_.options().set_compression(CompressionType::NONE);
+    if (lower_)
+      solver_.set_lower_triangle_matrix
+        (cast_matrix<refine_t,integer_t,factor_t>(mat_));
+    else
+      solver_.set_matrix(cast_matrix<refine_t,integer_t,factor_t>(mat_));
+    return solver_.reorder(nx_, ny_, nz_) == ReturnCode::SUCCESS &&
+      solver_.factor() == ReturnCode::SUCCESS;
+  }
+
+  template<typename factor_t,typename refine_t,typename integer_t> void
+  SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
+  set_factor_storage_precision(StoragePrecision p) {
+    auto& o = solver_.options();
+    if (p != StoragePrecision::BFLOAT16) {
+      if (fprec_ != StoragePrecision::FULL)
+        o.set_compression(CompressionType::NONE);
+      fprec_ = StoragePrecision::FULL;
+      return;
+    }
+    fprec_ = p;
+    o.set_compression(CompressionType::LOSSY);
+#if defined(STRUMPACK_USE_SZ3)
+    // SZ3 uses a relative error bound
+    o.set_lossy_accuracy
+      (unit_roundoff<typename RealType<factor_t>::value_type>(p));
+#elif defined(STRUMPACK_USE_ZFP)
+    // ZFP bit planes, about 16 bits per value
+    o.set_lossy_precision(16);
+    o.set_lossy_accuracy(-1);
+#else
+    // built-in codec, keep the 7 explicit mantissa bits of bfloat16,
+    // the 2 low order bytes are then always zero, and not stored
+    o.set_lossy_precision(7);
+    o.set_lossy_accuracy(-1);
+#endif
   }
 
   template<typename factor_t,typename refine_t,typename integer_t> ReturnCode
@@ -189,6 +299,7 @@ namespace strumpack {
   template<typename factor_t,typename refine_t,typename integer_t> ReturnCode
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   reorder(int nx, int ny, int nz) {
+    nx_ = nx;  ny_ = ny;  nz_ = nz;
     return solver_.reorder(nx, ny, nz);
   }
 
@@ -196,6 +307,7 @@ namespace strumpack {
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   set_matrix(const CSRMatrix<refine_t,integer_t>& A) {
     mat_ = A;
+    lower_ = false;
     solver_.set_matrix(cast_matrix<refine_t,integer_t,factor_t>(A));
   }
 
@@ -203,6 +315,7 @@ namespace strumpack {
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   set_matrix(const CSRMatrix<factor_t,integer_t>& A) {
     mat_ = cast_matrix<factor_t,integer_t,refine_t>(A);
+    lower_ = false;
     solver_.set_matrix(A);
   }
 
@@ -210,6 +323,7 @@ namespace strumpack {
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   set_lower_triangle_matrix(const CSRMatrix<refine_t,integer_t>& A) {
     mat_ = A;
+    lower_ = true;
     solver_.set_lower_triangle_matrix(cast_matrix<refine_t,integer_t,factor_t>(A));
   }
 
@@ -217,6 +331,7 @@ namespace strumpack {
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   set_lower_triangle_matrix(const CSRMatrix<factor_t,integer_t>& A) {
     mat_ = cast_matrix<factor_t,integer_t,refine_t>(A);
+    lower_ = true;
     solver_.set_lower_triangle_matrix(A);
   }
 
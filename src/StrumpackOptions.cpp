@@ -52,6 +52,7 @@ namespace strumpack {
     case ReorderingStrategy::AND: return "AND";
     case ReorderingStrategy::MLF: return "MLF";
     case ReorderingStrategy::SPECTRAL: return "Spectral";
+    case ReorderingStrategy::MLND: return "MLND";
     }
     return "UNKNOWN";
   }
@@ -70,6 +71,7 @@ namespace strumpack {
     case ReorderingStrategy::AND: return false;
     case ReorderingStrategy::MLF: return false;
     case ReorderingStrategy::SPECTRAL: return false;
+    case ReorderingStrategy::MLND: return false;
     }
     return false;
   }
@@ -185,6 +187,24 @@ namespace strumpack {
        {"sp_proportional_mapping",      required_argument, 0, 50},
        {"sp_enable_openmp_tree",        no_argument, 0, 51},
        {"sp_disable_openmp_tree",       no_argument, 0, 52},
+       {"sp_enable_relaxed_amalg",      no_argument, 0, 53},
+       {"sp_disable_relaxed_amalg",     no_argument, 0, 54},
+       {"sp_amalg_fill_tol",            required_argument, 0, 55},
+       {"sp_enable_partitioner_mapping",  no_argument, 0, 56},
+       {"sp_disable_partitioner_mapping", no_argument, 0, 57},
+       {"sp_partitioner_mapping_imbalance", required_argument, 0, 58},
+       {"sp_enable_CB_compression",     no_argument, 0, 59},
+       {"sp_disable_CB_compression",    no_argument, 0, 60},
+       {"sp_CB_compression_accuracy",   required_argument, 0, 61},
+       {"sp_tiled_LU_min_sep_size",     required_argument, 0, 62},
+       {"sp_tiled_LU_tile_size",        required_argument, 0, 64},
+       {"sp_enable_assembly_maps",      no_argument, 0, 65},
+       {"sp_disable_assembly_maps",     no_argument, 0, 66},
+       {"sp_enable_auction_matching",   no_argument, 0, 67},
+       {"sp_disable_auction_matching",  no_argument, 0, 68},
+       {"sp_enable_distributed_tiled_LU",  no_argument, 0, 69},
+       {"sp_disable_distributed_tiled_LU", no_argument, 0, 70},
+       {"sp_lossy_panel_cols",          required_argument, 0, 71},
        {"sp_verbose",                   no_argument, 0, 'v'},
        {"sp_quiet",                     no_argument, 0, 'q'},
        {"help",                         no_argument, 0, 'h'},
@@ -252,9 +272,11 @@ namespace strumpack {
         else if (s == "mlf") set_reordering_method(ReorderingStrategy::MLF);
         else if (s == "and") set_reordering_method(ReorderingStrategy::AND);
         else if (s == "spectral") set_reordering_method(ReorderingStrategy::SPECTRAL);
+        else if (s == "mlnd") set_reordering_method(ReorderingStrategy::MLND);
         else std::cerr << "# WARNING: matrix reordering strategy not"
                " recognized, use 'metis', 'parmetis', 'scotch', 'ptscotch',"
-               " 'rcm', 'geometric', 'amd', 'mmd', 'mlf', 'and' or 'spectral'"
+               " 'rcm', 'geometric', 'amd', 'mmd', 'mlf', 'and', 'spectral'"
+               " or 'mlnd'"
                        << std::endl;
       } break;
       case 8: {
@@ -428,6 +450,48 @@ namespace strumpack {
       } break;
       case 51: enable_openmp_tree(); break;
       case 52: disable_openmp_tree(); break;
+      case 53: enable_relaxed_amalg(); break;
+      case 54: disable_relaxed_amalg(); break;
+      case 55: {
+        std::istringstream iss(optarg);
+        iss >> amalg_fill_tol_;
+        set_amalg_fill_tol(amalg_fill_tol_);
+      } break;
+      case 56: enable_partitioner_mapping(); break;
+      case 57: disable_partitioner_mapping(); break;
+      case 58: {
+        std::istringstream iss(optarg);
+        iss >> partitioner_mapping_imb_;
+        set_partitioner_mapping_imbalance(partitioner_mapping_imb_);
+      } break;
+      case 59: enable_CB_compression(); break;
+      case 60: disable_CB_compression(); break;
+      case 61: {
+        std::istringstream iss(optarg);
+        iss >> CB_compression_acc_;
+        set_CB_compression_accuracy(CB_compression_acc_);
+      } break;
+      case 62: {
+        std::istringstream iss(optarg);
+        iss >> tiled_LU_min_sep_size_;
+        set_tiled_LU_min_sep_size(tiled_LU_min_sep_size_);
+      } break;
+      case 64: {
+        std::istringstream iss(optarg);
+        iss >> tiled_LU_nb_;
+        set_tiled_LU_tile_size(tiled_LU_nb_);
+      } break;
+      case 65: enable_assembly_maps(); break;
+      case 66: disable_assembly_maps(); break;
+      case 67: enable_auction_matching(); break;
+      case 68: disable_auction_matching(); break;
+      case 69: enable_distributed_tiled_LU(); break;
+      case 70: disable_distributed_tiled_LU(); break;
+      case 71: {
+        std::istringstream iss(optarg);
+        iss >> lossy_panel_cols_;
+        set_lossy_panel_cols(lossy_panel_cols_);
+      } break;
       case 'h': { describe_options(); } break;
       case 'v': set_verbose(true); break;
       case 'q': set_verbose(false); break;
@@ -441,9 +505,7 @@ namespace strumpack {
     //             << std::endl;
     HSS_options().set_from_command_line(argc, cargv);
     BLR_options().set_from_command_line(argc, cargv);
-#if defined(STRUMPACK_USE_BPACK)
     HODLR_options().set_from_command_line(argc, cargv);
-#endif
     // ND_options().set_from_command_line(argc, cargv);
 #else
     std::cerr << "WARNING: no support for getopt.h, "
@@ -478,7 +540,8 @@ namespace strumpack {
               << std::endl;
     std::cout << "#          Gram-Schmidt type for GMRES" << std::endl;
     std::cout << "#   --sp_reordering_method [natural|metis|scotch|parmetis|"
-              << "ptscotch|rcm|geometric|amd|mmd|mlf|and|spectral]" << std::endl;
+              << "ptscotch|rcm|geometric|amd|mmd|mlf|and|spectral|mlnd]"
+              << std::endl;
     std::cout << "#          Select a fill-reducing ordering algorithm." << std::endl;
     std::cout << "#          Geometric only works on regular meshes and you"
               << " need to provide the sizes." << std::endl;
@@ -521,6 +584,14 @@ namespace strumpack {
               << std::boolalpha << use_agg_amalg() << ")" << std::endl;
     std::cout << "#   --sp_disable_agg_amalg (default "
               << std::boolalpha << !use_agg_amalg() << ")" << std::endl;
+    std::cout << "#   --sp_enable_relaxed_amalg (default "
+              << std::boolalpha << use_relaxed_amalg() << ")" << std::endl;
+    std::cout << "#   --sp_disable_relaxed_amalg (default "
+              << std::boolalpha << !use_relaxed_amalg() << ")" << std::endl;
+    std::cout << "#   --sp_amalg_fill_tol real (default "
+              << amalg_fill_tol() << ")" << std::endl
+              << "#          relative fill allowed by relaxed amalgamation"
+              << std::endl;
     std::cout << "#   --sp_matching int [0-6] (default "
               << static_cast<int>(matching()) << ")" << std::endl;
     for (int i=0; i<7; i++)
@@ -556,6 +627,18 @@ namespace strumpack {
               << "#          should be [FLOPS|FACTOR_MEMORY|PEAK_MEMORY]" << std::endl
               << "#          type of proportional mapping"
               << std::endl;
+    std::cout << "#   --sp_enable_partitioner_mapping (default "
+              << std::boolalpha << partitioner_mapping_ << ")" << std::endl
+              << "#          keep ParMETIS/PT-Scotch process mapping for local subtrees"
+              << std::endl
+              << "#          (their rows are moved along with the subgraphs)"
+              << std::endl;
+    std::cout << "#   --sp_disable_partitioner_mapping (default "
+              << std::boolalpha << !partitioner_mapping_ << ")" << std::endl
+              << "#          always use proportional mapping" << std::endl;
+    std::cout << "#   --sp_partitioner_mapping_imbalance (default "
+              << partitioner_mapping_imb_ << ")" << std::endl
+              << "#          max load imbalance with partitioner mapping" << std::endl;
     std::cout << "#   --sp_enable_gpu" << std::endl;
     std::cout << "#   --sp_disable_gpu" << std::endl;
     std::cout << "#   --sp_gpu_streams (default "
@@ -576,7 +659,49 @@ namespace strumpack {
     std::cout << "#   --sp_lossy_accuracy (default "
               << lossy_accuracy() << ")" << std::endl
               << "#          lossy compression accuracy" << std::endl
-              << "#          (for precision mode, set < 0)" << std::endl;
+              << "#          (for precision mode, set <= 0)" << std::endl;
+    std::cout << "#   --sp_lossy_panel_cols (default "
+              << lossy_panel_cols() << ")" << std::endl
+              << "#          columns per compressed panel (0: automatic)"
+              << std::endl;
+    std::cout << "#   --sp_enable_CB_compression (default "
+              << std::boolalpha << CB_compression_ << ")" << std::endl
+              << "#          compress contribution blocks to reduce peak memory"
+              << std::endl;
+    std::cout << "#   --sp_disable_CB_compression (default "
+              << std::boolalpha << !CB_compression_ << ")" << std::endl;
+    std::cout << "#   --sp_CB_compression_accuracy (default "
+              << CB_compression_acc_ << ")" << std::endl
+              << "#          contribution block compression accuracy"
+              << std::endl
+              << "#          (for lossless compression, set < 0)" << std::endl;
+    std::cout << "#   --sp_tiled_LU_min_sep_size (default "
+              << tiled_LU_min_sep_size() << ")" << std::endl
+              << "#          minimum separator size for the tiled dense LU"
+              << std::endl;
+    std::cout << "#   --sp_tiled_LU_tile_size (default "
+              << tiled_LU_tile_size() << ")" << std::endl
+              << "#          tile size for the tiled dense LU" << std::endl;
+    std::cout << "#   --sp_enable_distributed_tiled_LU (default "
+              << std::boolalpha << distributed_tiled_LU_ << ")" << std::endl
+              << "#          tiled LU for distributed dense fronts"
+              << std::endl;
+    std::cout << "#   --sp_disable_distributed_tiled_LU (default "
+              << std::boolalpha << !distributed_tiled_LU_ << ")" << std::endl
+              << "#          ScaLAPACK pgetrf for distributed dense fronts"
+              << std::endl;
+    std::cout << "#   --sp_enable_assembly_maps (default "
+              << std::boolalpha << assembly_maps_ << ")" << std::endl
+              << "#          precompute the front assembly maps, for"
+              << " refactorization" << std::endl;
+    std::cout << "#   --sp_disable_assembly_maps (default "
+              << std::boolalpha << !assembly_maps_ << ")" << std::endl;
+    std::cout << "#   --sp_enable_auction_matching (default "
+              << std::boolalpha << auction_matching_ << ")" << std::endl
+              << "#          use an auction algorithm instead of MC64"
+              << " for matching job 5" << std::endl;
+    std::cout << "#   --sp_disable_auction_matching (default "
+              << std::boolalpha << !auction_matching_ << ")" << std::endl;
     std::cout << "#   --sp_hss_min_sep_size (default "
               << hss_min_sep_size() << ")" << std::endl
               << "#          minimum separator size for hss compression"
@@ -71,7 +71,9 @@ namespace strumpack {
     MMD,        /*!< Multiple minimum degree                        */
     AND,        /*!< Nested dissection                              */
     MLF,        /*!< Minimum local fill                             */
-    SPECTRAL    /*!< Spectral nested dissection                     */
+    SPECTRAL,   /*!< Spectral nested dissection                     */
+    MLND        /*!< Built-in multithreaded multilevel nested
+                  dissection, does not require Metis/Scotch         */
   };
 
   /**
@@ -518,6 +520,36 @@ namespace strumpack {
      */
     void disable_agg_amalg() { use_agg_amalg_ = false; }
 
+    /**
+     * Enable relaxed amalgamation of the separator tree, after the
+     * reordering. A child front is merged with its parent when the
+     * number of explicit zeros this introduces in the merged front is
+     * at most amalg_fill_tol() times the size of the merged
+     * front. This gives fewer, larger fronts, for which the dense
+     * kernels are more efficient. This works with any of the
+     * sequential reorderings.
+     *
+     * \see disable_relaxed_amalg(), set_amalg_fill_tol()
+     */
+    void enable_relaxed_amalg() { use_relaxed_amalg_ = true; }
+
+    /**
+     * Disable relaxed amalgamation of the separator tree.
+     *
+     * \see enable_relaxed_amalg()
+     */
+    void disable_relaxed_amalg() { use_relaxed_amalg_ = false; }
+
+    /**
+     * Set the relative fill tolerance for relaxed amalgamation, see
+     * enable_relaxed_amalg(). This should be >= 0. A value of 0 only
+     * allows merges that do not introduce any extra fill.
+     *
+     * \see enable_relaxed_amalg(), amalg_fill_tol()
+     */
+    void set_amalg_fill_tol(double tol)
+    { assert(tol >= 0); amalg_fill_tol_ = tol; }
+
     /**
      * Specify the job type for the column ordering for
      * stability. This ordering is computed using a maximum matching
@@ -791,9 +823,13 @@ namespace strumpack {
 
     /**
      * Set the precision for lossy compression. Preferred mode is
-     * accuracy. To use precision mode, set the accuracy to a negative
-     * value. For lossless compression, set both accuracy and
-     * precision to a negative value.
+     * accuracy. To use precision mode, set the accuracy to zero or a
+     * negative value. For lossless compression, set both accuracy
+     * and precision to zero or a negative value. With ZFP this is the
+     * number of bit planes, with the built-in codec (used when
+     * STRUMPACK is configured without ZFP, and with SZ3 in precision
+     * and lossless mode) this is the number of mantissa bits that are
+     * kept.
      *
      * \see set_lossy_accuracy
      */
@@ -802,12 +838,146 @@ namespace strumpack {
     }
 
     /**
-     * Set the accuracy for lossy compression.
+     * Set the accuracy for lossy compression. With ZFP and with the
+     * built-in codec this is an absolute error bound. With SZ3 it is
+     * a relative error bound: relative to the value range of each
+     * compressed column panel of the front. A value <= 0 selects
+     * precision mode, see set_lossy_precision.
      *
      * \see set_lossy_precision
      */
     void set_lossy_accuracy(double a) { lossy_accuracy_ = a; }
 
+    /**
+     * Set the number of columns in a panel of the lossy compressed
+     * front factors. The panels are compressed independently, and
+     * decompressed one at a time in the solve. The default, 0,
+     * selects a panel width such that a decompressed panel takes
+     * about 256KB, see LossyMatrix::default_panel_cols.
+     *
+     * \see set_lossy_precision
+     */
+    void set_lossy_panel_cols(int c) {
+      assert(c >= 0);
+      lossy_panel_cols_ = c;
+    }
+
+    /**
+     * Compress the contribution block of a (sequential dense, BLR or
+     * lossy) front as soon as it has been computed, and decompress
+     * it, one column panel at a time, during the extend-add in the
+     * parent. This reduces the peak memory of the factorization, at
+     * the cost of extra (de)compression time. The contribution
+     * blocks are compressed lossless, unless a positive accuracy is
+     * set with set_CB_compression_accuracy.
+     *
+     * \see disable_CB_compression, set_CB_compression_accuracy
+     */
+    void enable_CB_compression() { CB_compression_ = true; }
+
+    /**
+     * Do not compress the contribution blocks, this is the default.
+     *
+     * \see enable_CB_compression
+     */
+    void disable_CB_compression() { CB_compression_ = false; }
+
+    /**
+     * Set the absolute accuracy for lossy compression of the
+     * contribution blocks. A value <= 0 (the default is -1) means
+     * lossless compression. A reasonable value for lossy compression
+     * is the absolute compression tolerance used for the fronts, see
+     * set_compression_abs_tol.
+     *
+     * \see enable_CB_compression
+     */
+    void set_CB_compression_accuracy(double a) { CB_compression_acc_ = a; }
+
+    /**
+     * Dense (uncompressed) fronts with a separator of at least this
+     * size are factored with a tiled LU factorization, with
+     * tournament pivoting and lookahead, instead of the recursive
+     * LU. This can be faster for the large root fronts of 3D
+     * problems. The default is 10000.
+     *
+     * \see set_tiled_LU_tile_size, DenseMatrix::LU_tiled
+     */
+    void set_tiled_LU_min_sep_size(int s) {
+      assert(s >= 0);
+      tiled_LU_min_sep_size_ = s;
+    }
+
+    /**
+     * Set the tile size for the tiled dense LU factorization.
+     *
+     * \see set_tiled_LU_min_sep_size
+     */
+    void set_tiled_LU_tile_size(int nb) {
+      assert(nb > 0);
+      tiled_LU_nb_ = nb;
+    }
+
+    /**
+     * Factor the distributed dense fronts with the tiled LU
+     * factorization, with tournament pivoting, which works directly
+     * on the 2D block-cyclic layout. This is the default. It is only
+     * used when the row and column block sizes are equal, otherwise
+     * ScaLAPACK pgetrf is used.
+     *
+     * \see disable_distributed_tiled_LU(),
+     * DistributedMatrix::LU_tiled
+     */
+    void enable_distributed_tiled_LU() { distributed_tiled_LU_ = true; }
+
+    /**
+     * Factor the distributed dense fronts with ScaLAPACK pgetrf,
+     * with partial pivoting.
+     *
+     * \see enable_distributed_tiled_LU(),
+     * DistributedMatrix::LU_scalapack
+     */
+    void disable_distributed_tiled_LU() { distributed_tiled_LU_ = false; }
+
+    /**
+     * Precompute, in the symbolic phase, for every dense and BLR
+     * front, the list of positions where the nonzeros of the sparse
+     * matrix are assembled. Refactorizations after
+     * update_matrix_values (with the same sparsity pattern) then
+     * assemble the fronts by a plain scatter. This costs about 3
+     * integers per nonzero of the (permuted) sparse matrix. This is
+     * disabled by default.
+     *
+     * \see disable_assembly_maps()
+     */
+    void enable_assembly_maps() { assembly_maps_ = true; }
+
+    /**
+     * Do not precompute the front assembly maps.
+     *
+     * \see enable_assembly_maps()
+     */
+    void disable_assembly_maps() { assembly_maps_ = false; }
+
+    /**
+     * For MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING, compute the
+     * matching and scaling with an auction algorithm instead of
+     * MC64. In the sequential/multithreaded solver this runs in
+     * parallel (OpenMP), in the distributed memory solver it avoids
+     * gathering the matrix on the root. The result is optimal up to
+     * a small tolerance, and falls back to MC64 if the auction does
+     * not converge. This is disabled by default.
+     *
+     * \see disable_auction_matching(), set_matching()
+     */
+    void enable_auction_matching() { auction_matching_ = true; }
+
+    /**
+     * Always use MC64 for MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING.
+     *
+     * \see enable_auction_matching()
+     */
+    void disable_auction_matching() { auction_matching_ = false; }
+
     /**
      * Print statistics, about ranks, memory etc, for the root front
      * only.
@@ -819,6 +989,50 @@ namespace strumpack {
      */
     void set_proportional_mapping(ProportionalMapping pmap) { prop_map_ = pmap; }
 
+    /**
+     * In the distributed memory solver, with ParMETIS or PT-Scotch
+     * reordering, keep the subdomain to process assignment computed
+     * by the graph partitioner for the local subtrees, instead of
+     * remapping them with proportional mapping. The values of the
+     * rows of each subgraph are sent to its process together with
+     * the graph, right after the graph partitioning. A local subtree
+     * which stays on that process then uses these values, and its
+     * rows are not redistributed again from the input block-row
+     * distribution. Only the rows of the distributed separators, and
+     * of the subtrees moved by the load balancing, are
+     * redistributed. Where keeping the mapping would lead to a load
+     * imbalance larger than partitioner_mapping_imbalance(), the
+     * regular proportional mapping is used instead. When the matrix
+     * values are updated, all rows are redistributed.
+     *
+     * \see disable_partitioner_mapping(),
+     * set_partitioner_mapping_imbalance()
+     */
+    void enable_partitioner_mapping() { partitioner_mapping_ = true; }
+
+    /**
+     * Always use proportional mapping in the distributed memory
+     * solver, this is the default.
+     *
+     * \see enable_partitioner_mapping()
+     */
+    void disable_partitioner_mapping() { partitioner_mapping_ = false; }
+
+    /**
+     * Set the maximum allowed load imbalance when keeping the mapping
+     * from the graph partitioner. For a distributed separator, if
+     * the work per process in one of its subtrees exceeds imb times
+     * the average work per process, that separator and its subtrees
+     * are mapped using proportional mapping.
+     *
+     * \param imb load imbalance, should be >= 1
+     * \see enable_partitioner_mapping()
+     */
+    void set_partitioner_mapping_imbalance(double imb) {
+      assert(imb >= 1.);
+      partitioner_mapping_imb_ = imb;
+    }
+
     /**
      * Check if verbose output is enabled.
      * \see set_verbose()
@@ -937,6 +1151,18 @@ namespace strumpack {
      */
     bool use_agg_amalg() const { return use_agg_amalg_; }
 
+    /**
+     * Is relaxed amalgamation of the separator tree enabled?
+     * \see enable_relaxed_amalg()
+     */
+    bool use_relaxed_amalg() const { return use_relaxed_amalg_; }
+
+    /**
+     * Relative fill tolerance for relaxed amalgamation.
+     * \see set_amalg_fill_tol(), enable_relaxed_amalg()
+     */
+    double amalg_fill_tol() const { return amalg_fill_tol_; }
+
     /**
      * Get the matching job to use for numerical stability reordering.
      * \see set_matching()
@@ -1212,6 +1438,13 @@ namespace strumpack {
         -1 : lossy_accuracy_;
     }
 
+    /**
+     * Returns the panel width for lossy compression, 0 means
+     * automatic.
+     * \see set_lossy_panel_cols
+     */
+    int lossy_panel_cols() const { return lossy_panel_cols_; }
+
     /**
      * Info about the stats of the root front will be printed to
      * std::cout
@@ -1223,6 +1456,63 @@ namespace strumpack {
      */
     ProportionalMapping proportional_mapping() const { return prop_map_; }
 
+    /**
+     * Check whether the contribution blocks are compressed.
+     * \see enable_CB_compression()
+     */
+    bool CB_compression() const { return CB_compression_; }
+
+    /**
+     * Accuracy for the compression of the contribution blocks, a
+     * value <= 0 means lossless.
+     * \see set_CB_compression_accuracy()
+     */
+    double CB_compression_accuracy() const { return CB_compression_acc_; }
+
+    /**
+     * Minimum separator size for the tiled dense LU factorization.
+     * \see set_tiled_LU_min_sep_size()
+     */
+    int tiled_LU_min_sep_size() const { return tiled_LU_min_sep_size_; }
+
+    /**
+     * Tile size for the tiled dense LU factorization.
+     * \see set_tiled_LU_tile_size()
+     */
+    int tiled_LU_tile_size() const { return tiled_LU_nb_; }
+
+    /**
+     * Are the distributed dense fronts factored with the tiled LU,
+     * instead of ScaLAPACK pgetrf?
+     * \see enable_distributed_tiled_LU()
+     */
+    bool use_distributed_tiled_LU() const { return distributed_tiled_LU_; }
+
+    /**
+     * Are the front assembly maps precomputed?
+     * \see enable_assembly_maps()
+     */
+    bool use_assembly_maps() const { return assembly_maps_; }
+
+    /**
+     * Is the auction algorithm used instead of MC64?
+     * \see enable_auction_matching()
+     */
+    bool use_auction_matching() const { return auction_matching_; }
+
+    /**
+     * Check whether to keep the process mapping from the graph
+     * partitioner for the local subtrees.
+     * \see enable_partitioner_mapping()
+     */
+    bool partitioner_mapping() const { return partitioner_mapping_; }
+
+    /**
+     * Maximum load imbalance when keeping the partitioner mapping.
+     * \see set_partitioner_mapping_imbalance()
+     */
+    double partitioner_mapping_imbalance() const { return partitioner_mapping_imb_; }
+
     /**
      * Get a (const) reference to an object holding various options
      * pertaining to the HSS code, and data structures.
@@ -1319,6 +1609,8 @@ namespace strumpack {
     bool use_METIS_NodeNDP_ = false;
     bool use_MUMPS_SYMQAMD_ = false;
     bool use_agg_amalg_ = false;
+    bool use_relaxed_amalg_ = false;
+    double amalg_fill_tol_ = 0.1;
     MatchingJob matching_job_ = MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING;
     bool log_assembly_tree_ = false;
     bool replace_tiny_pivots_ = false;
@@ -1326,6 +1618,8 @@ namespace strumpack {
     bool write_root_front_ = false;
     bool print_comp_front_stats_ = false;
     ProportionalMapping prop_map_ = ProportionalMapping::FLOPS;
+    bool partitioner_mapping_ = false;
+    double partitioner_mapping_imb_ = 1.5;
     bool use_openmp_tree_ = true;
     bool use_symmetric_ = false;
     bool use_positive_definite_ = false;
@@ -1364,6 +1658,14 @@ namespace strumpack {
     int lossy_min_sep_size_ = 8;
     int lossy_precision_ = 16;
     double lossy_accuracy_ = 1e-3;
+    int lossy_panel_cols_ = 0;
+    bool CB_compression_ = false;
+    double CB_compression_acc_ = -1.;
+    int tiled_LU_min_sep_size_ = 10000;
+    int tiled_LU_nb_ = 256;
+    bool distributed_tiled_LU_ = true;
+    bool assembly_maps_ = false;
+    bool auction_matching_ = false;
 
     // ordering::NDOptions nd_opts_;
 
@@ -49,6 +49,9 @@ namespace strumpack {
     std::atomic<long long int> peak_memory(0);
     std::atomic<long long int> device_memory(0);
     std::atomic<long long int> peak_device_memory(0);
+    std::atomic<long long int> CB_memory(0);
+    std::atomic<long long int> CB_compressed_memory(0);
+    std::atomic<long long int> assembly_map_fronts(0);
 
     std::atomic<long long int> CB_sample_flops(0);
     std::atomic<long long int> sparse_sample_flops(0);
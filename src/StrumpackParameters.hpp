@@ -81,6 +81,11 @@ namespace strumpack { // these are all global variables
     extern std::atomic<long long int> peak_memory;
     extern std::atomic<long long int> device_memory;
     extern std::atomic<long long int> peak_device_memory;
+    // contribution block memory before/after compression
+    extern std::atomic<long long int> CB_memory;
+    extern std::atomic<long long int> CB_compressed_memory;
+    // fronts assembled with a precomputed FrontAssemblyMap
+    extern std::atomic<long long int> assembly_map_fronts;
 
     extern std::atomic<long long int> CB_sample_flops;
     extern std::atomic<long long int> sparse_sample_flops;
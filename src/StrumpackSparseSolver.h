@@ -107,6 +107,7 @@ typedef enum
    STRUMPACK_AND=9,
    STRUMPACK_MLF=10,
    STRUMPACK_SPECTRAL=11,
+   STRUMPACK_MLND=12,
   } STRUMPACK_REORDERING_STRATEGY;
 
 typedef enum
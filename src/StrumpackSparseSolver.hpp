@@ -49,6 +49,46 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> class MatrixReordering;
   template<typename scalar_t,typename integer_t> class EliminationTree;
   class TaskTimer;
+  template<typename scalar_t,typename integer_t> class SparseSolver;
+
+  /**
+   * \class SolveContext
+   *
+   * \brief Per-caller workspace for the const SparseSolver::solve
+   * routines.
+   *
+   * Each thread that wants to solve concurrently with a single
+   * (already factored) SparseSolver object should use its own
+   * SolveContext. The context holds the permuted right-hand side and
+   * the Krylov iteration count of the last solve done with it. It can
+   * be reused for many solves, avoiding reallocation when the number
+   * of right-hand sides does not change.
+   *
+   * \tparam scalar_t can be: float, double, std::complex<float> or
+   * std::complex<double>.
+   *
+   * \see SparseSolver::solve(const DenseMatrix<scalar_t>&,
+   * DenseMatrix<scalar_t>&, SolveContext<scalar_t>&, bool) const
+   */
+  template<typename scalar_t> class SolveContext {
+  public:
+    /**
+     * Number of Krylov iterations (or iterative refinement steps)
+     * done in the last solve using this context.
+     */
+    int Krylov_iterations() const { return Krylov_its_; }
+
+    /**
+     * Release the workspace memory.
+     */
+    void clear() { bloc_.clear(); Krylov_its_ = 0; }
+
+  private:
+    DenseMatrix<scalar_t> bloc_;
+    int Krylov_its_ = 0;
+
+    template<typename S,typename I> friend class SparseSolver;
+  };
 
   /**
    * \class SparseSolver
@@ -219,6 +259,155 @@ namespace strumpack {
      */
     void update_matrix_values(const CSRMatrix<scalar_t,integer_t>& A);
 
+    using SparseSolverBase<scalar_t,integer_t>::solve;
+
+    /**
+     * Solve a linear system with a single right-hand side, using an
+     * existing factorization. Unlike the non-const solve routines,
+     * this will not reorder or factor the matrix, so factor() (or
+     * reorder() for the non-preconditioned Krylov solvers) must have
+     * been called before. This routine does not modify the solver
+     * object, and can be called concurrently from multiple threads,
+     * as long as each thread uses its own SolveContext. No timing or
+     * statistics are printed.
+     *
+     * \param b input, will not be modified. Pointer to the right-hand
+     * side. Array should be lenght N, the dimension of the input
+     * matrix.
+     * \param x Output, pointer to the solution vector. Array should
+     * be lenght N, the dimension of the input matrix.
+     * \param ctx workspace for this solve, should not be used
+     * concurrently by another thread.
+     * \param use_initial_guess set to true if x contains an intial
+     * guess to the solution.
+     * \return error code, MATRIX_NOT_SET if the matrix was not set,
+     * or was not yet factored (reordered)
+     */
+    ReturnCode solve(const scalar_t* b, scalar_t* x,
+                     SolveContext<scalar_t>& ctx,
+                     bool use_initial_guess=false) const;
+
+    /**
+     * Solve a linear system with a single or multiple right-hand
+     * sides, using an existing factorization. This routine does not
+     * modify the solver object, and can be called concurrently from
+     * multiple threads, as long as each thread uses its own
+     * SolveContext.
+     *
+     * \param b input, will not be modified. DenseMatrix containgin
+     * the right-hand side vector/matrix. Should have N rows, with N
+     * the dimension of the input matrix.
+     * \param x Output, pointer to the solution vector. Should have N
+     * rows, and the same number of columns as b.
+     * \param ctx workspace for this solve, should not be used
+     * concurrently by another thread.
+     * \param use_initial_guess set to true if x contains an intial
+     * guess to the solution.
+     * \return error code, MATRIX_NOT_SET if the matrix was not set,
+     * or was not yet factored (reordered)
+     *
+     * \see solve(const scalar_t*, scalar_t*, SolveContext<scalar_t>&,
+     * bool) const
+     */
+    ReturnCode solve(const DenseM_t& b, DenseM_t& x,
+                     SolveContext<scalar_t>& ctx,
+                     bool use_initial_guess=false) const;
+
+    /**
+     * Mark a set of unknowns as interface unknowns, for use with
+     * Schur_complement. The reordering will put these unknowns in
+     * the root separator, in the order given by I, and the root
+     * front will always be a dense front. This has to be called
+     * before reorder (or factor/solve). The matching (MC64) permutes
+     * the columns, and is not supported with an interface: it should
+     * be disabled, with
+     * options().set_matching(MatchingJob::NONE), before calling
+     * this. Call with an empty vector to clear the interface.
+     *
+     * \param I indices (0-based, original numbering) of the
+     * interface unknowns, without duplicates
+     * \return error code, REORDERING_ERROR if the matrix was already
+     * reordered, if I is invalid, or if the matching is enabled
+     *
+     * \see Schur_complement
+     */
+    ReturnCode set_interface(const std::vector<integer_t>& I);
+
+    /**
+     * Compute the Schur complement S = A_II - A_IR A_RR^{-1} A_RI
+     * of the interface unknowns I, set with set_interface, with R all
+     * other unknowns. This reorders the matrix if needed and factors
+     * all fronts except the root. The root front, which contains
+     * exactly the interface unknowns, is assembled but not factored,
+     * and returned. The cost is that of a single partial
+     * factorization. The solver is not left in a factored state, a
+     * subsequent solve will redo the (complete) factorization.
+     *
+     * \param S output, dense |I| x |I| matrix, the rows and columns
+     * are in the order of the vector passed to set_interface
+     * \return error code
+     *
+     * \see set_interface
+     */
+    ReturnCode Schur_complement(DenseM_t& S);
+
+    /**
+     * Solve with the low-rank updated matrix A + U V^T, instead of
+     * with A, while keeping the factorization of A. This replaces any
+     * earlier low-rank update. The solves use the
+     * Sherman-Morrison-Woodbury formula
+     *
+     *   (A + U V^T)^{-1} = A^{-1} - W (I + V^T W)^{-1} V^T A^{-1}
+     *
+     * with W = A^{-1} U, computed here with a multiple right-hand
+     * side solve (this will factor A if that was not done yet), and
+     * with a small dense LU factorization of the capacitance matrix
+     * I + V^T W. The extra cost per solve is O(N k), with k the rank
+     * of the update.
+     *
+     * When the accumulated rank becomes so large that applying the
+     * correction is more expensive than a solve with the sparse
+     * factors, and if U V^T does not introduce too many new nonzeros,
+     * the update is merged in the sparse matrix, which is then
+     * reordered and refactored on the next solve. This is not done
+     * with the geometric reordering or with a permutation passed to
+     * reorder, since the reordering cannot be redone for A + U V^T.
+     *
+     * The update is cleared when a new matrix is set, or when the
+     * matrix values are updated.
+     *
+     * \param U dense N x k matrix
+     * \param V dense N x k matrix
+     * \return error code, the error code of the factorization of A
+     *
+     * \see add_low_rank_update, clear_low_rank_update
+     */
+    ReturnCode set_low_rank_update(const DenseM_t& U, const DenseM_t& V);
+
+    /**
+     * Add a low-rank term to the current low-rank update, so that
+     * subsequent solves are with A + U_0 V_0^T + U V^T. Only the new
+     * columns are solved for, see set_low_rank_update.
+     *
+     * \param U dense N x k matrix
+     * \param V dense N x k matrix
+     * \return error code, the error code of the factorization of A
+     *
+     * \see set_low_rank_update, clear_low_rank_update
+     */
+    ReturnCode add_low_rank_update(const DenseM_t& U, const DenseM_t& V);
+
+    /**
+     * Remove the low-rank update, subsequent solves will again be
+     * with A only.
+     */
+    void clear_low_rank_update();
+
+    /**
+     * Rank of the current low-rank update, see set_low_rank_update.
+     */
+    std::size_t low_rank_update_rank() const { return lrU_.cols(); }
+
   private:
     void setup_tree() override;
     void setup_reordering() override;
@@ -226,6 +415,7 @@ namespace strumpack {
                            int nx, int ny, int nz,
                            int components, int width) override;
     void separator_reordering() override;
+    void setup_assembly_maps() override;
 
     SpMat_t* matrix() override { return mat_.get(); }
     Reord_t* reordering() override { return nd_.get(); }
@@ -235,21 +425,35 @@ namespace strumpack {
     const Tree_t* tree() const override { return tree_.get(); }
 
     void permute_matrix_values();
+    void check_pattern(const CSRMatrix<scalar_t,integer_t>& old);
 
     ReturnCode solve_internal(const scalar_t* b, scalar_t* x,
                               bool use_initial_guess=false) override;
     ReturnCode solve_internal(const DenseM_t& b, DenseM_t& x,
                               bool use_initial_guess=false) override;
+    ReturnCode solve_internal(const DenseM_t& b, DenseM_t& x,
+                              SolveContext<scalar_t>& ctx,
+                              bool use_initial_guess) const;
 
     void delete_factors_internal() override;
 
-    void transform_x0(DenseM_t& x, DenseM_t& xtmp);
-    void transform_b(const DenseM_t& b, DenseM_t& bloc);
-    void transform_x(DenseM_t& x, DenseM_t& xtmp);
+    void low_rank_correction(DenseM_t& x) const;
+    bool merge_low_rank_update();
+
+    void transform_x0(DenseM_t& x, DenseM_t& xtmp) const;
+    void transform_b(const DenseM_t& b, DenseM_t& bloc) const;
+    void transform_x(DenseM_t& x, DenseM_t& xtmp) const;
 
     std::unique_ptr<CSRMatrix<scalar_t,integer_t>> mat_;
     std::unique_ptr<MatrixReordering<scalar_t,integer_t>> nd_;
     std::unique_ptr<EliminationTree<scalar_t,integer_t>> tree_;
+    std::vector<integer_t> interface_;
+    // the fill-reducing permutation was passed to reorder(p)
+    bool user_perm_ = false;
+    // low-rank update U V^T, with W = A^{-1} U and the LU factors
+    // (with pivots lrpiv_) of the capacitance matrix I + V^T W
+    DenseM_t lrU_, lrV_, lrW_, lrC_;
+    std::vector<int> lrpiv_;
 
     using SPBase_t = SparseSolverBase<scalar_t,integer_t>;
     using SPBase_t::opts_;
@@ -150,11 +150,52 @@ namespace strumpack {
      */
     int Krylov_iterations() const { return Krylov_its_; }
 
+    /**
+     * Store the factors in a precision lower than factor_t. The
+     * fronts are still factored in factor_t, but with BFLOAT16 the
+     * factors (of all but the smallest fronts) are then rounded to
+     * bfloat16 and stored using the lossy front compression. This
+     * halves the factor memory, and the memory traffic in the
+     * triangular solves. Since this sets the compression type of the
+     * inner solver to CompressionType::LOSSY, it should be called
+     * before reorder() or factor(). Setting FULL again resets the
+     * compression type to CompressionType::NONE.
+     *
+     * With reduced storage precision, the default outer solver,
+     * KrylovSolver::AUTO, uses GMRES based iterative refinement
+     * (GMRES-IR): the residual is computed in refine_t, and each
+     * correction is computed with GMRES in refine_t, preconditioned
+     * with the reduced precision factors. When the refinement
+     * stalls, the matrix is reordered and refactored with dense
+     * fronts, ie, with the factors in full factor_t precision, and
+     * the refinement continues from the current solution.
+     *
+     * \param p FULL or BFLOAT16, SINGLE is the same as FULL since
+     * factor_t is already single precision
+     */
+    void set_factor_storage_precision(StoragePrecision p);
+
+    /**
+     * Precision used to store the factors. This is FULL after
+     * GMRES-IR fell back to full precision factors.
+     */
+    StoragePrecision factor_storage_precision() const { return fprec_; }
+
   private:
     CSRMatrix<refine_t,integer_t> mat_;
     SparseSolver<factor_t,integer_t> solver_;
     SPOptions<refine_t> opts_;
     int Krylov_its_ = 0;
+    bool lower_ = false;
+    StoragePrecision fprec_ = StoragePrecision::FULL;
+    // arguments of the last reorder call, to reorder again in
+    // increase_factor_precision
+    int nx_ = 1, ny_ = 1, nz_ = 1;
+
+    void inner_solve(DenseMatrix<refine_t>& w);
+    ReturnCode GMRES_IR(const DenseMatrix<refine_t>& b,
+                        DenseMatrix<refine_t>& x, bool use_initial_guess);
+    bool increase_factor_precision();
   };
 
   template<typename factor_t,typename refine_t,typename integer_t>
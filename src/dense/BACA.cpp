@@ -56,10 +56,10 @@ namespace strumpack {
     for (; rank<d; rank++) if (std::abs(W(rank,rank)) < sfmin) break;
 #endif
     blas::lapmt(true, C.rows(), C.cols(), C.data(), C.ld(), piv);
-    // R = T^{-1} Q^T R
+    // R = T^{-1} Q^H R
     blas::xxmqr
-      ('L', 'T', d, R.cols(), rank, W.data(), W.ld(), tau,
-       R.data(), R.ld());
+      ('L', is_complex<scalar_t>() ? 'C' : 'T', d, R.cols(), rank,
+       W.data(), W.ld(), tau, R.data(), R.ld());
     blas::trsm
       ('L', 'U', 'N', 'N', rank, R.cols(), scalar_t(1.),
        W.data(), W.ld(), R.data(), R.ld());
@@ -162,6 +162,8 @@ namespace strumpack {
       //std::cout << "WARNING copying a BLACS grid is expensive!!" << std::endl;
       comm_ = grid.Comm();
       P_ = grid.P();
+      row_comm_.reset();
+      col_comm_.reset();
       setup();
       return *this;
     }
@@ -187,6 +189,8 @@ namespace strumpack {
       grid.ctxt_ = -1;
       grid.ctxt_all_ = -1;
       grid.ctxt_T_ = -1;
+      row_comm_ = std::move(grid.row_comm_);
+      col_comm_ = std::move(grid.col_comm_);
       return *this;
     }
 
@@ -300,6 +304,36 @@ namespace strumpack {
       else return Comm();
     }
 
+    /**
+     * Return a communicator with the active processes in the same
+     * processor row as this rank, ordered by processor column. It is
+     * created on first use, which is collective on all active ranks
+     * of the grid, and then kept for the lifetime of the grid. Should
+     * only be called on active ranks.
+     *
+     * \see col_comm, active
+     */
+    const MPIComm& row_comm() const {
+      if (!row_comm_)
+        row_comm_.reset(new MPIComm(Comm_active().split(prow_, pcol_)));
+      return *row_comm_;
+    }
+
+    /**
+     * Return a communicator with the active processes in the same
+     * processor column as this rank, ordered by processor row. It is
+     * created on first use, which is collective on all active ranks
+     * of the grid, and then kept for the lifetime of the grid. Should
+     * only be called on active ranks.
+     *
+     * \see row_comm, active
+     */
+    const MPIComm& col_comm() const {
+      if (!col_comm_)
+        col_comm_.reset(new MPIComm(Comm_active().split(pcol_, prow_)));
+      return *col_comm_;
+    }
+
   private:
     MPIComm comm_;
     int P_ = -1;
@@ -311,6 +345,7 @@ namespace strumpack {
     int prow_ = -1;
     int pcol_ = -1;
     std::unique_ptr<MPIComm> active_comm_;
+    mutable std::unique_ptr<MPIComm> row_comm_, col_comm_;
 
     void setup() {
       layout(P_, nprows_, npcols_);
@@ -344,6 +379,7 @@ namespace strumpack {
       std::swap(ctxt_, ctxt_T_);
       std::swap(nprows_, npcols_);
       std::swap(prow_, pcol_);
+      std::swap(row_comm_, col_comm_);
     }
 
     friend std::ostream& operator<<(std::ostream& os, const BLACSGrid* g);
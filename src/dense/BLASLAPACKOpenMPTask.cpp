@@ -26,6 +26,9 @@
  *             Division).
  *
  */
+#include <vector>
+#include <memory>
+
 #include "BLASLAPACKOpenMPTask.hpp"
 #include "StrumpackFortranCInterface.h"
 
@@ -531,6 +534,142 @@ namespace strumpack {
   }
 
 
+  // Select w pivot rows from the rows r of the m x w panel p using
+  // partial pivoting, returns the selected rows in pivot order.
+  template<typename scalar> std::vector<int>
+  calu_select_rows(int w, const scalar* p, int lda,
+                   const std::vector<int>& r) {
+    int h = r.size(), k = std::min(h, w);
+    std::vector<scalar> B(std::size_t(h)*w);
+    for (int j=0; j<w; j++)
+      for (int i=0; i<h; i++)
+        B[i+j*h] = p[r[i]+j*lda];
+    std::vector<int> piv(k), sel(r);
+    blas::getrf(h, w, B.data(), h, piv.data());
+    for (int i=0; i<k; i++)
+      std::swap(sel[i], sel[piv[i]-1]);
+    sel.resize(k);
+    return sel;
+  }
+
+  // LU factorization of the m x w (m >= w) panel p, with the pivots
+  // selected by tournament pivoting (CALU): the rows are split over
+  // the leaves, each leaf selects w candidate rows with partial
+  // pivoting, and the candidates are merged pairwise in a reduction
+  // tree. The interchanges are returned in ipiv as in getrf.
+  template<typename scalar> int
+  calu_panel(int m, int w, scalar* p, int lda, int* ipiv, int leaves) {
+    leaves = std::max(1, std::min(leaves, m / (2*w)));
+    if (leaves == 1)
+      return blas::getrf(m, w, p, lda, ipiv);
+    std::vector<std::vector<int>> cand(leaves);
+    int h = (m + leaves - 1) / leaves;
+    for (int l=0; l<leaves; l++) {
+#pragma omp task default(shared) firstprivate(l)
+      {
+        std::vector<int> r;
+        for (int i=l*h; i<std::min(m, (l+1)*h); i++)
+          r.push_back(i);
+        cand[l] = calu_select_rows(w, p, lda, r);
+      }
+    }
+#pragma omp taskwait
+    for (int d=1; d<leaves; d*=2) {
+      for (int l=0; l+d<leaves; l+=2*d) {
+#pragma omp task default(shared) firstprivate(l,d)
+        {
+          auto r = cand[l];
+          r.insert(r.end(), cand[l+d].begin(), cand[l+d].end());
+          cand[l] = calu_select_rows(w, p, lda, r);
+        }
+      }
+#pragma omp taskwait
+    }
+    // factor the selected rows, this also determines their final
+    // order
+    auto& sel = cand[0];
+    std::vector<scalar> T(std::size_t(w)*w);
+    for (int j=0; j<w; j++)
+      for (int i=0; i<w; i++)
+        T[i+j*w] = p[sel[i]+j*lda];
+    std::vector<int> tpiv(w);
+    int info = blas::getrf(w, w, T.data(), w, tpiv.data());
+    for (int i=0; i<w; i++)
+      std::swap(sel[i], sel[tpiv[i]-1]);
+    // move the selected rows to the top of the panel
+    std::vector<int> row(m), pos(m);
+    for (int i=0; i<m; i++) row[i] = pos[i] = i;
+    for (int i=0; i<w; i++) {
+      int j = pos[sel[i]];
+      ipiv[i] = j + 1;
+      std::swap(row[i], row[j]);
+      pos[row[i]] = i;
+      pos[row[j]] = j;
+    }
+    blas::laswp(w, p, lda, 1, w, ipiv, 1);
+    for (int j=0; j<w; j++)
+      for (int i=0; i<w; i++)
+        p[i+j*lda] = T[i+j*w];
+    blas::trsm('R', 'U', 'N', 'N', m-w, w, scalar(1.), p, lda, p+w, lda);
+    return info;
+  }
+
+  // tiled right-looking LU, with tournament pivoting for the panels
+  // and OpenMP task dependencies on tile columns, so that the
+  // factorization of the next panel overlaps with the trailing
+  // update (lookahead)
+  template<typename scalar>
+  int getrf_tiled_omp_task(int m, int n, scalar* a, int lda, int* ipiv,
+                           int nb, int depth) {
+#if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+    int mn = std::min(m, n), K = (mn + nb - 1) / nb, N = (n + nb - 1) / nb;
+    if (depth >= params::task_recursion_cutoff_level || K < 2)
+      return getrf_omp_task(m, n, a, lda, ipiv, depth);
+    int info = 0, leaves = params::num_threads;
+    std::unique_ptr<char[]> B(new char[N]);
+    auto col = B.get();
+#pragma omp taskgroup
+    {
+      for (int k=0; k<K; k++) {
+        int k0 = k*nb, w = std::min(nb, mn-k0);
+#pragma omp task default(shared) firstprivate(k,k0,w)  \
+  depend(inout:col[k]) priority(N)
+        {
+          int ierr = calu_panel
+            (m-k0, w, a+k0+std::size_t(k0)*lda, lda, ipiv+k0, leaves);
+          if (ierr && !info) info = ierr + k0;
+          for (int i=k0; i<k0+w; i++) ipiv[i] += k0;
+        }
+        for (int j=k+1; j<N; j++) {
+          int j0 = j*nb, nj = std::min(nb, n-j0);
+#pragma omp task default(shared) firstprivate(k,k0,w,j,j0,nj)  \
+  depend(in:col[k]) depend(inout:col[j]) priority(N-j)
+          {
+            auto akj = a + k0 + std::size_t(j0)*lda;
+            blas::laswp(nj, a+std::size_t(j0)*lda, lda, k0+1, k0+w, ipiv, 1);
+            blas::trsm('L', 'L', 'N', 'U', w, nj, scalar(1.),
+                       a+k0+std::size_t(k0)*lda, lda, akj, lda);
+            if (m > k0+w)
+              blas::gemm('N', 'N', m-k0-w, nj, w, scalar(-1.),
+                         a+k0+w+std::size_t(k0)*lda, lda, akj, lda,
+                         scalar(1.), akj+w, lda);
+          }
+        }
+      }
+    }
+    // apply the interchanges from the later panels to the L factor
+    for (int k=0; k<K-1; k++) {
+#pragma omp task default(shared) firstprivate(k)
+      blas::laswp(nb, a+std::size_t(k)*nb*lda, lda,
+                  (k+1)*nb+1, mn, ipiv, 1);
+    }
+#pragma omp taskwait
+    return info;
+#else
+    return getrf_omp_task(m, n, a, lda, ipiv, depth);
+#endif
+  }
+
   template<typename scalar>
   int getrs_omp_task(char t, int m, int n, const scalar *a, int lda,
                      const int* piv, scalar *b, int ldb,
@@ -597,6 +736,11 @@ namespace strumpack {
   template int getrf_omp_task(int m, int n, std::complex<float>* a, int lda, int* ipiv, int depth);
   template int getrf_omp_task(int m, int n, std::complex<double>* a, int lda, int* ipiv, int depth);
 
+  template int getrf_tiled_omp_task(int m, int n, float* a, int lda, int* ipiv, int nb, int depth);
+  template int getrf_tiled_omp_task(int m, int n, double* a, int lda, int* ipiv, int nb, int depth);
+  template int getrf_tiled_omp_task(int m, int n, std::complex<float>* a, int lda, int* ipiv, int nb, int depth);
+  template int getrf_tiled_omp_task(int m, int n, std::complex<double>* a, int lda, int* ipiv, int nb, int depth);
+
   template int getrs_omp_task(char t, int m, int n, const float *a, int lda, const int* piv, float *b, int ldb, int depth);
   template int getrs_omp_task(char t, int m, int n, const double *a, int lda, const int* piv, double *b, int ldb, int depth);
   template int getrs_omp_task(char t, int m, int n, const std::complex<float> *a, int lda, const int* piv, std::complex<float> *b, int ldb, int depth);
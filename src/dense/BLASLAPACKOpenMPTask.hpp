@@ -43,6 +43,7 @@ namespace strumpack {
   template<typename scalar> void trsm_omp_task(char s, char ul, char ta, char d, int m, int n, scalar alpha, const scalar* a, int lda, scalar* b, int ldb, int depth);
   template<typename scalar> void laswp_omp_task(int n, scalar* a, int lda, int k1, int k2, const int* ipiv, int incx, int depth);
   template<typename scalar> int getrf_omp_task(int m, int n, scalar* a, int lda, int* ipiv, int depth);
+  template<typename scalar> int getrf_tiled_omp_task(int m, int n, scalar* a, int lda, int* ipiv, int nb, int depth);
   template<typename scalar> int getrs_omp_task(char t, int m, int n, const scalar *a, int lda, const int* piv, scalar *b, int ldb, int depth);
 
 } // end namespace strumpack
@@ -588,6 +588,20 @@ namespace strumpack {
       return blas::getrf(rows(), cols(), data(), ld(), piv.data());
   }
 
+  template<typename scalar_t> int
+  DenseMatrix<scalar_t>::LU_tiled(std::vector<int>& piv, int nb, int depth) {
+#if defined(_OPENMP)
+    bool in_par = depth < params::task_recursion_cutoff_level
+      && omp_in_parallel();
+#else
+    bool in_par = false;
+#endif
+    if (!in_par) return LU(piv, depth);
+    piv.resize(rows());
+    return getrf_tiled_omp_task
+      (rows(), cols(), data(), ld(), piv.data(), nb, depth);
+  }
+
   template<typename scalar_t> int
   DenseMatrix<scalar_t>::Cholesky(int depth) {
     assert(rows() == cols());
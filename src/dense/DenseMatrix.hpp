@@ -701,6 +701,24 @@ namespace strumpack {
      */
     int LU(std::vector<int>& piv, int depth=0);
 
+    /**
+     * Compute an LU factorization of this matrix, with the same
+     * output as LU(std::vector<int>&,int), using a tiled algorithm
+     * with tiles of size nb x nb. The pivots for each column panel
+     * are selected with tournament pivoting (CALU), and the panel
+     * factorizations overlap with the trailing updates through OpenMP
+     * task dependencies. This is meant for large matrices, and falls
+     * back to LU(std::vector<int>&,int) when not called from within
+     * an OpenMP parallel region.
+     *
+     * \param piv pivot vector, will be resized if necessary
+     * \param nb tile size
+     * \param depth current OpenMP task recursion depth
+     * \return if nonzero, the pivot in this column was exactly zero
+     * \see LU, laswp, solve
+     */
+    int LU_tiled(std::vector<int>& piv, int nb, int depth=0);
+
     /**
      * Compute an LU factorization of this matrix using partial
      * pivoting with row interchanges. The factorization has the form
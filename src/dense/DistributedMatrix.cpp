@@ -27,6 +27,8 @@
  */
 
 #include <limits>
+#include <map>
+#include <numeric>
 #include <iomanip>
 #include <fstream>
 
@@ -907,10 +909,8 @@ namespace strumpack {
   template<typename scalar_t> std::vector<int>
   DistributedMatrix<scalar_t>::LU() {
     if (!active()) return std::vector<int>();
-    STRUMPACK_FLOPS(LU_flops(*this));
-    std::vector<int> ipiv(lrows()+MB());
-    int info = scalapack::pgetrf
-      (rows(), cols(), data(), I(), J(), desc(), ipiv.data());
+    std::vector<int> ipiv;
+    int info = LU(ipiv);
     if (info) {
       std::cerr << "ERROR: LU factorization of DistributedMatrix failed"
                 << " with info = " << info << std::endl;
@@ -921,6 +921,12 @@ namespace strumpack {
 
   template<typename scalar_t> int
   DistributedMatrix<scalar_t>::LU(std::vector<int>& piv) {
+    // LU_tiled falls back to LU_scalapack when it does not apply
+    return LU_tiled(piv);
+  }
+
+  template<typename scalar_t> int
+  DistributedMatrix<scalar_t>::LU_scalapack(std::vector<int>& piv) {
     if (!active()) return 0;
     STRUMPACK_FLOPS(LU_flops(*this));
     piv.resize(lrows()+MB());
@@ -928,6 +934,210 @@ namespace strumpack {
       (rows(), cols(), data(), I(), J(), desc(), piv.data());
   }
 
+  template<typename scalar_t> int
+  DistributedMatrix<scalar_t>::LU_tiled(std::vector<int>& piv) {
+    if (!active()) return 0;
+    if (MB() != NB() || I() != 1 || J() != 1 || desc()[6] || desc()[7])
+      return LU_scalapack(piv);
+    STRUMPACK_FLOPS(LU_flops(*this));
+    const int m = rows(), n = cols(), mn = std::min(m, n), nb = MB(),
+      P = nprows(), Q = npcols(), pr = prow(), pc = pcol(),
+      K = (mn + nb - 1) / nb;
+    const std::size_t lda = ld();
+    auto A = data();
+    // number of local rows (columns) with global index < g
+    auto lcnt = [nb](int g, int p, int np) {
+      int b = g / nb, c = ((b + np - 1 - p) / np) * nb;
+      return (b % np == p) ? c + g % nb : c;
+    };
+    const int lm = lcnt(m, pr, P), ln = lcnt(n, pc, Q);
+    const auto& rowc = grid()->row_comm();
+    const auto& colc = grid()->col_comm();
+    std::vector<int> gpiv(mn);
+    std::vector<scalar_t> T, L, U;
+    int info = 0;
+
+    // Select the pivots for panel k with tournament pivoting over the
+    // process column owning the panel. Every process in that column
+    // ends up with the same pivots (in gpiv) and the same factored
+    // diagonal block T.
+    auto panel = [&](int k) {
+      const int k0 = k*nb, w = std::min(nb, mn-k0), r0 = lcnt(k0, pr, P),
+        c0 = lcnt(k0, pc, Q), h = lm - r0, ck = std::min(h, w);
+      std::vector<int> lsel(h);
+      std::iota(lsel.begin(), lsel.end(), 0);
+      if (h) {
+        DenseMatrix<scalar_t> B(h, w);
+        for (int j=0; j<w; j++)
+          for (int i=0; i<h; i++)
+            B(i, j) = A[r0+i+(c0+j)*lda];
+        std::vector<int> bpiv(ck);
+        blas::getrf(h, w, B.data(), h, bpiv.data());
+        for (int i=0; i<ck; i++)
+          std::swap(lsel[i], lsel[bpiv[i]-1]);
+      }
+      std::vector<int> cnt(P), dsp(P);
+      cnt[pr] = ck;
+      colc.all_gather(cnt.data(), 1);
+      std::partial_sum(cnt.begin(), cnt.end()-1, dsp.begin()+1);
+      int c = dsp[P-1] + cnt[P-1];
+      std::vector<int> grows(c);
+      for (int i=0; i<ck; i++)
+        grows[dsp[pr]+i] = rowl2g(r0+lsel[i]);
+      colc.all_gather_v(grows.data(), cnt.data(), dsp.data());
+      // candidate rows are stored row-major
+      std::vector<scalar_t> cand(std::size_t(c)*w);
+      for (int i=0; i<ck; i++)
+        for (int j=0; j<w; j++)
+          cand[(dsp[pr]+i)*w+j] = A[r0+lsel[i]+(c0+j)*lda];
+      for (int p=0; p<P; p++) { cnt[p] *= w; dsp[p] *= w; }
+      colc.all_gather_v(cand.data(), cnt.data(), dsp.data());
+      DenseMatrix<scalar_t> S(c, w);
+      for (int i=0; i<c; i++)
+        for (int j=0; j<w; j++)
+          S(i, j) = cand[std::size_t(i)*w+j];
+      std::vector<int> spiv(w);
+      int ierr = blas::getrf(c, w, S.data(), c, spiv.data());
+      if (ierr && !info) info = k0 + ierr;
+      for (int i=0; i<w; i++)
+        std::swap(grows[i], grows[spiv[i]-1]);
+      // the interchanges that bring the selected rows to the top
+      std::map<int,int> at, where;
+      auto row_at = [&](int x) { auto it = at.find(x);
+        return it == at.end() ? x : it->second; };
+      auto pos_of = [&](int g) { auto it = where.find(g);
+        return it == where.end() ? g : it->second; };
+      for (int i=0; i<w; i++) {
+        int t = k0 + i, p = pos_of(grows[i]), rt = row_at(t);
+        gpiv[t] = p + 1;
+        at[p] = rt;   where[rt] = p;
+        at[t] = grows[i];  where[grows[i]] = t;
+      }
+      T.resize(std::size_t(w)*w);
+      for (int j=0; j<w; j++)
+        for (int i=0; i<w; i++)
+          T[i+j*w] = S(i, j);
+    };
+
+    // update of local columns [cb, ce) with the broadcasted L and U
+    // panels
+    auto update = [&](int r1, int cj, int w, int cb, int ce) {
+      if (lm > r1 && ce > cb)
+        blas::gemm('N', 'N', lm-r1, ce-cb, w, scalar_t(-1.),
+                   L.data(), lm-r1, U.data()+std::size_t(cb-cj)*w, w,
+                   scalar_t(1.), A+r1+cb*lda, lda);
+    };
+
+    // the pivots, the diagonal block and info of panel k go to all
+    // processes, with a non-blocking broadcast from the process
+    // column owning the panel
+    int info_k = 0;
+    std::vector<MPIRequest> preq;
+    auto bcast_panel = [&](int k) {
+      const int k0 = k*nb, w = std::min(nb, mn-k0), pck = k % Q;
+      T.resize(std::size_t(w)*w);
+      info_k = info;
+      preq.push_back(rowc.ibroadcast_from(gpiv.data()+k0, w, pck));
+      preq.push_back(rowc.ibroadcast_from(T.data(), T.size(), pck));
+      preq.push_back(rowc.ibroadcast_from(&info_k, 1, pck));
+    };
+
+#pragma omp parallel if(!omp_in_parallel())
+#pragma omp master
+    {
+      if (K) {
+        if (pc == 0) panel(0);
+        bcast_panel(0);
+      }
+      for (int k=0; k<K; k++) {
+        const int k0 = k*nb, w = std::min(nb, mn-k0), pck = k % Q,
+          prk = k % P, r0 = lcnt(k0, pr, P), r1 = lcnt(k0+w, pr, P),
+          c0 = lcnt(k0, pc, Q), cj = lcnt(k0+w, pc, Q);
+        wait_all(preq);
+        preq.clear();
+        if (!info) info = info_k;
+        { // apply the interchanges to all local columns
+          std::map<int,int> src;
+          auto src_of = [&](int x) { auto it = src.find(x);
+            return it == src.end() ? x : it->second; };
+          for (int i=0; i<w; i++) {
+            int t = k0 + i, p = gpiv[t] - 1;
+            if (p == t) continue;
+            int st = src_of(t), sp = src_of(p);
+            src[t] = sp;  src[p] = st;
+          }
+          auto owner = [&](int g) { return (g / nb) % P; };
+          std::vector<std::vector<scalar_t>> sbuf(P);
+          for (auto& xs : src)
+            if (xs.first != xs.second && owner(xs.second) == pr) {
+              auto& b = sbuf[owner(xs.first)];
+              auto lr = rowg2l(xs.second);
+              for (int j=0; j<ln; j++) b.push_back(A[lr+j*lda]);
+            }
+          std::vector<scalar_t> rbuf;
+          std::vector<scalar_t*> pbuf;
+          colc.all_to_all_v(sbuf, rbuf, pbuf);
+          for (auto& xs : src)
+            if (xs.first != xs.second && owner(xs.first) == pr) {
+              auto& b = pbuf[owner(xs.second)];
+              auto lr = rowg2l(xs.first);
+              for (int j=0; j<ln; j++) A[lr+j*lda] = *b++;
+            }
+        }
+        L.resize(std::size_t(lm-r1)*w);
+        if (pc == pck) {
+          if (pr == prk)
+            for (int j=0; j<w; j++)
+              for (int i=0; i<w; i++)
+                A[r0+i+(c0+j)*lda] = T[i+j*w];
+          if (lm > r1)
+            blas::trsm('R', 'U', 'N', 'N', lm-r1, w, scalar_t(1.),
+                       T.data(), w, A+r1+c0*lda, lda);
+          for (int j=0; j<w; j++)
+            std::copy(A+r1+(c0+j)*lda, A+lm+(c0+j)*lda,
+                      L.data()+std::size_t(lm-r1)*j);
+        }
+        rowc.broadcast_from(L.data(), L.size(), pck);
+        U.resize(std::size_t(w)*(ln-cj));
+        if (pr == prk) {
+          if (ln > cj)
+            blas::trsm('L', 'L', 'N', 'U', w, ln-cj, scalar_t(1.),
+                       T.data(), w, A+r0+cj*lda, lda);
+          for (int j=cj; j<ln; j++)
+            std::copy(A+r0+j*lda, A+r0+w+j*lda,
+                      U.data()+std::size_t(j-cj)*w);
+        }
+        colc.broadcast_from(U.data(), U.size(), prk);
+        // lookahead: the process column owning the next panel first
+        // updates that panel, and factors it while the rest of the
+        // trailing matrix is updated
+        int cla = cj;
+        bool la = k+1 < K && pc == (k+1) % Q;
+        if (la) {
+          cla = std::min(ln, cj+nb);
+          update(r1, cj, w, cj, cla);
+        }
+        for (int cb=cla; cb<ln; cb+=nb) {
+#pragma omp task default(shared) firstprivate(cb,r1,cj,w)
+          update(r1, cj, w, cb, std::min(ln, cb+nb));
+        }
+        // the next panel is broadcast while the trailing update tasks
+        // run, T is no longer needed for this step
+        if (k+1 < K) {
+          if (la) panel(k+1);
+          bcast_panel(k+1);
+        }
+#pragma omp taskwait
+      }
+    }
+    piv.resize(lrows()+MB());
+    for (int lr=0; lr<lm; lr++) {
+      auto g = rowl2g(lr);
+      piv[lr] = (g < mn) ? gpiv[g] : g+1;
+    }
+    return info;
+  }
+
   // Solve a system of linear equations with B as right hand side.
   // assumption: the current matrix should have been factored using LU.
   template<typename scalar_t> DistributedMatrix<scalar_t>
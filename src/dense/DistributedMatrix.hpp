@@ -660,8 +660,57 @@ namespace strumpack {
     DenseMatrix<scalar_t> dense() const;
     DenseMatrixWrapper<scalar_t> dense_wrapper();
 
+    /**
+     * LU factorization, exits with an error message if a pivot is
+     * exactly zero. This calls LU(std::vector<int>&).
+     *
+     * \return local pivot vector, in the ScaLAPACK format
+     */
     std::vector<int> LU();
-    int LU(std::vector<int>&);
+
+    /**
+     * LU factorization. This uses LU_tiled when MB() == NB() and this
+     * is not a submatrix (I() == J() == 1), otherwise it uses
+     * ScaLAPACK pgetrf, see LU_scalapack.
+     *
+     * \param piv local pivot vector, in the ScaLAPACK format, will be
+     * resized
+     * \return if nonzero, the pivot in this column was exactly zero
+     */
+    int LU(std::vector<int>& piv);
+
+    /**
+     * LU factorization with partial pivoting, with ScaLAPACK pgetrf.
+     *
+     * \param piv local pivot vector, will be resized
+     * \return if nonzero, the pivot in this column was exactly zero
+     * \see LU, SPOptions::disable_distributed_tiled_LU
+     */
+    int LU_scalapack(std::vector<int>& piv);
+
+    /**
+     * LU factorization with the same output format as LU_scalapack,
+     * ie., the local pivot vector is in the ScaLAPACK format and can
+     * be used with solve or laswp. This does not use ScaLAPACK
+     * pgetrf, but a tiled right-looking algorithm on the MB x NB
+     * blocks: the pivots of each column panel are selected with
+     * tournament pivoting (CALU) over the process column, so they
+     * differ from those of partial pivoting when there is more than
+     * one process row. The process column owning the next panel
+     * factors it while the trailing matrix is updated, with OpenMP
+     * tasks per local tile column, and the pivots and diagonal block
+     * of that panel are sent along the grid rows with a non-blocking
+     * broadcast, overlapping with the update. The L and U panels are
+     * sent with blocking broadcasts along the grid rows and columns
+     * of BLACSGrid::row_comm and BLACSGrid::col_comm. This falls
+     * back to LU_scalapack unless MB() == NB() and this is not a
+     * submatrix (I() == J() == 1).
+     *
+     * \param piv local pivot vector, will be resized
+     * \return if nonzero, the pivot in this column was exactly zero
+     * \see LU, SPOptions::enable_distributed_tiled_LU
+     */
+    int LU_tiled(std::vector<int>& piv);
 
     DistributedMatrix<scalar_t>
     solve(const DistributedMatrix<scalar_t>& b,
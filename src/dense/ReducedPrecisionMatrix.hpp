@@ -0,0 +1,275 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/*!
+ * \file ReducedPrecisionMatrix.hpp
+ * \brief Contains the ReducedPrecisionMatrix class, a read-only
+ * dense matrix stored in a lower floating point precision.
+ */
+#ifndef REDUCED_PRECISION_MATRIX_HPP
+#define REDUCED_PRECISION_MATRIX_HPP
+
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+#include <cassert>
+#include <complex>
+#include <string>
+
+#include "DenseMatrix.hpp"
+
+namespace strumpack {
+
+  /**
+   * Floating point format used to store (parts of) a compressed
+   * matrix. FULL means the working precision of the matrix, ie,
+   * scalar_t. SINGLE is IEEE single precision, BFLOAT16 is the 16
+   * bit brain floating point format (8 bit exponent, 7 bit
+   * mantissa). For complex matrices, the real and imaginary parts
+   * are stored separately in the given format.
+   * \ingroup Enumerations
+   */
+  enum class StoragePrecision { FULL, SINGLE, BFLOAT16 };
+
+  inline std::string get_name(StoragePrecision p) {
+    switch (p) {
+    case StoragePrecision::FULL: return "full";
+    case StoragePrecision::SINGLE: return "single";
+    case StoragePrecision::BFLOAT16: return "bfloat16";
+    default: return "unknown";
+    }
+  }
+
+  /**
+   * Unit roundoff of the storage precision p, for a matrix with
+   * working precision real_t.
+   */
+  template<typename real_t> real_t unit_roundoff(StoragePrecision p) {
+    switch (p) {
+    case StoragePrecision::SINGLE:
+      return std::max(real_t(std::numeric_limits<float>::epsilon()/2),
+                      std::numeric_limits<real_t>::epsilon()/2);
+    case StoragePrecision::BFLOAT16: return real_t(1./256.);
+    case StoragePrecision::FULL:
+    default: return std::numeric_limits<real_t>::epsilon()/2;
+    }
+  }
+
+  /**
+   * Return the lowest storage precision, not lower than lowest,
+   * which can be used to store a matrix with (Frobenius) norm nrm,
+   * such that the rounding error is at most tol. This returns FULL
+   * if SINGLE (or BFLOAT16) does not save memory compared to the
+   * working precision real_t.
+   */
+  template<typename real_t> StoragePrecision
+  select_storage_precision(real_t nrm, real_t tol, StoragePrecision lowest) {
+    if (lowest == StoragePrecision::FULL) return StoragePrecision::FULL;
+    if (lowest == StoragePrecision::BFLOAT16 &&
+        unit_roundoff<real_t>(StoragePrecision::BFLOAT16) * nrm <= tol)
+      return StoragePrecision::BFLOAT16;
+    if (sizeof(real_t) > sizeof(float) &&
+        unit_roundoff<real_t>(StoragePrecision::SINGLE) * nrm <= tol)
+      return StoragePrecision::SINGLE;
+    return StoragePrecision::FULL;
+  }
+
+  /**
+   * \class ReducedPrecisionMatrix
+   * \brief Read-only dense column major matrix, stored in single
+   * precision or bfloat16.
+   *
+   * This is meant to store parts of a (compressed) factorization
+   * which are only used in matrix-vector or matrix-matrix products,
+   * for instance during the triangular solve. The elements are
+   * converted back to scalar_t on the fly, and all arithmetic is
+   * performed in the working precision scalar_t, so only the
+   * storage (and the memory traffic) is reduced.
+   *
+   * \tparam scalar_t float, double, std::complex<float> or
+   * std::complex<double>, the working precision.
+   */
+  template<typename scalar_t> class ReducedPrecisionMatrix {
+    using real_t = typename RealType<scalar_t>::value_type;
+    using DenseM_t = DenseMatrix<scalar_t>;
+
+  public:
+    ReducedPrecisionMatrix() = default;
+
+    /**
+     * Store a copy of A in precision p. Precision p should be
+     * SINGLE or BFLOAT16.
+     */
+    ReducedPrecisionMatrix(const DenseM_t& A, StoragePrecision p)
+      : rows_(A.rows()), cols_(A.cols()), prec_(p) {
+      assert(p != StoragePrecision::FULL);
+      const std::size_t nr = rows_ * cols_ * reals();
+      if (prec_ == StoragePrecision::SINGLE) sp_.resize(nr);
+      else bf_.resize(nr);
+      for (std::size_t j=0, k=0; j<cols_; j++)
+        for (std::size_t i=0; i<rows_; i++, k+=reals())
+          set(k, A(i, j));
+    }
+
+    std::size_t rows() const { return rows_; }
+    std::size_t cols() const { return cols_; }
+    StoragePrecision precision() const { return prec_; }
+
+    /**
+     * Memory in bytes used to store this matrix.
+     */
+    std::size_t memory() const {
+      return sp_.size() * sizeof(float) + bf_.size() * sizeof(std::uint16_t);
+    }
+
+    scalar_t operator()(std::size_t i, std::size_t j) const {
+      return get((i + j * rows_) * reals());
+    }
+
+    /**
+     * Copy columns [j, j+n) to the rows() x n matrix B.
+     */
+    void extract_cols(std::size_t j, std::size_t n, DenseM_t& B) const {
+      assert(B.rows() == rows_ && B.cols() >= n && j+n <= cols_);
+      for (std::size_t c=0; c<n; c++) {
+        auto k = (j + c) * rows_ * reals();
+        auto Bc = B.ptr(0, c);
+        for (std::size_t i=0; i<rows_; i++, k+=reals())
+          Bc[i] = get(k);
+      }
+    }
+
+    DenseM_t dense() const {
+      DenseM_t A(rows_, cols_);
+      extract_cols(0, cols_, A);
+      return A;
+    }
+
+    /**
+     * Compute C = alpha op(this) B + beta C, accumulating in the
+     * working precision. Columns of this matrix are decoded one at a
+     * time, so no copy of the matrix in the working precision is
+     * made.
+     */
+    void gemm(Trans ta, scalar_t alpha, const DenseM_t& B,
+              scalar_t beta, DenseM_t& C) const {
+      const std::size_t nrhs = B.cols();
+      if (ta == Trans::N) {
+        assert(B.rows() == cols_ && C.rows() == rows_ && C.cols() == nrhs);
+        scale(beta, C);
+        std::vector<scalar_t> a(rows_);
+        for (std::size_t j=0; j<cols_; j++) {
+          decode_col(j, a.data());
+          for (std::size_t c=0; c<nrhs; c++) {
+            const scalar_t t = alpha * B(j, c);
+            if (t == scalar_t(0.)) continue;
+            auto Cc = C.ptr(0, c);
+            for (std::size_t i=0; i<rows_; i++)
+              Cc[i] += a[i] * t;
+          }
+        }
+      } else {
+        assert(B.rows() == rows_ && C.rows() == cols_ && C.cols() == nrhs);
+        std::vector<scalar_t> a(rows_);
+        for (std::size_t j=0; j<cols_; j++) {
+          decode_col(j, a.data());
+          if (ta == Trans::C)
+            for (auto& ai : a) ai = blas::my_conj(ai);
+          for (std::size_t c=0; c<nrhs; c++) {
+            auto Bc = B.ptr(0, c);
+            scalar_t t(0.);
+            for (std::size_t i=0; i<rows_; i++)
+              t += a[i] * Bc[i];
+            C(j, c) = (beta == scalar_t(0.)) ?
+              alpha * t : alpha * t + beta * C(j, c);
+          }
+        }
+      }
+      STRUMPACK_FLOPS
+        ((is_complex<scalar_t>() ? 4 : 1) *
+         blas::gemm_flops(rows_, nrhs, cols_, alpha, beta));
+    }
+
+  private:
+    std::size_t rows_ = 0, cols_ = 0;
+    StoragePrecision prec_ = StoragePrecision::SINGLE;
+    std::vector<float> sp_;
+    std::vector<std::uint16_t> bf_;
+
+    static constexpr std::size_t reals() {
+      return sizeof(scalar_t) / sizeof(real_t);
+    }
+
+    static std::uint16_t to_bf16(float f) {
+      std::uint32_t u;
+      std::memcpy(&u, &f, sizeof(u));
+      // round to nearest even
+      u += 0x7FFF + ((u >> 16) & 1);
+      return std::uint16_t(u >> 16);
+    }
+    static float from_bf16(std::uint16_t h) {
+      std::uint32_t u = std::uint32_t(h) << 16;
+      float f;
+      std::memcpy(&f, &u, sizeof(f));
+      return f;
+    }
+
+    void set_real(std::size_t k, real_t v) {
+      if (prec_ == StoragePrecision::SINGLE) sp_[k] = float(v);
+      else bf_[k] = to_bf16(float(v));
+    }
+    real_t get_real(std::size_t k) const {
+      if (prec_ == StoragePrecision::SINGLE) return real_t(sp_[k]);
+      return real_t(from_bf16(bf_[k]));
+    }
+    void set(std::size_t k, real_t v) { set_real(k, v); }
+    void set(std::size_t k, std::complex<real_t> v) {
+      set_real(k, v.real());
+      set_real(k+1, v.imag());
+    }
+    scalar_t get(std::size_t k) const {
+      if constexpr (reals() == 2)
+        return scalar_t(get_real(k), get_real(k+1));
+      else return scalar_t(get_real(k));
+    }
+    void decode_col(std::size_t j, scalar_t* a) const {
+      auto k = j * rows_ * reals();
+      for (std::size_t i=0; i<rows_; i++, k+=reals())
+        a[i] = get(k);
+    }
+    static void scale(scalar_t beta, DenseM_t& C) {
+      if (beta == scalar_t(1.)) return;
+      if (beta == scalar_t(0.)) C.zero();
+      else C.scale(beta);
+    }
+  };
+
+} // end namespace strumpack
+
+#endif // REDUCED_PRECISION_MATRIX_HPP
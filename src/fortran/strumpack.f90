@@ -106,10 +106,12 @@ module strumpack
   enumerator :: STRUMPACK_AND = 9
   enumerator :: STRUMPACK_MLF = 10
   enumerator :: STRUMPACK_SPECTRAL = 11
+  enumerator :: STRUMPACK_MLND = 12
  end enum
  integer, parameter, public :: STRUMPACK_REORDERING_STRATEGY = kind(STRUMPACK_NATURAL)
  public :: STRUMPACK_NATURAL, STRUMPACK_METIS, STRUMPACK_PARMETIS, STRUMPACK_SCOTCH, STRUMPACK_PTSCOTCH, STRUMPACK_RCM, &
-    STRUMPACK_GEOMETRIC, STRUMPACK_AMD, STRUMPACK_MMD, STRUMPACK_AND, STRUMPACK_MLF, STRUMPACK_SPECTRAL
+    STRUMPACK_GEOMETRIC, STRUMPACK_AMD, STRUMPACK_MMD, STRUMPACK_AND, STRUMPACK_MLF, STRUMPACK_SPECTRAL, &
+    STRUMPACK_MLND
  ! typedef enum STRUMPACK_GRAM_SCHMIDT_TYPE
  enum, bind(c)
   enumerator :: STRUMPACK_CLASSICAL = 0
@@ -218,7 +218,10 @@ namespace strumpack {
      * \param c object to copy from, will not be modified.
      */
     MPIComm& operator=(const MPIComm& c) {
-      if (this != &c) duplicate(c.comm());
+      if (this != &c) {
+        duplicate(c.comm());
+        sparse_exchange_round_ = 0;
+      }
       return *this;
     }
 
@@ -230,6 +233,7 @@ namespace strumpack {
      */
     MPIComm& operator=(MPIComm&& c) noexcept {
       comm_ = c.comm_;
+      sparse_exchange_round_ = c.sparse_exchange_round_;
       c.comm_ = MPI_COMM_NULL;
       return *this;
     }
@@ -307,6 +311,25 @@ namespace strumpack {
       MPI_Bcast(sbuf, ssize, mpi_type<T>(), src, comm_);
     }
 
+    /**
+     * Non-blocking broadcast, with MPI_Ibcast, of ssize elements from
+     * rank src. This is collective on all the ranks in this
+     * communicator, and sbuf should not be accessed before the
+     * request has completed.
+     *
+     * \param sbuf buffer, input on src, output on the other ranks
+     * \param ssize number of elements in sbuf
+     * \param src rank of the root of the broadcast
+     * \return request object, use this to wait for completion of the
+     * broadcast
+     */
+    template<typename T> MPIRequest
+    ibroadcast_from(T* sbuf, std::size_t ssize, int src) const {
+      MPIRequest req;
+      MPI_Ibcast(sbuf, ssize, mpi_type<T>(), src, comm_, req.req_.get());
+      return req;
+    }
+
     template<typename T>
     void all_gather(T* buf, std::size_t rsize) const {
       MPI_Allgather
@@ -749,6 +772,84 @@ namespace strumpack {
       }
     }
 
+    /**
+     * Sparse personalized exchange. Each rank sends the data in
+     * sbuf[i].second to rank sbuf[i].first, without knowing in
+     * advance from which ranks it will receive data. The received
+     * data is appended to a single vector, which is returned, in the
+     * order the messages arrive.  This is collective on this MPI
+     * communicator, but unlike all_to_all_v, the cost only depends
+     * on the number of neighbors and not on the size of the
+     * communicator. This uses synchronous sends, followed by a
+     * nonblocking barrier once all sends have been matched (the NBX
+     * algorithm, Hoefler et al. 2010).
+     *
+     * Consecutive calls alternate between tags tag and tag+1, since a
+     * fast rank can already start the next exchange while others are
+     * still completing the current one. These tags should not be
+     * used by other messages in flight on this communicator.
+     *
+     * \tparam T type of data to send, this should have a
+     * corresponding mpi_type<T>() implementation or should define
+     * T::mpi_type()
+     * \param sbuf list of destination ranks and data, at most one
+     * entry per destination
+     * \param tag base tag, messages use tag or tag+1, alternating
+     * between consecutive calls
+     * \return all received data
+     * \see all_to_all_v
+     */
+    template<typename T> std::vector<T>
+    sparse_exchange(const std::vector<std::pair<int,std::vector<T>>>& sbuf,
+                    int tag) const {
+      tag += sparse_exchange_round_++ & 1;
+      std::vector<T> rbuf;
+      std::vector<MPI_Request> sreq;
+      sreq.reserve(sbuf.size());
+      auto r = rank();
+      for (auto& s : sbuf) {
+        if (s.first == r) {
+          rbuf.insert(rbuf.end(), s.second.begin(), s.second.end());
+          continue;
+        }
+        if (s.second.size() >
+            static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+          std::cerr << "# ERROR: 32bit integer overflow in sparse_exchange!!"
+                    << std::endl;
+          MPI_Abort(comm_, 1);
+        }
+        sreq.emplace_back();
+        MPI_Issend(const_cast<T*>(s.second.data()), s.second.size(),
+                   mpi_type<T>(), s.first, tag, comm_, &sreq.back());
+      }
+      MPI_Request breq;
+      bool barrier = false;
+      while (true) {
+        int flag;
+        MPI_Status stat;
+        MPI_Iprobe(MPI_ANY_SOURCE, tag, comm_, &flag, &stat);
+        if (flag) {
+          int msgsize;
+          MPI_Get_count(&stat, mpi_type<T>(), &msgsize);
+          auto m = rbuf.size();
+          rbuf.resize(m + msgsize);
+          MPI_Recv(rbuf.data()+m, msgsize, mpi_type<T>(), stat.MPI_SOURCE,
+                   tag, comm_, MPI_STATUS_IGNORE);
+        }
+        if (barrier) {
+          MPI_Test(&breq, &flag, MPI_STATUS_IGNORE);
+          if (flag) break;
+        } else {
+          MPI_Testall(sreq.size(), sreq.data(), &flag, MPI_STATUSES_IGNORE);
+          if (flag) {
+            MPI_Ibarrier(comm_, &breq);
+            barrier = true;
+          }
+        }
+      }
+      return rbuf;
+    }
+
     /**
      * Return a subcommunicator with P ranks, starting from rank P0,
      * using stride stride. Ie., ranks (relative to this communicator)
@@ -802,6 +903,22 @@ namespace strumpack {
       return c0;
     }
 
+    /**
+     * Split this communicator, with MPI_Comm_split. This is
+     * collective on the current communicator.
+     *
+     * \param color ranks with the same color end up in the same new
+     * communicator
+     * \param key determines the rank order in the new communicator
+     * \return new communicator containing the ranks with this color
+     */
+    MPIComm split(int color, int key) const {
+      if (is_null()) return MPIComm(MPI_COMM_NULL);
+      MPIComm c;
+      MPI_Comm_split(comm_, color, key, &c.comm_);
+      return c;
+    }
+
     /**
      * Call MPI_Pcontrol with level 1, and string name
      */
@@ -823,6 +940,7 @@ namespace strumpack {
 
   private:
     MPI_Comm comm_ = MPI_COMM_WORLD;
+    mutable unsigned int sparse_exchange_round_ = 0;
 
     void duplicate(MPI_Comm c) {
       if (c == MPI_COMM_NULL) comm_ = c;
@@ -0,0 +1,289 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/*! \file AuctionMatching.hpp
+ * \brief Shared memory parallel auction algorithm for the maximum
+ * product perfect matching, with MC64-like row and column scaling.
+ */
+#ifndef STRUMPACK_AUCTION_MATCHING_HPP
+#define STRUMPACK_AUCTION_MATCHING_HPP
+
+#include <cmath>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+namespace strumpack {
+
+  /*! \brief
+   *
+   * <pre>
+   * Purpose
+   * =======
+   *   Compute a column permutation Q and scaling vectors R and C such
+   *   that diag(R)*A*diag(C)*Q^T has ones on the diagonal and all
+   *   off-diagonal entries bounded by (approximately) one in
+   *   magnitude, ie, the same output as MC64 with job 5
+   *   (MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING).
+   *
+   *   Rows are bidders and columns are objects, with benefit
+   *   log|a_ij| - log max_k |a_ik|. The unassigned rows are split
+   *   over the threads, and each thread lets its rows bid, one at a
+   *   time, for their best column. A bid is accepted, under a
+   *   per-column lock, if it is still higher than the current price
+   *   of the column, and the row that is outbid is taken over by the
+   *   bidding thread. Since prices only increase, bids computed with
+   *   stale prices preserve epsilon complementary slackness. This is
+   *   repeated with decreasing epsilon (epsilon scaling), keeping the
+   *   assignments that are still valid. The resulting matching is
+   *   optimal up to n*epsilon in the log of the diagonal product, and
+   *   the scaling follows from the dual variables, with |r_i a_ij
+   *   c_j| <= exp(epsilon).
+   *
+   * Arguments
+   * =========
+   *
+   * n      (input) integer_t
+   *        Number of rows/columns.
+   * ptr, ind, val (input)
+   *        Matrix in CSR format.
+   * Q      (output) integer_t*, size n
+   *        Column permutation, column Q[j] of the original matrix is
+   *        column j of the permuted matrix.
+   * R, C   (output) real_t*, size n
+   *        Row and column scaling.
+   *
+   * Return value
+   * ============
+   *   0 on success, 1 if the matrix has an empty row (structurally
+   *   singular), -1 if the prices grew beyond the bound for a
+   *   feasible assignment problem, in which case the matrix is most
+   *   likely structurally singular.
+   * </pre>
+   */
+  template<typename scalar_t, typename integer_t, typename real_t>
+  int AuctionMatching
+  (integer_t n, const integer_t* ptr, const integer_t* ind,
+   const scalar_t* val, integer_t* Q, real_t* R, real_t* C) {
+    const double eps_min = 1e-3, theta = 8.;
+    // benefits, explicit zeros are dropped
+    std::unique_ptr<integer_t[]> bptr(new integer_t[n+1]);
+    std::vector<double> rmax(n);
+    int empty = 0;
+    double range = 0.;
+    bptr[0] = 0;
+#pragma omp parallel for reduction(max:empty)
+    for (integer_t r=0; r<n; r++) {
+      double m = 0.;
+      integer_t nz = 0;
+      for (integer_t k=ptr[r]; k<ptr[r+1]; k++) {
+        double a = std::abs(val[k]);
+        if (a == 0.) continue;
+        m = std::max(m, a);
+        nz++;
+      }
+      rmax[r] = m;
+      bptr[r+1] = nz;
+      if (!nz) empty = 1;
+    }
+    if (empty) return 1;
+    for (integer_t r=0; r<n; r++) bptr[r+1] += bptr[r];
+    std::unique_ptr<integer_t[]> bcol(new integer_t[bptr[n]]);
+    std::unique_ptr<double[]> b(new double[bptr[n]]);
+#pragma omp parallel for reduction(max:range)
+    for (integer_t r=0; r<n; r++) {
+      auto lm = std::log(rmax[r]);
+      auto kb = bptr[r];
+      for (integer_t k=ptr[r]; k<ptr[r+1]; k++) {
+        double a = std::abs(val[k]);
+        if (a == 0.) continue;
+        b[kb] = std::log(a) - lm;
+        bcol[kb++] = ind[k];
+        range = std::max(range, -b[kb-1]);
+      }
+    }
+
+    std::unique_ptr<std::atomic<double>[]> price
+      (new std::atomic<double>[n]);
+    std::unique_ptr<std::atomic<bool>[]> lock(new std::atomic<bool>[n]);
+    std::vector<integer_t> holder(n, -1), mate(n, -1), U(n);
+    for (integer_t j=0; j<n; j++) {
+      price[j].store(0., std::memory_order_relaxed);
+      lock[j].store(false, std::memory_order_relaxed);
+      U[j] = n-1-j;
+    }
+    // best and second best value, and position of the best column,
+    // for row r
+    auto best = [&](integer_t r, double& v1, double& v2, integer_t& k1) {
+      v1 = v2 = -std::numeric_limits<double>::infinity();
+      k1 = bptr[r];
+      for (integer_t k=bptr[r]; k<bptr[r+1]; k++) {
+        auto v = b[k] - price[bcol[k]].load(std::memory_order_relaxed);
+        if (v > v1) { v2 = v1; v1 = v; k1 = k; }
+        else if (v > v2) v2 = v;
+      }
+    };
+    double eps = std::max(range / theta, eps_min);
+    const double bound = 2. * (n + 1.) * (range + 2. * eps) + 1.;
+    std::atomic<bool> overflow(false);
+    while (true) {
+      const integer_t nu = U.size();
+#pragma omp parallel
+      {
+#if defined(_OPENMP)
+        const integer_t T = omp_get_num_threads(), t = omp_get_thread_num();
+#else
+        const integer_t T = 1, t = 0;
+#endif
+        std::vector<integer_t> S(U.begin() + nu*t/T, U.begin() + nu*(t+1)/T);
+        while (!S.empty() && !overflow.load(std::memory_order_relaxed)) {
+          auto r = S.back();
+          S.pop_back();
+          double v1, v2;
+          integer_t k1;
+          best(r, v1, v2, k1);
+          // a row with a single nonzero has no alternative, any bid
+          // larger than the gap to the worst benefit will do
+          if (bptr[r+1] - bptr[r] == 1) v2 = v1 - range - eps;
+          auto j = bcol[k1];
+          auto bid = b[k1] - v2 + eps;
+          while (lock[j].exchange(true, std::memory_order_acquire)) {}
+          if (bid > price[j].load(std::memory_order_relaxed)) {
+            auto h = holder[j];
+            holder[j] = r;
+            price[j].store(bid, std::memory_order_relaxed);
+            lock[j].store(false, std::memory_order_release);
+            if (h != -1) S.push_back(h);
+            if (bid > bound) overflow.store(true);
+          } else {
+            lock[j].store(false, std::memory_order_release);
+            S.push_back(r);
+          }
+        }
+      }
+      if (overflow.load()) return -1;
+#pragma omp parallel for
+      for (integer_t j=0; j<n; j++)
+        if (holder[j] != -1) mate[holder[j]] = j;
+      if (eps <= eps_min) break;
+      eps = std::max(eps / theta, eps_min);
+      // keep the assignments that satisfy eps-complementary slackness
+      // for the new eps, only the other rows need to bid again
+#pragma omp parallel for
+      for (integer_t r=0; r<n; r++) {
+        double v1, v2;
+        integer_t k1;
+        best(r, v1, v2, k1);
+        for (integer_t k=bptr[r]; k<bptr[r+1]; k++)
+          if (bcol[k] == mate[r]) {
+            v2 = b[k] - price[mate[r]].load(std::memory_order_relaxed);
+            break;
+          }
+        if (v2 < v1 - eps) holder[mate[r]] = -1;
+      }
+      U.clear();
+      for (integer_t r=n-1; r>=0; r--)
+        if (holder[mate[r]] != r) {
+          mate[r] = -1;
+          U.push_back(r);
+        }
+    }
+
+    // The auction prices depend on the order of the bids and can be
+    // spread out over a large range, which gives poorly balanced
+    // scaling. Replace them by the largest prices <= 0 which still
+    // satisfy eps-complementary slackness for this matching, ie,
+    //   p(mate[r]) <= p(j) + b(r,mate[r]) - b(r,j) + eps,
+    // computed by label correcting. Each row only updates the price
+    // of its own mate, so the sweeps can run in parallel. If this
+    // does not converge quickly, keep the auction prices.
+    {
+      const int max_sweeps = 100;
+      std::vector<double> bm(n), pa(n);
+#pragma omp parallel for
+      for (integer_t r=0; r<n; r++) {
+        for (integer_t k=bptr[r]; k<bptr[r+1]; k++)
+          if (bcol[k] == mate[r]) { bm[r] = b[k]; break; }
+        pa[r] = price[r].load(std::memory_order_relaxed);
+        price[r].store(0., std::memory_order_relaxed);
+      }
+      int changed = 1;
+      for (int sweep=0; changed && sweep<max_sweeps; sweep++) {
+        changed = 0;
+#pragma omp parallel for reduction(max:changed)
+        for (integer_t r=0; r<n; r++) {
+          auto j = mate[r];
+          auto pj = price[j].load(std::memory_order_relaxed), p = pj;
+          for (integer_t k=bptr[r]; k<bptr[r+1]; k++)
+            p = std::min
+              (p, price[bcol[k]].load(std::memory_order_relaxed)
+               + bm[r] - b[k] + eps);
+          if (p < pj - 1e-12) {
+            price[j].store(p, std::memory_order_relaxed);
+            changed = 1;
+          }
+        }
+      }
+      if (changed)
+        for (integer_t j=0; j<n; j++)
+          price[j].store(pa[j], std::memory_order_relaxed);
+    }
+
+    // duals: profit of row r is b(r,mate[r]) - p(mate[r]), shift
+    // all prices to balance the row and column scaling factors
+    double pmax = -std::numeric_limits<double>::max(),
+      pmin = std::numeric_limits<double>::max();
+#pragma omp parallel for reduction(max:pmax) reduction(min:pmin)
+    for (integer_t j=0; j<n; j++) {
+      auto p = price[j].load(std::memory_order_relaxed);
+      pmax = std::max(pmax, p);
+      pmin = std::min(pmin, p);
+    }
+    const double shift = (pmax + pmin) / 2.;
+#pragma omp parallel for
+    for (integer_t r=0; r<n; r++) {
+      auto j = mate[r];
+      auto pj = price[j].load(std::memory_order_relaxed);
+      double pi = 0.;
+      for (integer_t k=bptr[r]; k<bptr[r+1]; k++)
+        if (bcol[k] == j) { pi = b[k] - pj; break; }
+      R[r] = real_t(std::exp(-(pi + shift)) / rmax[r]);
+      Q[r] = j;
+      C[j] = real_t(std::exp(shift - pj));
+    }
+    return 0;
+  }
+
+} // end namespace strumpack
+
+#endif // STRUMPACK_AUCTION_MATCHING_HPP
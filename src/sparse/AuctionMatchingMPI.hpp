@@ -0,0 +1,412 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/*! \file AuctionMatchingMPI.hpp
+ * \brief Distributed memory auction algorithm for the maximum
+ * product perfect matching, with MC64-like row and column scaling.
+ */
+#ifndef STRUMPACK_AUCTION_MATCHING_MPI_HPP
+#define STRUMPACK_AUCTION_MATCHING_MPI_HPP
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+#include "misc/MPIWrapper.hpp"
+#include "misc/Triplet.hpp"
+
+namespace strumpack {
+
+  /*! \brief
+   *
+   * <pre>
+   * Purpose
+   * =======
+   *   Compute a column permutation Q and scaling vectors R and C such
+   *   that diag(R)*A*diag(C)*Q^T has ones on the diagonal and all
+   *   off-diagonal entries bounded by (approximately) one in
+   *   magnitude, ie, the same output as MC64 with job 5
+   *   (MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING), without
+   *   gathering the matrix.
+   *
+   *   Rows are bidders and columns are objects, with benefit
+   *   log|a_ij| - log max_k |a_ik|. Each column is owned by the
+   *   process that owns the row with the same index. In every round
+   *   the unassigned rows bid for their best column. Bids for local
+   *   columns are resolved immediately (Gauss-Seidel), bids for
+   *   remote columns are collected and resolved by their owners at
+   *   the end of the round (Jacobi), after which the new prices are
+   *   sent to the processes that reference those columns. This is
+   *   repeated with decreasing epsilon (epsilon scaling). The
+   *   resulting matching is optimal up to n*epsilon in the log of
+   *   the diagonal product. The scaling follows from the dual
+   *   variables: |r_i a_ij c_j| <= exp(epsilon).
+   *
+   * Arguments
+   * =========
+   *
+   * comm   (input) MPIComm
+   *        Communicator over which the matrix rows are distributed.
+   * dist   (input) std::vector<integer_t>
+   *        Row distribution, process p owns rows [dist[p],dist[p+1]).
+   * ptr, ind, val (input)
+   *        Local rows in CSR format, with global column indices.
+   * Q      (output) std::vector<integer_t>
+   *        Global column permutation, column Q[j] of the original
+   *        matrix is column j of the permuted matrix.
+   * R      (output) std::vector<real_t>
+   *        Row scaling for the local rows.
+   * C      (output) std::vector<real_t>
+   *        Global column scaling.
+   *
+   * Return value
+   * ============
+   *   0 on success, 1 if the matrix has an empty row (structurally
+   *   singular), -1 if the prices grew beyond the bound for a
+   *   feasible assignment problem, in which case the matrix is most
+   *   likely structurally singular.
+   * </pre>
+   */
+  template<typename scalar_t, typename integer_t, typename real_t>
+  int AuctionMatchingMPI
+  (const MPIComm& comm, const std::vector<integer_t>& dist,
+   const integer_t* ptr, const integer_t* ind, const scalar_t* val,
+   std::vector<integer_t>& Q, std::vector<real_t>& R,
+   std::vector<real_t>& C) {
+    using Bid = Triplet<double,integer_t>;
+    using Price = IdxVal<double,integer_t>;
+    using Mate = IdxIJ<integer_t>;
+    const double eps_min = 1e-3, theta = 8.;
+    const int P = comm.size(), rank = comm.rank();
+    const integer_t n = dist[P], brow = dist[rank],
+      lrows = dist[rank+1] - brow;
+    auto owner = [&dist](integer_t j) -> int {
+      return std::upper_bound(dist.begin(), dist.end(), j)
+        - dist.begin() - 1;
+    };
+
+    // benefits, explicit zeros are dropped
+    std::vector<integer_t> bptr(lrows+1), bcol;
+    std::vector<double> b, rmax(lrows);
+    bcol.reserve(ptr[lrows]-ptr[0]);
+    b.reserve(ptr[lrows]-ptr[0]);
+    int empty = 0;
+    double range = 0.;
+    for (integer_t r=0; r<lrows; r++) {
+      double m = 0.;
+      for (integer_t k=ptr[r]; k<ptr[r+1]; k++)
+        m = std::max(m, double(std::abs(val[k])));
+      rmax[r] = m;
+      if (m == 0.) empty = 1;
+      else {
+        auto lm = std::log(m);
+        for (integer_t k=ptr[r]; k<ptr[r+1]; k++) {
+          double a = std::abs(val[k]);
+          if (a == 0.) continue;
+          b.push_back(std::log(a) - lm);
+          bcol.push_back(ind[k]);
+          range = std::max(range, -b.back());
+        }
+      }
+      bptr[r+1] = b.size();
+    }
+    if (comm.all_reduce(empty, MPI_MAX)) return 1;
+    range = comm.all_reduce(range, MPI_MAX);
+
+    // compress the referenced columns, and tell their owners which
+    // columns we need the prices for
+    std::vector<integer_t> cols(bcol);
+    std::sort(cols.begin(), cols.end());
+    cols.erase(std::unique(cols.begin(), cols.end()), cols.end());
+    auto cidx = [&cols](integer_t j) -> integer_t {
+      return std::lower_bound(cols.begin(), cols.end(), j) - cols.begin();
+    };
+    for (auto& j : bcol) j = cidx(j);
+    std::vector<integer_t> sptr(lrows+1), sranks;
+    {
+      std::vector<std::vector<Mate>> sbuf(P);
+      for (auto j : cols) sbuf[owner(j)].emplace_back(j, rank);
+      auto rbuf = comm.all_to_all_v(sbuf);
+      for (auto& s : rbuf) sptr[s.i-brow+1]++;
+      for (integer_t r=0; r<lrows; r++) sptr[r+1] += sptr[r];
+      sranks.resize(sptr[lrows]);
+      std::vector<integer_t> fill(sptr.begin(), sptr.end()-1);
+      for (auto& s : rbuf) sranks[fill[s.i-brow]++] = s.j;
+    }
+
+    // pc: prices of the referenced columns, price/holder/bid/bidder:
+    // for the owned columns, mate: column assigned to each local row
+    std::vector<double> pc(cols.size(), 0.), price(lrows, 0.), bid(lrows);
+    std::vector<integer_t> mate(lrows), holder(lrows), bidder(lrows, -1),
+      U, pending, changed;
+    std::vector<bool> is_changed(lrows, false);
+    auto set_price = [&](integer_t lj, double p) {
+      price[lj] = p;
+      auto c = cidx(brow+lj);
+      if (c < integer_t(cols.size()) && cols[c] == brow+lj) pc[c] = p;
+      if (!is_changed[lj]) {
+        is_changed[lj] = true;
+        changed.push_back(lj);
+      }
+    };
+    double eps = std::max(range / theta, eps_min);
+    const double bound = 2. * (n + 1.) * (range + 2. * eps) + 1.;
+    int info = 0;
+    // best and second best value, and best column, for local row r
+    auto best = [&](integer_t r, double& v1, double& v2, integer_t& j1) {
+      v1 = v2 = -std::numeric_limits<double>::infinity();
+      j1 = 0;
+      for (integer_t k=bptr[r]; k<bptr[r+1]; k++) {
+        auto v = b[k] - pc[bcol[k]];
+        if (v > v1) { v2 = v1; v1 = v; j1 = bcol[k]; }
+        else if (v > v2) v2 = v;
+      }
+    };
+    std::fill(mate.begin(), mate.end(), integer_t(-1));
+    std::fill(holder.begin(), holder.end(), integer_t(-1));
+    U.resize(lrows);
+    for (integer_t r=0; r<lrows; r++) U[r] = lrows-1-r;
+    while (!info) {
+      int overflow = 0;
+      while (true) {
+        // Bids for local columns are resolved immediately (Gauss-Seidel
+        // auction), this makes most displacement chains local. Bids for
+        // remote columns are sent to the owner at the end of the round.
+        std::vector<std::vector<Bid>> sbids(P);
+        std::vector<std::vector<Mate>> smates(P);
+        auto evict = [&](integer_t h) {
+          if (h == -1) return;
+          if (h >= brow && h < brow+lrows) {
+            mate[h-brow] = -1;
+            U.push_back(h-brow);
+          } else smates[owner(h)].emplace_back(h, -1);
+        };
+        pending.clear();
+        while (!U.empty()) {
+          auto r = U.back();
+          U.pop_back();
+          double v1, v2;
+          integer_t j1;
+          best(r, v1, v2, j1);
+          // a row with a single nonzero has no alternative, any bid
+          // larger than the gap to the worst benefit will do
+          if (bptr[r+1] - bptr[r] == 1) v2 = v1 - range - eps;
+          auto j = cols[j1];
+          auto bv = pc[j1] + (v1 - v2) + eps;
+          if (j >= brow && j < brow+lrows) {
+            auto lj = j - brow;
+            evict(holder[lj]);
+            holder[lj] = brow+r;
+            mate[r] = j;
+            set_price(lj, bv);
+            if (bv > bound) overflow = 1;
+          } else {
+            sbids[owner(j)].emplace_back(brow+r, j, bv);
+            pending.push_back(r);
+          }
+        }
+        // resolve the remote bids, the highest bid wins, but only if
+        // it is still higher than the current price
+        std::vector<integer_t> touched;
+        for (auto& x : comm.all_to_all_v(sbids)) {
+          auto lj = x.c - brow;
+          if (bidder[lj] == -1) {
+            touched.push_back(lj);
+            bidder[lj] = x.r;
+            bid[lj] = x.v;
+          } else if (x.v > bid[lj] || (x.v == bid[lj] && x.r < bidder[lj])) {
+            bidder[lj] = x.r;
+            bid[lj] = x.v;
+          }
+        }
+        for (auto lj : touched) {
+          if (bid[lj] > price[lj]) {
+            evict(holder[lj]);
+            holder[lj] = bidder[lj];
+            smates[owner(bidder[lj])].emplace_back(bidder[lj], brow+lj);
+            set_price(lj, bid[lj]);
+            if (bid[lj] > bound) overflow = 1;
+          }
+          bidder[lj] = -1;
+        }
+        for (auto& m : comm.all_to_all_v(smates)) {
+          mate[m.i-brow] = m.j;
+          if (m.j == -1) U.push_back(m.i-brow);
+        }
+        for (auto r : pending)
+          if (mate[r] == -1) U.push_back(r);
+        std::vector<std::vector<Price>> sprices(P);
+        for (auto lj : changed) {
+          for (integer_t s=sptr[lj]; s<sptr[lj+1]; s++)
+            if (sranks[s] != rank)
+              sprices[sranks[s]].emplace_back(brow+lj, price[lj]);
+          is_changed[lj] = false;
+        }
+        changed.clear();
+        for (auto& p : comm.all_to_all_v(sprices))
+          pc[cidx(p.i)] = p.v;
+        integer_t st[2] = {integer_t(U.size()), integer_t(overflow)};
+        comm.all_reduce(st, 2, MPI_SUM);
+        if (!st[0]) break;
+        if (st[1]) { info = -1; break; }
+      }
+      if (info || eps <= eps_min) break;
+      eps = std::max(eps / theta, eps_min);
+      // keep the assignments that satisfy eps-complementary slackness
+      // for the new eps, only the other rows need to bid again
+      std::vector<std::vector<Mate>> sfree(P);
+      for (integer_t r=lrows-1; r>=0; r--) {
+        double v1, v2;
+        integer_t j1;
+        best(r, v1, v2, j1);
+        auto j = cidx(mate[r]);
+        for (integer_t k=bptr[r]; k<bptr[r+1]; k++)
+          if (bcol[k] == j) { v2 = b[k] - pc[j]; break; }
+        if (v2 >= v1 - eps) continue;
+        if (mate[r] >= brow && mate[r] < brow+lrows)
+          holder[mate[r]-brow] = -1;
+        else sfree[owner(mate[r])].emplace_back(brow+r, mate[r]);
+        mate[r] = -1;
+        U.push_back(r);
+      }
+      for (auto& m : comm.all_to_all_v(sfree))
+        holder[m.j-brow] = -1;
+    }
+    // The auction prices depend on the order of the bids and can be
+    // spread out over a large range, which gives poorly balanced
+    // scaling. Replace them by the largest prices <= 0 which still
+    // satisfy eps-complementary slackness for this matching, ie,
+    //   p(mate[r]) <= p(j) + b(r,mate[r]) - b(r,j) + eps,
+    // computed by label correcting. Each row only updates the price
+    // of its own mate. Rows matched to a local column are relaxed
+    // until the local prices no longer change, then the updates for
+    // remote columns are sent to the owner, which forwards the new
+    // price to the processes referencing that column. This is
+    // repeated until no price changes, but at most max_rounds times
+    // (each round costs two all_to_all_v), otherwise the auction
+    // prices are kept.
+    if (!info) {
+      const int max_rounds = 20;
+      std::vector<double> bm(lrows), pa(price), pca(pc);
+      std::vector<integer_t> lrow, rrow;
+      for (integer_t r=0; r<lrows; r++) {
+        auto j = cidx(mate[r]);
+        for (integer_t k=bptr[r]; k<bptr[r+1]; k++)
+          if (bcol[k] == j) { bm[r] = b[k]; break; }
+        if (mate[r] >= brow && mate[r] < brow+lrows) lrow.push_back(r);
+        else rrow.push_back(r);
+      }
+      auto relax = [&](integer_t r) {
+        auto j = cidx(mate[r]);
+        auto p = pc[j];
+        for (integer_t k=bptr[r]; k<bptr[r+1]; k++)
+          p = std::min(p, pc[bcol[k]] + bm[r] - b[k] + eps);
+        return p < pc[j] - 1e-12 ? p : pc[j];
+      };
+      std::fill(price.begin(), price.end(), 0.);
+      std::fill(pc.begin(), pc.end(), 0.);
+      int active = 1, round = 0;
+      for (; active && round<max_rounds; round++) {
+        for (bool local_change=true; local_change; ) {
+          local_change = false;
+          for (auto r : lrow) {
+            auto lj = mate[r] - brow;
+            auto p = relax(r);
+            if (p < price[lj]) {
+              set_price(lj, p);
+              local_change = true;
+            }
+          }
+        }
+        std::vector<std::vector<Price>> supd(P);
+        for (auto r : rrow) {
+          auto p = relax(r);
+          if (p < pc[cidx(mate[r])])
+            supd[owner(mate[r])].emplace_back(mate[r], p);
+        }
+        for (auto& u : comm.all_to_all_v(supd))
+          if (u.v < price[u.i-brow])
+            set_price(u.i-brow, u.v);
+        std::vector<std::vector<Price>> sprices(P);
+        for (auto lj : changed) {
+          for (integer_t s=sptr[lj]; s<sptr[lj+1]; s++)
+            if (sranks[s] != rank)
+              sprices[sranks[s]].emplace_back(brow+lj, price[lj]);
+          is_changed[lj] = false;
+        }
+        active = changed.empty() ? 0 : 1;
+        changed.clear();
+        for (auto& p : comm.all_to_all_v(sprices))
+          pc[cidx(p.i)] = p.v;
+        active = comm.all_reduce(active, MPI_MAX);
+      }
+      if (active) {
+        price.swap(pa);
+        pc.swap(pca);
+      }
+    }
+    // the MPI types of Bid, Price and Mate are cached and shared with
+    // other code, so they are not freed here
+    if (info) return info;
+
+    // duals: profit of row r is b(r,mate[r]) - p(mate[r]), shift
+    // all prices to balance the row and column scaling factors
+    double pmax = lrows ? *std::max_element(price.begin(), price.end())
+      : -std::numeric_limits<double>::max();
+    double pmin = lrows ? *std::min_element(price.begin(), price.end())
+      : std::numeric_limits<double>::max();
+    pmax = comm.all_reduce(pmax, MPI_MAX);
+    pmin = comm.all_reduce(pmin, MPI_MIN);
+    const double shift = (pmax + pmin) / 2.;
+    std::vector<int> rcnts(P), displs(P);
+    for (int p=0; p<P; p++) {
+      rcnts[p] = dist[p+1] - dist[p];
+      displs[p] = dist[p];
+    }
+    R.resize(lrows);
+    Q.resize(n);
+    C.resize(n);
+#pragma omp parallel for
+    for (integer_t r=0; r<lrows; r++) {
+      auto j = cidx(mate[r]);
+      double pi = 0.;
+      for (integer_t k=bptr[r]; k<bptr[r+1]; k++)
+        if (bcol[k] == j) { pi = b[k] - pc[j]; break; }
+      R[r] = real_t(std::exp(-(pi + shift)) / rmax[r]);
+      Q[brow+r] = mate[r];
+      C[brow+r] = real_t(std::exp(shift - price[r]));
+    }
+    comm.all_gather_v(Q.data(), rcnts.data(), displs.data());
+    comm.all_gather_v(C.data(), rcnts.data(), displs.data());
+    return 0;
+  }
+
+} // end namespace strumpack
+
+#endif // STRUMPACK_AUCTION_MATCHING_MPI_HPP
@@ -29,9 +29,14 @@
 #include <memory>
 #include <queue>
 #include <algorithm>
+#include <numeric>
+#include <tuple>
 
 #include "CSRGraph.hpp"
+#include "SeparatorTree.hpp"
 #include "ordering/MetisReordering.hpp"
+#include "StrumpackParameters.hpp"
+#include "misc/Tools.hpp"
 
 namespace strumpack {
 
@@ -298,6 +303,7 @@ namespace strumpack {
     auto n = size();
     auto dim = end - begin;
     std::vector<bool> mark(dim);
+    std::vector<integer_t> marked;
     std::unique_ptr<integer_t[]> ind_to_part(new integer_t[dim]);
     integer_t count = 0;
     for (integer_t r=0; r<dim; r++)
@@ -306,7 +312,8 @@ namespace strumpack {
     for (integer_t r=begin, edges=0; r<end; r++) {
       if (order[r-begin] == part) {
         g.ptr_.push_back(edges);
-        std::fill(mark.begin(), mark.end(), false);
+        for (auto lc : marked) mark[lc] = false;
+        marked.clear();
         for (integer_t j=ptr_[r]; j<ptr_[r+1]; j++) {
           auto c = ind_[j] - lo;
           if (c == r) continue;
@@ -315,6 +322,7 @@ namespace strumpack {
             if (lc >= 0 && lc < dim && order[lc] == part) {
               if (!mark[lc]) {
                 mark[lc] = true;
+                marked.push_back(lc);
                 g.ind_.push_back(ind_to_part[lc]);
                 edges++;
               }
@@ -326,6 +334,7 @@ namespace strumpack {
                   if (cc != r && lcc >= 0 && lcc < dim &&
                       order[lcc] == part && !mark[lcc]) {
                     mark[lcc] = true;
+                    marked.push_back(lcc);
                     g.ind_.push_back(ind_to_part[lcc]);
                     edges++;
                   }
@@ -339,6 +348,7 @@ namespace strumpack {
                 if (cc != r && lcc >= 0 &&
                     lcc < dim && order[lcc] == part && !mark[lcc]) {
                   mark[lcc] = true;
+                  marked.push_back(lcc);
                   g.ind_.push_back(ind_to_part[lcc]);
                   edges++;
                 }
@@ -352,6 +362,364 @@ namespace strumpack {
     return g;
   }
 
+  namespace {
+    // minimum number of vertices handled by a single task in a
+    // taskloop
+    const int nd_grain = 4096;
+    // number of FM refinement passes
+    const int fm_passes = 4;
+
+    template<typename integer_t> integer_t
+    max_part_weight(const std::vector<integer_t>& vw) {
+      auto tw = std::accumulate(vw.begin(), vw.end(), integer_t(0));
+      auto mw = vw.empty() ? integer_t(0) :
+        *std::max_element(vw.begin(), vw.end());
+      return std::max(integer_t(0.55 * tw), (tw + 1) / 2 + mw);
+    }
+  }
+
+  template<typename integer_t> integer_t CSRGraph<integer_t>::edge_cut
+  (const std::vector<integer_t>& ew, const std::vector<char>& part) const {
+    integer_t cut = 0;
+    auto n = size();
+    for (integer_t v=0; v<n; v++)
+      for (auto e=ptr_[v]; e<ptr_[v+1]; e++)
+        if (part[ind_[e]] != part[v]) cut += ew[e];
+    return cut / 2;
+  }
+
+  /**
+   * Moves are made from the boundary, highest gain first, respecting
+   * the balance constraint, and the best prefix of the sequence of
+   * moves is kept.
+   */
+  template<typename integer_t> void CSRGraph<integer_t>::fm_refine
+  (const std::vector<integer_t>& vw, const std::vector<integer_t>& ew,
+   std::vector<char>& part, int depth) const {
+    using pq_t = std::priority_queue<std::pair<integer_t,integer_t>>;
+    const auto n = size();
+    if (n <= 0) return;
+    const auto maxw = max_part_weight(vw);
+    const std::size_t limit = std::min
+      (std::max(integer_t(15), n / 100), integer_t(100));
+    integer_t w[2] = {0, 0};
+    for (integer_t v=0; v<n; v++) w[int(part[v])] += vw[v];
+    std::vector<integer_t> gain(n);
+    std::vector<char> locked(n), bnd(n);
+    std::vector<integer_t> moves;
+    auto cut = edge_cut(ew, part);
+    auto state = [&]() {
+      auto hw = std::max(w[0], w[1]);
+      return std::make_tuple
+      (std::max(hw - maxw, integer_t(0)), cut, hw - std::min(w[0], w[1]));
+    };
+    for (int pass=0; pass<fm_passes; pass++) {
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(nd_grain)        \
+  if(depth < params::task_recursion_cutoff_level)
+#endif
+      for (integer_t v=0; v<n; v++) {
+        integer_t ext = 0, in = 0;
+        for (auto e=ptr_[v]; e<ptr_[v+1]; e++) {
+          if (part[ind_[e]] != part[v]) ext += ew[e];
+          else in += ew[e];
+        }
+        gain[v] = ext - in;
+        bnd[v] = ext > 0;
+        locked[v] = 0;
+      }
+      pq_t pq[2];
+      for (integer_t v=0; v<n; v++)
+        if (bnd[v]) pq[int(part[v])].emplace(gain[v], v);
+      moves.clear();
+      const auto init = state();
+      auto best = init;
+      std::size_t bestm = 0;
+      while (true) {
+        integer_t v = -1;
+        int from = -1;
+        for (int s=0; s<2; s++) {
+          while (!pq[s].empty()) {
+            auto u = pq[s].top().second;
+            if (locked[u] || part[u] != s || pq[s].top().first != gain[u])
+              pq[s].pop();
+            else break;
+          }
+          if (pq[s].empty()) continue;
+          auto u = pq[s].top().second;
+          auto wt = w[1-s] + vw[u];
+          if (wt > maxw && wt >= w[s]) continue;
+          if (v == -1 || gain[u] > gain[v] ||
+              (gain[u] == gain[v] && w[s] > w[from])) {
+            v = u;
+            from = s;
+          }
+        }
+        if (v == -1) break;
+        pq[from].pop();
+        part[v] = 1 - from;
+        w[from] -= vw[v];
+        w[1-from] += vw[v];
+        cut -= gain[v];
+        locked[v] = 1;
+        moves.push_back(v);
+        for (auto e=ptr_[v]; e<ptr_[v+1]; e++) {
+          auto u = ind_[e];
+          if (locked[u]) continue;
+          if (part[u] == part[v]) gain[u] -= 2 * ew[e];
+          else gain[u] += 2 * ew[e];
+          pq[int(part[u])].emplace(gain[u], u);
+        }
+        auto st = state();
+        if (st < best) {
+          best = st;
+          bestm = moves.size();
+        } else if (moves.size() - bestm > limit) break;
+      }
+      for (auto i=moves.size(); i>bestm; i--) {
+        auto v = moves[i-1];
+        auto s = part[v];
+        part[v] = 1 - s;
+        w[int(s)] -= vw[v];
+        w[1-s] += vw[v];
+      }
+      cut = std::get<1>(best);
+      if (!(best < init)) break;
+    }
+  }
+
+  template<typename integer_t> integer_t
+  CSRGraph<integer_t>::pseudo_peripheral() const {
+    auto n = size();
+    std::vector<integer_t> q(n);
+    std::vector<char> mark(n);
+    integer_t root = 0;
+    for (int it=0; it<2; it++) {
+      std::fill(mark.begin(), mark.end(), 0);
+      integer_t qb = 0, qe = 0;
+      q[qe++] = root;
+      mark[root] = 1;
+      while (qb < qe) {
+        auto v = q[qb++];
+        for (auto e=ptr_[v]; e<ptr_[v+1]; e++)
+          if (!mark[ind_[e]]) {
+            mark[ind_[e]] = 1;
+            q[qe++] = ind_[e];
+          }
+      }
+      root = q[qe-1];
+    }
+    return root;
+  }
+
+  /**
+   * The initial separator consists of the boundary vertices on the
+   * side with the smallest boundary. In the FM refinement, a
+   * separator vertex moved to part t pulls its neighbors from the
+   * other part into the separator. The best prefix of moves is kept.
+   */
+  template<typename integer_t> void CSRGraph<integer_t>::vertex_separator
+  (const std::vector<integer_t>& vw, std::vector<char>& where) const {
+    using pq_t = std::priority_queue<std::pair<integer_t,integer_t>>;
+    const auto n = size();
+    const auto maxw = max_part_weight(vw);
+    const std::size_t limit = std::min
+      (std::max(integer_t(15), n / 100), integer_t(100));
+    integer_t w[3] = {0, 0, 0}, bw[2] = {0, 0};
+    std::vector<char> bnd(n);
+    for (integer_t v=0; v<n; v++) {
+      w[int(where[v])] += vw[v];
+      for (auto e=ptr_[v]; e<ptr_[v+1]; e++)
+        if (where[ind_[e]] != where[v]) {
+          bnd[v] = 1;
+          bw[int(where[v])] += vw[v];
+          break;
+        }
+    }
+    char s = (bw[0] < bw[1] || (bw[0] == bw[1] && w[0] >= w[1])) ? 0 : 1;
+    for (integer_t v=0; v<n; v++)
+      if (bnd[v] && where[v] == s) {
+        where[v] = 2;
+        w[int(s)] -= vw[v];
+        w[2] += vw[v];
+      }
+    auto gain = [&](integer_t v, int t) {
+      integer_t gv = vw[v];
+      for (auto e=ptr_[v]; e<ptr_[v+1]; e++)
+        if (where[ind_[e]] == 1-t) gv -= vw[ind_[e]];
+      return gv;
+    };
+    auto state = [&]() {
+      auto hw = std::max(w[0], w[1]);
+      return std::make_tuple
+      (std::max(hw - maxw, integer_t(0)), w[2], hw - std::min(w[0], w[1]));
+    };
+    std::vector<char> locked(n), side;
+    std::vector<integer_t> moves, pulled, npulled;
+    for (int pass=0; pass<fm_passes; pass++) {
+      pq_t pq[2];
+      std::fill(locked.begin(), locked.end(), 0);
+      for (integer_t v=0; v<n; v++)
+        if (where[v] == 2)
+          for (int t=0; t<2; t++)
+            pq[t].emplace(gain(v, t), v);
+      moves.clear();  side.clear();
+      pulled.clear();  npulled.clear();
+      const auto init = state();
+      auto best = init;
+      std::size_t bestm = 0;
+      while (true) {
+        integer_t v = -1, gv = 0;
+        int to = -1;
+        for (int t=0; t<2; t++) {
+          while (!pq[t].empty()) {
+            auto [gs, u] = pq[t].top();
+            if (where[u] != 2 || locked[u]) { pq[t].pop(); continue; }
+            auto gu = gain(u, t);
+            if (gu != gs) {
+              pq[t].pop();
+              pq[t].emplace(gu, u);
+              continue;
+            }
+            break;
+          }
+          if (pq[t].empty()) continue;
+          auto [gu, u] = pq[t].top();
+          if (w[t] + vw[u] > maxw) continue;
+          if (v == -1 || gu > gv || (gu == gv && w[t] < w[to])) {
+            v = u;
+            gv = gu;
+            to = t;
+          }
+        }
+        if (v == -1) break;
+        pq[to].pop();
+        where[v] = to;
+        w[to] += vw[v];
+        w[2] -= vw[v];
+        locked[v] = 1;
+        moves.push_back(v);
+        side.push_back(to);
+        for (auto e=ptr_[v]; e<ptr_[v+1]; e++) {
+          auto u = ind_[e];
+          if (where[u] != 1-to) continue;
+          where[u] = 2;
+          w[1-to] -= vw[u];
+          w[2] += vw[u];
+          pulled.push_back(u);
+          for (int t=0; t<2; t++)
+            pq[t].emplace(gain(u, t), u);
+        }
+        npulled.push_back(pulled.size());
+        auto st = state();
+        if (st < best) {
+          best = st;
+          bestm = moves.size();
+        } else if (moves.size() - bestm > limit) break;
+      }
+      for (auto i=moves.size(); i>bestm; i--) {
+        auto v = moves[i-1];
+        int t = side[i-1];
+        for (auto k=(i > 1 ? npulled[i-2] : 0); k<npulled[i-1]; k++) {
+          auto u = pulled[k];
+          where[u] = 1 - t;
+          w[1-t] += vw[u];
+          w[2] -= vw[u];
+        }
+        where[v] = 2;
+        w[t] -= vw[v];
+        w[2] += vw[v];
+      }
+      if (!(best < init)) break;
+    }
+  }
+
+  /**
+   * Nested dissection of g, whose vertices have global indices
+   * gid. The vertices are numbered from off, first the left part,
+   * then the right part, then the separator. The separator tree of
+   * this subgraph is returned in tree, in postorder, with indices
+   * relative to this subtree. The memory of g and gid is released
+   * before the recursion.
+   */
+  template<typename integer_t> void CSRGraph<integer_t>::dissect_recursive
+  (CSRGraph<integer_t>& g, std::vector<integer_t>& gid, integer_t off,
+   integer_t leaf, integer_t* iperm, std::vector<Separator<integer_t>>& tree,
+   const Bisection& bisect, int depth) {
+    const auto n = g.size();
+    std::vector<char> where;
+    if (n > leaf) bisect(g, where, depth);
+    integer_t nw[3] = {0, 0, 0};
+    for (auto w : where) nw[int(w)]++;
+    if (nw[0] == 0 || nw[1] == 0) {
+      std::copy(gid.begin(), gid.end(), iperm+off);
+      tree.emplace_back(off+n, -1, -1, -1);
+      return;
+    }
+    std::vector<integer_t> part(n), gid0(nw[0]), gid1(nw[1]);
+    integer_t c[3] = {0, 0, 0};
+    for (integer_t v=0; v<n; v++) {
+      int w = part[v] = where[v];
+      auto lv = c[w]++;
+      if (w == 0) gid0[lv] = gid[v];
+      else if (w == 1) gid1[lv] = gid[v];
+      else iperm[off+nw[0]+nw[1]+lv] = gid[v];
+    }
+    Length2Edges l2;
+    auto g0 = g.extract_subgraph(0, 0, 0, n, 0, part.data(), l2);
+    auto g1 = g.extract_subgraph(0, 0, 0, n, 1, part.data(), l2);
+    g = CSRGraph<integer_t>();
+    std::vector<integer_t>().swap(gid);
+    std::vector<integer_t>().swap(part);
+    std::vector<Separator<integer_t>> t0, t1;
+#pragma omp task default(shared)                        \
+  if(depth < params::task_recursion_cutoff_level)
+    dissect_recursive(g0, gid0, off, leaf, iperm, t0, bisect, depth+1);
+#pragma omp task default(shared)                        \
+  if(depth < params::task_recursion_cutoff_level)
+    dissect_recursive(g1, gid1, off+nw[0], leaf, iperm, t1, bisect, depth+1);
+#pragma omp taskwait
+    integer_t s0 = t0.size(), s1 = t1.size();
+    tree.reserve(s0+s1+1);
+    tree.insert(tree.end(), t0.begin(), t0.end());
+    for (auto s : t1) {
+      if (s.pa != -1) s.pa += s0;
+      if (s.lch != -1) s.lch += s0;
+      if (s.rch != -1) s.rch += s0;
+      tree.push_back(s);
+    }
+    tree[s0-1].pa = tree[s0+s1-1].pa = s0 + s1;
+    tree.emplace_back(off+n, -1, s0-1, s0+s1-1);
+  }
+
+  template<typename integer_t> SeparatorTree<integer_t>
+  CSRGraph<integer_t>::nested_dissection
+  (int leaf, std::vector<integer_t>& perm, std::vector<integer_t>& iperm,
+   const Bisection& bisect) const {
+    auto n = size();
+    if (n <= 0) return SeparatorTree<integer_t>();
+    // a copy of this graph, without self-loops
+    std::vector<integer_t> part(n, 0);
+    auto g = extract_subgraph(0, 0, 0, n, 0, part.data(), Length2Edges());
+    std::vector<integer_t>().swap(part);
+    if (!g.edges())
+      if (mpi_root())
+        std::cerr << "# WARNING: matrix seems to be diagonal!" << std::endl;
+    std::vector<integer_t> gid(n);
+    std::iota(gid.begin(), gid.end(), 0);
+    perm.resize(n);
+    iperm.resize(n);
+    std::vector<Separator<integer_t>> tree;
+#pragma omp parallel if(!omp_in_parallel())
+#pragma omp single nowait
+    dissect_recursive
+      (g, gid, integer_t(0), integer_t(std::max(leaf, 1)),
+       iperm.data(), tree, bisect, 0);
+    for (integer_t i=0; i<n; i++)
+      perm[iperm[i]] = i;
+    return SeparatorTree<integer_t>(tree);
+  }
+
 #if defined(STRUMPACK_USE_MPI)
   template<typename integer_t> void
   CSRGraph<integer_t>::broadcast(const MPIComm& comm) {
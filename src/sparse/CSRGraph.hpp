@@ -31,6 +31,7 @@
 
 #include <vector>
 #include <unordered_map>
+#include <functional>
 
 #include "structured/ClusterTree.hpp"
 #include "dense/DenseMatrix.hpp"
@@ -41,6 +42,8 @@
 
 namespace strumpack {
 
+  template<typename integer_t> class Separator;
+  template<typename integer_t> class SeparatorTree;
 
   /**
    * Compressed sparse row representation of a graph.
@@ -100,6 +103,56 @@ namespace strumpack {
     partition_K_way(int K, integer_t* order, integer_t* iorder, integer_t lo,
                     integer_t sep_begin, integer_t sep_end) const;
 
+    /**
+     * Bisection routine used in nested_dissection, called as
+     * bisect(g, where, depth). It should set where[v] to 0 or 1 for
+     * the two parts, or to 2 for the vertex separator.
+     */
+    using Bisection = std::function
+      <void(const CSRGraph<integer_t>&,std::vector<char>&,int)>;
+
+    /**
+     * Nested dissection of this graph, self-loops are ignored. Every
+     * (sub)graph is split with bisect, the parts are extracted with
+     * extract_subgraph and dissected recursively, as OpenMP tasks.
+     * Subgraphs with at most leaf vertices are not further
+     * dissected.
+     *
+     * \param perm on output, the fill reducing permutation, perm[old]
+     * = new
+     * \param iperm on output, the inverse of perm
+     * \return the separator tree of the dissection, in postorder
+     */
+    SeparatorTree<integer_t>
+    nested_dissection(int leaf, std::vector<integer_t>& perm,
+                      std::vector<integer_t>& iperm,
+                      const Bisection& bisect) const;
+
+    /**
+     * Fiduccia-Mattheyses refinement of the edge bisection in part
+     * (0 or 1 for each vertex). vw are the vertex weights and ew the
+     * edge weights, ew[j] is the weight of edge ind(j).
+     */
+    void fm_refine(const std::vector<integer_t>& vw,
+                   const std::vector<integer_t>& ew,
+                   std::vector<char>& part, int depth) const;
+
+    /**
+     * Turn the edge bisection in where into a vertex separator,
+     * marked with 2 in where, and refine it with FM.
+     */
+    void vertex_separator(const std::vector<integer_t>& vw,
+                          std::vector<char>& where) const;
+
+    integer_t edge_cut(const std::vector<integer_t>& ew,
+                       const std::vector<char>& part) const;
+
+    /**
+     * A vertex at (approximately) maximal distance from the others,
+     * found with two breadth first searches.
+     */
+    integer_t pseudo_peripheral() const;
+
     template<typename int_t> DenseMatrix<bool>
     admissibility(const std::vector<int_t>& tiles) const;
 
@@ -120,6 +173,12 @@ namespace strumpack {
                          integer_t& parts, integer_t part,
                          integer_t count, const Length2Edges& l2) const;
 
+    static void
+    dissect_recursive(CSRGraph<integer_t>& g, std::vector<integer_t>& gid,
+                      integer_t off, integer_t leaf, integer_t* iperm,
+                      std::vector<Separator<integer_t>>& tree,
+                      const Bisection& bisect, int depth);
+
     /**
      * Extract the separator from sep_begin to sep_end. Also add extra
      * length-2 edges if sep_order_level > 0.
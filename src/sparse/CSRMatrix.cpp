@@ -640,6 +640,56 @@ namespace strumpack {
     }
   }
 
+  /**
+   * Same traversal as extract_front, but instead of copying the
+   * values, record where each nonzero goes.
+   */
+  template<typename scalar_t,typename integer_t> void
+  CSRMatrix<scalar_t,integer_t>::front_assembly_map
+  (integer_t slo, integer_t shi, const std::vector<integer_t>& upd,
+   FrontAssemblyMap<integer_t>& map) const {
+    integer_t ds = shi - slo, du = upd.size();
+    map.clear();
+    auto push = [](std::vector<integer_t>& m, integer_t j,
+                   integer_t r, integer_t c) {
+      m.push_back(j); m.push_back(r); m.push_back(c);
+    };
+    for (integer_t row=0; row<ds; row++) { // separator rows
+      integer_t upd_ptr = 0;
+      const auto hij = ptr_[row+slo+1];
+      for (integer_t j=ptr_[row+slo]; j<hij; j++) {
+        integer_t col = ind_[j];
+        if (col >= slo) {
+          if (col < shi)
+            push(map.F11, j, row, col-slo);
+          else {
+            while (upd_ptr<du && upd[upd_ptr]<col)
+              upd_ptr++;
+            if (upd_ptr == du) break;
+            if (upd[upd_ptr] == col)
+              push(map.F12, j, row, upd_ptr);
+          }
+        }
+      }
+    }
+    for (integer_t i=0; i<du; i++) { // update rows
+      auto row = upd[i];
+      const auto hij = ptr_[row+1];
+      for (integer_t j=ptr_[row]; j<hij; j++) {
+        integer_t col = ind_[j];
+        if (col >= slo) {
+          if (col < shi)
+            push(map.F21, j, i, col-slo);
+          else break;
+        }
+      }
+    }
+    map.F11.shrink_to_fit();
+    map.F12.shrink_to_fit();
+    map.F21.shrink_to_fit();
+    map.set = true;
+  }
+
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::front_multiply
   (integer_t slo, integer_t shi, const std::vector<integer_t>& upd,
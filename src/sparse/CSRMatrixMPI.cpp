@@ -36,6 +36,7 @@
 
 
 #include "CSRMatrixMPI.hpp"
+#include "AuctionMatchingMPI.hpp"
 #if defined(STRUMPACK_USE_COMBBLAS)
 #include "AWPMCombBLAS.hpp"
 #endif
@@ -399,7 +400,8 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> CSRGraph<integer_t>
   CSRMatrixMPI<scalar_t,integer_t>::get_sub_graph
   (const std::vector<integer_t>& perm,
-   const std::vector<std::pair<integer_t,integer_t>>& graph_ranges) const {
+   const std::vector<std::pair<integer_t,integer_t>>& graph_ranges,
+   std::vector<Triplet<scalar_t,integer_t>>* vals) const {
     auto rank = comm_.rank();
     auto P = comm_.size();
     std::vector<int> scnts(P, 0), dest(lrows_, -1);
@@ -414,6 +416,7 @@ namespace strumpack {
         }
     }
     std::vector<std::vector<integer_t>> sbuf(P);
+    std::vector<std::vector<scalar_t>> vbuf(vals ? P : 0);
     for (int p=0; p<P; p++)
       sbuf[p].reserve(scnts[p]);
     for (integer_t row=0; row<lrows_; row++) {
@@ -426,8 +429,28 @@ namespace strumpack {
       for (auto j=ptr_[row]; j<ptr_[row+1]; j++)
         // send the actual edges
         sbuf[d].push_back(perm[ind_[j]]);
+      if (vals)
+        vbuf[d].insert(vbuf[d].end(), val_.begin()+ptr_[row],
+                       val_.begin()+ptr_[row+1]);
     }
     auto rbuf = comm_.all_to_all_v(sbuf);
+    if (vals) {
+      // the values arrive in the same order as the edges
+      auto rvals = comm_.all_to_all_v(vbuf);
+      std::vector<integer_t> iperm(perm.size());
+      for (std::size_t i=0; i<perm.size(); i++)
+        iperm[perm[i]] = i;
+      vals->clear();
+      vals->reserve(rvals.size());
+      std::size_t prbuf = 0, pv = 0;
+      while (prbuf < rbuf.size()) {
+        auto r = iperm[rbuf[prbuf]];
+        auto ne = rbuf[prbuf+1];
+        for (integer_t k=0; k<ne; k++)
+          vals->emplace_back(r, iperm[rbuf[prbuf+2+k]], rvals[pv++]);
+        prbuf += 2 + ne;
+      }
+    }
     auto n_vert = graph_ranges[rank].second - graph_ranges[rank].first;
     std::vector<integer_t> edge_count(n_vert);
     integer_t n_edges = 0;
@@ -507,13 +530,19 @@ namespace strumpack {
     spmv_rind.erase
       (std::unique(spmv_rind.begin(), spmv_rind.end()), spmv_rind.end());
 
-    spmv_bufs_.prbuf.reserve(nr_offdiag_nnz);
+    spmv_bufs_.poff.resize(lrows_+1);
+    spmv_bufs_.poff[0] = 0;
     for (integer_t r=0; r<lrows_; r++)
-      for (integer_t j=offdiag_start_[r]; j<ptr_[r+1]; j++)
-        spmv_bufs_.prbuf.push_back
-          (std::distance
-           (spmv_rind.begin(), std::lower_bound
-            (spmv_rind.begin(), spmv_rind.end(), ind_[j])));
+      spmv_bufs_.poff[r+1] =
+        spmv_bufs_.poff[r] + ptr_[r+1] - offdiag_start_[r];
+    spmv_bufs_.prbuf.resize(nr_offdiag_nnz);
+#pragma omp parallel for
+    for (integer_t r=0; r<lrows_; r++)
+      for (integer_t j=offdiag_start_[r], k=spmv_bufs_.poff[r];
+           j<ptr_[r+1]; j++, k++)
+        spmv_bufs_.prbuf[k] = std::distance
+          (spmv_rind.begin(), std::lower_bound
+           (spmv_rind.begin(), spmv_rind.end(), ind_[j]));
 
     // how much to receive from each proc
     std::vector<int> rsizes(P), ssizes(P);
@@ -558,8 +587,40 @@ namespace strumpack {
                   spmv_bufs_.soff[p+1] - spmv_bufs_.soff[p],
                   spmv_bufs_.sranks[p], 0, &req[npr+p]);
     wait_all(req);
-    spmv_bufs_.rbuf.resize(oset_recv);
-    spmv_bufs_.sbuf.resize(oset_send);
+  }
+
+  /**
+   * Return the persistent send/receive requests for the halo
+   * exchange of nrhs right hand sides, creating them on first use.
+   * The send and receive buffers store the nrhs values for each
+   * index contiguously, so the data for each neighbor is a single
+   * contiguous message. The requests are cached per nrhs, so
+   * alternating between for instance 1 and k right hand sides does
+   * not recreate them.
+   */
+  template<typename scalar_t,typename integer_t>
+  typename SPMVBuffers<scalar_t,integer_t>::Requests&
+  CSRMatrixMPI<scalar_t,integer_t>::setup_spmv_requests
+  (std::size_t nrhs) const {
+    setup_spmv_buffers();
+    auto& b = spmv_bufs_;
+    auto it = b.reqs.find(nrhs);
+    if (it != b.reqs.end()) return it->second;
+    auto& q = b.reqs[nrhs];
+    q.sbuf.resize(b.sind.size() * nrhs);
+    q.rbuf.resize(std::size_t(b.roffs.back()) * nrhs);
+    q.sreq.resize(b.sranks.size());
+    q.rreq.resize(b.rranks.size());
+    auto tp = mpi_type<scalar_t>();
+    for (std::size_t p=0; p<b.sranks.size(); p++)
+      MPI_Send_init(q.sbuf.data() + b.soff[p]*nrhs,
+                    int((b.soff[p+1] - b.soff[p])*nrhs), tp,
+                    b.sranks[p], 0, comm_.comm(), &q.sreq[p]);
+    for (std::size_t p=0; p<b.rranks.size(); p++)
+      MPI_Recv_init(q.rbuf.data() + b.roffs[p]*nrhs,
+                    int((b.roffs[p+1] - b.roffs[p])*nrhs), tp,
+                    b.rranks[p], 0, comm_.comm(), &q.rreq[p]);
+    return q;
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -568,51 +629,63 @@ namespace strumpack {
     assert(x.cols() == y.cols());
     assert(x.rows() == std::size_t(lrows_));
     assert(y.rows() == std::size_t(lrows_));
-    for (std::size_t c=0; c<x.cols(); c++)
-      spmv(x.ptr(0,c), y.ptr(0,c));
+    if (!x.cols()) return;
+    spmv(x.cols(), x.data(), x.ld(), y.data(), y.ld());
   }
 
   template<typename scalar_t,typename integer_t> void
   CSRMatrixMPI<scalar_t,integer_t>::spmv
   (const scalar_t* x, scalar_t* y) const {
-    setup_spmv_buffers();
-
-    for (std::size_t i=0; i<spmv_bufs_.sind.size(); i++)
-      spmv_bufs_.sbuf[i] =
-        x[spmv_bufs_.sind[i]-brow_];
-
-    std::vector<MPI_Request> sreq(spmv_bufs_.sranks.size()),
-      rreq(spmv_bufs_.rranks.size());
-    for (std::size_t p=0; p<spmv_bufs_.sranks.size(); p++)
-      comm_.isend(spmv_bufs_.sbuf.data() + spmv_bufs_.soff[p],
-                  spmv_bufs_.soff[p+1] - spmv_bufs_.soff[p],
-                  spmv_bufs_.sranks[p], 0, &sreq[p]);
+    spmv(1, x, lrows_, y, lrows_);
+  }
 
-    for (std::size_t p=0; p<spmv_bufs_.rranks.size(); p++)
-      comm_.irecv(spmv_bufs_.rbuf.data() + spmv_bufs_.roffs[p],
-                  spmv_bufs_.roffs[p+1] - spmv_bufs_.roffs[p],
-                  spmv_bufs_.rranks[p], 0, &rreq[p]);
+  template<typename scalar_t,typename integer_t> void
+  CSRMatrixMPI<scalar_t,integer_t>::spmv
+  (std::size_t nrhs, const scalar_t* x, int ldx,
+   scalar_t* y, int ldy) const {
+    auto& q = setup_spmv_requests(nrhs);
+    auto& b = spmv_bufs_;
+    const auto nsend = b.sind.size();
+    // post the receives first, then pack and send all columns at once
+    if (!q.rreq.empty())
+      MPI_Startall(q.rreq.size(), q.rreq.data());
+#pragma omp parallel for
+    for (std::size_t i=0; i<nsend; i++)
+      for (std::size_t c=0; c<nrhs; c++)
+        q.sbuf[i*nrhs+c] = x[b.sind[i]-brow_+c*ldx];
+    if (!q.sreq.empty())
+      MPI_Startall(q.sreq.size(), q.sreq.data());
 
     // first do the block diagonal part, while the communication is going on
 #pragma omp parallel for
     for (integer_t r=0; r<lrows_; r++) {
-      auto yrow = scalar_t(0.);
-      for (auto j=ptr_[r]; j<offdiag_start_[r]; j++)
-        yrow += val_[j] * x[ind_[j] - brow_];
-      y[r] = yrow;
+      for (std::size_t c=0; c<nrhs; c++) {
+        auto yrow = scalar_t(0.);
+        for (auto j=ptr_[r]; j<offdiag_start_[r]; j++)
+          yrow += val_[j] * x[ind_[j]-brow_+c*ldx];
+        y[r+c*ldy] = yrow;
+      }
     }
     // wait for incoming messages
-    wait_all(rreq);
+    if (!q.rreq.empty())
+      MPI_Waitall(q.rreq.size(), q.rreq.data(), MPI_STATUSES_IGNORE);
 
-    // do the block off-diagonal part of the matrix
-    // TODO some openmp here
-    auto pbuf = spmv_bufs_.prbuf.begin();
-    for (integer_t r=0; r<lrows_; r++)
-      for (integer_t j=offdiag_start_[r]; j<ptr_[r+1]; j++)
-        y[r] += val_[j] * spmv_bufs_.rbuf[*pbuf++];
+    // do the block off-diagonal part of the matrix, each row has its
+    // own offset in prbuf, so rows can be processed independently
+#pragma omp parallel for
+    for (integer_t r=0; r<lrows_; r++) {
+      const auto pb = b.prbuf.data() + b.poff[r] - offdiag_start_[r];
+      for (std::size_t c=0; c<nrhs; c++) {
+        auto yrow = scalar_t(0.);
+        for (integer_t j=offdiag_start_[r]; j<ptr_[r+1]; j++)
+          yrow += val_[j] * q.rbuf[pb[j]*nrhs+c];
+        y[r+c*ldy] += yrow;
+      }
+    }
 
     // wait for all send messages to finish
-    wait_all(sreq);
+    if (!q.sreq.empty())
+      MPI_Waitall(q.sreq.size(), q.sreq.data(), MPI_STATUSES_IGNORE);
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -730,7 +803,8 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t>
   MatchingData<scalar_t,integer_t>
-  CSRMatrixMPI<scalar_t,integer_t>::matching(MatchingJob job, bool apply) {
+  CSRMatrixMPI<scalar_t,integer_t>::matching
+  (MatchingJob job, bool apply, bool auction) {
     if (job == MatchingJob::MAX_CARDINALITY) {
       if (comm_.is_root())
         std::cerr << "# WARNING matching job not supported." << std::endl;
@@ -754,6 +828,26 @@ namespace strumpack {
       return M;
     }
 
+    if (auction && job == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING) {
+      Match_t M(job, this->size());
+      int info = AuctionMatchingMPI
+        (comm_, dist_, this->ptr(), this->ind(), this->val(),
+         M.Q, M.R, M.C);
+      if (info == 1) throw std::runtime_error
+        (std::string("matrix is structurally singular"));
+      if (info == 0) {
+        M.auction = true;
+        if (apply) {
+          scale_real(M.R, M.C);
+          permute_columns(M.Q);
+        }
+        return M;
+      }
+      if (comm_.is_root())
+        std::cerr << "# WARNING: distributed matching did not converge,"
+                  << " falling back to MC64 on the root" << std::endl;
+    }
+
     auto Aseq = gather();
     Match_t M;
     int ierr = 0;
@@ -892,7 +986,7 @@ namespace strumpack {
         ind_[j] = iperm[ind_[j]];
     split_diag_offdiag();
     symm_sparse_ = false;
-    spmv_bufs_ = SPMVBuffers<scalar_t,integer_t>();
+    spmv_bufs_.clear();
   }
 
   // Apply row and column scaling. Dr is LOCAL, Dc is global!
@@ -1027,7 +1121,7 @@ namespace strumpack {
       nnz_ = total_new_nnz;
     }
     symm_sparse_ = true;
-    spmv_bufs_ = SPMVBuffers<scalar_t,integer_t>();
+    spmv_bufs_.clear();
   }
 
   template<typename scalar_t,typename integer_t> int
@@ -1057,25 +1151,16 @@ namespace strumpack {
   typename RealType<scalar_t>::value_type
   CSRMatrixMPI<scalar_t,integer_t>::max_scaled_residual
   (const scalar_t* x, const scalar_t* b) const {
-    setup_spmv_buffers();
-
-    for (std::size_t i=0; i<spmv_bufs_.sind.size(); i++)
-      spmv_bufs_.sbuf[i] = x[spmv_bufs_.sind[i]-brow_];
-
-    std::vector<MPI_Request> sreq(spmv_bufs_.sranks.size());
-    for (std::size_t p=0; p<spmv_bufs_.sranks.size(); p++)
-      comm_.isend(spmv_bufs_.sbuf.data() + spmv_bufs_.soff[p],
-                  spmv_bufs_.soff[p+1] - spmv_bufs_.soff[p],
-                  spmv_bufs_.sranks[p], 0, &sreq[p]);
-
-    std::vector<MPI_Request> rreq(spmv_bufs_.rranks.size());
-    for (std::size_t p=0; p<spmv_bufs_.rranks.size(); p++)
-      comm_.irecv(spmv_bufs_.rbuf.data() + spmv_bufs_.roffs[p],
-                  spmv_bufs_.roffs[p+1] - spmv_bufs_.roffs[p],
-                  spmv_bufs_.rranks[p], 0, &rreq[p]);
-
-    //MPI_Waitall(rreq.size(), rreq.data(), MPI_STATUSES_IGNORE);
-    wait_all(rreq);
+    auto& q = setup_spmv_requests(1);
+    auto& sb = spmv_bufs_;
+    if (!q.rreq.empty())
+      MPI_Startall(q.rreq.size(), q.rreq.data());
+    for (std::size_t i=0; i<sb.sind.size(); i++)
+      q.sbuf[i] = x[sb.sind[i]-brow_];
+    if (!q.sreq.empty())
+      MPI_Startall(q.sreq.size(), q.sreq.data());
+    if (!q.rreq.empty())
+      MPI_Waitall(q.rreq.size(), q.rreq.data(), MPI_STATUSES_IGNORE);
 
     real_t m = real_t(0.);
     auto pbuf = spmv_bufs_.prbuf.begin();
@@ -1089,14 +1174,15 @@ namespace strumpack {
         abs_res += std::abs(val_[j]) * std::abs(x[c-brow_]);
       }
       for (auto j=offdiag_start_[r]; j<ptr_[r+1]; j++) {
-        true_res -= val_[j] * spmv_bufs_.rbuf[*pbuf];
-        abs_res += std::abs(val_[j]) * std::abs(spmv_bufs_.rbuf[*pbuf]);
+        true_res -= val_[j] * q.rbuf[*pbuf];
+        abs_res += std::abs(val_[j]) * std::abs(q.rbuf[*pbuf]);
         pbuf++;
       }
       m = std::max(m, std::abs(true_res) / std::abs(abs_res));
     }
     // wait for all send messages to finish
-    wait_all(sreq);
+    if (!q.sreq.empty())
+      MPI_Waitall(q.sreq.size(), q.sreq.data(), MPI_STATUSES_IGNORE);
     return comm_.all_reduce(m, MPI_MAX);
   }
 
@@ -36,6 +36,7 @@
 #include <vector>
 #include <tuple>
 #include <memory>
+#include <map>
 
 #include "CSRMatrix.hpp"
 #include "misc/MPIWrapper.hpp"
@@ -47,12 +48,51 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> class SPMVBuffers {
   public:
+    SPMVBuffers() = default;
+    // the persistent requests are bound to the send/receive buffers
+    // of this object, so a copy always starts out uninitialized
+    SPMVBuffers(const SPMVBuffers&) {}
+    SPMVBuffers& operator=(const SPMVBuffers&) { clear(); return *this; }
+    ~SPMVBuffers() { free_requests(); }
+
+    // persistent send/receive requests, with their buffers, for a
+    // given number of right hand sides. The values for all right
+    // hand sides are packed in a single message per neighbor.
+    struct Requests {
+      std::vector<scalar_t> sbuf, rbuf;
+      std::vector<MPI_Request> sreq, rreq;
+    };
+
     bool initialized = false;
     std::vector<integer_t> sranks, rranks, soff, roffs, sind;
-    std::vector<scalar_t> sbuf, rbuf;
     // for each off-diagonal entry spmv_prbuf stores the
-    // corresponding index in the receive buffer
-    std::vector<integer_t> prbuf;
+    // corresponding index in the receive buffer, the off-diagonal
+    // entries of local row r start at prbuf[poff[r]]
+    std::vector<integer_t> prbuf, poff;
+    // one set of requests per nrhs that was used, map nodes are
+    // never moved, so the buffers stay valid
+    std::map<std::size_t,Requests> reqs;
+
+    void clear() {
+      free_requests();
+      initialized = false;
+      for (auto v : {&sranks, &rranks, &soff, &roffs, &sind, &prbuf, &poff})
+        v->clear();
+    }
+    void free_requests() {
+      // requests can no longer be freed after MPI_Finalize, for
+      // instance for a matrix with static storage duration
+      int finalized = 0;
+      MPI_Finalized(&finalized);
+      if (!finalized)
+        for (auto& q : reqs) {
+          for (auto& r : q.second.sreq)
+            if (r != MPI_REQUEST_NULL) MPI_Request_free(&r);
+          for (auto& r : q.second.rreq)
+            if (r != MPI_REQUEST_NULL) MPI_Request_free(&r);
+        }
+      reqs.clear();
+    }
   };
 
 
@@ -118,11 +158,17 @@ namespace strumpack {
 
 
     /**
-     * This gathers the matrix to 1 process, then applies MC64
-     * sequentially. lDr and gDc are only set when job ==
+     * For MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING with
+     * auction==true, this runs a distributed auction algorithm, see
+     * AuctionMatchingMPI. Otherwise, or if the auction fails, this
+     * gathers the matrix to 1 process, then applies MC64
+     * sequentially, see MatchingData::auction for which one was
+     * used. lDr and gDc are only set when job ==
      * MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING.
      *
      * \param job The job type.
+     * \param auction Use the distributed auction algorithm instead of
+     * MC64, see SPOptions::enable_auction_matching().
      * \param perm Output, column permutation vector containing the
      * GLOBAL column permutation, such that the column perm[j] of the
      * original matrix is column j in the permuted matrix.
@@ -131,7 +177,8 @@ namespace strumpack {
      * \param gDc Col scaling factors, this is global, ie, Dc.size()
      * == this->size()
      */
-    Match_t matching(MatchingJob job, bool apply=true) override;
+    Match_t matching(MatchingJob job, bool apply=true,
+                     bool auction=false) override;
 
     Equil_t equilibration() const override;
 
@@ -152,10 +199,18 @@ namespace strumpack {
     std::unique_ptr<CSRMatrixMPI<scalar_t,integer_t>>
     add_missing_diagonal(const scalar_t& s) const;
 
+    /**
+     * Extract the subgraph of (permuted) rows graph_ranges[rank] on
+     * each process. If vals is not null, the nonzeros of these rows
+     * are also collected, as triplets in the original (not permuted)
+     * numbering, together with the graph.
+     */
     CSRGraph<integer_t>
     get_sub_graph(const std::vector<integer_t>& perm,
                   const std::vector<std::pair<integer_t,integer_t>>&
-                  graph_ranges) const;
+                  graph_ranges,
+                  std::vector<Triplet<scalar_t,integer_t>>* vals=nullptr)
+      const;
 
     CSRGraph<integer_t>
     extract_graph(int ordering_level,
@@ -238,6 +293,10 @@ namespace strumpack {
   protected:
     void split_diag_offdiag();
     void setup_spmv_buffers() const;
+    typename SPMVBuffers<scalar_t,integer_t>::Requests&
+    setup_spmv_requests(std::size_t nrhs) const;
+    void spmv(std::size_t nrhs, const scalar_t* x, int ldx,
+              scalar_t* y, int ldy) const;
 
     // TODO use MPIComm
     MPIComm comm_;
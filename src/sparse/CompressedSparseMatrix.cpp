@@ -36,6 +36,7 @@
 #include "CompressedSparseMatrix.hpp"
 #include "misc/Tools.hpp"
 #include "CSRGraph.hpp"
+#include "AuctionMatching.hpp"
 #include "StrumpackConfig.hpp"
 #include "dense/DenseMatrix.hpp"
 #if defined(STRUMPACK_USE_MPI)
@@ -93,7 +94,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t>
   MatchingData<scalar_t,integer_t>
   CompressedSparseMatrix<scalar_t,integer_t>::matching
-  (MatchingJob job, bool apply) {
+  (MatchingJob job, bool apply, bool auction) {
     Match_t M(job, n_);
     if (job == MatchingJob::NONE)
       return M;
@@ -106,7 +107,18 @@ namespace strumpack {
                 << std::endl;
       return M;
     }
-    int info = strumpack_mc64(job, M);
+    int info = -1;
+    // MC64 is sequential, the auction algorithm is threaded
+    if (auction && job == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING) {
+      info = AuctionMatching
+        (n_, ptr_.data(), ind_.data(), val_.data(),
+         M.Q.data(), M.R.data(), M.C.data());
+      if (info == -1)
+        std::cerr << "# WARNING: auction matching did not converge,"
+                  << " falling back to MC64" << std::endl;
+      else M.auction = true;
+    }
+    if (info == -1) info = strumpack_mc64(job, M);
     switch (info) {
     case 0: break;
     case 1: throw std::runtime_error
@@ -133,6 +145,21 @@ namespace strumpack {
     symm_sparse_ = false;
   }
 
+  template<typename scalar_t,typename integer_t> void
+  CompressedSparseMatrix<scalar_t,integer_t>::extract_front
+  (DenseM_t& F11, DenseM_t& F12, DenseM_t& F21,
+   const FrontAssemblyMap<integer_t>& map) const {
+    auto scatter = [&](DenseM_t& F, const std::vector<integer_t>& m) {
+      const auto n = m.size();
+      for (std::size_t k=0; k<n; k+=3)
+        F(m[k+1], m[k+2]) = val_[m[k]];
+    };
+    scatter(F11, map.F11);
+    scatter(F12, map.F12);
+    scatter(F21, map.F21);
+    params::assembly_map_fronts++;
+  }
+
   template<typename scalar_t,typename integer_t> void
   CompressedSparseMatrix<scalar_t,integer_t>::symmetrize_sparsity() {
     if (symm_sparse_) return;
@@ -51,6 +51,35 @@ namespace strumpack {
   template<typename scalar_t> class DistributedMatrix;
 
 
+  /**
+   * \class FrontAssemblyMap
+   * \brief Precomputed scatter lists from the nonzeros of a
+   * compressed sparse matrix to the F11, F12 and F21 blocks of a
+   * single front.
+   *
+   * Each list stores (nonzero index, row, column) triplets. As long
+   * as the sparsity pattern of the matrix does not change, a front
+   * can be assembled from these lists without any searching.
+   *
+   * \see CompressedSparseMatrix::front_assembly_map
+   */
+  template<typename integer_t> class FrontAssemblyMap {
+  public:
+    std::vector<integer_t> F11, F12, F21;
+    bool set = false;
+
+    void clear() {
+      F11 = std::vector<integer_t>();
+      F12 = std::vector<integer_t>();
+      F21 = std::vector<integer_t>();
+      set = false;
+    }
+    std::size_t memory() const {
+      return (F11.capacity() + F12.capacity() + F21.capacity())
+        * sizeof(integer_t);
+    }
+  };
+
   template<typename scalar_t, typename integer_t,
            typename real_t = typename RealType<scalar_t>::value_type>
   class MatchingData {
@@ -68,6 +97,9 @@ namespace strumpack {
     MatchingJob job = MatchingJob::NONE;
     std::vector<integer_t> Q;
     std::vector<real_t> R, C;
+    /** Q, R and C were computed with the auction algorithm, not with
+        MC64 (the fallback if the auction does not converge) */
+    bool auction = false;
 
     integer_t mc64_work_int(std::size_t n, std::size_t nnz) const {
       switch (job) {
@@ -340,7 +372,16 @@ namespace strumpack {
 
     virtual void equilibrate(const Equil_t&) {}
 
-    virtual Match_t matching(MatchingJob, bool apply=true);
+    /**
+     * Compute (and apply if apply==true) a column permutation and,
+     * for MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING, row and column
+     * scaling. This uses MC64, unless auction==true and job ==
+     * MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING, in which case a
+     * multithreaded auction algorithm is used (with MC64 as
+     * fallback). MatchingData::auction tells which one was used.
+     */
+    virtual Match_t matching(MatchingJob job, bool apply=true,
+                             bool auction=false);
 
     virtual void apply_matching(const Match_t&);
 
@@ -385,6 +426,17 @@ namespace strumpack {
                   integer_t slo, integer_t shi,
                   const std::vector<integer_t>& upd,
                   int depth) const = 0;
+    /**
+     * Compute the scatter lists for extract_front(F11, F12, F21,
+     * map). Implementations that do not support this leave map
+     * unset, and the front is then assembled with extract_front.
+     */
+    virtual void
+    front_assembly_map(integer_t slo, integer_t shi,
+                       const std::vector<integer_t>& upd,
+                       FrontAssemblyMap<integer_t>& map) const {}
+    void extract_front(DenseM_t& F11, DenseM_t& F12, DenseM_t& F21,
+                       const FrontAssemblyMap<integer_t>& map) const;
     virtual void
     push_front_elements(integer_t, integer_t, const std::vector<integer_t>&,
                         std::vector<Triplet<scalar_t>>&,
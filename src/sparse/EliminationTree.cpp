@@ -32,6 +32,7 @@
 #include "EliminationTree.hpp"
 #include "fronts/FrontFactory.hpp"
 #include "fronts/Front.hpp"
+#include "fronts/FrontDense.hpp"
 #include "SeparatorTree.hpp"
 
 namespace strumpack {
@@ -39,12 +40,14 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t>
   EliminationTree<scalar_t,integer_t>::EliminationTree
   (const SPOptions<scalar_t>& opts, const SpMat_t& A,
-   SeparatorTree<integer_t>& sep_tree) {
+   SeparatorTree<integer_t>& sep_tree, bool dense_root) {
     std::vector<std::vector<integer_t>> upd(sep_tree.separators());
 #pragma omp parallel default(shared)
 #pragma omp single
     symbolic_factorization(A, sep_tree, sep_tree.root(), upd);
-    root_ = setup_tree(opts, A, sep_tree, upd, sep_tree.root(), 0);
+    root_ = setup_tree
+      (opts, A, sep_tree, upd, sep_tree.root(), 0, dense_root);
+    if (root_) peak_mem_ = root_->order_children_peak_memory();
   }
 
   template<typename scalar_t,typename integer_t>
@@ -128,7 +131,7 @@ namespace strumpack {
   (const SPOptions<scalar_t>& opts, const SpMat_t& A,
    SeparatorTree<integer_t>& sep_tree,
    std::vector<std::vector<integer_t>>& upd,
-   integer_t sep, int level) {
+   integer_t sep, int level, bool dense) {
     auto sep_begin = sep_tree.sizes[sep];
     auto sep_end = sep_tree.sizes[sep+1];
     auto dim_sep = sep_end - sep_begin;
@@ -137,8 +140,14 @@ namespace strumpack {
     // So fix this here!
     if (dim_sep == 0 && sep_tree.lch[sep] != -1)
       sep_begin = sep_end = sep_tree.sizes[sep_tree.rch[sep]+1];
-    auto front = create_frontal_matrix<scalar_t,integer_t>
-      (opts, sep, sep_begin, sep_end, upd[sep], level, nr_fronts_);
+    std::unique_ptr<F_t> front;
+    if (dense) {
+      front = std::make_unique<FrontDense<scalar_t,integer_t>>
+        (sep, sep_begin, sep_end, upd[sep]);
+      nr_fronts_.dense++;
+    } else
+      front = create_frontal_matrix<scalar_t,integer_t>
+        (opts, sep, sep_begin, sep_end, upd[sep], level, nr_fronts_);
     if (sep_tree.lch[sep] != -1)
       front->set_lchild
         (setup_tree(opts, A, sep_tree, upd, sep_tree.lch[sep], level+1));
@@ -154,6 +163,31 @@ namespace strumpack {
     return root_->multifrontal_factorization(A, opts);
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  EliminationTree<scalar_t,integer_t>::Schur_complement
+  (const SpMat_t& A, const SPOptions<scalar_t>& opts, DenseM_t& S) {
+    auto F = dynamic_cast<FrontDense<scalar_t,integer_t>*>(root_.get());
+    if (!F || root_->dim_upd()) {
+      std::cerr << "# ERROR: the Schur complement requires a dense"
+                << " root front without update indices" << std::endl;
+      return ReturnCode::REORDERING_ERROR;
+    }
+    return F->Schur_complement(A, opts, S);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  EliminationTree<scalar_t,integer_t>::setup_assembly_maps
+  (const SpMat_t& A) {
+#pragma omp parallel if(!omp_in_parallel())
+#pragma omp single nowait
+    root_->setup_assembly_maps(A);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  EliminationTree<scalar_t,integer_t>::clear_assembly_maps() {
+    root_->clear_assembly_maps();
+  }
+
   template<typename scalar_t,typename integer_t> void
   EliminationTree<scalar_t,integer_t>::delete_factors() {
     root_->delete_factors();
@@ -52,17 +52,48 @@ namespace strumpack {
   public:
     EliminationTree() {}
 
+    /**
+     * Construct the tree of frontal matrices from the separator
+     * tree. With dense_root, the root front is always a dense front,
+     * regardless of the compression options, which is required for
+     * Schur_complement.
+     */
     EliminationTree(const SPOptions<scalar_t>& opts,
                     const SpMat_t& A,
-                    SeparatorTree<integer_t>& sep_tree);
+                    SeparatorTree<integer_t>& sep_tree,
+                    bool dense_root=false);
     virtual ~EliminationTree();
 
     virtual ReturnCode
     multifrontal_factorization(const SpMat_t& A,
                                const SPOptions<scalar_t>& opts);
 
+    /**
+     * Factor all fronts except the root, and return the assembled,
+     * but not factored, root front in S. This is the Schur complement
+     * of the unknowns in the root separator. This requires that the
+     * tree was constructed with dense_root, and that the root front
+     * has no update indices.
+     */
+    ReturnCode Schur_complement(const SpMat_t& A,
+                                const SPOptions<scalar_t>& opts,
+                                DenseM_t& S);
+
     virtual void delete_factors();
 
+    /**
+     * Precompute the front assembly maps, see
+     * Front::setup_assembly_maps. This is done once the matrix is
+     * permuted and the separators are reordered.
+     */
+    void setup_assembly_maps(const SpMat_t& A);
+
+    /**
+     * Drop the precomputed front assembly maps, for instance when
+     * the sparsity pattern of the matrix changed.
+     */
+    void clear_assembly_maps();
+
     virtual void multifrontal_solve(DenseM_t& x) const;
 
     virtual void
@@ -85,6 +116,14 @@ namespace strumpack {
 
     virtual FrontCounter front_counter() const { return nr_fronts_; }
 
+    /**
+     * Predicted peak active memory (frontal matrices and
+     * contribution block stack) of the factorization, in number of
+     * scalars, after reordering the children, see
+     * Front::order_children_peak_memory.
+     */
+    virtual long long peak_memory() const { return peak_mem_; }
+
     void draw(const SpMat_t& A, const std::string& name) const;
 
     F_t* root() const;
@@ -92,13 +131,14 @@ namespace strumpack {
   protected:
     FrontCounter nr_fronts_;
     std::unique_ptr<F_t> root_;
+    long long peak_mem_ = 0;
 
   private:
     std::unique_ptr<F_t>
     setup_tree(const SPOptions<scalar_t>& opts, const SpMat_t& A,
                SeparatorTree<integer_t>& sep_tree,
                std::vector<std::vector<integer_t>>& upd,
-               integer_t sep, int level);
+               integer_t sep, int level, bool dense=false);
 
     void
     symbolic_factorization(const SpMat_t& A,
@@ -53,6 +53,11 @@ namespace strumpack {
     return this->nr_fronts_.reduce(comm_);
   }
 
+  template<typename scalar_t,typename integer_t> long long
+  EliminationTreeMPI<scalar_t,integer_t>::peak_memory() const {
+    return comm_.all_reduce(this->peak_mem_, MPI_MAX);
+  }
+
   template<typename scalar_t,typename integer_t> void
   EliminationTreeMPI<scalar_t,integer_t>::update_local_ranges
   (integer_t lo, integer_t hi) {
@@ -61,6 +61,12 @@ namespace strumpack {
     long long dense_factor_nonzeros() const override;
     const MPIComm& Comm() const { return comm_; }
 
+    /**
+     * Range of (permuted) rows of the local subtree of this process,
+     * ie., of the fronts which are factored by this process alone.
+     */
+    const SepRange& local_range() const { return local_range_; }
+
     ReturnCode inertia(integer_t& neg,
                        integer_t& zero,
                        integer_t& pos) const override;
@@ -73,10 +79,10 @@ namespace strumpack {
     const MPIComm& comm_;
     int rank_, P_;
 
-    std::vector<SepRange> subtree_ranges_;
     SepRange local_range_;
 
     virtual FrontCounter front_counter() const override;
+    long long peak_memory() const override;
     void update_local_ranges(integer_t lo, integer_t hi);
   };
 
@@ -27,6 +27,8 @@
  *
  */
 #include <stack>
+#include <functional>
+#include <tuple>
 
 #include "EliminationTreeMPIDist.hpp"
 #include "Redistribute.hpp"
@@ -51,8 +53,7 @@ namespace strumpack {
     // every process is responsible for 1 distributed separator, so
     // store only 1 dist_upd
     std::vector<integer_t> dist_upd, dleaf_upd;
-    std::vector<float> ltree_work(nd_.ltree().separators()),
-      dtree_work(nd_.tree().separators());
+    std::vector<float> ltree_work(nd_.ltree().separators());
 
     float dsep_work, dleaf_work;
     MPIComm::control_start("symbolic_factorization");
@@ -60,46 +61,128 @@ namespace strumpack {
     symb_fact(lupd, ltree_work, dist_upd, dsep_work, dleaf_upd, dleaf_work);
     MPIComm::control_stop("symbolic_factorization");
 
-    {
-      auto ndseps = nd_.tree().separators();
-      // communicate dtree_work to everyone
-      std::vector<float> sbuf(2*P_);
-      for (integer_t dsep=0; dsep<ndseps; dsep++)
-        if (rank_ == nd_.proc_dist_sep[dsep]) {
-          sbuf[2*rank_] = dleaf_work;
-          sbuf[2*rank_+1] = dsep_work;
-        }
-      comm_.all_gather(sbuf.data(), 2);
-      for (integer_t dsep=0; dsep<ndseps; dsep++) {
-        auto i = 2 * nd_.proc_dist_sep[dsep];
-        dtree_work[dsep] = nd_.tree().is_leaf(dsep) ? sbuf[i] : sbuf[i+1];
-      }
-    }
+    auto dtree_work = dist_subtree_work(dleaf_work, dsep_work);
 
     local_range_ = {A.size(), 0};
     MPIComm::control_start("proportional_mapping");
+    if (opts.partitioner_mapping()) count_dist_leaves();
     this->root_ = prop_map
       (opts, lupd, ltree_work, dist_upd, dleaf_upd, dtree_work,
        nd_.tree().root(), 0, P_, 0, 0, comm_, 0);
+    if (this->root_)
+      this->peak_mem_ = this->root_->order_children_peak_memory();
     MPIComm::control_stop("proportional_mapping");
 
     MPIComm::control_start("block_row_A_to_prop_A");
     if (local_range_.first > local_range_.second)
       local_range_.first = local_range_.second = 0;
-    subtree_ranges_.resize(P_);
-    subtree_ranges_[rank_] = local_range_;
-    comm_.all_gather(subtree_ranges_.data(), 1);
-
-    get_all_pfronts();
     find_row_front(A);
     find_row_owner(A);
     Aprop_.setup(A, nd_, *this, opts.compression() != CompressionType::NONE);
     MPIComm::control_stop("block_row_A_to_prop_A");
   }
 
+  template<typename scalar_t,typename integer_t> void
+  EliminationTreeMPIDist<scalar_t,integer_t>::count_dist_leaves() {
+    auto& t = nd_.tree();
+    auto ndseps = t.separators();
+    dleaves_.assign(ndseps, 0);
+    dleaf0_.assign(ndseps, 0);
+    std::function<void(integer_t)> count = [&](integer_t dsep) {
+      if (t.is_leaf(dsep)) {
+        dleaves_[dsep] = 1;
+        dleaf0_[dsep] = nd_.proc_dist_sep[dsep];
+      } else {
+        auto chl = t.lch[dsep], chr = t.rch[dsep];
+        count(chl);
+        count(chr);
+        dleaves_[dsep] = dleaves_[chl] + dleaves_[chr];
+        dleaf0_[dsep] = std::min(dleaf0_[chl], dleaf0_[chr]);
+      }
+    };
+    count(t.root());
+  }
+
+  /**
+   * Collect the work estimates of all distributed separators, on
+   * every process, communicating only along the distributed
+   * separator tree. First each owner of a distributed separator
+   * receives the work for the subtrees of its children and sends the
+   * work of its subtree to the owner of the parent. The tree is in
+   * postorder, so the subtree of dsep is [first(dsep), dsep]. Then
+   * the owner of the root sends the work of the entire tree back
+   * down. Each process receives this only once, for the highest
+   * distributed separator it owns.
+   */
+  template<typename scalar_t,typename integer_t> std::vector<float>
+  EliminationTreeMPIDist<scalar_t,integer_t>::dist_subtree_work
+  (float dleaf_work, float dsep_work) {
+    auto& t = nd_.tree();
+    integer_t ndseps = t.separators();
+    std::vector<float> work(ndseps);
+    auto owner = [&](integer_t dsep) { return nd_.proc_dist_sep[dsep]; };
+    auto first = [&t](integer_t dsep) {
+      while (!t.is_leaf(dsep)) dsep = t.lch[dsep];
+      return dsep;
+    };
+    // highest distributed separator owned by each process, a process
+    // owns at most 1 leaf and 1 non-leaf distributed separator
+    std::vector<integer_t> top(P_, -1);
+    for (integer_t dsep=0; dsep<ndseps; dsep++)
+      if (top[owner(dsep)] == -1 || !t.is_leaf(dsep))
+        top[owner(dsep)] = dsep;
+    // avoid the tags used in symb_fact and prop_map
+    const int up_tag = 2*ndseps, down_tag = 3*ndseps;
+    std::vector<std::vector<float>> sbuf;
+    sbuf.reserve(2);
+    std::vector<MPIRequest> sreq;
+    for (integer_t dsep=0; dsep<ndseps; dsep++) {
+      if (owner(dsep) != rank_) continue;
+      if (t.is_leaf(dsep)) work[dsep] = dleaf_work;
+      else {
+        for (auto ch : {t.lch[dsep], t.rch[dsep]}) {
+          auto w = comm_.template recv<float>(owner(ch), up_tag+ch);
+          std::copy(w.begin(), w.end(), work.begin()+first(ch));
+        }
+        work[dsep] = dsep_work;
+      }
+      if (t.is_root(dsep)) continue;
+      sbuf.emplace_back(work.begin()+first(dsep), work.begin()+dsep+1);
+      sreq.emplace_back
+        (comm_.isend(sbuf.back(), owner(t.parent[dsep]), up_tag+dsep));
+    }
+    auto root = t.root();
+    if (top[rank_] != root)
+      work = comm_.template recv<float>
+        (top[rank_] == -1 ? owner(root) : owner(t.parent[top[rank_]]),
+         down_tag);
+    auto dsep = top[rank_];
+    if (dsep != -1 && !t.is_leaf(dsep))
+      for (auto ch : {t.lch[dsep], t.rch[dsep]})
+        if (top[owner(ch)] == ch)
+          sreq.emplace_back(comm_.isend(work, owner(ch), down_tag));
+    if (dsep == root) // processes without a distributed separator
+      for (int p=0; p<P_; p++)
+        if (top[p] == -1)
+          sreq.emplace_back(comm_.isend(work, p, down_tag));
+    wait_all(sreq);
+    return work;
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  EliminationTreeMPIDist<scalar_t,integer_t>::kept_subgraph_row
+  (integer_t i) const {
+    auto f = row_pfront(i);
+    if (f >= 0) return false;
+    auto& r = nd_.sub_graph_ranges[-f-1];
+    return i >= r.first && i < r.second;
+  }
+
   template<typename scalar_t,typename integer_t> void
   EliminationTreeMPIDist<scalar_t,integer_t>::update_values
   (const Opts_t& opts, const CSRMPI_t& A, Reord_t& nd) {
+    // the values collected with the subgraphs are outdated
+    nd_.clear_sub_matrix();
     Aprop_.setup(A, nd_, *this, opts.compression() != CompressionType::NONE);
   }
 
@@ -130,9 +213,9 @@ namespace strumpack {
   EliminationTreeMPIDist<scalar_t,integer_t>::get_sparse_mapped_destination
   (const CSRMPI_t& A, integer_t oi, integer_t oj,
    integer_t i, integer_t j, bool duplicate_fronts) const {
-    auto fi = row_pfront_[i];
+    auto fi = row_pfront(i);
     if (fi < 0) return std::make_tuple(-fi-1, 1, 1);
-    auto fj = row_pfront_[j];
+    auto fj = row_pfront(j);
     if (fj < 0) return std::make_tuple(-fj-1, 1, 1);
     constexpr auto B = DistM_t::default_MB;
     int pfront =
@@ -156,47 +239,15 @@ namespace strumpack {
     return std::make_tuple(0, P_, 1);
   }
 
-  template<typename scalar_t,typename integer_t> void
-  EliminationTreeMPIDist<scalar_t,integer_t>::get_all_pfronts() {
-    std::unique_ptr<int[]> iwork(new int[3*P_]);
-    auto nr_par_fronts = iwork.get();
-    auto rcnts = nr_par_fronts + P_;
-    auto rdispls = rcnts + P_;
-    nr_par_fronts[rank_] = 0;
-    for (auto& f : local_pfronts_)
-      if (f.P0 == rank_)
-        nr_par_fronts[rank_]++;
-    comm_.all_gather(nr_par_fronts, 1);
-    int total_pfronts = std::accumulate(nr_par_fronts, nr_par_fronts+P_, 0);
-    all_pfronts_.resize(total_pfronts);
-    rdispls[0] = 0;
-    for (int p=0; p<P_; p++)
-      rcnts[p] = nr_par_fronts[p];
-    for (int p=1; p<P_; p++)
-      rdispls[p] = rdispls[p-1] + rcnts[p-1];
-    {
-      int i = rdispls[rank_];
-      for (auto& f : local_pfronts_)
-        if (f.P0 == rank_)
-          all_pfronts_[i++] = f;
-    }
-    comm_.all_gather_v(all_pfronts_.data(), rcnts, rdispls);
-    ParallelFront::free_mpi_type();
-  }
-
   /**
    * Every row of the matrix is mapped to one specific proces according
    * to the proportional mapping. This function finds out which process
    * and stores that info in a vector<integer_t> row_owner_ of size
    * _A.local_rows().
    *
-   * First gather a list of ParFrontMaster structs for all parallel
-   * fronts on every processor, by gathering the data stored in
-   * local_pfront_master (which keeps only the fronts for which this
-   * process is the master).  Then loop over all elements in
-   * [dist[rank],dist[rank+1]), and figure out to which process that
-   * element belongs, by looking for the rank using the ParFrontMaster
-   * list.
+   * Loop over all elements in [dist[rank],dist[rank+1]), and figure
+   * out to which process that element belongs, by looking up its
+   * front in row_ranges_, see find_row_front.
    */
   template<typename scalar_t,typename integer_t> void
   EliminationTreeMPIDist<scalar_t,integer_t>::find_row_owner
@@ -208,7 +259,7 @@ namespace strumpack {
 #pragma omp parallel for
     for (std::size_t r=0; r<n_loc; r++) {
       std::size_t pr = nd_.perm()[r+lo];
-      auto rf = row_pfront_[pr];
+      auto rf = row_pfront(pr);
       if (rf < 0)
         row_owner_[r] = -rf-1;
       else {
@@ -218,19 +269,66 @@ namespace strumpack {
     }
   }
 
+  /**
+   * The ranges of the distributed separators, and of the local
+   * subgraphs mapped to a single process, are already in row_ranges_
+   * after prop_map. The fronts in a local subgraph which is mapped to
+   * more than one process are only known to the first of those
+   * processes. Ask those processes for the fronts of the subgraphs
+   * which contain rows of the local part of A, or column indices of
+   * its nonzeros. This only communicates with the processes that are
+   * actually needed.
+   */
   template<typename scalar_t,typename integer_t> void
   EliminationTreeMPIDist<scalar_t,integer_t>::find_row_front
   (const CSRMPI_t& A) {
-    row_pfront_.resize(A.size());
-    for (int p=0; p<P_; p++) // local separators
-      for (integer_t r=subtree_ranges_[p].first;
-           r<subtree_ranges_[p].second; r++)
-        row_pfront_[r] = -p-1;
-    for (std::size_t i=0; i<all_pfronts_.size(); i++) {
-      auto& f = all_pfronts_[i];
-      for (integer_t r=f.sep_begin; r<f.sep_end; r++)
-        row_pfront_[r] = i;
+    auto by_lo = [](const RowRange& a, const RowRange& b) {
+      return a.lo < b.lo; };
+    std::sort(remote_leaves_.begin(), remote_leaves_.end(), by_lo);
+    std::vector<bool> needed(remote_leaves_.size(), false);
+    if (!remote_leaves_.empty()) {
+      auto mark = [&](integer_t r) {
+        auto l = std::upper_bound
+          (remote_leaves_.begin(), remote_leaves_.end(), r,
+           [](integer_t i, const RowRange& rr) { return i < rr.lo; });
+        if (l != remote_leaves_.begin() && r < (l-1)->hi)
+          needed[l-1-remote_leaves_.begin()] = true;
+      };
+      auto perm = nd_.perm().data();
+      auto ptr = A.ptr();
+      auto ind = A.ind();
+      for (integer_t r=0, lo=A.begin_row(); r<A.local_rows(); r++) {
+        mark(perm[r+lo]);
+        for (integer_t j=ptr[r]-ptr[0]; j<ptr[r+1]-ptr[0]; j++)
+          mark(perm[ind[j]]);
+      }
+      // for the rows in MatrixReorderingMPI::my_sub_matrix
+      if (nd_.has_sub_matrix() &&
+          nd_.sub_graph_range.first < nd_.sub_graph_range.second)
+        mark(nd_.sub_graph_range.first);
     }
+    std::vector<std::pair<int,std::vector<int>>> sreq;
+    for (std::size_t i=0; i<remote_leaves_.size(); i++)
+      if (needed[i])
+        sreq.emplace_back(remote_leaves_[i].front, std::vector<int>{rank_});
+    auto requesters = comm_.sparse_exchange(sreq, 0);
+    std::vector<std::pair<int,std::vector<ParallelFront>>> sfronts;
+    sfronts.reserve(requesters.size());
+    for (auto p : requesters)
+      sfronts.emplace_back(p, leaf_fronts_);
+    auto fronts = comm_.sparse_exchange(sfronts, 0);
+    ParallelFront::free_mpi_type();
+    for (auto& f : fronts) {
+      if (f.P == 1)
+        row_ranges_.push_back({f.sep_begin, f.sep_end, -f.P0-1});
+      else {
+        row_ranges_.push_back
+          ({f.sep_begin, f.sep_end, int(all_pfronts_.size())});
+        all_pfronts_.push_back(f);
+      }
+    }
+    std::vector<ParallelFront>().swap(leaf_fronts_);
+    std::sort(row_ranges_.begin(), row_ranges_.end(), by_lo);
   }
 
   template<typename scalar_t,typename integer_t> ReturnCode
@@ -262,7 +360,7 @@ namespace strumpack {
         scnts[row_owner_[r]]++;
     else {
       for (integer_t r=0; r<m; r++) {
-        int pf = row_pfront_[nd_.perm()[r+lo]];
+        int pf = row_pfront(nd_.perm()[r+lo]);
         if (pf < 0) scnts[row_owner_[r]] += n;
         else {
           auto& f = all_pfronts_[pf];
@@ -284,7 +382,7 @@ namespace strumpack {
       for (integer_t r=0; r<m; r++) {
         auto destr = row_owner_[r];
         auto permr = nd_.perm()[r+lo];
-        int pf = row_pfront_[permr];
+        int pf = row_pfront(permr);
         if (pf < 0)
           for (integer_t c=0; c<n; c++)
             sbuf[pp[destr]++] = {permr, c, x(r,c)};
@@ -637,14 +735,31 @@ namespace strumpack {
    int P0, int P, int P0_sib, int P_sib, const MPIComm& fcomm, int level) {
     auto owner = nd_.proc_dist_sep[dsep];
     if (nd_.tree().is_leaf(dsep)) {
+      auto& r = nd_.sub_graph_ranges[owner];
+      if (r.first < r.second) {
+        if (P == 1) row_ranges_.push_back({r.first, r.second, -P0-1});
+        else remote_leaves_.push_back({r.first, r.second, P0});
+      }
       RedistSubTree<integer_t> sub_tree
         (nd_.ltree(), dsep, nd_.sub_graph_range.first,
          local_upd, local_subtree_work,
          P0, P, P0_sib, P_sib, owner, comm_);
       if (!sub_tree.nr_sep) return nullptr;
+      if (P > 1 && rank_ == P0)
+        leaf_fronts_ = sub_graph_fronts(sub_tree, P0, P);
       return prop_map_sub_graphs
         (opts, sub_tree, P0, P, P0_sib, P_sib, fcomm, level);
     }
+    // the mapping of the distributed separator tree is known on all
+    // processes
+    auto lo = nd_.tree().sizes[dsep], hi = nd_.tree().sizes[dsep+1];
+    if (lo < hi) {
+      if (P == 1) row_ranges_.push_back({lo, hi, -P0-1});
+      else {
+        row_ranges_.push_back({lo, hi, int(all_pfronts_.size())});
+        all_pfronts_.emplace_back(lo, hi, P0, P);
+      }
+    }
     std::vector<integer_t> dsep_upd;
     integer_t dsep_begin = nd_.dist_sep_range.first,
       dsep_end = nd_.dist_sep_range.second;
@@ -678,6 +793,19 @@ namespace strumpack {
     auto wr = dist_subtree_work[chr];
     int Pl = std::max(1, std::min(int(std::round(P * wl / (wl + wr))), P-1));
     int Pr = std::max(1, P - Pl);
+    if (opts.partitioner_mapping() && P > 1 &&
+        P0 == dleaf0_[dsep] && P == dleaves_[dsep]) {
+      // This subtree is still mapped to the processes that own its
+      // subgraphs after graph partitioning. Keep that mapping for the
+      // children, unless it is too unbalanced.
+      int Pll = dleaves_[chl], Prr = dleaves_[chr];
+      if (dleaf0_[chl] == P0 && dleaf0_[chr] == P0 + Pll &&
+          std::max(wl / Pll, wr / Prr) <=
+          opts.partitioner_mapping_imbalance() * (wl + wr) / P) {
+        Pl = Pll;
+        Pr = Prr;
+      }
+    }
     auto cl = fcomm.sub(0, Pl);
     auto cr = fcomm.sub(P-Pr, Pr);
     auto lch = prop_map
@@ -694,6 +822,52 @@ namespace strumpack {
   }
 
 
+  /**
+   * All fronts in the subtree of a local subgraph, which is mapped to
+   * processes [P0,P0+P). This follows the same mapping as
+   * prop_map_sub_graphs, but for the entire tree, not only for the
+   * fronts this process works on. A subtree mapped to a single
+   * process is returned as one ParallelFront with P == 1.
+   */
+  template<typename scalar_t,typename integer_t>
+  std::vector<typename EliminationTreeMPIDist<scalar_t,integer_t>::ParallelFront>
+  EliminationTreeMPIDist<scalar_t,integer_t>::sub_graph_fronts
+  (const RedistSubTree<integer_t>& tree, int P0, int P) const {
+    std::vector<ParallelFront> fronts;
+    std::stack<std::tuple<integer_t,int,int>> fstack;
+    fstack.emplace(tree.root, P0, P);
+    while (!fstack.empty()) {
+      integer_t sep;
+      int sP0, sP;
+      std::tie(sep, sP0, sP) = fstack.top();
+      fstack.pop();
+      auto chl = tree.lchild[sep];
+      auto chr = tree.rchild[sep];
+      if (sP == 1) {
+        // the tree is in postorder, the subtree is one range of rows
+        auto first = sep;
+        while (tree.lchild[first] != -1) first = tree.lchild[first];
+        if (tree.sep_ptr[first] < tree.sep_ptr[sep+1])
+          fronts.emplace_back
+            (tree.sep_ptr[first], tree.sep_ptr[sep+1], sP0, 1);
+        continue;
+      }
+      if (tree.sep_ptr[sep] < tree.sep_ptr[sep+1])
+        fronts.emplace_back
+          (tree.sep_ptr[sep], tree.sep_ptr[sep+1], sP0, sP);
+      if (chl != -1 && chr != -1) {
+        auto wl = tree.work[chl];
+        auto wr = tree.work[chr];
+        int Pl = std::max
+          (1, std::min(int(std::round(sP * wl / (wl + wr))), sP-1));
+        int Pr = std::max(1, sP - Pl);
+        fstack.emplace(chl, sP0, Pl);
+        fstack.emplace(chr, sP0+sP-Pr, Pr);
+      }
+    }
+    return fronts;
+  }
+
   /**
    * This should only be called by [P0,P0+P) and
    * [P0_sib,P0_sib+P_sib)
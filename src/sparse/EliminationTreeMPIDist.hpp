@@ -30,6 +30,7 @@
 #define ELIMINATION_TREE_MPI_DIST_HPP
 
 #include <cstddef>
+#include <algorithm>
 
 #include "EliminationTreeMPI.hpp"
 #include "PropMapSparseMatrix.hpp"
@@ -78,12 +79,20 @@ namespace strumpack {
 
     void separator_reordering(const Opts_t& opts, const CSRMPI_t& A);
 
+    /**
+     * Check whether (permuted) row i is part of a local subtree which
+     * is factored by the process that holds its subgraph, ie., the
+     * process that received this row as part of
+     * MatrixReorderingMPI::my_sub_graph. This can only be the case
+     * with SPOptions::partitioner_mapping().
+     */
+    bool kept_subgraph_row(integer_t i) const;
+
   private:
     using EliminationTreeMPI<scalar_t,integer_t>::comm_;
     using EliminationTreeMPI<scalar_t,integer_t>::rank_;
     using EliminationTreeMPI<scalar_t,integer_t>::P_;
     using EliminationTreeMPI<scalar_t,integer_t>::local_range_;
-    using EliminationTreeMPI<scalar_t,integer_t>::subtree_ranges_;
 
     Reord_t& nd_;
     PropMapSparseMatrix<scalar_t,integer_t> Aprop_;
@@ -94,15 +103,36 @@ namespace strumpack {
      * which process has the corresponding separator entry
      */
     std::vector<int> row_owner_;
-    void get_all_pfronts();
     void find_row_owner(const CSRMPI_t& A);
 
     /**
-     * vector of size A.size(), storing for each row, to which front
-     * it belongs.
+     * Sorted, non-overlapping ranges [lo, hi) of (permuted) rows,
+     * with for each range the front it belongs to: an index in
+     * all_pfronts_, or -p-1 for the local subtree of process p. This
+     * covers the distributed separator tree, and the fronts in those
+     * local subgraphs, mapped to more than one process, which contain
+     * rows or columns of the local part of A. This takes O(P)
+     * storage, instead of storing the front for each of the A.size()
+     * rows.
      */
-    std::vector<int> row_pfront_;
+    struct RowRange {
+      integer_t lo, hi;
+      int front;
+    };
+    std::vector<RowRange> row_ranges_;
     void find_row_front(const CSRMPI_t& A);
+    /**
+     * Find to which front (permuted) row r belongs, returns an index
+     * in all_pfronts_ for a distributed front, or -p-1 if row r is
+     * part of the local subtree of process p.
+     */
+    int row_pfront(integer_t r) const {
+      auto f = std::upper_bound
+        (row_ranges_.begin(), row_ranges_.end(), r,
+         [](integer_t i, const RowRange& rr) { return i < rr.lo; });
+      assert(f != row_ranges_.begin() && r < (f-1)->hi);
+      return (f-1)->front;
+    }
 
     struct ParallelFront {
       ParallelFront() {}
@@ -110,6 +140,11 @@ namespace strumpack {
       (integer_t lo, integer_t hi, int _P0, int _P, BLACSGrid* g)
         : sep_begin(lo), sep_end(hi), P0(_P0), P(_P),
           prows(g->nprows()), pcols(g->npcols()), grid(g) {}
+      ParallelFront(integer_t lo, integer_t hi, int _P0, int _P)
+        : sep_begin(lo), sep_end(hi), P0(_P0), P(_P), grid(nullptr) {
+        // same layout as the grid of a front on P processes
+        BLACSGrid::layout(P, prows, pcols);
+      }
       integer_t dim_sep() const { return sep_end - sep_begin; }
 
       static MPI_Datatype pf_mpi_type;
@@ -144,10 +179,40 @@ namespace strumpack {
       const BLACSGrid* grid;
     };
 
-    /** all parallel fronts, all parallel fronts on which this process
-        is active. */
+    /**
+     * For each distributed separator, the number of leaves (local
+     * subgraphs) in its subtree and the owner of the first leaf. The
+     * leaves in a subtree are owned by consecutive processes. Only
+     * used with opts.partitioner_mapping().
+     */
+    std::vector<int> dleaves_, dleaf0_;
+    void count_dist_leaves();
+
+    /** all parallel fronts for the rows in row_ranges_, all parallel
+        fronts on which this process is active. */
     std::vector<ParallelFront> all_pfronts_, local_pfronts_;
 
+    /**
+     * Ranges of the local subgraphs which are mapped to more than one
+     * process, with the first of those processes in
+     * RowRange::front. Only that process knows the fronts in the
+     * subgraph, see leaf_fronts_.
+     */
+    std::vector<RowRange> remote_leaves_;
+    /**
+     * If this process is the first of the processes a local subgraph
+     * is mapped to, and there is more than one, all fronts in that
+     * subgraph. A ParallelFront with P == 1 stands for the entire
+     * local subtree of process P0.
+     */
+    std::vector<ParallelFront> leaf_fronts_;
+    std::vector<ParallelFront>
+    sub_graph_fronts(const RedistSubTree<integer_t>& tree,
+                     int P0, int P) const;
+
+    std::vector<float> dist_subtree_work(float dleaf_work,
+                                         float dsep_work);
+
     void symb_fact(std::vector<std::vector<integer_t>>& local_upd,
                    std::vector<float>& local_subtree_work,
                    std::vector<integer_t>& dsep_upd, float& dsep_work,
@@ -30,6 +30,7 @@
 #include <algorithm>
 #include <cmath>
 #include <tuple>
+#include <unordered_map>
 
 #include "PropMapSparseMatrix.hpp"
 #include "dense/DistributedMatrix.hpp"
@@ -54,41 +55,49 @@ namespace strumpack {
     n_ = Ampi.size();
     nnz_ = Ampi.nnz();
     const auto& comm = et.Comm();
-    auto P = comm.size();
     auto eps = blas::lamch<real_t>('E');
 
     std::vector<std::tuple<int,int,int>> dest(Ampi.local_nnz());
-    std::vector<std::size_t> scnts(P);
     integer_t lrows = Ampi.local_rows();
     auto perm = nd.perm();
     auto Aptr = Ampi.ptr();
     auto Aind = Ampi.ind();
     auto Aval = Ampi.val();
+    // Rows of a local subtree which stays on the process holding its
+    // subgraph are already there, in nd.my_sub_matrix. Those are not
+    // sent, only the other rows are redistributed.
+    const bool sub = nd.has_sub_matrix();
 #pragma omp parallel for
     for (integer_t r=0; r<lrows; r++) {
       auto r_perm = perm[r + Ampi.begin_row()];
       auto hij = Aptr[r+1] - Aptr[0];
-      for (integer_t j=Aptr[r]-Aptr[0]; j<hij; j++) {
-        if (std::abs(Aval[j]) > eps) {
-          auto indj = Aind[j];
-          auto c_perm = perm[indj];
-          dest[j] = et.get_sparse_mapped_destination
-            (Ampi, r, indj, r_perm, c_perm, duplicate_fronts);
-          auto& d = dest[j];
-          auto hip = std::get<0>(d) + std::get<1>(d);
-          for (int p=std::get<0>(d); p<hip; p+=std::get<2>(d)) {
-            auto ps = scnts.data() + p;
-#pragma omp atomic update
-            (*ps)++;
-          }
-        }
-      }
+      bool kept = sub && et.kept_subgraph_row(r_perm);
+      for (integer_t j=Aptr[r]-Aptr[0]; j<hij; j++)
+        if (std::abs(Aval[j]) > eps)
+          dest[j] = kept ? std::make_tuple(0, 0, 1) :
+            et.get_sparse_mapped_destination
+            (Ampi, r, Aind[j], r_perm, perm[Aind[j]], duplicate_fronts);
     }
 
+    // Point-to-point redistribution, only to the processes that
+    // actually receive entries from this process. This avoids
+    // buffers, counts and messages for all P processes.
     using Triplet = Triplet<scalar_t,integer_t>;
-    std::vector<std::vector<Triplet>> sbuf(P);
-    for (int p=0; p<P; p++)
-      sbuf[p].reserve(scnts[p]);
+    std::unordered_map<int,std::size_t> scnts;
+    for (integer_t j=0, lnnz=Ampi.local_nnz(); j<lnnz; j++)
+      if (std::abs(Aval[j]) > eps) {
+        auto& d = dest[j];
+        auto hip = std::get<0>(d) + std::get<1>(d);
+        for (int p=std::get<0>(d); p<hip; p+=std::get<2>(d))
+          scnts[p]++;
+      }
+    std::vector<std::pair<int,std::vector<Triplet>>> sbuf;
+    sbuf.reserve(scnts.size());
+    for (auto& c : scnts) {
+      sbuf.emplace_back(c.first, std::vector<Triplet>());
+      sbuf.back().second.reserve(c.second);
+      c.second = sbuf.size() - 1;
+    }
     for (integer_t r=0; r<lrows; r++) {
       auto r_perm = perm[r + Ampi.begin_row()];
       auto hij = Aptr[r+1] - Aptr[0];
@@ -99,12 +108,20 @@ namespace strumpack {
           auto& d = dest[j];
           auto hip = std::get<0>(d) + std::get<1>(d);
           for (int p=std::get<0>(d); p<hip; p+=std::get<2>(d))
-            sbuf[p].push_back(t); // do NOT use emplace
+            sbuf[scnts[p]].second.push_back(t); // do NOT use emplace
         }
       }
     }
-    auto triplets = comm.all_to_all_v(sbuf);
+    std::vector<std::tuple<int,int,int>>().swap(dest);
+    auto triplets = comm.sparse_exchange(sbuf, 0);
+    std::vector<std::pair<int,std::vector<Triplet>>>().swap(sbuf);
     Triplet::free_mpi_type();
+    if (sub)
+      for (auto& t : nd.my_sub_matrix) {
+        auto r_perm = perm[t.r];
+        if (std::abs(t.v) > eps && et.kept_subgraph_row(r_perm))
+          triplets.emplace_back(r_perm, perm[t.c], t.v);
+      }
 
     // TODO this sort can be avoided? first make the CSR/CSC
     // representation, then sort that row per row in parallel
@@ -536,6 +536,148 @@ namespace strumpack {
     return SeparatorTree<integer_t>(seps);
   }
 
+  template<typename integer_t> SeparatorTree<integer_t>
+  relaxed_amalgamation(const SeparatorTree<integer_t>& tree,
+                       const integer_t* ptr, const integer_t* ind,
+                       std::vector<integer_t>& perm,
+                       std::vector<integer_t>& iperm, double fill_tol,
+                       long long& fill_before, long long& fill_after) {
+    integer_t n = perm.size(), ns = tree.separators();
+    auto sep_lo = [&](integer_t s) { return std::min(tree.sizes[s], n); };
+    auto sep_hi = [&](integer_t s) {
+      return std::max(sep_lo(s), std::min(tree.sizes[s+1], n)); };
+    // postorder of the separator tree
+    std::vector<integer_t> order;
+    order.reserve(ns);
+    {
+      std::stack<std::pair<integer_t,bool>,
+                 std::vector<std::pair<integer_t,bool>>> st;
+      st.emplace(tree.root(), false);
+      while (!st.empty()) {
+        auto t = st.top(); st.pop();
+        if (t.second) { order.push_back(t.first); continue; }
+        st.emplace(t.first, true);
+        if (tree.rch[t.first] != -1) st.emplace(tree.rch[t.first], false);
+        if (tree.lch[t.first] != -1) st.emplace(tree.lch[t.first], false);
+      }
+    }
+    // symbolic factorization, only the sizes of the update sets are
+    // kept
+    std::vector<integer_t> mark(n, -1), dupd(ns, 0);
+    {
+      std::vector<std::vector<integer_t>> upd(ns);
+      for (auto s : order) {
+        auto hi = sep_hi(s);
+        auto& u = upd[s];
+        auto add = [&](integer_t c) {
+          if (c >= hi && mark[c] != s) { mark[c] = s; u.push_back(c); }
+        };
+        for (integer_t r=sep_lo(s); r<hi; r++) {
+          auto o = iperm[r];
+          for (integer_t j=ptr[o]; j<ptr[o+1]; j++)
+            add(perm[ind[j]]);
+        }
+        for (auto ch : {tree.lch[s], tree.rch[s]}) {
+          if (ch == -1) continue;
+          for (auto c : upd[ch]) add(c);
+          upd[ch] = std::vector<integer_t>();
+        }
+        dupd[s] = u.size();
+      }
+    }
+    // greedy bottom-up merging of children into their parent
+    auto entries = [](double ds, double du) { return ds*ds + 2.*ds*du; };
+    std::vector<integer_t> up(ns, -1), dsep(ns);
+    std::vector<double> ent(ns);
+    std::vector<std::vector<integer_t>> kids(ns);
+    fill_before = fill_after = 0;
+    for (auto s : order) {
+      dsep[s] = sep_hi(s) - sep_lo(s);
+      ent[s] = entries(dsep[s], dupd[s]);
+      fill_before += static_cast<long long>(ent[s]);
+      auto merge = [&](integer_t c) {
+        dsep[s] += dsep[c];
+        ent[s] += ent[c];
+        kids[s].insert(kids[s].end(), kids[c].begin(), kids[c].end());
+        kids[c] = std::vector<integer_t>();
+        up[c] = s;
+      };
+      std::vector<integer_t> ch;
+      for (auto c : {tree.lch[s], tree.rch[s]})
+        if (c != -1) ch.push_back(c);
+      // try the smallest child first
+      std::sort(ch.begin(), ch.end(), [&](integer_t a, integer_t b) {
+        return ent[a] < ent[b]; });
+      for (auto c : ch) {
+        auto e = entries(dsep[s] + dsep[c], dupd[s]);
+        if (e - ent[s] - ent[c] <= fill_tol * e) merge(c);
+        else kids[s].push_back(c);
+      }
+      // a single child would be merged anyway when building the new
+      // tree, so do that here, to get the correct fill estimate
+      if (kids[s].size() == 1) {
+        auto c = kids[s][0];
+        kids[s].clear();
+        merge(c);
+      }
+    }
+    for (auto s : order)
+      if (up[s] == -1)
+        fill_after += static_cast<long long>(entries(dsep[s], dupd[s]));
+    // new postordering, with the dofs of each merged group numbered
+    // consecutively
+    std::vector<integer_t> grp(ns);
+    for (auto it=order.rbegin(); it!=order.rend(); it++)
+      grp[*it] = (up[*it] == -1) ? *it : grp[up[*it]];
+    std::vector<integer_t> gsize(ns, 0), gbegin(ns), q(n);
+    for (auto s : order)
+      gsize[grp[s]] += sep_hi(s) - sep_lo(s);
+    std::vector<integer_t> gorder;
+    {
+      std::stack<std::pair<integer_t,bool>,
+                 std::vector<std::pair<integer_t,bool>>> st;
+      st.emplace(tree.root(), false);
+      while (!st.empty()) {
+        auto t = st.top(); st.pop();
+        if (t.second) { gorder.push_back(t.first); continue; }
+        st.emplace(t.first, true);
+        for (auto c=kids[t.first].rbegin(); c!=kids[t.first].rend(); c++)
+          st.emplace(*c, false);
+      }
+    }
+    std::vector<integer_t> gfirst(ns, -1);
+    integer_t dof = 0;
+    for (auto g : gorder) {
+      gbegin[g] = dof;
+      if (gsize[g]) gfirst[g] = dof;
+      dof += gsize[g];
+    }
+    // within a group, merged children come before the parent
+    for (auto s : order)
+      for (integer_t r=sep_lo(s); r<sep_hi(s); r++)
+        q[r] = gbegin[grp[s]]++;
+    // elimination tree with a chain for each group, children attached
+    // to the first dof in the closest non-empty ancestor group
+    std::vector<integer_t> etree(n, n), gpa(ns, -1);
+    for (auto g : gorder)
+      for (auto c : kids[g]) gpa[c] = g;
+    for (auto g : gorder) {
+      if (gfirst[g] == -1) continue;
+      auto last = gbegin[g] - 1;
+      for (auto r=gfirst[g]; r<last; r++) etree[r] = r + 1;
+      auto p = gpa[g];
+      while (p != -1 && gfirst[p] == -1) p = gpa[p];
+      etree[last] = (p == -1) ? n : gfirst[p];
+    }
+    std::vector<integer_t> post(n);
+    auto seps = separators_from_etree(etree, post);
+    for (integer_t i=0; i<n; i++)
+      perm[i] = post[q[perm[i]]];
+    for (integer_t i=0; i<n; i++)
+      iperm[perm[i]] = i;
+    return SeparatorTree<integer_t>(seps);
+  }
+
   /** path halving */
   template<typename integer_t> inline integer_t
   find(integer_t i, std::vector<integer_t>& pp) {
@@ -597,6 +739,27 @@ namespace strumpack {
                            std::vector<long long int>& perm,
                            std::vector<long long int>& iperm);
 
+  template SeparatorTree<int>
+  relaxed_amalgamation(const SeparatorTree<int>& tree,
+                       const int* ptr, const int* ind,
+                       std::vector<int>& perm, std::vector<int>& iperm,
+                       double fill_tol, long long& fill_before,
+                       long long& fill_after);
+  template SeparatorTree<long int>
+  relaxed_amalgamation(const SeparatorTree<long int>& tree,
+                       const long int* ptr, const long int* ind,
+                       std::vector<long int>& perm,
+                       std::vector<long int>& iperm,
+                       double fill_tol, long long& fill_before,
+                       long long& fill_after);
+  template SeparatorTree<long long int>
+  relaxed_amalgamation(const SeparatorTree<long long int>& tree,
+                       const long long int* ptr, const long long int* ind,
+                       std::vector<long long int>& perm,
+                       std::vector<long long int>& iperm,
+                       double fill_tol, long long& fill_before,
+                       long long& fill_after);
+
   template std::vector<int>
   spsymetree(const int* acolst, const int* acolend,
              const int* arow, int n, int subgraph_begin);
@@ -116,6 +116,28 @@ namespace strumpack {
                            std::vector<integer_t>& perm,
                            std::vector<integer_t>& iperm);
 
+  /**
+   * Relaxed amalgamation of a separator tree. A child is merged with
+   * its parent when the number of explicit zeros this introduces in
+   * the merged front is at most fill_tol times the size (number of
+   * entries) of the merged front. The front sizes are estimated with
+   * a symbolic factorization using the (symmetric) sparsity pattern
+   * ptr/ind of the original matrix, and the permutation perm. The
+   * merged tree is postordered again and converted to a binary tree,
+   * and perm and iperm are updated accordingly.
+   *
+   * \param fill_before estimated number of entries in all fronts,
+   * before amalgamation
+   * \param fill_after estimated number of entries in all fronts,
+   * after amalgamation
+   */
+  template<typename integer_t> SeparatorTree<integer_t>
+  relaxed_amalgamation(const SeparatorTree<integer_t>& tree,
+                       const integer_t* ptr, const integer_t* ind,
+                       std::vector<integer_t>& perm,
+                       std::vector<integer_t>& iperm, double fill_tol,
+                       long long& fill_before, long long& fill_after);
+
   /*! \brief Symmetric elimination tree
    *
    * <pre>
@@ -107,6 +107,11 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   Front<scalar_t,integer_t>::upd_to_parent
   (const F_t* pa, std::size_t& upd2sep, std::size_t* I) const {
+    if (pa == upd2pa_front_) {
+      std::copy(upd2pa_.begin(), upd2pa_.end(), I);
+      upd2sep = upd2pa_sep_;
+      return;
+    }
     integer_t r = 0, dupd = dim_upd(), pa_dsep = pa->dim_sep();
     for (; r<dupd; r++) {
       auto up = upd_[r];
@@ -123,6 +128,10 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   Front<scalar_t,integer_t>::upd_to_parent
   (const F_t* pa, std::size_t* I) const {
+    if (pa == upd2pa_front_) {
+      std::copy(upd2pa_.begin(), upd2pa_.end(), I);
+      return;
+    }
     integer_t r = 0, dupd = dim_upd(), pa_dsep = pa->dim_sep();
     for (; r<dupd; r++) {
       auto up = upd_[r];
@@ -146,11 +155,49 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> std::vector<std::size_t>
   Front<scalar_t,integer_t>::upd_to_parent
   (const F_t* pa, std::size_t& upd2sep) const {
+    if (pa == upd2pa_front_) {
+      upd2sep = upd2pa_sep_;
+      return upd2pa_;
+    }
     std::vector<std::size_t> I(dim_upd());
     upd_to_parent(pa, upd2sep, I.data());
     return I;
   }
 
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::setup_assembly_maps
+  (const SpMat_t& A, int task_depth) {
+    auto lch = lchild_.get();
+    auto rch = rchild_.get();
+    if (lch)
+#pragma omp task default(shared) firstprivate(task_depth,lch)          \
+  if(task_depth < params::task_recursion_cutoff_level)
+      lch->setup_assembly_maps(A, task_depth+1);
+    if (rch)
+#pragma omp task default(shared) firstprivate(task_depth,rch)          \
+  if(task_depth < params::task_recursion_cutoff_level)
+      rch->setup_assembly_maps(A, task_depth+1);
+    if (!Amap_.set && uses_assembly_map())
+      A.front_assembly_map(sep_begin_, sep_end_, upd_, Amap_);
+#pragma omp taskwait
+    for (auto ch : {lch, rch}) {
+      if (!ch || ch->upd2pa_front_ == this) continue;
+      ch->upd2pa_.resize(ch->dim_upd());
+      ch->upd_to_parent(this, ch->upd2pa_sep_, ch->upd2pa_.data());
+      ch->upd2pa_front_ = this;
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::clear_assembly_maps() {
+    Amap_.clear();
+    upd2pa_front_ = nullptr;
+    upd2pa_sep_ = 0;
+    upd2pa_ = std::vector<std::size_t>();
+    if (lchild_) lchild_->clear_assembly_maps();
+    if (rchild_) rchild_->clear_assembly_maps();
+  }
+
   template<typename scalar_t,typename integer_t> inline void
   Front<scalar_t,integer_t>::extend_add_b
   (DenseM_t& b, DenseM_t& bupd, const DenseM_t& CB, const F_t* pa) const {
@@ -386,6 +433,56 @@ namespace strumpack {
     return nnz + nnzl + nnzr;
   }
 
+  template<typename scalar_t,typename integer_t> long long
+  Front<scalar_t,integer_t>::order_children_peak_memory() {
+    long long pl = 0, pr = 0, cbl = 0, cbr = 0;
+    if (lchild_) {
+      pl = lchild_->order_children_peak_memory();
+      cbl = (long long)(lchild_->dim_upd()) * lchild_->dim_upd();
+    }
+    if (rchild_) {
+      pr = rchild_->order_children_peak_memory();
+      cbr = (long long)(rchild_->dim_upd()) * rchild_->dim_upd();
+    }
+    long long dblk = dim_blk();
+    if (P() > 1)
+      return std::max(std::max(pl, pr), dblk * dblk / P());
+    // the contribution block of the first child stays on the stack
+    // while the second child is being processed
+    if (pr - cbr > pl - cbl) {
+      std::swap(lchild_, rchild_);
+      std::swap(pl, pr);
+      std::swap(cbl, cbr);
+    }
+    return std::max(std::max(pl, cbl + pr), cbl + cbr + dblk * dblk);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::compress_dense_CB
+  (DenseMW_t& F22, std::vector<scalar_t,NoInit<scalar_t>>& CBstorage,
+   const Opts_t& opts) {
+    if (!opts.CB_compression() || !F22.rows()) return;
+    CBc_ = LossyMatrix<scalar_t>(F22, 0, opts.CB_compression_accuracy());
+    params::CB_memory += F22.rows() * F22.cols() * sizeof(scalar_t);
+    params::CB_compressed_memory += CBc_.compressed_size();
+    // free the memory, instead of returning it to the workspace
+    STRUMPACK_SUB_MEMORY(CBstorage.size()*sizeof(scalar_t));
+    CBstorage = std::vector<scalar_t,NoInit<scalar_t>>();
+    F22 = DenseMW_t();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::decompress_dense_CB
+  (DenseMW_t& F22, std::vector<scalar_t,NoInit<scalar_t>>& CBstorage,
+   VectorPool<scalar_t>& workspace) {
+    if (!CB_compressed()) return;
+    std::size_t dupd = CBc_.rows();
+    CBstorage = workspace.get(dupd*dupd);
+    F22 = DenseMW_t(dupd, dupd, CBstorage.data(), dupd);
+    CBc_.decompress(F22);
+    CBc_ = LossyMatrix<scalar_t>();
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   Front<scalar_t,integer_t>::inertia
   (integer_t& neg, integer_t& zero, integer_t& pos) const {
@@ -628,6 +725,10 @@ namespace strumpack {
       upd_[i] = perm[upd_[i]];
     std::sort(upd_.begin(), upd_.end());
 #pragma omp taskwait
+    // upd changed, and so did the sparse matrix, maps are invalid
+    Amap_.clear();
+    if (lch) lch->upd2pa_front_ = nullptr;
+    if (rch) rch->upd2pa_front_ = nullptr;
   }
 
   template<typename scalar_t,typename integer_t> void
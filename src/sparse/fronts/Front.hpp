@@ -39,6 +39,7 @@
 #include "dense/DenseMatrix.hpp"
 #include "sparse/CompressedSparseMatrix.hpp"
 #include "BLR/BLRMatrix.hpp"
+#include "LossyMatrix.hpp"
 #if defined(_OPENMP)
 #include "omp.h"
 #endif
@@ -93,6 +94,18 @@ namespace strumpack {
                                            std::size_t& upd2sep) const;
     std::vector<std::size_t> upd_to_parent(const F_t* pa) const;
 
+    /**
+     * Precompute, for this front and all its descendants, the
+     * upd_to_parent map of each child, and, for the fronts that
+     * assemble F11/F12/F21 explicitly (see uses_assembly_map), the
+     * scatter list from the nonzeros of A to F11/F12/F21. These only
+     * depend on the sparsity pattern and the tree, so they are
+     * computed once and reused in later (value-only)
+     * refactorizations. Front::permute_CB invalidates them.
+     */
+    void setup_assembly_maps(const SpMat_t& A, int task_depth=0);
+    void clear_assembly_maps();
+
     virtual void release_work_memory() {
       VectorPool<scalar_t> workspace;
       release_work_memory(workspace);
@@ -164,31 +177,48 @@ namespace strumpack {
     void extend_add(DenseM_t& F11, DenseM_t& F12,
                     DenseM_t& F21, DenseM_t& F22,
                     DenseM_t& CB, const F_t* p) {
-      const std::size_t pdsep = F11.rows();
       const std::size_t dupd = CB.rows();
       std::size_t upd2sep;
       auto I = upd_to_parent(p, upd2sep);
-#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
-#pragma omp taskloop default(shared) grainsize(64)
-#endif
-      for (std::size_t c=0; c<dupd; c++) {
-        auto pc = I[c];
-        if (pc < pdsep) {
-          for (std::size_t r=0; r<upd2sep; r++)
-            F11(I[r],pc) += CB(r,c);
-          for (std::size_t r=upd2sep; r<dupd; r++)
-            F21(I[r]-pdsep,pc) += CB(r,c);
-        } else {
-          for (std::size_t r=0; r<upd2sep; r++)
-            F12(I[r],pc-pdsep) += CB(r, c);
-          for (std::size_t r=upd2sep; r<dupd; r++)
-            F22(I[r]-pdsep,pc-pdsep) += CB(r,c);
-        }
+      extend_add_columns(F11, F12, F21, F22, CB, I, upd2sep, 0, dupd);
+      STRUMPACK_FLOPS((is_complex<scalar_t>()?2:1) * dupd * dupd);
+      STRUMPACK_FULL_RANK_FLOPS((is_complex<scalar_t>()?2:1) * dupd * dupd);
+    }
+
+    /**
+     * Extend-add of a compressed contribution block, decompressing
+     * one column panel at a time.
+     */
+    void extend_add(DenseM_t& F11, DenseM_t& F12,
+                    DenseM_t& F21, DenseM_t& F22,
+                    const LossyMatrix<scalar_t>& CB, const F_t* p) {
+      const std::size_t dupd = CB.rows();
+      std::size_t upd2sep;
+      auto I = upd_to_parent(p, upd2sep);
+      DenseM_t buf(dupd, CB.panel_cols());
+      for (std::size_t k=0; k<CB.panels(); k++) {
+        auto c0 = CB.panel_begin(k), c1 = CB.panel_end(k);
+        CB.decompress_panel(k, buf.data(), buf.ld());
+        DenseMW_t CBk(dupd, c1-c0, buf, 0, 0);
+        extend_add_columns(F11, F12, F21, F22, CBk, I, upd2sep, c0, c1);
       }
       STRUMPACK_FLOPS((is_complex<scalar_t>()?2:1) * dupd * dupd);
       STRUMPACK_FULL_RANK_FLOPS((is_complex<scalar_t>()?2:1) * dupd * dupd);
     }
 
+    /**
+     * Compress the contribution block, to reduce memory while it is
+     * waiting to be extend-added to the parent. This is called by
+     * the parent, and only for parents that can handle a compressed
+     * contribution block, see SPOptions::enable_CB_compression.
+     */
+    virtual void compress_CB(const Opts_t& opts) {}
+    /**
+     * Undo compress_CB, for parents that need random access to the
+     * contribution block.
+     */
+    virtual void decompress_CB(VectorPool<scalar_t>& workspace) {}
+
     virtual void
     extend_add_to_dense(DenseM_t& paF11, DenseM_t& paF12,
                         DenseM_t& paF21, DenseM_t& paF22,
@@ -272,9 +302,29 @@ namespace strumpack {
 
     virtual long long factor_nonzeros(int task_depth=0) const;
     virtual long long dense_factor_nonzeros(int task_depth=0) const;
+
+    /**
+     * Reorder the children of the (sequential) fronts in this
+     * subtree to minimize the peak active memory of a sequential
+     * postorder traversal, Liu's ordering: visit first the child for
+     * which the difference between its peak and its contribution
+     * block is largest. The children of distributed fronts are
+     * traversed concurrently and are not swapped.
+     *
+     * \return predicted peak active memory, in number of scalars,
+     * for the frontal matrices plus the stack of contribution blocks
+     * (for a distributed front, the local part of the front).
+     */
+    long long order_children_peak_memory();
     virtual bool isHSS() const { return false; }
     virtual bool isMPI() const { return false; }
     virtual bool isGPU() const { return false; }
+    /**
+     * Does this front assemble F11, F12 and F21 from the sparse
+     * matrix with extract_front, and can it use a precomputed
+     * FrontAssemblyMap? See setup_assembly_maps.
+     */
+    virtual bool uses_assembly_map() const { return false; }
     virtual void print_rank_statistics(std::ostream &out) const {}
     virtual std::string type() const { return "Front"; }
 
@@ -440,10 +490,27 @@ namespace strumpack {
     std::vector<integer_t> upd_;
     std::unique_ptr<F_t> lchild_, rchild_;
 
+    // see setup_assembly_maps
+    FrontAssemblyMap<integer_t> Amap_;
+    const F_t* upd2pa_front_ = nullptr;
+    std::size_t upd2pa_sep_ = 0;
+    std::vector<std::size_t> upd2pa_;
+
+    // compressed contribution block, see compress_CB
+    LossyMatrix<scalar_t> CBc_;
+
     virtual long long node_factor_nonzeros() const {
       return dense_node_factor_nonzeros();
     }
 
+    bool CB_compressed() const { return CBc_.rows() != 0; }
+    void compress_dense_CB
+    (DenseMW_t& F22, std::vector<scalar_t,NoInit<scalar_t>>& CBstorage,
+     const Opts_t& opts);
+    void decompress_dense_CB
+    (DenseMW_t& F22, std::vector<scalar_t,NoInit<scalar_t>>& CBstorage,
+     VectorPool<scalar_t>& workspace);
+
     virtual void partition(const Opts_t& opts, const SpMat_t& A,
                            integer_t* sorder,
                            bool is_root=true, int task_depth=0);
@@ -473,6 +540,36 @@ namespace strumpack {
       long long dsep = dim_sep(), dupd = dim_upd();
       return dsep * (dsep + 2 * dupd);
     }
+
+    // add columns [c0,c1) of the contribution block to the parent,
+    // CB holds just those columns
+    void extend_add_columns(DenseM_t& F11, DenseM_t& F12,
+                            DenseM_t& F21, DenseM_t& F22,
+                            const DenseM_t& CB,
+                            const std::vector<std::size_t>& I,
+                            std::size_t upd2sep,
+                            std::size_t c0, std::size_t c1) {
+      const std::size_t pdsep = F11.rows();
+      const std::size_t dupd = CB.rows();
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(64)
+#endif
+      for (std::size_t c=c0; c<c1; c++) {
+        auto pc = I[c];
+        auto cc = c - c0;
+        if (pc < pdsep) {
+          for (std::size_t r=0; r<upd2sep; r++)
+            F11(I[r],pc) += CB(r,cc);
+          for (std::size_t r=upd2sep; r<dupd; r++)
+            F21(I[r]-pdsep,pc) += CB(r,cc);
+        } else {
+          for (std::size_t r=0; r<upd2sep; r++)
+            F12(I[r],pc-pdsep) += CB(r,cc);
+          for (std::size_t r=upd2sep; r<dupd; r++)
+            F22(I[r]-pdsep,pc-pdsep) += CB(r,cc);
+        }
+      }
+    }
   };
 
 } // end namespace strumpack
@@ -29,6 +29,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <functional>
 
 #include "FrontBLR.hpp"
 #include "sparse/CSRGraph.hpp"
@@ -60,9 +61,22 @@ namespace strumpack {
     workspace.restore(CBstorage_);
     F22_.clear();
     F22blr_.clear();
-    admissibility_.clear();
-    sep_tiles_.clear();
-    upd_tiles_.clear();
+    this->CBc_ = LossyMatrix<scalar_t>();
+    // the tiling and admissibility are kept, they are computed only
+    // once, in partition, and are needed to refactor this front
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontBLR<scalar_t,integer_t>::compress_CB(const Opts_t& opts) {
+    // only a dense contribution block, in host memory, is compressed
+    if (!CBstorage_.empty() && F22blr_.rows() != std::size_t(dim_upd()))
+      this->compress_dense_CB(F22_, CBstorage_, opts);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontBLR<scalar_t,integer_t>::decompress_CB
+  (VectorPool<scalar_t>& workspace) {
+    this->decompress_dense_CB(F22_, CBstorage_, workspace);
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -149,7 +163,9 @@ namespace strumpack {
         if (F22blr_.rows() == dupd) {
           auto F22 = F22blr_.dense();
           this->extend_add(paF11, paF12, paF21, paF22, F22, p);
-        } else
+        } else if (this->CB_compressed())
+          this->extend_add(paF11, paF12, paF21, paF22, this->CBc_, p);
+        else
           this->extend_add(paF11, paF12, paF21, paF22, F22_, p);
       }
     release_work_memory(workspace);
@@ -280,24 +296,36 @@ namespace strumpack {
   (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace,
    int etree_level, int task_depth) {
     ReturnCode el = ReturnCode::SUCCESS, er = ReturnCode::SUCCESS;
+    // the GPU assembly reads the contribution blocks of the children
+    // with get_device_F22, so these are only compressed on the host
+    const bool compress_CB = !opts.use_gpu();
     if (opts.use_openmp_tree() &&
         !opts.use_gpu() && // do not create too many GPU streams, handles, etc
         task_depth < params::task_recursion_cutoff_level) {
       if (lchild_)
 #pragma omp task default(shared)                                        \
   final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
-        el = lchild_->factor(A, opts, workspace, etree_level+1, task_depth+1);
+        {
+          el = lchild_->factor(A, opts, workspace, etree_level+1, task_depth+1);
+          if (compress_CB) lchild_->compress_CB(opts);
+        }
       if (rchild_)
 #pragma omp task default(shared)                                        \
   final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
-        er = rchild_->factor(A, opts, workspace, etree_level+1, task_depth+1);
+        {
+          er = rchild_->factor(A, opts, workspace, etree_level+1, task_depth+1);
+          if (compress_CB) rchild_->compress_CB(opts);
+        }
 #pragma omp taskwait
     } else {
       if (lchild_) {
         el = lchild_->factor(A, opts, workspace, etree_level+1, task_depth);
+        if (compress_CB) lchild_->compress_CB(opts);
       }
-      if (rchild_)
+      if (rchild_) {
         er = rchild_->factor(A, opts, workspace, etree_level+1, task_depth);
+        if (compress_CB) rchild_->compress_CB(opts);
+      }
     }
     ReturnCode err_code = (el == ReturnCode::SUCCESS) ? er : el;
     TaskTimer t("");
@@ -317,6 +345,10 @@ namespace strumpack {
         BLR::LowRankAlgorithm::RRQR) {
       if (blr_opts.BLR_factor_algorithm() ==
           BLR::BLRFactorAlgorithm::COLWISE) {
+        // the column-wise extend-add needs the full contribution
+        // blocks of the children
+        if (lchild_) lchild_->decompress_CB(workspace);
+        if (rchild_) rchild_->decompress_CB(workspace);
         // factor column-block-wise for memory reduction
         F11blr_ = BLRM_t(dsep, sep_tiles_, dsep, sep_tiles_);
         F12blr_ = BLRM_t(dsep, sep_tiles_, dupd, upd_tiles_);
@@ -406,8 +438,11 @@ namespace strumpack {
           {
             DenseM_t F11(dsep, dsep), F12(dsep, dupd), F21(dupd, dsep);
             F11.zero(); F12.zero(); F21.zero();
-            A.extract_front
-              (F11, F12, F21, sep_begin_, sep_end_, this->upd_, task_depth);
+            if (this->Amap_.set)
+              A.extract_front(F11, F12, F21, this->Amap_);
+            else
+              A.extract_front
+                (F11, F12, F21, sep_begin_, sep_end_, this->upd_, task_depth);
             if (dupd) {
               CBstorage_ = workspace.get(std::size_t(dupd)*dupd);
               F22_ = DenseMW_t(dupd, dupd, CBstorage_.data(), dupd);
@@ -433,6 +468,8 @@ namespace strumpack {
           }
       }
     } else { // ACA or BACA
+      if (lchild_) lchild_->decompress_CB(workspace);
+      if (rchild_) rchild_->decompress_CB(workspace);
       auto F11elem = [&](const std::vector<std::size_t>& lI,
                          const std::vector<std::size_t>& lJ, DenseM_t& B) {
         auto gI = lI; auto gJ = lJ;
@@ -476,6 +513,22 @@ namespace strumpack {
     }
     if (lchild_) lchild_->release_work_memory(workspace);
     if (rchild_) rchild_->release_work_memory(workspace);
+    if (blr_opts.storage_precision() != StoragePrecision::FULL &&
+        !opts.use_gpu() && dsep) {
+      // The factors are only used in the solve from now on, so the
+      // low-rank tiles can be stored in lower precision. The
+      // tolerance is split over all tiles of F11, F12 and F21.
+      auto n11 = F11blr_.normF_bound(), n12 = F12blr_.normF_bound(),
+        n21 = F21blr_.normF_bound();
+      auto ntiles = F11blr_.rowblocks() * F11blr_.colblocks() +
+        F12blr_.rowblocks() * F12blr_.colblocks() +
+        F21blr_.rowblocks() * F21blr_.colblocks();
+      auto tol = blr_opts.rel_tol() *
+        std::sqrt(n11*n11 + n12*n12 + n21*n21) / std::sqrt(ntiles);
+      F11blr_.reduce_precision(tol, blr_opts.storage_precision());
+      F12blr_.reduce_precision(tol, blr_opts.storage_precision());
+      F21blr_.reduce_precision(tol, blr_opts.storage_precision());
+    }
     if (opts.print_compressed_front_stats()) {
       auto time = t.elapsed();
       auto nnz = F11blr_.nonzeros();
@@ -629,7 +682,21 @@ namespace strumpack {
       auto sep_tree = g.recursive_bisection
         (opts.BLR_options().leaf_size(), 0,
          sorder+sep_begin_, nullptr, 0, 0, dim_sep());
-      sep_tiles_ = sep_tree.template leaf_sizes<std::size_t>();
+      if (opts.BLR_options().MBLR_levels() > 1) {
+        // the bisection is done down to the finest level, so the
+        // nested tiles are also ordered with nested dissection, but
+        // the outer tiles are taken higher up in the tree
+        std::size_t mls = opts.BLR_options().MBLR_leaf_size();
+        std::function<void(const structured::ClusterTree&)> outer =
+          [&](const structured::ClusterTree& t) {
+            if (!t.c.empty() && std::size_t(t.size) >= 2*mls)
+              for (auto& c : t.c) outer(c);
+            else sep_tiles_.push_back(t.size);
+          };
+        sep_tiles_.clear();
+        outer(sep_tree);
+      } else
+        sep_tiles_ = sep_tree.template leaf_sizes<std::size_t>();
 #else
       int K = std::round((1.* dim_sep()) / opts.BLR_options().leaf_size());
       if (K > 1)
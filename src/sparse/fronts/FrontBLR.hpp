@@ -56,6 +56,9 @@ namespace strumpack {
 
     void release_work_memory(VectorPool<scalar_t>& workspace) override;
 
+    void compress_CB(const Opts_t& opts) override;
+    void decompress_CB(VectorPool<scalar_t>& workspace) override;
+
     void build_front_cols(const SpMat_t& A, std::size_t i,
                           bool part, std::size_t CP,
                           const std::vector<Triplet<scalar_t>>& e11,
@@ -97,6 +100,7 @@ namespace strumpack {
                                DenseM_t& B, int task_depth) const override;
 
     std::string type() const override { return "FrontBLR"; }
+    bool uses_assembly_map() const override { return true; }
 
 #if defined(STRUMPACK_USE_MPI)
     void
@@ -47,6 +47,18 @@ namespace strumpack {
   (VectorPool<scalar_t>& workspace) {
     workspace.restore(CBstorage_);
     F22_.clear();
+    this->CBc_ = LossyMatrix<scalar_t>();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDense<scalar_t,integer_t>::compress_CB(const Opts_t& opts) {
+    this->compress_dense_CB(F22_, CBstorage_, opts);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDense<scalar_t,integer_t>::decompress_CB
+  (VectorPool<scalar_t>& workspace) {
+    this->decompress_dense_CB(F22_, CBstorage_, workspace);
   }
 
   template<typename scalar_t,typename integer_t> scalar_t*
@@ -114,7 +126,10 @@ namespace strumpack {
   FrontDense<scalar_t,integer_t>::extend_add_to_dense
   (DenseM_t& paF11, DenseM_t& paF12, DenseM_t& paF21, DenseM_t& paF22,
    const F_t* p, VectorPool<scalar_t>& workspace, int task_depth) {
-    this->extend_add(paF11, paF12, paF21, paF22, F22_, p);
+    if (this->CB_compressed())
+      this->extend_add(paF11, paF12, paF21, paF22, this->CBc_, p);
+    else
+      this->extend_add(paF11, paF12, paF21, paF22, F22_, p);
     release_work_memory(workspace);
   }
 
@@ -204,27 +219,54 @@ namespace strumpack {
     return (e1 == ReturnCode::SUCCESS) ? e2 : e1;
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDense<scalar_t,integer_t>::Schur_complement
+  (const SpMat_t& A, const Opts_t& opts, DenseM_t& S) {
+    assert(dim_upd() == 0);
+    VectorPool<scalar_t> workspace;
+    ReturnCode err_code;
+#pragma omp parallel if(!omp_in_parallel()) default(shared)
+#pragma omp single nowait
+    err_code = factor_phase1(A, opts, workspace, 0, 1);
+    S = std::move(F11_);
+    F12_.clear();
+    F21_.clear();
+    return err_code;
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   FrontDense<scalar_t,integer_t>::factor_phase1
   (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace,
    int etree_level, int task_depth) {
     ReturnCode el = ReturnCode::SUCCESS, er = ReturnCode::SUCCESS;
+    // the contribution blocks of the children are optionally
+    // compressed while waiting for the extend-add
     if (opts.use_openmp_tree() &&
         task_depth < params::task_recursion_cutoff_level) {
       if (lchild_)
 #pragma omp task default(shared)                                        \
   final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
-        el = lchild_->factor(A, opts, workspace, etree_level+1, task_depth+1);
+        {
+          el = lchild_->factor(A, opts, workspace, etree_level+1, task_depth+1);
+          lchild_->compress_CB(opts);
+        }
       if (rchild_)
 #pragma omp task default(shared)                                        \
   final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
-        er = rchild_->factor(A, opts, workspace, etree_level+1, task_depth+1);
+        {
+          er = rchild_->factor(A, opts, workspace, etree_level+1, task_depth+1);
+          rchild_->compress_CB(opts);
+        }
 #pragma omp taskwait
     } else {
-      if (lchild_)
+      if (lchild_) {
         el = lchild_->factor(A, opts, workspace, etree_level+1, task_depth);
-      if (rchild_)
+        lchild_->compress_CB(opts);
+      }
+      if (rchild_) {
         er = rchild_->factor(A, opts, workspace, etree_level+1, task_depth);
+        rchild_->compress_CB(opts);
+      }
     }
     ReturnCode err_code = (el == ReturnCode::SUCCESS) ? er : el;
     // TODO can we allocate the memory in one go??
@@ -233,9 +275,12 @@ namespace strumpack {
     F11_ = DenseM_t(dsep, dsep); F11_.zero();
     F12_ = DenseM_t(dsep, dupd); F12_.zero();
     F21_ = DenseM_t(dupd, dsep); F21_.zero();
-    A.extract_front
-      (F11_, F12_, F21_, this->sep_begin_, this->sep_end_,
-       this->upd_, task_depth);
+    if (this->Amap_.set)
+      A.extract_front(F11_, F12_, F21_, this->Amap_);
+    else
+      A.extract_front
+        (F11_, F12_, F21_, this->sep_begin_, this->sep_end_,
+         this->upd_, task_depth);
     if (dupd) {
       CBstorage_ = workspace.get(std::size_t(dupd)*dupd);
       F22_ = DenseMW_t(dupd, dupd, CBstorage_.data(), dupd);
@@ -257,7 +302,10 @@ namespace strumpack {
    int etree_level, int task_depth) {
     ReturnCode err_code = ReturnCode::SUCCESS;
     if (dim_sep()) {
-      if (F11_.LU(piv_, task_depth))
+      int info = (dim_sep() >= opts.tiled_LU_min_sep_size()) ?
+        F11_.LU_tiled(piv_, opts.tiled_LU_tile_size(), task_depth) :
+        F11_.LU(piv_, task_depth);
+      if (info)
         err_code = ReturnCode::ZERO_PIVOT;
       if (opts.replace_tiny_pivots()) {
         auto thresh = opts.pivot_threshold();
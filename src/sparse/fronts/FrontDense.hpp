@@ -59,6 +59,9 @@ namespace strumpack {
 
     void release_work_memory(VectorPool<scalar_t>& workspace) override;
 
+    void compress_CB(const Opts_t& opts) override;
+    void decompress_CB(VectorPool<scalar_t>& workspace) override;
+
     void extend_add_to_dense(DenseM_t& paF11, DenseM_t& paF12,
                              DenseM_t& paF21, DenseM_t& paF22,
                              const F_t* p, VectorPool<scalar_t>& workspace,
@@ -101,6 +104,15 @@ namespace strumpack {
                               VectorPool<scalar_t>& workspace,
                               int etree_level=0, int task_depth=0) override;
 
+    /**
+     * Factor the descendants of this front, and assemble, but do not
+     * factor, this front. F11 is returned in S, this is the Schur
+     * complement of the unknowns in the separator of this front,
+     * assuming there are no update indices.
+     */
+    ReturnCode Schur_complement(const SpMat_t& A, const Opts_t& opts,
+                                DenseM_t& S);
+
     void
     extract_CB_sub_matrix(const std::vector<std::size_t>& I,
                           const std::vector<std::size_t>& J,
@@ -109,6 +121,7 @@ namespace strumpack {
     void delete_factors() override;
 
     std::string type() const override { return "FrontDense"; }
+    bool uses_assembly_map() const override { return true; }
 
 #if defined(STRUMPACK_USE_MPI)
     void
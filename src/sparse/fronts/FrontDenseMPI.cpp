@@ -89,12 +89,10 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> long long
   FrontDenseMPI<scalar_t,integer_t>::node_factor_nonzeros() const {
-#if defined(STRUMPACK_USE_ZFP) || defined(STRUMPACK_USE_SZ3)
     if (compressed_)
       return (F11c_.compressed_size() + F12c_.compressed_size() +
               F21c_.compressed_size()) / sizeof(scalar_t);
     else
-#endif
       return FMPI_t::node_factor_nonzeros();
   }
 
@@ -164,7 +162,9 @@ namespace strumpack {
     if (!this->dim_upd())
       slate::getrf(slateF11, slate_piv_, slate_opts_);
 #else
-    if (F11_.LU(piv))
+    int info = opts.use_distributed_tiled_LU() ?
+      F11_.LU(piv) : F11_.LU_scalapack(piv);
+    if (info)
       err_code = ReturnCode::ZERO_PIVOT;
 #endif
     if (opts.replace_tiny_pivots()) {
@@ -264,13 +264,10 @@ namespace strumpack {
     if (rchild_) rchild_->release_work_memory();
     auto ef = partial_factorization(opts);
     if (ef != ReturnCode::SUCCESS) err_code = ef;
-#if defined(STRUMPACK_USE_ZFP) || defined(STRUMPACK_USE_SZ3)
     compress(opts);
-#endif
     return err_code;
   }
 
-#if defined(STRUMPACK_USE_ZFP) || defined(STRUMPACK_USE_SZ3)
   template<typename scalar_t,typename integer_t> void
   FrontDenseMPI<scalar_t,integer_t>::compress
   (const SPOptions<scalar_t>& opts) {
@@ -279,9 +276,10 @@ namespace strumpack {
         opts.compression() == CompressionType::ZFP_BLR_HODLR) {
       auto prec = opts.lossy_precision();
       auto acc = opts.lossy_accuracy();
-      F11c_ = LossyMatrix<scalar_t>(F11_.dense_wrapper(), prec, acc);
-      F12c_ = LossyMatrix<scalar_t>(F12_.dense_wrapper(), prec, acc);
-      F21c_ = LossyMatrix<scalar_t>(F21_.dense_wrapper(), prec, acc);
+      auto pcols = opts.lossy_panel_cols();
+      F11c_ = LossyMatrix<scalar_t>(F11_.dense_wrapper(), prec, acc, pcols);
+      F12c_ = LossyMatrix<scalar_t>(F12_.dense_wrapper(), prec, acc, pcols);
+      F21c_ = LossyMatrix<scalar_t>(F21_.dense_wrapper(), prec, acc, pcols);
       F11_.clear();
       F12_.clear();
       F21_.clear();
@@ -303,7 +301,6 @@ namespace strumpack {
       }
     }
   }
-#endif
 
   template<typename scalar_t,typename integer_t> void
   FrontDenseMPI<scalar_t,integer_t>::fwd_solve_phase2
@@ -365,7 +362,6 @@ namespace strumpack {
     bupd = DistM_t(grid(), this->dim_upd(), b.cols());
     bupd.zero();
     this->extend_add_b(b, bupd, CBl, CBr, seqCBl, seqCBr);
-#if defined(STRUMPACK_USE_ZFP) || defined(STRUMPACK_USE_SZ3)
     if (compressed_) {
       const auto dupd = this->dim_upd();
       const auto dsep = this->dim_sep();
@@ -374,7 +370,6 @@ namespace strumpack {
       decompress(F11, F12, F21);
       fwd_solve_phase2(F11, F12, F21, b, bupd);
     } else
-#endif
       fwd_solve_phase2(F11_, F12_, F21_, b, bupd);
   }
 
@@ -421,7 +416,6 @@ namespace strumpack {
   (DenseM_t& yloc, DistM_t* ydist, DistM_t& yupd, DenseM_t&,
    int etree_level) const {
     DistM_t& y = ydist[this->sep_];
-#if defined(STRUMPACK_USE_ZFP) || defined(STRUMPACK_USE_SZ3)
     if (compressed_) {
       const auto dupd = this->dim_upd();
       const auto dsep = this->dim_sep();
@@ -430,7 +424,6 @@ namespace strumpack {
       decompress(F11, F12, F21);
       bwd_solve_phase1(F11, F12, F21, y, yupd);
     } else
-#endif
       bwd_solve_phase1(F11_, F12_, F21_, y, yupd);
     DistM_t CBl, CBr;
     DenseM_t seqCBl, seqCBr;
@@ -543,14 +536,12 @@ namespace strumpack {
   (integer_t& neg, integer_t& zero, integer_t& pos) const {
     if (!this->dim_sep() || !grid()->active())
       return ReturnCode::SUCCESS;
-#if defined(STRUMPACK_USE_ZFP) || defined(STRUMPACK_USE_SZ3)
     if (compressed_) {
       DistM_t F11(grid(), this->dim_sep(), this->dim_sep());
       auto f = F11.dense_wrapper();
       F11c_.decompress(f);
       return matrix_inertia(F11, neg, zero, pos);
     }
-#endif
     return matrix_inertia(F11_, neg, zero, pos);
   }
 
@@ -560,7 +551,6 @@ namespace strumpack {
     const auto dsep = this->dim_sep();
     if (!dsep || !grid()->active())
       return ReturnCode::SUCCESS;
-#if defined(STRUMPACK_USE_ZFP) || defined(STRUMPACK_USE_SZ3)
     if (compressed_) {
       if (dsep) {
         DistM_t F11(grid(), dsep, dsep);
@@ -581,7 +571,6 @@ namespace strumpack {
       }
       return ReturnCode::SUCCESS;
     }
-#endif
     ns += F11_.subnormals() + F12_.subnormals() + F21_.subnormals();
     nz += F11_.zeros() + F12_.zeros() + F21_.zeros();
     return ReturnCode::SUCCESS;
@@ -30,9 +30,7 @@
 #define FRONTAL_MATRIX_DENSE_MPI_HPP
 
 #include "FrontMPI.hpp"
-#if defined(STRUMPACK_USE_ZFP)
 #include "FrontLossy.hpp"
-#endif
 #if defined(STRUMPACK_USE_SLATE_SCALAPACK)
 #define LAPACK_COMPLEX_CPP
 #include <slate/slate.hh>
@@ -144,13 +142,11 @@ namespace strumpack {
     slate::Matrix<scalar_t> slate_matrix(const DistM_t& M) const;
 #endif
 
-#if defined(STRUMPACK_USE_ZFP)
     LossyMatrix<scalar_t> F11c_, F12c_, F21c_;
     bool compressed_ = false;
 
     void compress(const SPOptions<scalar_t>& opts);
     void decompress(DistM_t& F11, DistM_t& F12, DistM_t& F21) const;
-#endif
 
     ReturnCode matrix_inertia(const DistM_t& F,
                               integer_t& neg,
@@ -37,6 +37,8 @@
 #include "FrontBLR.hpp"
 #if defined(STRUMPACK_USE_BPACK)
 #include "FrontHODLR.hpp"
+#else
+#include "FrontHODLRNative.hpp"
 #endif
 #if defined(STRUMPACK_USE_MPI)
 #include "FrontDenseMPI.hpp"
@@ -55,12 +57,20 @@
 #if defined(STRUMPACK_USE_CUDA)
 #include "FrontGPUSPD.hpp"
 #endif
-#if defined(STRUMPACK_USE_ZFP)
 #include "FrontLossy.hpp"
-#endif
 
 namespace strumpack {
 
+  // sequential HODLR front: with BPACK if available, otherwise the
+  // native shared-memory implementation
+#if defined(STRUMPACK_USE_BPACK)
+  template<typename scalar_t, typename integer_t>
+  using FrontHODLR_t = FrontHODLR<scalar_t,integer_t>;
+#else
+  template<typename scalar_t, typename integer_t>
+  using FrontHODLR_t = FrontHODLRNative<scalar_t,integer_t>;
+#endif
+
   template<typename scalar_t, typename integer_t>
   std::unique_ptr<Front<scalar_t,integer_t>> create_frontal_matrix
   (const SPOptions<scalar_t>& opts, integer_t s, integer_t sbegin,
@@ -88,22 +98,18 @@ namespace strumpack {
       }
     } break;
     case CompressionType::HODLR: {
-#if defined(STRUMPACK_USE_BPACK)
       if (is_HODLR(dsep, dupd, opts)) {
-        front = std::make_unique<FrontHODLR<scalar_t,integer_t>>
+        front = std::make_unique<FrontHODLR_t<scalar_t,integer_t>>
           (s, sbegin, send, upd);
         if (root) fc.HODLR++;
       }
-#endif
     } break;
     case CompressionType::BLR_HODLR: {
-#if defined(STRUMPACK_USE_BPACK)
       if (is_HODLR(dsep, dupd, opts, 0)) {
-        front = std::make_unique<FrontHODLR<scalar_t,integer_t>>
+        front = std::make_unique<FrontHODLR_t<scalar_t,integer_t>>
           (s, sbegin, send, upd);
         if (root) fc.HODLR++;
       }
-#endif
       if (!front && is_BLR(dsep, dupd, opts, 1)) {
         front = std::make_unique<FrontBLR<scalar_t,integer_t>>
           (s, sbegin, send, upd);
@@ -111,35 +117,29 @@ namespace strumpack {
       }
     } break;
     case CompressionType::ZFP_BLR_HODLR: {
-#if defined(STRUMPACK_USE_BPACK)
       if (is_HODLR(dsep, dupd, opts, 0)) {
-        front = std::make_unique<FrontHODLR<scalar_t,integer_t>>
+        front = std::make_unique<FrontHODLR_t<scalar_t,integer_t>>
           (s, sbegin, send, upd);
         if (root) fc.HODLR++;
       }
-#endif
       if (!front && is_BLR(dsep, dupd, opts, 1)) {
         front.reset
           (new FrontBLR<scalar_t,integer_t>(s, sbegin, send, upd));
         if (root) fc.BLR++;
       }
-#if defined(STRUMPACK_USE_ZFP)
       if (!front && is_lossy(dsep, dupd, opts, 2)) {
         front = std::make_unique<FrontLossy<scalar_t,integer_t>>
           (s, sbegin, send, upd);
         if (root) fc.lossy++;
       }
-#endif
     } break;
     case CompressionType::LOSSLESS:
     case CompressionType::LOSSY: {
-#if defined(STRUMPACK_USE_ZFP)
       if (is_lossy(dsep, dupd, opts)) {
         front = std::make_unique<FrontLossy<scalar_t,integer_t>>
           (s, sbegin, send, upd);
         if (root) fc.lossy++;
       }
-#endif
     } break;
     };
     if (front) return front;
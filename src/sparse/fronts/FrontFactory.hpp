@@ -99,28 +99,20 @@ namespace strumpack {
 
   template<typename scalar_t> bool is_HODLR
   (int dsep, int dupd, const SPOptions<scalar_t>& opts, int l=0) {
-#if defined(STRUMPACK_USE_BPACK)
     return (opts.compression() == CompressionType::HODLR ||
             opts.compression() == CompressionType::BLR_HODLR ||
             opts.compression() == CompressionType::ZFP_BLR_HODLR) &&
       (dsep >= opts.compression_min_sep_size(l) ||
        dsep + dupd >= opts.compression_min_front_size(l));
-#else
-    return false;
-#endif
   }
 
   template<typename scalar_t> bool is_lossy
   (int dsep, int dupd, const SPOptions<scalar_t>& opts, int l=0) {
-#if defined(STRUMPACK_USE_ZFP)
     return (opts.compression() == CompressionType::LOSSY ||
             opts.compression() == CompressionType::LOSSLESS ||
             opts.compression() == CompressionType::ZFP_BLR_HODLR) &&
       (dsep >= opts.compression_min_sep_size(l) ||
        dsep + dupd >= opts.compression_min_front_size(l));
-#else
-    return false;
-#endif
   }
 
   template<typename scalar_t> bool is_compressed
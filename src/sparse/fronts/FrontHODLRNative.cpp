@@ -0,0 +1,170 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include "FrontHODLRNative.hpp"
+#include "sparse/CSRGraph.hpp"
+
+namespace strumpack {
+
+  template<typename scalar_t,typename integer_t>
+  FrontHODLRNative<scalar_t,integer_t>::FrontHODLRNative
+  (integer_t sep, integer_t sep_begin, integer_t sep_end,
+   std::vector<integer_t>& upd)
+    : FD_t(sep, sep_begin, sep_end, upd) {}
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontHODLRNative<scalar_t,integer_t>::factor
+  (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace,
+   int etree_level, int task_depth) {
+    ReturnCode e1, e2;
+    if (task_depth == 0) {
+#pragma omp parallel if(!omp_in_parallel()) default(shared)
+#pragma omp single nowait
+      {
+        e1 = this->factor_phase1(A, opts, workspace, etree_level, task_depth+1);
+        e2 = factor_node(opts, task_depth);
+      }
+    } else {
+      e1 = this->factor_phase1(A, opts, workspace, etree_level, task_depth);
+      e2 = factor_node(opts, task_depth);
+    }
+    return (e1 == ReturnCode::SUCCESS) ? e2 : e1;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontHODLRNative<scalar_t,integer_t>::factor_node
+  (const Opts_t& opts, int task_depth) {
+    if (!dim_sep()) return ReturnCode::SUCCESS;
+    auto& F11 = this->F11_;
+    auto& F12 = this->F12_;
+    // the separator tree is set in partition, fall back to a regular
+    // bisection when the separator was not reordered
+    if (sep_tree_.size != dim_sep())
+      sep_tree_ = structured::ClusterTree(dim_sep()).refine
+        (opts.HODLR_options().leaf_size());
+    F11h_ = HODLR::HODLRMatrixNative<scalar_t>
+      (sep_tree_, F11, opts.HODLR_options());
+    F11.clear();
+    F11h_.factor();
+    if (dim_upd()) {
+      F11h_.solve(F12);
+      gemm(Trans::N, Trans::N, scalar_t(-1.), this->F21_, F12,
+           scalar_t(1.), this->F22_, task_depth);
+      STRUMPACK_FULL_RANK_FLOPS
+        (gemm_flops(Trans::N, Trans::N, scalar_t(-1.), this->F21_, F12,
+                    scalar_t(1.)));
+    }
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontHODLRNative<scalar_t,integer_t>::fwd_solve_phase2
+  (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const {
+    if (!dim_sep()) return;
+    DenseMW_t bloc(dim_sep(), b.cols(), b, sep_begin_, 0);
+    F11h_.solve(bloc);
+    if (dim_upd()) {
+      if (b.cols() == 1)
+        gemv(Trans::N, scalar_t(-1.), this->F21_, bloc,
+             scalar_t(1.), bupd, task_depth);
+      else
+        gemm(Trans::N, Trans::N, scalar_t(-1.), this->F21_, bloc,
+             scalar_t(1.), bupd, task_depth);
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontHODLRNative<scalar_t,integer_t>::bwd_solve_phase1
+  (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth) const {
+    if (!dim_sep() || !dim_upd()) return;
+    DenseMW_t yloc(dim_sep(), y.cols(), y, sep_begin_, 0);
+    if (y.cols() == 1)
+      gemv(Trans::N, scalar_t(-1.), this->F12_, yupd,
+           scalar_t(1.), yloc, task_depth);
+    else
+      gemm(Trans::N, Trans::N, scalar_t(-1.), this->F12_, yupd,
+           scalar_t(1.), yloc, task_depth);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontHODLRNative<scalar_t,integer_t>::delete_factors() {
+    FD_t::delete_factors();
+    F11h_ = HODLR::HODLRMatrixNative<scalar_t>();
+  }
+
+  template<typename scalar_t,typename integer_t> integer_t
+  FrontHODLRNative<scalar_t,integer_t>::front_rank(int task_depth) const {
+    return F11h_.rank();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontHODLRNative<scalar_t,integer_t>::print_rank_statistics
+  (std::ostream &out) const {
+    if (lchild_) lchild_->print_rank_statistics(out);
+    if (rchild_) rchild_->print_rank_statistics(out);
+    out << "# HODLRMatrixNative " << F11h_.rows() << "x" << F11h_.cols()
+        << " levels= " << F11h_.levels() << " rank= " << F11h_.rank()
+        << " memory= " << F11h_.memory() / 1.e6 << " MB" << std::endl;
+  }
+
+  template<typename scalar_t,typename integer_t> long long
+  FrontHODLRNative<scalar_t,integer_t>::node_factor_nonzeros() const {
+    return F11h_.nonzeros() + this->F12_.nonzeros() + this->F21_.nonzeros();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontHODLRNative<scalar_t,integer_t>::partition
+  (const Opts_t& opts, const SpMat_t& A, integer_t* sorder,
+   bool is_root, int task_depth) {
+    if (!dim_sep()) return;
+    auto g = A.extract_graph
+      (opts.separator_ordering_level(), sep_begin_, sep_end_);
+    sep_tree_ = g.recursive_bisection
+      (opts.HODLR_options().leaf_size(), 0,
+       sorder+sep_begin_, nullptr, 0, 0, dim_sep());
+    for (integer_t i=sep_begin_; i<sep_end_; i++)
+      sorder[i] += sep_begin_;
+  }
+
+  // explicit template instantiations
+  template class FrontHODLRNative<float,int>;
+  template class FrontHODLRNative<double,int>;
+  template class FrontHODLRNative<std::complex<float>,int>;
+  template class FrontHODLRNative<std::complex<double>,int>;
+
+  template class FrontHODLRNative<float,long int>;
+  template class FrontHODLRNative<double,long int>;
+  template class FrontHODLRNative<std::complex<float>,long int>;
+  template class FrontHODLRNative<std::complex<double>,long int>;
+
+  template class FrontHODLRNative<float,long long int>;
+  template class FrontHODLRNative<double,long long int>;
+  template class FrontHODLRNative<std::complex<float>,long long int>;
+  template class FrontHODLRNative<std::complex<double>,long long int>;
+
+} // end namespace strumpack
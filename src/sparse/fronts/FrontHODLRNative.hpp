@@ -0,0 +1,108 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef FRONTAL_MATRIX_HODLR_NATIVE_HPP
+#define FRONTAL_MATRIX_HODLR_NATIVE_HPP
+
+#include "FrontDense.hpp"
+#include "HODLR/HODLRMatrixNative.hpp"
+
+namespace strumpack {
+
+  /**
+   * Frontal matrix with the F11 block compressed as a shared memory
+   * HODLR matrix, see HODLR::HODLRMatrixNative. This is used for
+   * HODLR compression when STRUMPACK is not configured with
+   * ButterflyPACK, and does not require MPI.
+   *
+   * The front is assembled as a dense front, after which F11 is
+   * compressed and factored, F12 is overwritten with F11^{-1} F12
+   * and the Schur complement F22 - F21 F11^{-1} F12 is computed
+   * densely. F12 and F21 are kept as dense matrices. Since F11 is
+   * assembled densely, the peak memory during the factorization of
+   * this front is that of a dense front, only the memory for the
+   * factors is reduced.
+   */
+  template<typename scalar_t,typename integer_t> class FrontHODLRNative
+    : public FrontDense<scalar_t,integer_t> {
+    using F_t = Front<scalar_t,integer_t>;
+    using FD_t = FrontDense<scalar_t,integer_t>;
+    using DenseM_t = DenseMatrix<scalar_t>;
+    using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+    using SpMat_t = CompressedSparseMatrix<scalar_t,integer_t>;
+    using Opts_t = SPOptions<scalar_t>;
+
+  public:
+    FrontHODLRNative(integer_t sep, integer_t sep_begin, integer_t sep_end,
+                     std::vector<integer_t>& upd);
+
+    ReturnCode factor(const SpMat_t& A, const Opts_t& opts,
+                      VectorPool<scalar_t>& workspace,
+                      int etree_level=0, int task_depth=0) override;
+
+    void delete_factors() override;
+
+    integer_t front_rank(int task_depth=0) const override;
+    void print_rank_statistics(std::ostream &out) const override;
+    std::string type() const override { return "FrontHODLRNative"; }
+
+    void partition(const Opts_t& opts, const SpMat_t& A, integer_t* sorder,
+                   bool is_root=true, int task_depth=0) override;
+
+    long long node_factor_nonzeros() const override;
+
+  private:
+    HODLR::HODLRMatrixNative<scalar_t> F11h_;
+    structured::ClusterTree sep_tree_;
+
+    ReturnCode factor_node(const Opts_t& opts, int task_depth);
+
+    void fwd_solve_phase2(DenseM_t& b, DenseM_t& bupd,
+                          int etree_level, int task_depth) const override;
+    void bwd_solve_phase1(DenseM_t& y, DenseM_t& yupd,
+                          int etree_level, int task_depth) const override;
+
+    ReturnCode node_inertia(integer_t& neg, integer_t& zero,
+                            integer_t& pos) const override {
+      return ReturnCode::INACCURATE_INERTIA;
+    }
+
+    FrontHODLRNative(const FrontHODLRNative&) = delete;
+    FrontHODLRNative& operator=(FrontHODLRNative const&) = delete;
+
+    using F_t::lchild_;
+    using F_t::rchild_;
+    using F_t::dim_sep;
+    using F_t::dim_upd;
+    using F_t::sep_begin_;
+    using F_t::sep_end_;
+  };
+
+} // end namespace strumpack
+
+#endif // FRONTAL_MATRIX_HODLR_NATIVE_HPP
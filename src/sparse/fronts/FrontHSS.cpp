@@ -51,6 +51,11 @@ namespace strumpack {
     Sr2.clear();
     Sc2.clear();
     DUB01_.clear();
+    // the parent has been compressed, so from now on F11 is only
+    // used in the solve
+    if (storage_prec_ != StoragePrecision::FULL && !H_.leaf())
+      H_.child(0)->reduce_precision
+        (storage_rtol_, storage_atol_, storage_prec_);
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -362,6 +367,12 @@ namespace strumpack {
     if (er != ReturnCode::SUCCESS) err_code = er;
     TaskTimer t("FrontHSS_factor");
     if (opts.print_compressed_front_stats()) t.start();
+    if (!H_.is_untouched()) {
+      // refactorization
+      H_ = HSS::HSSMatrix<scalar_t>(tree_, opts.HSS_options());
+      Hf_.reset();
+      sampled_columns_ = 0;
+    }
     H_.set_openmp_task_depth(task_depth);
     auto mult = [&](DenseM_t& Rr, DenseM_t& Rc, DenseM_t& Sr, DenseM_t& Sc) {
       TIMER_TIME(TaskType::RANDOM_SAMPLING, 0, t_sampling);
@@ -406,10 +417,19 @@ namespace strumpack {
           STRUMPACK_SCHUR_FLOPS
             (gemm_flops(Trans::N, Trans::C, scalar_t(1.), Theta_, Vhat, scalar_t(0.)));
         }
+        // F11 is reduced to lower precision in release_work_memory,
+        // since the Schur complement sampling might still need it
+        storage_prec_ = HSSopts.storage_precision();
+        storage_rtol_ = HSSopts.rel_tol();
+        storage_atol_ = HSSopts.abs_tol();
       } else {
         TIMER_TIME(TaskType::HSS_FACTOR, 0, t_fact);
         H_.factor();
         TIMER_STOP(t_fact);
+        if (HSSopts.storage_precision() == StoragePrecision::FULL)
+          Hf_.reset(new HSS::HSSMatrixFrozen<scalar_t>(H_));
+        else H_.reduce_precision(HSSopts.rel_tol(), HSSopts.abs_tol(),
+                                 HSSopts.storage_precision());
       }
     }
     if (opts.print_compressed_front_stats()) {
@@ -452,23 +472,41 @@ namespace strumpack {
     if (etree_level) {
       if (Theta_.cols() && Phi_.cols()) {
         DenseMW_t bloc(dim_sep(), b.cols(), b, sep_begin_, 0);
-        // TODO get rid of this!!!
-        ULVwork_ = std::unique_ptr<HSS::WorkSolve<scalar_t>>
-          (new HSS::WorkSolve<scalar_t>());
-        H_.child(0)->forward_solve(*ULVwork_, bloc, true);
+        auto& w = new_ULVwork(b);
+        H_.child(0)->forward_solve(w, bloc, true);
         if (dim_upd())
           gemm(Trans::N, Trans::N, scalar_t(-1.), Theta_,
-               ULVwork_->reduced_rhs, scalar_t(1.), bupd, task_depth);
-        ULVwork_->reduced_rhs.clear();
+               w.reduced_rhs, scalar_t(1.), bupd, task_depth);
+        w.reduced_rhs.clear();
       }
     } else {
       DenseMW_t bloc(dim_sep(), b.cols(), b, sep_begin_, 0);
-      ULVwork_ = std::unique_ptr<HSS::WorkSolve<scalar_t>>
-        (new HSS::WorkSolve<scalar_t>());
-      H_.forward_solve(*ULVwork_, bloc, false);
+      // the root has no update block, so the backward solve can be
+      // done right away
+      if (Hf_) Hf_->solve(bloc);
+      else H_.forward_solve(new_ULVwork(b), bloc, false);
     }
   }
 
+  template<typename scalar_t,typename integer_t> HSS::WorkSolve<scalar_t>&
+  FrontHSS<scalar_t,integer_t>::new_ULVwork(const DenseM_t& b) const {
+    std::lock_guard<std::mutex> lock(ULVwork_mtx_);
+    auto& w = ULVwork_[b.data()];
+    w.reset(new HSS::WorkSolve<scalar_t>());
+    return *w;
+  }
+
+  template<typename scalar_t,typename integer_t>
+  std::unique_ptr<HSS::WorkSolve<scalar_t>>
+  FrontHSS<scalar_t,integer_t>::take_ULVwork(const DenseM_t& b) const {
+    std::lock_guard<std::mutex> lock(ULVwork_mtx_);
+    auto it = ULVwork_.find(b.data());
+    assert(it != ULVwork_.end());
+    auto w = std::move(it->second);
+    ULVwork_.erase(it);
+    return w;
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontHSS<scalar_t,integer_t>::backward_multifrontal_solve
   (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth) const {
@@ -485,17 +523,18 @@ namespace strumpack {
     DenseMW_t yupd(dim_upd(), y.cols(), work[0], 0, 0);
     if (etree_level) {
       if (Phi_.cols() && Theta_.cols()) {
+        auto w = take_ULVwork(y);
         if (dim_upd()) {
           gemm(Trans::C, Trans::N, scalar_t(-1.), Phi_, yupd,
-               scalar_t(1.), ULVwork_->x, task_depth);
+               scalar_t(1.), w->x, task_depth);
         }
         DenseMW_t yloc(dim_sep(), y.cols(), y, sep_begin_, 0);
-        H_.child(0)->backward_solve(*ULVwork_, yloc);
-        ULVwork_.reset();
+        H_.child(0)->backward_solve(*w, yloc);
       }
-    } else {
+    } else if (!Hf_) {
+      auto w = take_ULVwork(y);
       DenseMW_t yloc(dim_sep(), y.cols(), y, sep_begin_, 0);
-      H_.backward_solve(*ULVwork_, yloc);
+      H_.backward_solve(*w, yloc);
     }
     this->bwd_solve_phase2(y, yupd, work, etree_level, task_depth);
   }
@@ -517,7 +556,8 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> long long
   FrontHSS<scalar_t,integer_t>::node_factor_nonzeros() const {
     return H_.nonzeros() + H_.factor_nonzeros() + Theta_.nonzeros()
-      + Phi_.nonzeros() + ThetaVhatC_or_VhatCPhiC_.nonzeros();
+      + Phi_.nonzeros() + ThetaVhatC_or_VhatCPhiC_.nonzeros()
+      + (Hf_ ? Hf_->memory() / sizeof(scalar_t) : 0);
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -539,15 +579,15 @@ namespace strumpack {
     for (integer_t i=sep_begin_; i<sep_end_; i++)
       sorder[i] += sep_begin_;
     if (is_root)
-      H_ = HSS::HSSMatrix<scalar_t>(sep_tree, opts.HSS_options());
+      tree_ = sep_tree;
     else {
-      structured::ClusterTree tree(this->dim_blk());
-      tree.c.reserve(2);
-      tree.c.push_back(sep_tree);
-      tree.c.emplace_back(dim_upd());
-      tree.c.back().refine(opts.HSS_options().leaf_size());
-      H_ = HSS::HSSMatrix<scalar_t>(tree, opts.HSS_options());
+      tree_ = structured::ClusterTree(this->dim_blk());
+      tree_.c.reserve(2);
+      tree_.c.push_back(sep_tree);
+      tree_.c.emplace_back(dim_upd());
+      tree_.c.back().refine(opts.HSS_options().leaf_size());
     }
+    H_ = HSS::HSSMatrix<scalar_t>(tree_, opts.HSS_options());
   }
 
   // explicit template instantiations
@@ -29,8 +29,12 @@
 #ifndef FRONTAL_MATRIX_HSS_HPP
 #define FRONTAL_MATRIX_HSS_HPP
 
+#include <map>
+#include <mutex>
+
 #include "Front.hpp"
 #include "HSS/HSSMatrix.hpp"
+#include "HSS/HSSMatrixFrozen.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "FrontMPI.hpp"
 #endif
@@ -103,8 +107,26 @@ namespace strumpack {
     // TODO make private?
     HSS::HSSMatrix<scalar_t> H_;
 
-    // TODO do not store this here: makes solve not thread safe!!
-    mutable std::unique_ptr<HSS::WorkSolve<scalar_t>> ULVwork_;
+    /**
+     * Flattened copy of H_ for the root front, which is fully
+     * factored and is solved with a single ULV solve, once per
+     * (iterative refinement or GMRES) iteration. Only made when the
+     * generators are stored in full precision.
+     */
+    std::unique_ptr<HSS::HSSMatrixFrozen<scalar_t>> Hf_;
+
+    /**
+     * ULV solve work, passed from the forward to the backward
+     * solve. There is one per concurrent solve, identified by the
+     * (address of the) right-hand side, which is the same in the
+     * forward and backward solve.
+     */
+    mutable std::mutex ULVwork_mtx_;
+    mutable std::map<const scalar_t*,
+                     std::unique_ptr<HSS::WorkSolve<scalar_t>>> ULVwork_;
+    HSS::WorkSolve<scalar_t>& new_ULVwork(const DenseM_t& b) const;
+    std::unique_ptr<HSS::WorkSolve<scalar_t>>
+    take_ULVwork(const DenseM_t& b) const;
 
     /** Schur complement update:
      *    S = F22 - _Theta * Vhat^C * _Phi^C
@@ -120,6 +142,18 @@ namespace strumpack {
                            construct HSS matrix of this front */
     std::uint32_t sampled_columns_ = 0;
 
+    /** the HSS partitioning of this front, computed in partition,
+        H_ is rebuilt from this for every (re)factorization, since
+        release_work_memory deletes part of H_ */
+    structured::ClusterTree tree_;
+
+    /** lowest precision, and tolerances, to store the generators of
+        F11 once this front is no longer needed by its parent, see
+        HSS::HSSMatrix::reduce_precision */
+    StoragePrecision storage_prec_ = StoragePrecision::FULL;
+    typename RealType<scalar_t>::value_type storage_rtol_ = 0,
+      storage_atol_ = 0;
+
   private:
     FrontHSS(const FrontHSS&) = delete;
     FrontHSS& operator=(FrontHSS const&) = delete;
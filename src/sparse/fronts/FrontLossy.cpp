@@ -28,128 +28,8 @@
  */
 #include "FrontLossy.hpp"
 
-#if defined(STRUMPACK_USE_ZFP)
-#include "zfp.h"
-#if ZFP_VERSION >= 0x1000
-#include "zfp/array2.hpp"
-#else
-#include "zfparray2.h"
-#endif
-#endif
-
-#if defined(STRUMPACK_USE_SZ3)
-#include "SZ3/api/sz.hpp"
-#endif
-
 namespace strumpack {
 
-#if defined(STRUMPACK_USE_ZFP)
-  template<typename T> zfp_type get_zfp_type();
-  template<> inline zfp_type get_zfp_type<float>() { return zfp_type_float; }
-  template<> inline zfp_type get_zfp_type<double>() { return zfp_type_double; }
-#endif
-
-  template<typename T> LossyMatrix<T>::LossyMatrix
-  (const DenseMatrix<T>& F, int prec, double acc)
-    : rows_(F.rows()), cols_(F.cols()), prec_(prec), acc_(acc) {
-    if (!rows_ || !cols_) return;
-#if defined(STRUMPACK_USE_SZ3)
-    SZ3::Config conf(cols_, rows_);
-    conf.relErrorBound = acc;
-    conf.errorBoundMode = SZ3::EB_REL;
-    buffer_.reset(SZ_compress<T>(conf, F.data(), out_size_));
-    STRUMPACK_ADD_MEMORY(out_size_*sizeof(unsigned char));
-#else // defined(STRUMPACK_USE_ZFP)
-    zfp_field* f = zfp_field_2d
-      (static_cast<void*>(const_cast<T*>(F.data())),
-       get_zfp_type<T>(), rows_, cols_);
-    zfp_stream* stream = zfp_stream_open(NULL);
-#if defined(STRUMPACK_USE_OPENMP)
-    zfp_stream_set_execution(stream, zfp_exec_omp);
-#endif
-    if (acc_ < 0) {
-      if (prec_ <= 0) zfp_stream_set_reversible(stream);
-      else zfp_stream_set_precision(stream, prec_);
-    } else
-      zfp_stream_set_accuracy(stream, acc_);
-    auto bufsize = zfp_stream_maximum_size(stream, f);
-    buffer_.resize(bufsize);
-    bitstream* bstream = stream_open(buffer_.data(), bufsize);
-    zfp_stream_set_bit_stream(stream, bstream);
-    zfp_stream_rewind(stream);
-    auto comp_size = zfp_compress(stream, f);
-    buffer_.resize(comp_size);
-    STRUMPACK_ADD_MEMORY(buffer_.size()*sizeof(unsigned char));
-    zfp_stream_flush(stream);
-    zfp_field_free(f);
-    zfp_stream_close(stream);
-    stream_close(bstream);
-#endif
-  }
-
-  template<typename T> void LossyMatrix<T>::decompress
-  (DenseMatrix<T>& F) const {
-    assert(F.rows() == rows_ && F.cols() == cols_);
-    if (!rows_ || !cols_) return;
-#if defined(STRUMPACK_USE_SZ3)
-    SZ3::Config conf;
-    T* out = F.data();
-    SZ_decompress<T>(conf, buffer_.get(), out_size_, out);
-#else // defined(STRUMPACK_USE_ZFP)
-    zfp_field* f = zfp_field_2d
-      (static_cast<void*>(F.data()), get_zfp_type<T>(), rows_, cols_);
-    zfp_stream* destream = zfp_stream_open(NULL);
-// #if defined(STRUMPACK_USE_OPENMP)
-//     zfp_stream_set_execution(destream, zfp_exec_omp);
-// #endif
-    if (acc_ < 0) {
-      if (prec_ <= 0) zfp_stream_set_reversible(destream);
-      else zfp_stream_set_precision(destream, prec_);
-    } else
-      zfp_stream_set_accuracy(destream, acc_);
-    bitstream* bstream = stream_open
-      (static_cast<void*>
-       (const_cast<uchar*>(buffer_.data())), buffer_.size());
-    zfp_stream_set_bit_stream(destream, bstream);
-    zfp_stream_rewind(destream);
-    zfp_decompress(destream, f);
-    zfp_field_free(f);
-    zfp_stream_close(destream);
-    stream_close(bstream);
-#endif
-  }
-
-  template<typename T> LossyMatrix<std::complex<T>>::LossyMatrix
-  (const DenseMatrix<std::complex<T>>& F, int prec, double acc) {
-    int rows = F.rows(), cols = F.cols();
-    DenseMatrix<T> Freal(rows, cols), Fimag(rows, cols);
-    for (int j=0; j<cols; j++)
-      for (int i=0; i<rows; i++) {
-        Freal(i, j) = F(i,j).real();
-        Fimag(i, j) = F(i,j).imag();
-      }
-    Freal_ = LossyMatrix<T>(Freal, prec, acc);
-    Fimag_ = LossyMatrix<T>(Fimag, prec, acc);
-  }
-
-  template<typename T> void LossyMatrix<std::complex<T>>::decompress
-  (DenseMatrix<std::complex<T>>& F) const {
-    auto Freal = Freal_.decompress();
-    auto Fimag = Fimag_.decompress();
-    int rows = Freal_.rows(), cols = Freal_.cols();
-    for (int j=0; j<cols; j++)
-      for (int i=0; i<rows; i++)
-        F(i, j) = std::complex<T>(Freal(i,j), Fimag(i,j));
-    return;
-  }
-
-  // explicit template instantiations
-  template class LossyMatrix<float>;
-  template class LossyMatrix<double>;
-  template class LossyMatrix<std::complex<float>>;
-  template class LossyMatrix<std::complex<double>>;
-
-
   template<typename scalar_t,typename integer_t>
   FrontLossy<scalar_t,integer_t>::FrontLossy
   (integer_t sep, integer_t sep_begin, integer_t sep_end,
@@ -166,9 +46,10 @@ namespace strumpack {
   FrontLossy<scalar_t,integer_t>::compress(const Opts_t& opts) {
     auto prec = opts.lossy_precision();
     auto acc = opts.lossy_accuracy();
-    F11c_ = LossyMatrix<scalar_t>(this->F11_, prec, acc);
-    F12c_ = LossyMatrix<scalar_t>(this->F12_, prec, acc);
-    F21c_ = LossyMatrix<scalar_t>(this->F21_, prec, acc);
+    auto pcols = opts.lossy_panel_cols();
+    F11c_ = LossyMatrix<scalar_t>(this->F11_, prec, acc, pcols);
+    F12c_ = LossyMatrix<scalar_t>(this->F12_, prec, acc, pcols);
+    F21c_ = LossyMatrix<scalar_t>(this->F21_, prec, acc, pcols);
     this->F11_.clear();
     this->F12_.clear();
     this->F21_.clear();
@@ -191,47 +72,90 @@ namespace strumpack {
     return e;
   }
 
+  /**
+   * The factors are decompressed one column panel at a time into a
+   * small buffer. The forward solve only touches F11 and F21, the
+   * backward solve only F12 and F11.
+   */
   template<typename scalar_t,typename integer_t> void
   FrontLossy<scalar_t,integer_t>::fwd_solve_phase2
   (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const {
-    DenseM_t F11, F12, F21;
-    decompress(F11, F12, F21);
-    if (this->dim_sep()) {
-      DenseMW_t bloc(this->dim_sep(), b.cols(), b, this->sep_begin_, 0);
-      bloc.laswp(this->piv_, true);
-      if (b.cols() == 1) {
-        trsv(UpLo::L, Trans::N, Diag::U, F11, bloc, task_depth);
-        if (this->dim_upd())
-          gemv(Trans::N, scalar_t(-1.), F21, bloc,
-               scalar_t(1.), bupd, task_depth);
-      } else {
-        trsm(Side::L, UpLo::L, Trans::N, Diag::U,
-             scalar_t(1.), F11, bloc, task_depth);
-        if (this->dim_upd())
-          gemm(Trans::N, Trans::N, scalar_t(-1.), F21, bloc,
-               scalar_t(1.), bupd, task_depth);
+    const std::size_t dsep = this->dim_sep(), dupd = this->dim_upd();
+    if (!dsep) return;
+    const auto nrhs = b.cols();
+    DenseMW_t bloc(dsep, nrhs, b, this->sep_begin_, 0);
+    bloc.laswp(this->piv_, true);
+    // forward substitution with the unit lower triangular L11, by
+    // column panels
+    DenseM_t buf(dsep, F11c_.panel_cols());
+    for (std::size_t p=0; p<F11c_.panels(); p++) {
+      auto c0 = F11c_.panel_begin(p), c1 = F11c_.panel_end(p), w = c1 - c0;
+      F11c_.decompress_panel(p, buf.data(), buf.ld());
+      DenseMW_t Ld(w, w, buf, c0, 0), bp(w, nrhs, bloc, c0, 0);
+      if (nrhs == 1) trsv(UpLo::L, Trans::N, Diag::U, Ld, bp, task_depth);
+      else trsm(Side::L, UpLo::L, Trans::N, Diag::U,
+                scalar_t(1.), Ld, bp, task_depth);
+      if (c1 < dsep) {
+        DenseMW_t Lb(dsep-c1, w, buf, c1, 0), bb(dsep-c1, nrhs, bloc, c1, 0);
+        if (nrhs == 1)
+          gemv(Trans::N, scalar_t(-1.), Lb, bp, scalar_t(1.), bb, task_depth);
+        else
+          gemm(Trans::N, Trans::N, scalar_t(-1.), Lb, bp,
+               scalar_t(1.), bb, task_depth);
       }
     }
+    if (!dupd) return;
+    buf = DenseM_t(dupd, F21c_.panel_cols());
+    for (std::size_t p=0; p<F21c_.panels(); p++) {
+      auto c0 = F21c_.panel_begin(p), c1 = F21c_.panel_end(p), w = c1 - c0;
+      F21c_.decompress_panel(p, buf.data(), buf.ld());
+      DenseMW_t F21p(dupd, w, buf, 0, 0), bp(w, nrhs, bloc, c0, 0);
+      if (nrhs == 1)
+        gemv(Trans::N, scalar_t(-1.), F21p, bp, scalar_t(1.), bupd, task_depth);
+      else
+        gemm(Trans::N, Trans::N, scalar_t(-1.), F21p, bp,
+             scalar_t(1.), bupd, task_depth);
+    }
   }
 
   template<typename scalar_t,typename integer_t> void
   FrontLossy<scalar_t,integer_t>::bwd_solve_phase1
   (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth) const {
-    DenseM_t F11, F12, F21;
-    decompress(F11, F12, F21);
-    if (this->dim_sep()) {
-      DenseMW_t yloc(this->dim_sep(), y.cols(), y, this->sep_begin_, 0);
-      if (y.cols() == 1) {
-        if (this->dim_upd())
-          gemv(Trans::N, scalar_t(-1.), F12, yupd,
-               scalar_t(1.), yloc, task_depth);
-        trsv(UpLo::U, Trans::N, Diag::N, F11, yloc, task_depth);
-      } else {
-        if (this->dim_upd())
-          gemm(Trans::N, Trans::N, scalar_t(-1.), F12, yupd,
+    const std::size_t dsep = this->dim_sep(), dupd = this->dim_upd();
+    if (!dsep) return;
+    const auto nrhs = y.cols();
+    DenseMW_t yloc(dsep, nrhs, y, this->sep_begin_, 0);
+    DenseM_t buf;
+    if (dupd) {
+      buf = DenseM_t(dsep, F12c_.panel_cols());
+      for (std::size_t p=0; p<F12c_.panels(); p++) {
+        auto c0 = F12c_.panel_begin(p), c1 = F12c_.panel_end(p), w = c1 - c0;
+        F12c_.decompress_panel(p, buf.data(), buf.ld());
+        DenseMW_t F12p(dsep, w, buf, 0, 0), yp(w, nrhs, yupd, c0, 0);
+        if (nrhs == 1)
+          gemv(Trans::N, scalar_t(-1.), F12p, yp, scalar_t(1.), yloc, task_depth);
+        else
+          gemm(Trans::N, Trans::N, scalar_t(-1.), F12p, yp,
                scalar_t(1.), yloc, task_depth);
-        trsm(Side::L, UpLo::U, Trans::N, Diag::N, scalar_t(1.),
-             F11, yloc, task_depth);
+      }
+    }
+    // backward substitution with the upper triangular U11, by column
+    // panels, from the last to the first panel
+    buf = DenseM_t(dsep, F11c_.panel_cols());
+    for (std::size_t p=F11c_.panels(); p-- > 0; ) {
+      auto c0 = F11c_.panel_begin(p), c1 = F11c_.panel_end(p), w = c1 - c0;
+      F11c_.decompress_panel(p, buf.data(), buf.ld());
+      DenseMW_t Ud(w, w, buf, c0, 0), yp(w, nrhs, yloc, c0, 0);
+      if (nrhs == 1) trsv(UpLo::U, Trans::N, Diag::N, Ud, yp, task_depth);
+      else trsm(Side::L, UpLo::U, Trans::N, Diag::N,
+                scalar_t(1.), Ud, yp, task_depth);
+      if (c0) {
+        DenseMW_t Ub(c0, w, buf, 0, 0), yb(c0, nrhs, yloc, 0, 0);
+        if (nrhs == 1)
+          gemv(Trans::N, scalar_t(-1.), Ub, yp, scalar_t(1.), yb, task_depth);
+        else
+          gemm(Trans::N, Trans::N, scalar_t(-1.), Ub, yp,
+               scalar_t(1.), yb, task_depth);
       }
     }
   }
@@ -30,76 +30,10 @@
 #define FRONTAL_MATRIX_LOSSY_HPP
 
 #include "FrontDense.hpp"
-#include "structured/StructuredMatrix.hpp"
+#include "LossyMatrix.hpp"
 
 namespace strumpack {
 
-  template<typename T> class LossyMatrix
-    : public structured::StructuredMatrix<T> {
-  public:
-    LossyMatrix() {}
-    LossyMatrix(const LossyMatrix<T>& ) = delete;
-    LossyMatrix(LossyMatrix<T>&& ) = default;
-    LossyMatrix& operator=(const LossyMatrix<T>&) = delete;
-    LossyMatrix& operator=(LossyMatrix<T>&&) = default;
-
-    LossyMatrix(const DenseMatrix<T>& F, int prec, double acc);
-    DenseMatrix<T> decompress() const {
-      DenseMatrix<T> F(rows_, cols_);
-      decompress(F);
-      return F;
-    }
-    virtual ~LossyMatrix() {
-      STRUMPACK_SUB_MEMORY(compressed_size()*sizeof(unsigned char));
-    }
-    void decompress(DenseMatrix<T>& F) const;
-#if defined(STRUMPACK_USE_SZ3)
-    std::size_t compressed_size() const { return out_size_; }
-#else // defined(STRUMPACK_USE_ZFP)
-    std::size_t compressed_size() const { return buffer_.size(); }
-#endif
-    std::size_t memory() const override { return compressed_size(); }
-    std::size_t nonzeros() const override { return rows()*cols(); }
-    std::size_t rank() const override { return std::min(rows(), cols()); }
-    std::size_t rows() const override { return rows_; }
-    std::size_t cols() const override { return cols_; }
-  private:
-    std::size_t rows_ = 0, cols_ = 0;
-    int prec_ = 16;
-    double acc_ = 1e-3;
-
-#if defined(STRUMPACK_USE_SZ3)
-    std::size_t out_size_;
-    std::unique_ptr<char> buffer_;
-#else // defined(STRUMPACK_USE_ZFP)
-    std::vector<unsigned char> buffer_;
-#endif
-  };
-
-  template<typename T> class LossyMatrix<std::complex<T>>
-    : public structured::StructuredMatrix<std::complex<T>> {
-  public:
-    LossyMatrix() {}
-    LossyMatrix(const DenseMatrix<std::complex<T>>& F, int prec, double acc);
-    DenseMatrix<std::complex<T>> decompress() const {
-      DenseMatrix<std::complex<T>> F(rows(), cols());
-      decompress(F);
-      return F;
-    }
-    void decompress(DenseMatrix<std::complex<T>>& F) const;
-    std::size_t compressed_size() const {
-      return Freal_.compressed_size() + Fimag_.compressed_size();
-    }
-    std::size_t memory() const override { return compressed_size(); }
-    std::size_t nonzeros() const override { return rows()*cols(); }
-    std::size_t rank() const override { return std::min(rows(), cols()); }
-    std::size_t rows() const override { return Freal_.rows(); }
-    std::size_t cols() const override { return Freal_.cols(); }
-  private:
-    LossyMatrix<T> Freal_, Fimag_;
-  };
-
-
   template<typename scalar_t,typename integer_t> class FrontLossy
     : public FrontDense<scalar_t,integer_t> {
     using F_t = Front<scalar_t,integer_t>;
@@ -0,0 +1,390 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+#include "LossyMatrix.hpp"
+
+#if defined(STRUMPACK_USE_ZFP)
+#include "zfp.h"
+#if ZFP_VERSION >= 0x1000
+#include "zfp/array2.hpp"
+#else
+#include "zfparray2.h"
+#endif
+#endif
+
+#if defined(STRUMPACK_USE_SZ3)
+#include "SZ3/api/sz.hpp"
+#endif
+
+namespace strumpack {
+
+#if defined(STRUMPACK_USE_ZFP)
+  template<typename T> zfp_type get_zfp_type();
+  template<> inline zfp_type get_zfp_type<float>() { return zfp_type_float; }
+  template<> inline zfp_type get_zfp_type<double>() { return zfp_type_double; }
+#endif
+
+  namespace {
+
+#if !defined(STRUMPACK_USE_ZFP) || defined(STRUMPACK_USE_SZ3)
+    /*
+     * Built-in floating point codec, used when STRUMPACK is not
+     * configured with ZFP or SZ3, and with SZ3 in precision and
+     * lossless mode (acc <= 0), since SZ3 only has error bound
+     * modes. A panel is encoded as follows:
+     *  - the mantissa of each value is rounded to prec bits, or, if
+     *    acc > 0, to just enough bits to guarantee an absolute error
+     *    <= acc, in which case values with |x| <= acc are flushed to
+     *    zero. With prec <= 0 and acc <= 0 all bits are kept,
+     *  - the values are shuffled in sizeof(T) byte planes, so that
+     *    the, now zero, low order mantissa bytes end up together, and
+     *    likewise for the high order sign/exponent bytes,
+     *  - each byte plane is stored either as all zero (nothing
+     *    stored), constant (1 byte), as a bitmap of the nonzero bytes
+     *    followed by the nonzero bytes, or raw, whichever is smaller.
+     * Panels are independent, so they can be decoded separately.
+     */
+    template<typename T> struct FPBits {};
+    template<> struct FPBits<float> {
+      using uint_t = std::uint32_t;
+      static constexpr int mant = 23, expo = 8;
+    };
+    template<> struct FPBits<double> {
+      using uint_t = std::uint64_t;
+      static constexpr int mant = 52, expo = 11;
+    };
+
+    enum class PlaneMode : unsigned char { ZERO, CONSTANT, SPARSE, RAW };
+
+    template<typename T> inline typename FPBits<T>::uint_t
+    fp_round(typename FPBits<T>::uint_t u, int prec, bool use_acc,
+             int lacc, double acc) {
+      using uint_t = typename FPBits<T>::uint_t;
+      const int m = FPBits<T>::mant;
+      const uint_t emask = ((uint_t(1) << FPBits<T>::expo) - 1) << m;
+      if ((u & emask) == emask) return u; // inf or nan
+      int k = prec;
+      if (use_acc) {
+        T x;
+        std::memcpy(&x, &u, sizeof(T));
+        if (std::abs(x) <= acc) return 0;
+        // exponent of x, (denormals have the exponent of the smallest
+        // normal number)
+        int e = std::max(int((u & emask) >> m), 1) -
+          ((1 << (FPBits<T>::expo-1)) - 1);
+        // rounding to k bits gives an error <= 2^(e-k-1) <= 2^lacc
+        k = std::max(e - 1 - lacc, 0);
+      }
+      if (k >= m) return u;
+      const uint_t ulp = uint_t(1) << (m - k);
+      uint_t r = (u + (ulp >> 1)) & ~(ulp - 1);
+      // do not round up to infinity
+      if ((r & emask) == emask) r = u & ~(ulp - 1);
+      return r;
+    }
+
+    template<typename T> std::vector<unsigned char>
+    fp_compress_panel(const T* F, std::size_t rows, std::size_t cols,
+                      std::size_t ld, int prec, double acc) {
+      using uint_t = typename FPBits<T>::uint_t;
+      const std::size_t n = rows * cols, S = sizeof(T);
+      const bool use_acc = acc > 0;
+      const int lacc = use_acc ? std::ilogb(acc) : 0,
+        k = (prec <= 0) ? FPBits<T>::mant : prec;
+      std::vector<unsigned char> planes(n * S);
+      for (std::size_t j=0; j<cols; j++)
+        for (std::size_t i=0; i<rows; i++) {
+          uint_t u;
+          std::memcpy(&u, F+i+j*ld, S);
+          u = fp_round<T>(u, k, use_acc, lacc, acc);
+          auto idx = i + j*rows;
+          for (std::size_t b=0; b<S; b++)
+            planes[b*n+idx] = (u >> (8*b)) & 0xff;
+        }
+      const std::size_t nbm = (n + 7) / 8;
+      std::vector<unsigned char> out(S);
+      for (std::size_t b=0; b<S; b++) {
+        auto pl = planes.data() + b*n;
+        std::size_t nnz = 0;
+        bool constant = true;
+        for (std::size_t i=0; i<n; i++) {
+          nnz += (pl[i] != 0);
+          constant = constant && (pl[i] == pl[0]);
+        }
+        auto o = out.size();
+        if (!nnz) out[b] = (unsigned char)PlaneMode::ZERO;
+        else if (constant) {
+          out[b] = (unsigned char)PlaneMode::CONSTANT;
+          out.push_back(pl[0]);
+        } else if (nbm + nnz < n) {
+          out[b] = (unsigned char)PlaneMode::SPARSE;
+          out.resize(o + nbm + nnz, 0);
+          auto bm = out.data() + o;
+          auto nz = bm + nbm;
+          for (std::size_t i=0; i<n; i++)
+            if (pl[i]) {
+              bm[i/8] |= (unsigned char)(1 << (i%8));
+              *nz++ = pl[i];
+            }
+        } else {
+          out[b] = (unsigned char)PlaneMode::RAW;
+          out.insert(out.end(), pl, pl+n);
+        }
+      }
+      return out;
+    }
+
+    template<typename T> void
+    fp_decompress_panel(const unsigned char* buf, std::size_t size,
+                        T* F, std::size_t rows, std::size_t cols,
+                        std::size_t ld) {
+      using uint_t = typename FPBits<T>::uint_t;
+      const std::size_t n = rows * cols, S = sizeof(T), nbm = (n + 7) / 8;
+      std::vector<uint_t> U(n, 0);
+      auto in = buf + S;
+      for (std::size_t b=0; b<S; b++) {
+        switch (PlaneMode(buf[b])) {
+        case PlaneMode::ZERO: break;
+        case PlaneMode::CONSTANT: {
+          uint_t c = uint_t(*in++) << (8*b);
+          for (std::size_t i=0; i<n; i++) U[i] |= c;
+        } break;
+        case PlaneMode::SPARSE: {
+          auto bm = in;
+          in += nbm;
+          for (std::size_t i=0; i<n; i++)
+            if (bm[i/8] & (1 << (i%8)))
+              U[i] |= uint_t(*in++) << (8*b);
+        } break;
+        case PlaneMode::RAW: {
+          for (std::size_t i=0; i<n; i++)
+            U[i] |= uint_t(in[i]) << (8*b);
+          in += n;
+        } break;
+        }
+      }
+      assert(std::size_t(in - buf) == size);
+      for (std::size_t j=0; j<cols; j++)
+        std::memcpy(F+j*ld, U.data()+j*rows, rows*S);
+    }
+#endif
+
+    template<typename T> std::vector<unsigned char>
+    lossy_compress_panel(const T* F, std::size_t rows, std::size_t cols,
+                   std::size_t ld, int prec, double acc) {
+#if defined(STRUMPACK_USE_SZ3)
+      if (acc <= 0)
+        return fp_compress_panel(F, rows, cols, ld, prec, acc);
+      std::vector<T> tmp;
+      if (ld != rows) {
+        tmp.resize(rows*cols);
+        for (std::size_t j=0; j<cols; j++)
+          std::copy(F+j*ld, F+j*ld+rows, tmp.data()+j*rows);
+        F = tmp.data();
+      }
+      SZ3::Config conf(cols, rows);
+      conf.relErrorBound = acc;
+      conf.errorBoundMode = SZ3::EB_REL;
+      std::size_t out_size;
+      std::unique_ptr<char[]> out
+        (SZ_compress<T>(conf, const_cast<T*>(F), out_size));
+      return std::vector<unsigned char>(out.get(), out.get()+out_size);
+#elif defined(STRUMPACK_USE_ZFP)
+      zfp_field* f = zfp_field_2d
+        (static_cast<void*>(const_cast<T*>(F)),
+         get_zfp_type<T>(), rows, cols);
+      zfp_field_set_stride_2d(f, 1, ld);
+      zfp_stream* stream = zfp_stream_open(NULL);
+      // the panels are already compressed in parallel tasks, but a
+      // single (large) panel can still use the OpenMP threads
+      zfp_stream_set_execution(stream, zfp_exec_omp);
+      if (acc <= 0) {
+        if (prec <= 0) zfp_stream_set_reversible(stream);
+        else zfp_stream_set_precision(stream, prec);
+      } else
+        zfp_stream_set_accuracy(stream, acc);
+      auto bufsize = zfp_stream_maximum_size(stream, f);
+      std::vector<unsigned char> buf(bufsize);
+      bitstream* bstream = stream_open(buf.data(), bufsize);
+      zfp_stream_set_bit_stream(stream, bstream);
+      zfp_stream_rewind(stream);
+      auto comp_size = zfp_compress(stream, f);
+      zfp_stream_flush(stream);
+      buf.resize(comp_size);
+      zfp_field_free(f);
+      zfp_stream_close(stream);
+      stream_close(bstream);
+      return buf;
+#else
+      return fp_compress_panel(F, rows, cols, ld, prec, acc);
+#endif
+    }
+
+    template<typename T> void
+    lossy_decompress_panel(const unsigned char* buf, std::size_t size,
+                     T* F, std::size_t rows, std::size_t cols,
+                     std::size_t ld, int prec, double acc) {
+#if defined(STRUMPACK_USE_SZ3)
+      if (acc <= 0) {
+        fp_decompress_panel(buf, size, F, rows, cols, ld);
+        return;
+      }
+      std::vector<T> tmp;
+      T* out = F;
+      if (ld != rows) {
+        tmp.resize(rows*cols);
+        out = tmp.data();
+      }
+      SZ3::Config conf;
+      SZ_decompress<T>
+        (conf, reinterpret_cast<char*>(const_cast<unsigned char*>(buf)),
+         size, out);
+      if (ld != rows)
+        for (std::size_t j=0; j<cols; j++)
+          std::copy(out+j*rows, out+(j+1)*rows, F+j*ld);
+#elif defined(STRUMPACK_USE_ZFP)
+      zfp_field* f = zfp_field_2d
+        (static_cast<void*>(F), get_zfp_type<T>(), rows, cols);
+      zfp_field_set_stride_2d(f, 1, ld);
+      zfp_stream* destream = zfp_stream_open(NULL);
+      if (acc <= 0) {
+        if (prec <= 0) zfp_stream_set_reversible(destream);
+        else zfp_stream_set_precision(destream, prec);
+      } else
+        zfp_stream_set_accuracy(destream, acc);
+      bitstream* bstream = stream_open
+        (static_cast<void*>(const_cast<unsigned char*>(buf)), size);
+      zfp_stream_set_bit_stream(destream, bstream);
+      zfp_stream_rewind(destream);
+      zfp_decompress(destream, f);
+      zfp_field_free(f);
+      zfp_stream_close(destream);
+      stream_close(bstream);
+#else
+      fp_decompress_panel(buf, size, F, rows, cols, ld);
+#endif
+    }
+
+  } // end anonymous namespace
+
+  template<typename T> LossyMatrix<T>::LossyMatrix
+  (const DenseMatrix<T>& F, int prec, double acc, std::size_t pcols)
+    : rows_(F.rows()), cols_(F.cols()),
+      pcols_(pcols ? pcols : default_panel_cols(F.rows())),
+      prec_(prec), acc_(acc) {
+    if (!rows_ || !cols_) return;
+    // a single panel, no wider than the matrix itself
+    pcols_ = std::min(pcols_, cols_);
+    std::size_t np = (cols_ + pcols_ - 1) / pcols_;
+    std::vector<std::vector<unsigned char>> pbuf(np);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)
+#endif
+    for (std::size_t p=0; p<np; p++)
+      pbuf[p] = lossy_compress_panel
+        (F.ptr(0, panel_begin(p)), rows_, panel_end(p)-panel_begin(p),
+         F.ld(), prec_, acc_);
+    poff_.resize(np+1);
+    poff_[0] = 0;
+    for (std::size_t p=0; p<np; p++)
+      poff_[p+1] = poff_[p] + pbuf[p].size();
+    buffer_.resize(poff_[np]);
+    for (std::size_t p=0; p<np; p++)
+      std::copy(pbuf[p].begin(), pbuf[p].end(), buffer_.begin()+poff_[p]);
+    STRUMPACK_ADD_MEMORY(buffer_.size()*sizeof(unsigned char));
+  }
+
+  template<typename T> void LossyMatrix<T>::decompress_panel
+  (std::size_t p, T* F, std::size_t ld) const {
+    assert(p < panels() && ld >= rows_);
+    lossy_decompress_panel
+      (buffer_.data()+poff_[p], poff_[p+1]-poff_[p], F,
+       rows_, panel_end(p)-panel_begin(p), ld, prec_, acc_);
+  }
+
+  template<typename T> void LossyMatrix<T>::decompress
+  (DenseMatrix<T>& F) const {
+    assert(F.rows() == rows_ && F.cols() == cols_);
+    auto np = panels();
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)
+#endif
+    for (std::size_t p=0; p<np; p++)
+      decompress_panel(p, F.ptr(0, panel_begin(p)), F.ld());
+  }
+
+  template<typename T> LossyMatrix<std::complex<T>>::LossyMatrix
+  (const DenseMatrix<std::complex<T>>& F, int prec, double acc,
+   std::size_t pcols) {
+    int rows = F.rows(), cols = F.cols();
+    DenseMatrix<T> Freal(rows, cols), Fimag(rows, cols);
+    for (int j=0; j<cols; j++)
+      for (int i=0; i<rows; i++) {
+        Freal(i, j) = F(i,j).real();
+        Fimag(i, j) = F(i,j).imag();
+      }
+    Freal_ = LossyMatrix<T>(Freal, prec, acc, pcols);
+    Fimag_ = LossyMatrix<T>(Fimag, prec, acc, pcols);
+  }
+
+  template<typename T> void LossyMatrix<std::complex<T>>::decompress
+  (DenseMatrix<std::complex<T>>& F) const {
+    auto Freal = Freal_.decompress();
+    auto Fimag = Fimag_.decompress();
+    int rows = Freal_.rows(), cols = Freal_.cols();
+    for (int j=0; j<cols; j++)
+      for (int i=0; i<rows; i++)
+        F(i, j) = std::complex<T>(Freal(i,j), Fimag(i,j));
+    return;
+  }
+
+  template<typename T> void
+  LossyMatrix<std::complex<T>>::decompress_panel
+  (std::size_t p, std::complex<T>* F, std::size_t ld) const {
+    std::size_t rows = Freal_.rows(),
+      cols = Freal_.panel_end(p) - Freal_.panel_begin(p);
+    DenseMatrix<T> Fr(rows, cols), Fi(rows, cols);
+    Freal_.decompress_panel(p, Fr.data(), Fr.ld());
+    Fimag_.decompress_panel(p, Fi.data(), Fi.ld());
+    for (std::size_t j=0; j<cols; j++)
+      for (std::size_t i=0; i<rows; i++)
+        F[i+j*ld] = std::complex<T>(Fr(i,j), Fi(i,j));
+  }
+
+  // explicit template instantiations
+  template class LossyMatrix<float>;
+  template class LossyMatrix<double>;
+  template class LossyMatrix<std::complex<float>>;
+  template class LossyMatrix<std::complex<double>>;
+
+} // end namespace strumpack
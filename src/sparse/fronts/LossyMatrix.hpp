@@ -0,0 +1,157 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef STRUMPACK_LOSSY_MATRIX_HPP
+#define STRUMPACK_LOSSY_MATRIX_HPP
+
+#include "dense/DenseMatrix.hpp"
+#include "structured/StructuredMatrix.hpp"
+
+namespace strumpack {
+
+  /**
+   * Lossy (or lossless) compressed dense matrix. The columns are
+   * split in panels of panel_cols() columns (the last panel can be
+   * smaller), and each panel is compressed independently. This
+   * allows to decompress only a single panel at a time, for instance
+   * in a triangular solve, into a small buffer, instead of inflating
+   * the whole matrix. Compression uses SZ3 or ZFP if STRUMPACK was
+   * configured with either, otherwise a built-in codec based on
+   * mantissa rounding and byte plane shuffling.
+   */
+  template<typename T> class LossyMatrix
+    : public structured::StructuredMatrix<T> {
+  public:
+    LossyMatrix() {}
+    LossyMatrix(const LossyMatrix<T>& ) = delete;
+    LossyMatrix(LossyMatrix<T>&& ) = default;
+    LossyMatrix& operator=(const LossyMatrix<T>&) = delete;
+    LossyMatrix& operator=(LossyMatrix<T>&& L) {
+      STRUMPACK_SUB_MEMORY(compressed_size()*sizeof(unsigned char));
+      rows_ = L.rows_;  cols_ = L.cols_;  pcols_ = L.pcols_;
+      prec_ = L.prec_;  acc_ = L.acc_;
+      buffer_ = std::move(L.buffer_);
+      poff_ = std::move(L.poff_);
+      L.rows_ = L.cols_ = 0;
+      L.buffer_.clear();
+      L.poff_.clear();
+      return *this;
+    }
+
+    /**
+     * Compress F, in panels of pcols columns, or of
+     * default_panel_cols(F.rows()) columns if pcols == 0.
+     */
+    LossyMatrix(const DenseMatrix<T>& F, int prec, double acc,
+                std::size_t pcols=0);
+    DenseMatrix<T> decompress() const {
+      DenseMatrix<T> F(rows_, cols_);
+      decompress(F);
+      return F;
+    }
+    virtual ~LossyMatrix() {
+      STRUMPACK_SUB_MEMORY(compressed_size()*sizeof(unsigned char));
+    }
+    void decompress(DenseMatrix<T>& F) const;
+
+    /**
+     * Decompress panel p, ie, columns [panel_begin(p), panel_end(p)),
+     * to F, a rows() x (panel_end(p)-panel_begin(p)) column major
+     * matrix with leading dimension ld >= rows().
+     */
+    void decompress_panel(std::size_t p, T* F, std::size_t ld) const;
+    std::size_t panels() const { return poff_.empty() ? 0 : poff_.size()-1; }
+    std::size_t panel_cols() const { return pcols_; }
+    std::size_t panel_begin(std::size_t p) const { return p * pcols_; }
+    std::size_t panel_end(std::size_t p) const {
+      return std::min(cols_, (p+1) * pcols_);
+    }
+
+    std::size_t compressed_size() const { return buffer_.size(); }
+    std::size_t memory() const override { return compressed_size(); }
+    std::size_t nonzeros() const override { return rows()*cols(); }
+    std::size_t rank() const override { return std::min(rows(), cols()); }
+    std::size_t rows() const override { return rows_; }
+    std::size_t cols() const override { return cols_; }
+
+    /**
+     * Panel width such that a decompressed panel with m rows fits in
+     * about 256KB, rounded to a multiple of 4 (the ZFP block size),
+     * but at least 64 columns. Narrower panels compress worse, since
+     * each panel has its own header and the codecs cannot exploit
+     * correlation across panels.
+     */
+    static std::size_t default_panel_cols(std::size_t m) {
+      std::size_t w = (std::size_t(1) << 18) /
+        (sizeof(T) * std::max(m, std::size_t(1)));
+      return std::max(std::size_t(64), w / 4 * 4);
+    }
+
+  private:
+    std::size_t rows_ = 0, cols_ = 0, pcols_ = 64;
+    int prec_ = 16;
+    double acc_ = 1e-3;
+    // compressed panels, panel p is stored in
+    // buffer_[poff_[p],poff_[p+1])
+    std::vector<unsigned char> buffer_;
+    std::vector<std::size_t> poff_;
+  };
+
+  template<typename T> class LossyMatrix<std::complex<T>>
+    : public structured::StructuredMatrix<std::complex<T>> {
+  public:
+    LossyMatrix() {}
+    LossyMatrix(const DenseMatrix<std::complex<T>>& F, int prec, double acc,
+                std::size_t pcols=0);
+    DenseMatrix<std::complex<T>> decompress() const {
+      DenseMatrix<std::complex<T>> F(rows(), cols());
+      decompress(F);
+      return F;
+    }
+    void decompress(DenseMatrix<std::complex<T>>& F) const;
+    void decompress_panel(std::size_t p, std::complex<T>* F,
+                          std::size_t ld) const;
+    std::size_t panels() const { return Freal_.panels(); }
+    std::size_t panel_cols() const { return Freal_.panel_cols(); }
+    std::size_t panel_begin(std::size_t p) const { return Freal_.panel_begin(p); }
+    std::size_t panel_end(std::size_t p) const { return Freal_.panel_end(p); }
+    std::size_t compressed_size() const {
+      return Freal_.compressed_size() + Fimag_.compressed_size();
+    }
+    std::size_t memory() const override { return compressed_size(); }
+    std::size_t nonzeros() const override { return rows()*cols(); }
+    std::size_t rank() const override { return std::min(rows(), cols()); }
+    std::size_t rows() const override { return Freal_.rows(); }
+    std::size_t cols() const override { return Freal_.cols(); }
+  private:
+    LossyMatrix<T> Freal_, Fimag_;
+  };
+
+} // end namespace strumpack
+
+#endif // STRUMPACK_LOSSY_MATRIX_HPP
@@ -54,10 +54,12 @@
 #endif
 #include "RCMReordering.hpp"
 #include "ANDSparspak.hpp"
+#include "MultilevelND.hpp"
 #include "GeometricReordering.hpp"
 #include "minimum_degree/AMDReordering.hpp"
 #include "minimum_degree/MMDReordering.hpp"
-// #include "spectral/SpectralReordering.hpp"
+#include "minimum_degree/MLFReordering.hpp"
+#include "spectral/SpectralReordering.hpp"
 
 namespace strumpack {
 
@@ -115,15 +117,16 @@ namespace strumpack {
       break;
     }
     case ReorderingStrategy::MLF: {
-      std::cerr << "# ERROR: MLF ordering not supported." << std::endl;
-      return 1;
+      tree_ = ordering::mlf_reordering(A, perm_, iperm_);
+      break;
     }
     case ReorderingStrategy::SPECTRAL: {
-      std::cerr << "# ERROR: spectral ordering not supported." << std::endl;
-      return 1;
-      // tree_ = ordering::spectral_nd
-      //   (A, perm_, iperm_, opts.ND_options());
-      // break;
+      tree_ = ordering::spectral_nd(A, perm_, iperm_, opts.nd_param());
+      break;
+    }
+    case ReorderingStrategy::MLND: {
+      tree_ = ordering::multilevel_nd(A, perm_, iperm_, opts.nd_param());
+      break;
     }
     default:
       std::cerr << "# ERROR: parallel matrix reorderings are"
@@ -131,6 +134,7 @@ namespace strumpack {
         "\tuse SparseSolverMPIDist instead." << std::endl;
       return 1;
     }
+    amalgamate(opts, A);
     tree_.check();
     nested_dissection_print(opts, A.nnz(), opts.verbose());
     return 0;
@@ -144,11 +148,56 @@ namespace strumpack {
     if (base == 0) std::copy(p, p+n, perm_.data());
     else for (std::size_t i=0; i<n; i++) perm_[i] = p[i] - base;
     tree_ = build_sep_tree_from_perm(A.ptr(), A.ind(), perm_, iperm_);
+    amalgamate(opts, A);
     tree_.check();
     nested_dissection_print(opts, A.nnz(), opts.verbose());
     return 0;
   }
 
+  template<typename scalar_t,typename integer_t> void
+  MatrixReordering<scalar_t,integer_t>::amalgamate
+  (const Opts_t& opts, const CSR_t& A) {
+    amalg_seps_ = 0;
+    if (!opts.use_relaxed_amalg()) return;
+    amalg_seps_ = tree_.separators();
+    tree_ = relaxed_amalgamation
+      (tree_, A.ptr(), A.ind(), perm_, iperm_, opts.amalg_fill_tol(),
+       amalg_fill_before_, amalg_fill_after_);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  MatrixReordering<scalar_t,integer_t>::separate_interface
+  (const std::vector<integer_t>& I) {
+    integer_t N = perm_.size(), nI = I.size(), nseps = tree_.separators();
+    if (!nI || !nseps) return;
+    std::vector<bool> mark(N, false);
+    for (integer_t k=0; k<nI; k++) {
+      assert(I[k] >= 0 && I[k] < N && !mark[I[k]]);
+      mark[I[k]] = true;
+    }
+    // keep the non-interface unknowns in their current order, and
+    // shrink the separators accordingly
+    std::vector<Separator<integer_t>> seps;
+    seps.reserve(nseps+2);
+    integer_t n = 0;
+    for (integer_t s=0; s<nseps; s++) {
+      for (integer_t i=tree_.sizes[s]; i<tree_.sizes[s+1]; i++) {
+        auto j = iperm_[i];
+        if (!mark[j]) perm_[j] = n++;
+      }
+      seps.emplace_back
+        (n, tree_.is_root(s) ? nseps+1 : tree_.parent[s],
+         tree_.lch[s], tree_.rch[s]);
+    }
+    assert(n == N - nI);
+    for (integer_t k=0; k<nI; k++) perm_[I[k]] = n + k;
+    for (integer_t i=0; i<N; i++) iperm_[perm_[i]] = i;
+    // empty leaf, and the new root containing only the interface
+    seps.emplace_back(n, nseps+1, -1, -1);
+    seps.emplace_back(N, -1, tree_.root(), nseps);
+    tree_ = SeparatorTree<integer_t>(seps);
+  }
+
   template<typename scalar_t,typename integer_t> void
   MatrixReordering<scalar_t,integer_t>::clear_tree_data() {
     tree_ = SeparatorTree<integer_t>();
@@ -226,6 +275,16 @@ namespace strumpack {
       std::cout << "#   - number of levels = "
                 << number_format_with_commas(max_level)
                 << std::flush << std::endl;
+      if (amalg_seps_)
+        std::cout << "#   - relaxed amalgamation, fill tolerance = "
+                  << opts.amalg_fill_tol() << std::endl
+                  << "#      - number of separators before = "
+                  << number_format_with_commas(amalg_seps_) << std::endl
+                  << "#      - estimated added fill = "
+                  << (amalg_fill_after_ - amalg_fill_before_) << " ("
+                  << 100. * (amalg_fill_after_ - amalg_fill_before_) /
+          std::max(amalg_fill_before_, 1LL)
+                  << "% of front entries)" << std::endl;
     }
     if (max_level > 50)
       std::cerr
@@ -63,6 +63,18 @@ namespace strumpack {
 
     void separator_reordering(const Opts_t& opts, CSR_t& A, F_t* F);
 
+    /**
+     * Move the unknowns in I (in the original, unpermuted numbering)
+     * to the end of the ordering, in the order in which they appear
+     * in I, and put them in a new root separator. The relative order
+     * of all other unknowns is kept. The old root becomes the left
+     * child of the new root, the right child is an empty leaf. This
+     * should be called after nested_dissection or set_permutation.
+     *
+     * \param I set of interface unknowns, without duplicates
+     */
+    void separate_interface(const std::vector<integer_t>& I);
+
     virtual void clear_tree_data();
 
     const std::vector<integer_t>& perm() const { return perm_; }
@@ -86,6 +98,11 @@ namespace strumpack {
     SeparatorTree<integer_t> tree_;
 
   private:
+    integer_t amalg_seps_ = 0;
+    long long amalg_fill_before_ = 0, amalg_fill_after_ = 0;
+
+    void amalgamate(const Opts_t& opts, const CSR_t& A);
+
     void
     nested_dissection_print(const Opts_t& opts, integer_t nnz,
                             bool verbose) const;
@@ -48,9 +48,11 @@
 #include "GeometricReorderingMPI.hpp"
 #include "RCMReordering.hpp"
 #include "ANDSparspak.hpp"
+#include "MultilevelND.hpp"
 #include "minimum_degree/AMDReordering.hpp"
 #include "minimum_degree/MMDReordering.hpp"
-// #include "spectral/SpectralReordering.hpp"
+#include "minimum_degree/MLFReordering.hpp"
+#include "spectral/SpectralReordering.hpp"
 
 
 namespace strumpack {
@@ -114,15 +116,18 @@ namespace strumpack {
           break;
         }
         case ReorderingStrategy::MLF: {
-          std::cerr << "# ERROR: MLF ordering not supported." << std::endl;
-          return 1;
+          global_sep_tree = ordering::mlf_reordering(*Aseq, perm_, iperm_);
+          break;
         }
         case ReorderingStrategy::SPECTRAL: {
-          std::cerr << "# ERROR: spectral ordering not supported." << std::endl;
-          return 1;
-          // global_sep_tree = ordering::spectral_nd
-          //   (*Aseq, perm_, iperm_, opts.ND_options());
-          // break;
+          global_sep_tree = ordering::spectral_nd
+            (*Aseq, perm_, iperm_, opts.nd_param());
+          break;
+        }
+        case ReorderingStrategy::MLND: {
+          global_sep_tree = ordering::multilevel_nd
+            (*Aseq, perm_, iperm_, opts.nd_param());
+          break;
         }
         default: assert(true);
         }
@@ -201,9 +206,14 @@ namespace strumpack {
       default: assert(true);
       }
       tree_.check();
-      get_local_graphs(A);
-      if (opts.reordering_method() == ReorderingStrategy::PARMETIS ||
-          opts.reordering_method() == ReorderingStrategy::PTSCOTCH)
+      bool partitioner =
+        opts.reordering_method() == ReorderingStrategy::PARMETIS ||
+        opts.reordering_method() == ReorderingStrategy::PTSCOTCH;
+      // with the partitioner mapping, the local subtrees can stay on
+      // the process holding their subgraph, so also collect the
+      // values of the subgraph rows
+      get_local_graphs(A, partitioner && opts.partitioner_mapping());
+      if (partitioner)
         build_local_tree(A);
       ltree_.check();
     }
@@ -266,7 +276,7 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   MatrixReorderingMPI<scalar_t,integer_t>::get_local_graphs
-  (const CSRMPI_t& A) {
+  (const CSRMPI_t& A, bool values) {
     auto P = comm_->size();
     auto rank = comm_->rank();
     sub_graph_ranges.resize(P);
@@ -290,7 +300,10 @@ namespace strumpack {
     }
     sub_graph_range = sub_graph_ranges[rank];
     dist_sep_range = dist_sep_ranges[rank];
-    my_sub_graph = A.get_sub_graph(perm_, sub_graph_ranges);
+    clear_sub_matrix();
+    my_sub_graph = A.get_sub_graph
+      (perm_, sub_graph_ranges, values ? &my_sub_matrix : nullptr);
+    has_sub_matrix_ = values;
     my_dist_sep = A.get_sub_graph(perm_, dist_sep_ranges);
   }
 
@@ -343,6 +356,7 @@ namespace strumpack {
     ltree_ = SeparatorTree<integer_t>();
     my_sub_graph = CSRGraph<integer_t>();
     my_dist_sep = CSRGraph<integer_t>();
+    clear_sub_matrix();
   }
 
   template<typename scalar_t,typename integer_t> void
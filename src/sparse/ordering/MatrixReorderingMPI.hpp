@@ -125,6 +125,31 @@ namespace strumpack {
      */
     CSRGraph<integer_t> my_dist_sep;
 
+    /**
+     * With SPOptions::partitioner_mapping() and ParMETIS or
+     * PT-Scotch, the nonzeros of the rows of my_sub_graph, in the
+     * original numbering, collected together with my_sub_graph. The
+     * local subtrees that stay on the process that holds their
+     * subgraph take their values from here, instead of from the
+     * block-row distributed matrix, see PropMapSparseMatrix::setup.
+     */
+    std::vector<Triplet<scalar_t,integer_t>> my_sub_matrix;
+
+    /**
+     * Whether my_sub_matrix was collected on all processes, and still
+     * holds the current matrix values.
+     */
+    bool has_sub_matrix() const { return has_sub_matrix_; }
+
+    /**
+     * Drop my_sub_matrix, for instance when the matrix values
+     * change. This should be called on all processes.
+     */
+    void clear_sub_matrix() {
+      std::vector<Triplet<scalar_t,integer_t>>().swap(my_sub_matrix);
+      has_sub_matrix_ = false;
+    }
+
     std::vector<std::pair<integer_t,integer_t>> sub_graph_ranges,
       dist_sep_ranges;
 
@@ -143,7 +168,9 @@ namespace strumpack {
      */
     integer_t dsep_leaf_;
 
-    void get_local_graphs(const CSRMPI_t& Ampi);
+    bool has_sub_matrix_ = false;
+
+    void get_local_graphs(const CSRMPI_t& Ampi, bool values=false);
     void build_local_tree(const CSRMPI_t& Ampi);
     void nested_dissection_print(const SPOptions<scalar_t>& opts,
                                  integer_t nnz) const;
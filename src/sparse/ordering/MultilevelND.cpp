@@ -0,0 +1,330 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <atomic>
+#include <cstdint>
+
+#include "MultilevelND.hpp"
+#include "sparse/CSRGraph.hpp"
+#include "StrumpackParameters.hpp"
+
+namespace strumpack {
+  namespace ordering {
+    namespace mlnd {
+
+      // minimum number of vertices handled by a single task in a
+      // taskloop
+      const int grain = 4096;
+      // stop coarsening at this number of vertices
+      const int coarse_size = 128;
+
+      inline std::uint64_t
+      edge_hash(std::uint64_t u, std::uint64_t v) {
+        if (u > v) std::swap(u, v);
+        auto h = u * 0x9E3779B97F4A7C15ull + v;
+        return h ^ (h >> 29);
+      }
+
+      template<typename integer_t> integer_t
+      total_weight(const std::vector<integer_t>& vw) {
+        return std::accumulate(vw.begin(), vw.end(), integer_t(0));
+      }
+
+      /**
+       * Contract the graph g, with vertex weights vw and edge weights
+       * ew, using a heavy edge matching. Returns the coarse graph,
+       * with its vertex and edge weights in cvw and cew, and the
+       * coarse vertex of every vertex of g in cmap.
+       *
+       * The matching is computed in parallel, in rounds: every
+       * unmatched vertex selects the heaviest edge to an unmatched
+       * neighbor (ties are broken with a hash which is symmetric in
+       * the two endpoints), and mutual selections are matched. This
+       * gives the locally dominant edges, similar to a sequential
+       * greedy matching.
+       */
+      template<typename integer_t> CSRGraph<integer_t>
+      coarsen(const CSRGraph<integer_t>& g, const std::vector<integer_t>& vw,
+              const std::vector<integer_t>& ew, std::vector<integer_t>& cmap,
+              std::vector<integer_t>& cvw, std::vector<integer_t>& cew,
+              integer_t maxvw, int depth) {
+        const auto n = g.size();
+        const auto ptr = g.ptr();
+        const auto ind = g.ind();
+        std::vector<integer_t> match(n, -1), cand(n);
+        for (int round=0; round<4; round++) {
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(grain)   \
+  if(depth < params::task_recursion_cutoff_level)
+#endif
+          for (integer_t v=0; v<n; v++) {
+            cand[v] = -1;
+            if (match[v] != -1) continue;
+            integer_t bew = 0;
+            std::uint64_t bh = 0;
+            for (auto e=ptr[v]; e<ptr[v+1]; e++) {
+              auto u = ind[e];
+              if (match[u] != -1 || vw[u] + vw[v] > maxvw) continue;
+              auto h = edge_hash(u, v);
+              if (ew[e] > bew || (ew[e] == bew && h > bh)) {
+                bew = ew[e];
+                bh = h;
+                cand[v] = u;
+              }
+            }
+          }
+          std::atomic<bool> matched(false);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(grain)   \
+  if(depth < params::task_recursion_cutoff_level)
+#endif
+          for (integer_t v=0; v<n; v++) {
+            auto u = cand[v];
+            if (u > v && cand[u] == v) {
+              match[v] = u;
+              match[u] = v;
+              matched.store(true, std::memory_order_relaxed);
+            }
+          }
+          if (!matched) break;
+        }
+        cmap.resize(n);
+        integer_t nc = 0;
+        std::vector<integer_t> first;
+        first.reserve(n);
+        for (integer_t v=0; v<n; v++) {
+          if (match[v] == -1 || v < match[v]) {
+            cmap[v] = nc++;
+            first.push_back(v);
+          } else cmap[v] = cmap[match[v]];
+        }
+        std::vector<integer_t> bound(nc+1), cdeg(nc);
+        bound[0] = 0;
+        for (integer_t i=0; i<nc; i++) {
+          auto v = first[i], u = match[v];
+          bound[i+1] = bound[i] + ptr[v+1] - ptr[v] +
+            ((u == -1) ? 0 : ptr[u+1] - ptr[u]);
+        }
+        cvw.resize(nc);
+        std::vector<std::pair<integer_t,integer_t>> tmp(bound[nc]);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(grain)   \
+  if(depth < params::task_recursion_cutoff_level)
+#endif
+        for (integer_t i=0; i<nc; i++) {
+          auto b = tmp.begin() + bound[i], e = b;
+          integer_t w = 0;
+          for (auto v : {first[i], match[first[i]]}) {
+            if (v == -1) continue;
+            w += vw[v];
+            for (auto k=ptr[v]; k<ptr[v+1]; k++) {
+              auto cu = cmap[ind[k]];
+              if (cu != i) *e++ = {cu, ew[k]};
+            }
+          }
+          std::sort(b, e);
+          auto o = b;
+          for (auto p=b; p!=e; p++) {
+            if (o != b && (o-1)->first == p->first)
+              (o-1)->second += p->second;
+            else *o++ = *p;
+          }
+          cdeg[i] = o - b;
+          cvw[i] = w;
+        }
+        std::vector<integer_t> cptr(nc+1);
+        cptr[0] = 0;
+        for (integer_t i=0; i<nc; i++)
+          cptr[i+1] = cptr[i] + cdeg[i];
+        std::vector<integer_t> cind(cptr[nc]);
+        cew.resize(cptr[nc]);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(grain)   \
+  if(depth < params::task_recursion_cutoff_level)
+#endif
+        for (integer_t i=0; i<nc; i++)
+          for (integer_t k=0; k<cdeg[i]; k++) {
+            cind[cptr[i]+k] = tmp[bound[i]+k].first;
+            cew[cptr[i]+k] = tmp[bound[i]+k].second;
+          }
+        return CSRGraph<integer_t>(std::move(cptr), std::move(cind));
+      }
+
+      /**
+       * Greedy graph growing bisection of the coarsest graph, from a
+       * few different seeds, each followed by FM refinement. The
+       * bisection with the smallest edge cut is kept.
+       */
+      template<typename integer_t> void
+      initial_bisection(const CSRGraph<integer_t>& g,
+                        const std::vector<integer_t>& vw,
+                        const std::vector<integer_t>& ew,
+                        std::vector<char>& part, int depth) {
+        const auto n = g.size();
+        const auto ptr = g.ptr();
+        const auto ind = g.ind();
+        const auto tw = total_weight(vw);
+        // few trials for the small graphs near the leaves of the
+        // dissection, there are many of those
+        const int ntrials = std::min(n, integer_t(n > coarse_size/2 ? 4 : 2));
+        std::vector<char> trial(n);
+        std::vector<integer_t> gain(n);
+        integer_t bestcut = -1;
+        part.assign(n, 0);
+        for (int t=0; t<ntrials; t++) {
+          auto seed = (t == 0) ? g.pseudo_peripheral() :
+            integer_t(edge_hash(t, n) % n);
+          std::fill(trial.begin(), trial.end(), 1);
+          // gain for moving v to part 0
+          for (integer_t v=0; v<n; v++) {
+            gain[v] = 0;
+            for (auto e=ptr[v]; e<ptr[v+1]; e++)
+              gain[v] -= ew[e];
+          }
+          std::priority_queue<std::pair<integer_t,integer_t>> pq;
+          pq.emplace(gain[seed], seed);
+          integer_t w0 = 0, next = 0;
+          while (2 * w0 < tw) {
+            integer_t v = -1;
+            while (!pq.empty()) {
+              auto [gu, u] = pq.top();
+              pq.pop();
+              if (trial[u] && gu == gain[u]) { v = u; break; }
+            }
+            if (v == -1) {
+              // disconnected graph, continue with another component
+              while (!trial[next]) next++;
+              v = next;
+            }
+            trial[v] = 0;
+            w0 += vw[v];
+            for (auto e=ptr[v]; e<ptr[v+1]; e++) {
+              auto u = ind[e];
+              if (trial[u]) {
+                gain[u] += 2 * ew[e];
+                pq.emplace(gain[u], u);
+              }
+            }
+          }
+          g.fm_refine(vw, ew, trial, depth);
+          auto cut = g.edge_cut(ew, trial);
+          if (bestcut < 0 || cut < bestcut) {
+            bestcut = cut;
+            part = trial;
+          }
+        }
+      }
+
+      /**
+       * Multilevel vertex bisection of g, on output where[v] is 0 or
+       * 1 for the two parts, or 2 for the separator. The vertices
+       * and edges of g have unit weights, the coarse graphs
+       * accumulate the weights of the vertices/edges they were
+       * contracted from.
+       */
+      template<typename integer_t> void
+      bisect(const CSRGraph<integer_t>& g, std::vector<char>& where,
+             int depth) {
+        // levels[l] is coarsened from levels[l-1], level 0 is g
+        std::vector<CSRGraph<integer_t>> levels;
+        std::vector<std::vector<integer_t>> vws, ews, cmaps;
+        vws.emplace_back(g.size(), 1);
+        ews.emplace_back(g.edges(), 1);
+        const auto maxvw = std::max
+          (integer_t(1), integer_t(1.5 * g.size() / coarse_size));
+        while (true) {
+          const auto& fine = levels.empty() ? g : levels.back();
+          if (fine.size() <= coarse_size) break;
+          std::vector<integer_t> cmap, cvw, cew;
+          auto c = coarsen
+            (fine, vws.back(), ews.back(), cmap, cvw, cew, maxvw, depth);
+          if (c.size() > 0.95 * fine.size()) break;
+          levels.push_back(std::move(c));
+          vws.push_back(std::move(cvw));
+          ews.push_back(std::move(cew));
+          cmaps.push_back(std::move(cmap));
+        }
+        auto L = levels.size();
+        initial_bisection
+          (L ? levels.back() : g, vws[L], ews[L], where, depth);
+        for (auto l=L; l>0; l--) {
+          const auto& fine = (l == 1) ? g : levels[l-2];
+          const auto& cmap = cmaps[l-1];
+          const auto nf = fine.size();
+          std::vector<char> fwhere(nf);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(grain)   \
+  if(depth < params::task_recursion_cutoff_level)
+#endif
+          for (integer_t v=0; v<nf; v++)
+            fwhere[v] = where[cmap[v]];
+          where.swap(fwhere);
+          levels.pop_back();
+          vws.pop_back();
+          ews.pop_back();
+          fine.fm_refine(vws.back(), ews.back(), where, depth);
+        }
+        g.vertex_separator(vws[0], where);
+      }
+
+    } // end namespace mlnd
+
+
+    template<typename integer_t> SeparatorTree<integer_t>
+    multilevel_nd(integer_t n, const integer_t* ptr, const integer_t* ind,
+                  std::vector<integer_t>& perm,
+                  std::vector<integer_t>& iperm, int leaf) {
+      if (n <= 0) return SeparatorTree<integer_t>();
+      CSRGraph<integer_t> g
+        (std::vector<integer_t>(ptr, ptr+n+1),
+         std::vector<integer_t>(ind, ind+ptr[n]));
+      return g.nested_dissection
+        (leaf, perm, iperm,
+         [](const CSRGraph<integer_t>& sg, std::vector<char>& where,
+            int depth) { mlnd::bisect(sg, where, depth); });
+    }
+
+    // explicit template instantiation
+    template SeparatorTree<int>
+    multilevel_nd(int n, const int* ptr, const int* ind,
+                  std::vector<int>& perm, std::vector<int>& iperm, int leaf);
+    template SeparatorTree<long int>
+    multilevel_nd(long int n, const long int* ptr, const long int* ind,
+                  std::vector<long int>& perm,
+                  std::vector<long int>& iperm, int leaf);
+    template SeparatorTree<long long int>
+    multilevel_nd(long long int n, const long long int* ptr,
+                  const long long int* ind, std::vector<long long int>& perm,
+                  std::vector<long long int>& iperm, int leaf);
+
+  } // end namespace ordering
+} // end namespace strumpack
+
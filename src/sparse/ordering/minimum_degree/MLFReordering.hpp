@@ -0,0 +1,171 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef STRUMPACK_ORDERING_MLF_HPP
+#define STRUMPACK_ORDERING_MLF_HPP
+
+#include <vector>
+#include <queue>
+#include <tuple>
+#include <functional>
+#include <iostream>
+
+#include "sparse/SeparatorTree.hpp"
+#include "misc/Tools.hpp"
+
+namespace strumpack {
+  namespace ordering {
+
+    /**
+     * Minimum local fill ordering. The elimination is simulated on a
+     * quotient graph, where eliminated vertices are represented by
+     * elements (cliques), absorbed when an adjacent vertex is
+     * eliminated, so the storage never exceeds that of the original
+     * graph. The vertex eliminated next is the one that creates the
+     * least fill. As in AMD, the exact fill is too expensive to
+     * maintain and it is approximated (see Ng and Raghavan, or
+     * Rothberg and Eisenstat) as d(d-1)/2 - c(c-1)/2, where d is the
+     * approximate external degree and c+1 the size of the last
+     * element the vertex became adjacent to, which is already a
+     * clique.
+     *
+     * \param n number of vertices
+     * \param ptr row pointers of the (structurally symmetric) graph
+     * \param ind column indices of the graph, self-loops are ignored
+     * \param perm on output, perm[old] = new
+     * \param iperm on output, iperm[new] = old
+     */
+    template<typename integer_t> void
+    mlf_order(integer_t n, const integer_t* ptr, const integer_t* ind,
+              std::vector<integer_t>& perm, std::vector<integer_t>& iperm) {
+      using score_t = std::tuple<double,integer_t,integer_t>;
+      // variable-variable, variable-element adjacency and element
+      // lists, element e is created by eliminating variable e
+      std::vector<std::vector<integer_t>> A(n), E(n), L(n);
+      for (integer_t i=0; i<n; i++)
+        for (integer_t t=ptr[i]; t<ptr[i+1]; t++)
+          if (ind[t] != i) A[i].push_back(ind[t]);
+      std::vector<char> elim(n, 0), elem(n, 0);
+      std::vector<integer_t> mark(n, -1), wmark(n, -1), w(n), deg(n);
+      std::vector<double> fill(n);
+      std::priority_queue<score_t,std::vector<score_t>,std::greater<>> pq;
+      for (integer_t i=0; i<n; i++) {
+        deg[i] = A[i].size();
+        fill[i] = 0.5 * double(deg[i]) * (deg[i] - 1);
+        pq.emplace(fill[i], deg[i], i);
+      }
+      perm.resize(n);
+      iperm.resize(n);
+      std::vector<integer_t> Lp;
+      for (integer_t k=0; k<n; k++) {
+        integer_t p = -1;
+        while (p == -1) {
+          auto [f, d, i] = pq.top();
+          pq.pop();
+          if (!elim[i] && f == fill[i] && d == deg[i]) p = i;
+        }
+        elim[p] = 1;
+        iperm[k] = p;
+        // the new element, the union of p's variable neighbors and
+        // the elements adjacent to p, which are absorbed
+        Lp.clear();
+        for (auto j : A[p])
+          if (!elim[j] && mark[j] != p) { mark[j] = p; Lp.push_back(j); }
+        for (auto e : E[p]) {
+          if (!elem[e]) continue;
+          for (auto j : L[e])
+            if (!elim[j] && mark[j] != p) { mark[j] = p; Lp.push_back(j); }
+          elem[e] = 0;
+          std::vector<integer_t>().swap(L[e]);
+        }
+        std::vector<integer_t>().swap(A[p]);
+        std::vector<integer_t>().swap(E[p]);
+        L[p] = Lp;
+        elem[p] = 1;
+        // w[e] = |L_e \ L_p| for the elements adjacent to L_p
+        for (auto i : Lp)
+          for (auto e : E[i]) {
+            if (!elem[e]) continue;
+            if (wmark[e] != p) { wmark[e] = p; w[e] = L[e].size(); }
+            w[e]--;
+          }
+        const integer_t c = Lp.size() - 1, nleft = n - k - 1;
+        for (auto i : Lp) {
+          integer_t d = c, ne = 0;
+          for (auto e : E[i]) {
+            if (!elem[e]) continue;
+            // aggressive absorption, L_e is a subset of L_p
+            if (w[e] == 0) {
+              elem[e] = 0;
+              std::vector<integer_t>().swap(L[e]);
+              continue;
+            }
+            d += w[e];
+            E[i][ne++] = e;
+          }
+          E[i].resize(ne);
+          E[i].push_back(p);
+          // prune variables which are now reached through element p
+          integer_t na = 0;
+          for (auto j : A[i])
+            if (!elim[j] && mark[j] != p) A[i][na++] = j;
+          A[i].resize(na);
+          d = std::min(d + na, nleft);
+          deg[i] = d;
+          fill[i] = 0.5 * (double(d) * (d - 1) - double(c) * (c - 1));
+          pq.emplace(fill[i], d, i);
+        }
+      }
+      for (integer_t i=0; i<n; i++)
+        perm[iperm[i]] = i;
+    }
+
+    template<typename integer_t>
+    SeparatorTree<integer_t>
+    mlf_reordering(integer_t n, const integer_t* ptr, const integer_t* ind,
+                   std::vector<integer_t>& perm,
+                   std::vector<integer_t>& iperm) {
+      if (ptr[n] <= n)
+        if (mpi_root())
+          std::cerr << "# WARNING: matrix seems to be diagonal!" << std::endl;
+      mlf_order(n, ptr, ind, perm, iperm);
+      return build_sep_tree_from_perm(ptr, ind, perm, iperm);
+    }
+
+    template<typename integer_t,typename G>
+    SeparatorTree<integer_t>
+    mlf_reordering(const G& A, std::vector<integer_t>& perm,
+                   std::vector<integer_t>& iperm) {
+      return mlf_reordering<integer_t>
+        (A.size(), A.ptr(), A.ind(), perm, iperm);
+    }
+
+  } // end namespace ordering
+} // end namespace strumpack
+
+#endif // STRUMPACK_ORDERING_MLF_HPP
@@ -0,0 +1,240 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <cmath>
+#include <cstdint>
+
+#include "SpectralReordering.hpp"
+#include "sparse/CSRGraph.hpp"
+#include "StrumpackParameters.hpp"
+#include "dense/DenseMatrix.hpp"
+
+namespace strumpack {
+  namespace ordering {
+    namespace spectral {
+
+      // minimum number of vertices handled by a single task in a
+      // taskloop
+      const int grain = 4096;
+      // maximum dimension of the Lanczos basis
+      const int lanczos_steps = 50;
+      // maximum number of Lanczos restarts
+      const int lanczos_restarts = 5;
+
+      /**
+       * Label the connected components of g, return the number of
+       * components.
+       */
+      template<typename integer_t> integer_t
+      components(const CSRGraph<integer_t>& g, std::vector<integer_t>& comp) {
+        const auto n = g.size();
+        const auto ptr = g.ptr();
+        const auto ind = g.ind();
+        std::vector<integer_t> q(n);
+        comp.assign(n, -1);
+        integer_t nc = 0;
+        for (integer_t r=0; r<n; r++) {
+          if (comp[r] != -1) continue;
+          integer_t qb = 0, qe = 0;
+          q[qe++] = r;
+          comp[r] = nc;
+          while (qb < qe) {
+            auto v = q[qb++];
+            for (auto e=ptr[v]; e<ptr[v+1]; e++)
+              if (comp[ind[e]] == -1) {
+                comp[ind[e]] = nc;
+                q[qe++] = ind[e];
+              }
+          }
+          nc++;
+        }
+        return nc;
+      }
+
+      /**
+       * Approximate the Fiedler vector of the Laplacian L = D - A of
+       * the connected graph g. The Lanczos basis is kept orthogonal
+       * to the constant vector, the null space of L, so the smallest
+       * Ritz value approximates the smallest nonzero eigenvalue. The
+       * iteration is restarted with the current Ritz vector until
+       * the residual is small compared to the gap with the next
+       * Ritz value.
+       */
+      template<typename integer_t> void
+      fiedler_vector(const CSRGraph<integer_t>& g, std::vector<double>& f,
+                     int depth) {
+        const std::size_t n = g.size();
+        const auto ptr = g.ptr();
+        const auto ind = g.ind();
+        const int m = std::min(n-1, std::size_t(lanczos_steps));
+        std::vector<double> d(n);
+        for (std::size_t v=0; v<n; v++)
+          d[v] = ptr[v+1] - ptr[v];
+        auto spmv = [&](const double* x, double* y) {
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(grain)   \
+  if(depth < params::task_recursion_cutoff_level)
+#endif
+          for (std::size_t v=0; v<n; v++) {
+            auto yv = d[v] * x[v];
+            for (auto e=ptr[v]; e<ptr[v+1]; e++)
+              yv -= x[ind[e]];
+            y[v] = yv;
+          }
+        };
+        DenseMatrix<double> Q(n, m+1), T;
+        std::vector<double> h(m+1), alpha(m), beta(m), lambda;
+        // orthogonalize against the first k+1 columns of Q, twice
+        auto orthogonalize = [&](double* w, int k) {
+          DenseMatrixWrapper<double> Qk(n, k+1, Q, 0, 0);
+          for (int it=0; it<2; it++) {
+            gemv(Trans::T, 1., Qk, w, 1, 0., h.data(), 1, depth);
+            gemv(Trans::N, -1., Qk, h.data(), 1, 1., w, 1, depth);
+          }
+        };
+        std::fill(Q.ptr(0, 0), Q.ptr(0, 0)+n, 1. / std::sqrt(double(n)));
+        f.resize(n);
+        // deterministic pseudo random starting vector
+        for (std::size_t v=0; v<n; v++) {
+          std::uint64_t r = (v + 1) * 0x9E3779B97F4A7C15ull;
+          r ^= r >> 29;
+          f[v] = double(r % 2001) / 1000. - 1.;
+        }
+        for (int restart=0; restart<lanczos_restarts; restart++) {
+          auto q1 = Q.ptr(0, 1);
+          std::copy(f.begin(), f.end(), q1);
+          orthogonalize(q1, 0);
+          auto nrm = blas::nrm2(n, q1, 1);
+          if (nrm == 0.) return;
+          blas::scal(n, 1. / nrm, q1, 1);
+          int k = 0;
+          while (k < m) {
+            auto qk = Q.ptr(0, k+1);
+            auto w = (k+1 < m) ? Q.ptr(0, k+2) : f.data();
+            spmv(qk, w);
+            alpha[k] = blas::dotu(n, qk, 1, w, 1);
+            orthogonalize(w, k+1);
+            beta[k] = blas::nrm2(n, w, 1);
+            k++;
+            if (k == m || beta[k-1] <= 1e-12 * std::abs(alpha[0]))
+              break;
+            blas::scal(n, 1. / beta[k-1], w, 1);
+          }
+          T = DenseMatrix<double>(k, k);
+          T.zero();
+          for (int i=0; i<k; i++) {
+            T(i, i) = alpha[i];
+            if (i+1 < k) T(i+1, i) = beta[i];
+          }
+          T.syev(Jobz::V, UpLo::L, lambda);
+          // Ritz vector for the smallest Ritz value
+          DenseMatrixWrapper<double> Qk(n, k, Q, 0, 1);
+          gemv(Trans::N, 1., Qk, T.ptr(0, 0), 1, 0., f.data(), 1, depth);
+          auto res = std::abs(beta[k-1] * T(k-1, 0));
+          auto gap = (k > 1) ? lambda[1] - lambda[0] : 0.;
+          if (k < m || res <= 0.1 * gap) break;
+        }
+      }
+
+      /**
+       * Spectral bisection of g, on output where[v] is 0 or 1 for the
+       * two parts, or 2 for the separator. A disconnected graph is
+       * split along its connected components, without separator.
+       */
+      template<typename integer_t> void
+      bisect(const CSRGraph<integer_t>& g, std::vector<char>& where,
+             int depth) {
+        const auto n = g.size();
+        where.assign(n, 0);
+        std::vector<integer_t> comp;
+        auto nc = components(g, comp);
+        if (nc > 1) {
+          std::vector<std::pair<integer_t,integer_t>> cw(nc);
+          for (integer_t c=0; c<nc; c++) cw[c].second = c;
+          for (integer_t v=0; v<n; v++) cw[comp[v]].first++;
+          std::sort(cw.begin(), cw.end(), std::greater<>());
+          std::vector<char> part(nc);
+          integer_t w[2] = {0, 0};
+          for (auto& c : cw) {
+            int p = (w[0] <= w[1]) ? 0 : 1;
+            part[c.second] = p;
+            w[p] += c.first;
+          }
+          for (integer_t v=0; v<n; v++)
+            where[v] = part[comp[v]];
+          return;
+        }
+        std::vector<double> f;
+        fiedler_vector(g, f, depth);
+        std::vector<integer_t> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](integer_t a, integer_t b) {
+          return f[a] < f[b] || (f[a] == f[b] && a < b); });
+        integer_t w0 = 0;
+        for (auto v : order)
+          where[v] = (2 * w0++ < n) ? 0 : 1;
+        std::vector<integer_t> vw(n, 1), ew(g.edges(), 1);
+        g.fm_refine(vw, ew, where, depth);
+        g.vertex_separator(vw, where);
+      }
+
+    } // end namespace spectral
+
+
+    template<typename integer_t> SeparatorTree<integer_t>
+    spectral_nd(integer_t n, const integer_t* ptr, const integer_t* ind,
+                std::vector<integer_t>& perm,
+                std::vector<integer_t>& iperm, int leaf) {
+      if (n <= 0) return SeparatorTree<integer_t>();
+      CSRGraph<integer_t> g
+        (std::vector<integer_t>(ptr, ptr+n+1),
+         std::vector<integer_t>(ind, ind+ptr[n]));
+      return g.nested_dissection
+        (leaf, perm, iperm,
+         [](const CSRGraph<integer_t>& sg, std::vector<char>& where,
+            int depth) { spectral::bisect(sg, where, depth); });
+    }
+
+    // explicit template instantiation
+    template SeparatorTree<int>
+    spectral_nd(int n, const int* ptr, const int* ind,
+                std::vector<int>& perm, std::vector<int>& iperm, int leaf);
+    template SeparatorTree<long int>
+    spectral_nd(long int n, const long int* ptr, const long int* ind,
+                std::vector<long int>& perm,
+                std::vector<long int>& iperm, int leaf);
+    template SeparatorTree<long long int>
+    spectral_nd(long long int n, const long long int* ptr,
+                const long long int* ind, std::vector<long long int>& perm,
+                std::vector<long long int>& iperm, int leaf);
+
+  } // end namespace ordering
+} // end namespace strumpack
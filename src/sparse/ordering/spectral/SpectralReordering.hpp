@@ -0,0 +1,77 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef STRUMPACK_ORDERING_SPECTRAL_REORDERING_HPP
+#define STRUMPACK_ORDERING_SPECTRAL_REORDERING_HPP
+
+#include <vector>
+
+#include "sparse/SeparatorTree.hpp"
+
+
+namespace strumpack {
+  namespace ordering {
+
+    /**
+     * Spectral nested dissection. Every connected subgraph is split
+     * at the median of its Fiedler vector, the
+     * eigenvector of the graph Laplacian for the smallest nonzero
+     * eigenvalue. The Fiedler vector is approximated with a
+     * (restarted) Lanczos method with full reorthogonalization,
+     * using a multithreaded sparse matrix-vector product. The median
+     * split is improved with Fiduccia-Mattheyses and then turned
+     * into a vertex separator, see CSRGraph::fm_refine and
+     * CSRGraph::vertex_separator.
+     *
+     * \param n number of vertices
+     * \param ptr row pointers of the (structurally symmetric) graph
+     * \param ind column indices of the graph, self-loops are ignored
+     * \param perm on output, the fill reducing permutation, perm[old]
+     * = new
+     * \param iperm on output, the inverse of perm
+     * \param leaf subgraphs with at most this many vertices are not
+     * further dissected
+     * \return the separator tree corresponding to the dissection
+     */
+    template<typename integer_t> SeparatorTree<integer_t>
+    spectral_nd(integer_t n, const integer_t* ptr, const integer_t* ind,
+                std::vector<integer_t>& perm,
+                std::vector<integer_t>& iperm, int leaf);
+
+    template<typename integer_t,typename G>
+    SeparatorTree<integer_t>
+    spectral_nd(const G& A, std::vector<integer_t>& perm,
+                std::vector<integer_t>& iperm, int leaf) {
+      return spectral_nd<integer_t>
+        (A.size(), A.ptr(), A.ind(), perm, iperm, leaf);
+    }
+
+  } // end namespace ordering
+} // end namespace strumpack
+
+#endif // STRUMPACK_ORDERING_SPECTRAL_REORDERING_HPP
@@ -33,10 +33,9 @@
 
 #include "StructuredMatrix.hpp"
 #include "HSS/HSSMatrix.hpp"
-#if defined(STRUMPACK_USE_ZFP)
-#include "sparse/fronts/FrontLossy.hpp"
-#endif
+#include "sparse/fronts/LossyMatrix.hpp"
 #include "BLR/BLRMatrix.hpp"
+#include "HODLR/HODLRMatrixNative.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "BLR/BLRMatrixMPI.hpp"
 #include "sparse/fronts/ExtendAdd.hpp"
@@ -97,25 +96,23 @@ namespace strumpack {
         return std::unique_ptr<StructuredMatrix<scalar_t>>(B);
       }
       case Type::LOSSY: {
-#if defined(STRUMPACK_USE_ZFP)
         return std::unique_ptr<StructuredMatrix<scalar_t>>
           (new LossyMatrix<scalar_t>(A, 16, 1e-3));
-#else
-        throw std::runtime_error
-          ("Lossy compression requires ZFP to be enabled.");
-#endif
       }
       case Type::LOSSLESS: {
-#if defined(STRUMPACK_USE_ZFP)
         return std::unique_ptr<StructuredMatrix<scalar_t>>
-          (new LossyMatrix<scalar_t>(A, 16, 1e-3));
-#else
-        throw std::runtime_error
-          ("Lossless compression requires ZFP to be enabled.");
-#endif
+          (new LossyMatrix<scalar_t>(A, 0, -1.));
+      }
+      case Type::HODLR: {
+        if (A.rows() != A.cols())
+          throw std::invalid_argument
+            ("HODLR compression only supported for square matrices.");
+        HODLR::HODLROptions<scalar_t> hodlr_opts(opts);
+        auto tree = row_tree ? *row_tree :
+          structured::ClusterTree(A.rows()).refine(opts.leaf_size());
+        return std::unique_ptr<StructuredMatrix<scalar_t>>
+          (new HODLR::HODLRMatrixNative<scalar_t>(tree, A, hodlr_opts));
       }
-      case Type::HODLR:
-        throw std::invalid_argument("Type HODLR requires MPI.");
       case Type::HODBF:
         throw std::invalid_argument("Type HODBF requires MPI.");
       case Type::BUTTERFLY:
@@ -293,8 +290,16 @@ namespace strumpack {
         }
         return std::unique_ptr<StructuredMatrix<scalar_t>>(B);
       }
-      case Type::HODLR:
-        throw std::invalid_argument("Type HODLR requires MPI.");
+      case Type::HODLR: {
+        if (rows != cols)
+          throw std::invalid_argument
+            ("HODLR compression only supported for square matrices.");
+        HODLR::HODLROptions<scalar_t> hodlr_opts(opts);
+        auto tree = row_tree ? *row_tree :
+          structured::ClusterTree(rows).refine(opts.leaf_size());
+        return std::unique_ptr<StructuredMatrix<scalar_t>>
+          (new HODLR::HODLRMatrixNative<scalar_t>(tree, A, hodlr_opts));
+      }
       case Type::HODBF:
         throw std::invalid_argument("Type HODBF requires MPI.");
       case Type::BUTTERFLY:
@@ -570,21 +575,86 @@ namespace strumpack {
                                     const admissibility_t*);
 
 
+    /**
+     * Compress A as a (shared memory) HODLR matrix, using randomized
+     * peeling, which only requires products with A. This is the
+     * first step of the sequential matrix-free construction of HSS,
+     * BLR and HODLR. If the HODLR matrix is only an intermediate,
+     * to be recompressed as HSS or BLR, it is compressed with a
+     * smaller tolerance, to limit the accumulation of errors.
+     */
+    template<typename scalar_t>
+    std::unique_ptr<HODLR::HODLRMatrixNative<scalar_t>>
+    peel_matrix_free(int rows, int cols, const mult_t<scalar_t>& Amult,
+                     const StructuredOptions<scalar_t>& opts,
+                     const structured::ClusterTree* row_tree,
+                     bool intermediate) {
+      if (rows != cols)
+        throw std::invalid_argument
+          ("Matrix-free compression only supported for square matrices.");
+      auto peel_opts = opts;
+      if (intermediate) {
+        peel_opts.set_rel_tol(opts.rel_tol() / 10);
+        peel_opts.set_abs_tol(opts.abs_tol() / 10);
+      }
+      HODLR::HODLROptions<scalar_t> hodlr_opts(peel_opts);
+      auto tree = row_tree ? *row_tree :
+        structured::ClusterTree(rows).refine(opts.leaf_size());
+      return std::make_unique<HODLR::HODLRMatrixNative<scalar_t>>
+        (tree, Amult, hodlr_opts);
+    }
+
     template<typename scalar_t> std::unique_ptr<StructuredMatrix<scalar_t>>
     construct_matrix_free(int rows, int cols,
                           const mult_t<scalar_t>& Amult,
                           const StructuredOptions<scalar_t>& opts,
                           const structured::ClusterTree* row_tree,
                           const structured::ClusterTree* col_tree) {
+      // HSS, BLR and HODLR are first compressed as a (shared memory)
+      // HODLR matrix, using randomized peeling. HSS and BLR are then
+      // recompressed from that HODLR matrix, without further
+      // products with A.
+      auto peel = [&](bool intermediate) {
+        return peel_matrix_free
+          (rows, cols, Amult, opts, row_tree, intermediate);
+      };
       switch (opts.type()) {
-      case Type::HSS:
-        throw std::invalid_argument
-          ("Type HSS does not support matrix-free compression.");
-      case Type::BLR:
-        throw std::invalid_argument
-          ("Type BLR does not support matrix-free compression.");
+      case Type::HSS: {
+        auto A = peel(true);
+        HSS::HSSOptions<scalar_t> hss_opts(opts);
+        auto H = row_tree ?
+          new HSS::HSSMatrix<scalar_t>(*row_tree, hss_opts) :
+          new HSS::HSSMatrix<scalar_t>(rows, cols, hss_opts);
+        using DenseM_t = DenseMatrix<scalar_t>;
+        auto sample =
+          [&A](DenseM_t& Rr, DenseM_t& Rc, DenseM_t& Sr, DenseM_t& Sc) {
+            A->mult(Trans::N, Rr, Sr);
+            A->mult(Trans::C, Rc, Sc);
+          };
+        auto elem =
+          [&A](const std::vector<std::size_t>& I,
+               const std::vector<std::size_t>& J, DenseM_t& B) {
+            A->extract(I, J, B);
+          };
+        H->compress(sample, elem, hss_opts);
+        return std::unique_ptr<StructuredMatrix<scalar_t>>(H);
+      }
+      case Type::BLR: {
+        // BLR::BLRMatrix can only be factored during construction,
+        // so this BLR matrix only supports mult, see
+        // construct_and_factor_matrix_free
+        auto A = peel(true);
+        auto elem =
+          [&A](const std::vector<std::size_t>& I,
+               const std::vector<std::size_t>& J,
+               DenseMatrix<scalar_t>& B) {
+            A->extract(I, J, B);
+          };
+        return construct_from_elements<scalar_t>
+          (rows, cols, elem, opts, row_tree, col_tree);
+      }
       case Type::HODLR:
-        throw std::invalid_argument("Type HODLR requires MPI.");
+        return peel(false);
       case Type::HODBF:
         throw std::invalid_argument("Type HODBF requires MPI.");
       case Type::BUTTERFLY:
@@ -625,6 +695,60 @@ namespace strumpack {
                           const structured::ClusterTree*);
 
 
+    template<typename scalar_t> std::unique_ptr<StructuredMatrix<scalar_t>>
+    construct_and_factor_matrix_free(int rows, int cols,
+                                     const mult_t<scalar_t>& Amult,
+                                     const StructuredOptions<scalar_t>& opts,
+                                     const structured::ClusterTree* row_tree,
+                                     const structured::ClusterTree* col_tree,
+                                     const admissibility_t* adm) {
+      if (opts.type() == Type::BLR) {
+        // compress and factor the BLR matrix from the elements of the
+        // peeled HODLR matrix, as construct_and_factor_from_elements
+        auto A = peel_matrix_free(rows, cols, Amult, opts, row_tree, true);
+        auto elem =
+          [&A](const std::vector<std::size_t>& I,
+               const std::vector<std::size_t>& J,
+               DenseMatrix<scalar_t>& B) {
+            A->extract(I, J, B);
+          };
+        return construct_and_factor_from_elements<scalar_t>
+          (rows, cols, elem, opts, row_tree, col_tree, adm);
+      }
+      auto H = construct_matrix_free
+        (rows, cols, Amult, opts, row_tree, col_tree);
+      H->factor();
+      return H;
+    }
+    // explicit template instantiations
+    template std::unique_ptr<StructuredMatrix<float>>
+    construct_and_factor_matrix_free(int, int, const mult_t<float>&,
+                                     const StructuredOptions<float>&,
+                                     const structured::ClusterTree*,
+                                     const structured::ClusterTree*,
+                                     const admissibility_t*);
+    template std::unique_ptr<StructuredMatrix<double>>
+    construct_and_factor_matrix_free(int, int, const mult_t<double>&,
+                                     const StructuredOptions<double>&,
+                                     const structured::ClusterTree*,
+                                     const structured::ClusterTree*,
+                                     const admissibility_t*);
+    template std::unique_ptr<StructuredMatrix<std::complex<float>>>
+    construct_and_factor_matrix_free(int, int,
+                                     const mult_t<std::complex<float>>&,
+                                     const StructuredOptions<std::complex<float>>&,
+                                     const structured::ClusterTree*,
+                                     const structured::ClusterTree*,
+                                     const admissibility_t*);
+    template std::unique_ptr<StructuredMatrix<std::complex<double>>>
+    construct_and_factor_matrix_free(int, int,
+                                     const mult_t<std::complex<double>>&,
+                                     const StructuredOptions<std::complex<double>>&,
+                                     const structured::ClusterTree*,
+                                     const structured::ClusterTree*,
+                                     const admissibility_t*);
+
+
 
     template<typename scalar_t> std::unique_ptr<StructuredMatrix<scalar_t>>
     construct_partially_matrix_free(int rows, int cols,
@@ -651,7 +775,7 @@ namespace strumpack {
       case Type::BLR:
         return construct_from_elements<scalar_t>(rows, cols, Aelem, opts);
       case Type::HODLR:
-        throw std::invalid_argument("Type HODLR requires MPI.");
+        return construct_from_elements<scalar_t>(rows, cols, Aelem, opts);
       case Type::HODBF:
         throw std::invalid_argument("Type HODBF requires MPI.");
       case Type::BUTTERFLY:
@@ -1566,7 +1690,7 @@ namespace strumpack {
     template<typename scalar_t> void
     StructuredMatrix<scalar_t>::factor() {
       throw std::invalid_argument
-        ("Operation factor not supported for this type. (Try construct_and_factor_from_...)");
+        ("Operation factor not supported for this type. (Try construct_and_factor_...)");
     }
     template<typename scalar_t> void
     StructuredMatrix<scalar_t>::solve(DenseMatrix<scalar_t>& b) const {
@@ -194,17 +194,30 @@ namespace strumpack {
      * |           |  parallel? || construct from ..        ||||| operation                  |||| precision  ||||
      * |-----------|------|------|-------|------|----|-----|----|------|--------|-------|-------|---|---|---|---|
      * |  ^        |  seq | MPI  | DENSE | ELEM | MF | PMF | NN | mult | factor | solve | shift | s | d | c | z |
-     * | BLR       |  X   |  X   | X     |  X   |    |     |    | X    |   X    |  X    | ?     | X | X | X | X |
-     * | HSS       |  X   |  X   | X     |      |    | X   | X  |  X   |   X    |  X    | X     | X | X | X | X |
-     * | HODLR     |      |  X   | X     |  X   | X  |     | X  |  X   |   X    |  X    | ?     |   | X |   | X |
+     * | BLR       |  X   |  X   | X     |  X   | X  |     |    | X    |   X    |  X    | ?     | X | X | X | X |
+     * | HSS       |  X   |  X   | X     |      | X  | X   | X  |  X   |   X    |  X    | X     | X | X | X | X |
+     * | HODLR     |  X   |  X   | X     |  X   | X  | X   | X  |  X   |   X    |  X    | X     | X | X | X | X |
      * | HODBF     |      |  X   | X     |  X   | X  |     | X  |  X   |   X    |  X    | ?     |   | X |   | X |
      * | BUTTERFLY |      |  X   | X     |  X   | X  |     | X  |  X   |        |       |       |   | X |   | X |
      * | LR        |      |  X   | X     |  X   | X  |     | X  |  X   |        |       |       |   | X |   | X |
      * | LOSSY     |  X   |      | X     |      |    |     |    |      |        |       |       | X | X | X | X |
      * | LOSSLESS  |  X   |      | X     |      |    |     |    |      |        |       |       | X | X | X | X |
      *
+     * Sequential HODLR (HODLR::HODLRMatrixNative) supports DENSE,
+     * ELEM, MF and PMF construction, in all precisions. The MPI
+     * version requires ButterflyPACK, which supports double and
+     * std::complex<double> only. Sequential MF construction of HSS
+     * and HODLR first builds a HODLR::HODLRMatrixNative by
+     * randomized peeling, and then (for HSS) recompresses it. This
+     * is only supported for square matrices. BLR is recompressed in
+     * the same way. A BLR matrix can only be factored when it is
+     * constructed, so a factored matrix-free BLR matrix is obtained
+     * with construct_and_factor_matrix_free, while
+     * construct_matrix_free returns a BLR matrix which only supports
+     * mult.
+     *
      * \see HSS::HSSMatrix, BLR::BLRMatrix, HODLR::HODLRMatrix,
-     * HODLR::ButterflyMatrix, ...
+     * HODLR::HODLRMatrixNative, HODLR::ButterflyMatrix, ...
      */
     template<typename scalar_t> class StructuredMatrix {
       using real_t = typename RealType<scalar_t>::value_type;
@@ -763,7 +776,9 @@ namespace strumpack {
      * matrix is square, this does not need to be specified.
      *
      * \return std::unique_ptr holding a pointer to a
-     * StructuredMatrix of the requested StructuredMatrix::Type
+     * StructuredMatrix of the requested StructuredMatrix::Type. A
+     * BLR matrix constructed this way cannot be factored, it only
+     * supports mult, see construct_and_factor_matrix_free.
      *
      * \throw std::invalid_argument If the operatation is not
      * supported for the type of structured::StructuredMatrix, if the
@@ -784,6 +799,53 @@ namespace strumpack {
                           const structured::ClusterTree* row_tree=nullptr,
                           const structured::ClusterTree* col_tree=nullptr);
 
+    /**
+     * Construct a StructuredMatrix using only a matrix-vector
+     * multiplication routine, and compute a factorization. For BLR,
+     * compression and factorization are combined and cannot be
+     * called separately, the BLR matrix is compressed and factored
+     * from the elements of the HODLR matrix obtained by randomized
+     * peeling, see construct_matrix_free.
+     *
+     * \tparam scalar_t precision of input matrix, and of
+     * constructed StructuredMatrix. Note that not all types support
+     * every all precisions. See StructuredMatrix::Type.
+     *
+     * \param rows Number of rows of matrix to be constructed.
+     * \param cols Number of columns of matrix to be constructed.
+     * \param Amult Matrix-(multi)vector multiplication routine.
+     * \param opts Options object
+     * \param row_tree optional clustertree for the rows, see also
+     * strumpack::binary_tree_clustering
+     * \param col_tree optional clustertree for the columns. If the
+     * matrix is square, this does not need to be specified.
+     * \param adm optional admissibility info for BLR, should be of
+     * size row_tree->leaf_sizes().size() x
+     * col_tree->leaf_sizes().size()
+     *
+     * \return std::unique_ptr holding a pointer to a
+     * StructuredMatrix of the requested StructuredMatrix::Type
+     *
+     * \throw std::invalid_argument If the operatation is not
+     * supported for the type of structured::StructuredMatrix, if the
+     * type requires a square matrix and the input is not square, if
+     * the structured::StructuredMatrix type requires MPI.
+     * \throw std::logic_error If the operation is not implemented yet
+     * \throw std::runtime_error If the operation requires a third
+     * party library which was not enabled when configuring STRUMPACK.
+     *
+     * \see strumpack::binary_tree_clustering, construct_from_dense
+     * construct_from_elements, construct_matrix_free and
+     * construct_partially_matrix_free
+     */
+    template<typename scalar_t> std::unique_ptr<StructuredMatrix<scalar_t>>
+    construct_and_factor_matrix_free(int rows, int cols,
+                                     const mult_t<scalar_t>& Amult,
+                                     const StructuredOptions<scalar_t>& opts,
+                                     const structured::ClusterTree* row_tree=nullptr,
+                                     const structured::ClusterTree* col_tree=nullptr,
+                                     const admissibility_t* adm=nullptr);
+
     /**
      * Construct a StructuredMatrix using both a matrix-vector
      * multiplication routine and a routine to extract a matrix
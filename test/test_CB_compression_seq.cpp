@@ -0,0 +1,105 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <cstring>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+/**
+ * Factor and solve with lossless compression of the contribution
+ * blocks, and check that the solution is bit for bit the same as
+ * without compression: the contribution blocks are decompressed
+ * exactly. Also check that the contribution blocks were actually
+ * compressed. Should be run with a single thread, so that the
+ * floating point operations are done in the same order.
+ */
+template<typename scalar_t,typename integer_t> int
+test_CB_compression(int argc, const char* const argv[],
+                    const CSRMatrix<scalar_t,integer_t>& A,
+                    CompressionType front_compression) {
+  integer_t N = A.size();
+  vector<scalar_t> b(N, scalar_t(1.)), x(N), xc(N);
+  auto solve = [&](bool CBc, vector<scalar_t>& x) {
+    StrumpackSparseSolver<scalar_t,integer_t> sps;
+    sps.options().set_from_command_line(argc, argv);
+    sps.options().set_verbose(false);
+    sps.options().set_Krylov_solver(KrylovSolver::DIRECT);
+    sps.options().set_compression(front_compression);
+    sps.options().set_compression_min_sep_size(10);
+    if (CBc) {
+      sps.options().enable_CB_compression();
+      sps.options().set_CB_compression_accuracy(-1.);
+    } else sps.options().disable_CB_compression();
+    sps.set_matrix(A);
+    if (sps.factor() != ReturnCode::SUCCESS) return false;
+    if (CBc && !params::CB_compressed_memory) {
+      cout << "NO CONTRIBUTION BLOCKS WERE COMPRESSED!" << endl;
+      return false;
+    }
+    return sps.solve(b.data(), x.data()) == ReturnCode::SUCCESS;
+  };
+  if (!solve(false, x) || !solve(true, xc)) {
+    cout << "problem with the factorization or solve." << endl;
+    return 1;
+  }
+  cout << "# " << get_name(front_compression) << " fronts, lossless "
+       << "CB compression: " << params::CB_memory / 1.e6 << " MB -> "
+       << params::CB_compressed_memory / 1.e6 << " MB" << endl;
+  if (std::memcmp(x.data(), xc.data(), N*sizeof(scalar_t))) {
+    cout << "LOSSLESS CB COMPRESSION CHANGED THE SOLUTION!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout << "Solve with lossless compression of the contribution blocks."
+         << "\n\nUsage: \n\t./test_CB_compression_seq pde900.mtx" << endl;
+    return 1;
+  }
+  CSRMatrix<double,int> A;
+  if (A.read_matrix_market(argv[1])) {
+    cerr << "Could not read matrix from file." << endl;
+    return 1;
+  }
+  int ierr = 0;
+  for (auto c : {CompressionType::NONE, CompressionType::BLR,
+        CompressionType::LOSSY})
+    ierr += test_CB_compression(argc, argv, A, c);
+  CSRMatrix<float,int> Af;
+  Af.read_matrix_market(argv[1]);
+  ierr += test_CB_compression(argc, argv, Af, CompressionType::NONE);
+  return ierr ? 1 : 0;
+}
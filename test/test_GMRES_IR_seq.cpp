@@ -0,0 +1,182 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+using namespace std;
+
+#include "StrumpackSparseSolverMixedPrecision.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+/**
+ * Solve A x = b with the mixed precision solver, with the factors
+ * stored in bfloat16, using GMRES-IR. Checks that the refinement
+ * converges to the requested tolerance, and returns the precision
+ * in which the factors are stored after the solve, which is FULL if
+ * the refinement stalled with the bfloat16 factors. With
+ * force_stall, only a single mantissa bit of the factors is kept,
+ * also for the smallest fronts, and each correction is a single
+ * GMRES iteration, so the refinement stalls before the fallback.
+ */
+template<typename integer_t> int
+solve_bf16(int argc, char* argv[], const CSRMatrix<double,integer_t>& A,
+           bool force_stall, std::size_t& bf16_memory,
+           StoragePrecision& fprec) {
+  integer_t N = A.size();
+  DenseMatrix<double> b(N, 1), x(N, 1), x_exact(N, 1);
+  x_exact.random();
+  A.spmv(x_exact, b);
+
+  SparseSolverMixedPrecision<float,double,integer_t> sps(false);
+  sps.options().set_rel_tol(1e-12);
+  sps.options().set_from_command_line(argc, argv);
+  sps.solver().options().set_from_command_line(argc, argv);
+  sps.solver().options().set_verbose(false);
+  sps.set_factor_storage_precision(StoragePrecision::BFLOAT16);
+  if (force_stall) {
+    sps.options().set_gmres_restart(1);
+    sps.solver().options().set_lossy_precision(1);
+#if defined(STRUMPACK_USE_SZ3)
+    sps.solver().options().set_lossy_accuracy(.5);
+#endif
+    sps.solver().options().set_lossy_min_sep_size(1);
+  }
+  sps.set_matrix(A);
+  if (sps.reorder() != ReturnCode::SUCCESS ||
+      sps.factor() != ReturnCode::SUCCESS) {
+    cout << "problem with the factorization of the matrix." << endl;
+    return 1;
+  }
+  bf16_memory = sps.solver().factor_memory();
+  if (sps.solve(b, x) != ReturnCode::SUCCESS) {
+    cout << "GMRES-IR DID NOT CONVERGE!" << endl;
+    return 1;
+  }
+  fprec = sps.factor_storage_precision();
+  // after a fallback, the factors are refactored with dense fronts
+  if (fprec == StoragePrecision::FULL &&
+      (sps.solver().options().compression() != CompressionType::NONE ||
+       sps.solver().factor_memory() <= bf16_memory)) {
+    cout << "GMRES-IR FALLBACK DID NOT USE DENSE FRONTS!" << endl;
+    return 1;
+  }
+  DenseMatrix<double> r(N, 1);
+  A.spmv(x, r);
+  r.scaled_add(-1., b);
+  auto rres = r.normF() / b.normF();
+  x.scaled_add(-1., x_exact);
+  cout << "# GMRES-IR, " << sps.Krylov_iterations()
+       << " GMRES iterations, factors stored in " << get_name(fprec)
+       << ", relative residual = " << rres
+       << ", relative error = " << x.normF() / x_exact.normF() << endl;
+  if (rres > sps.options().rel_tol()) {
+    cout << "GMRES-IR RESIDUAL TOO LARGE!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * bfloat16 factor storage for the matrix A from the command line:
+ * the factors should take less memory than single precision
+ * factors, and GMRES-IR should converge.
+ */
+template<typename integer_t> int
+test_bf16_storage(int argc, char* argv[],
+                  const CSRMatrix<double,integer_t>& A) {
+  SparseSolverMixedPrecision<float,double,integer_t> sps(false);
+  sps.solver().options().set_from_command_line(argc, argv);
+  sps.solver().options().set_verbose(false);
+  sps.set_matrix(A);
+  if (sps.factor() != ReturnCode::SUCCESS) {
+    cout << "problem with the factorization of the matrix." << endl;
+    return 1;
+  }
+  std::size_t memory = sps.solver().factor_memory(), bf16_memory = 0;
+  StoragePrecision fprec;
+  if (solve_bf16(argc, argv, A, false, bf16_memory, fprec)) return 1;
+  cout << "# factor memory, single = " << memory
+       << ", bfloat16 = " << bf16_memory << endl;
+  if (bf16_memory >= memory) {
+    cout << "BFLOAT16 FACTORS DO NOT SAVE MEMORY!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * A 2D Laplacian on an n x n grid, shifted towards its smallest
+ * eigenvalue, with the factors stored with a single mantissa bit,
+ * see solve_bf16. These factors are too inaccurate for GMRES-IR to
+ * make progress, so the solver has to fall back to single precision
+ * factors, which are accurate enough for this condition number.
+ */
+template<typename integer_t> int
+test_stall(int argc, char* argv[], integer_t n) {
+  integer_t N = n * n;
+  double h = M_PI / (n + 1),
+    shift = .99 * 2. * (4. * std::sin(h / 2.) * std::sin(h / 2.));
+  vector<integer_t> ptr(N+1), ind;
+  vector<double> val;
+  for (integer_t i=0; i<n; i++)
+    for (integer_t j=0; j<n; j++) {
+      if (i > 0) { ind.push_back((i-1)*n + j); val.push_back(-1.); }
+      if (j > 0) { ind.push_back(i*n + j-1); val.push_back(-1.); }
+      ind.push_back(i*n + j); val.push_back(4. - shift);
+      if (j < n-1) { ind.push_back(i*n + j+1); val.push_back(-1.); }
+      if (i < n-1) { ind.push_back((i+1)*n + j); val.push_back(-1.); }
+      ptr[i*n+j+1] = ind.size();
+    }
+  CSRMatrix<double,integer_t> A(N, ptr.data(), ind.data(), val.data());
+  std::size_t bf16_memory = 0;
+  StoragePrecision fprec;
+  if (solve_bf16(argc, argv, A, true, bf16_memory, fprec)) return 1;
+  if (fprec != StoragePrecision::FULL) {
+    cout << "GMRES-IR DID NOT FALL BACK TO FULL PRECISION FACTORS!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout << "Mixed precision solve with bfloat16 factors and GMRES-IR.\n\n"
+         << "Usage: \n\t./test_GMRES_IR_seq pde900.mtx" << endl;
+    return 1;
+  }
+  CSRMatrix<double,int> A;
+  if (A.read_matrix_market(argv[1])) {
+    cerr << "Could not read matrix from file." << endl;
+    return 1;
+  }
+  int ierr = test_bf16_storage(argc, argv, A);
+  if (ierr) return ierr;
+  return test_stall<int>(argc, argv, 100);
+}
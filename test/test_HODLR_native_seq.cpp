@@ -0,0 +1,161 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <complex>
+#include <string>
+using namespace std;
+
+#include "dense/DenseMatrix.hpp"
+#include "HODLR/HODLRMatrixNative.hpp"
+#include "structured/ClusterTree.hpp"
+using namespace strumpack;
+using namespace strumpack::HODLR;
+
+#define ERROR_TOLERANCE 1e2
+#define SOLVE_TOLERANCE 1e-10
+
+/**
+ * Compress A as a HODLRMatrixNative, from the dense matrix (RRQR),
+ * from an element extraction routine (BACA) and from matrix-vector
+ * products (randomized peeling). For each, check the compression
+ * error, the product with the compressed matrix, and factor and
+ * solve. The solve is checked against the compressed matrix, since
+ * the factorization is exact up to rounding.
+ */
+template<typename scalar_t> int
+test_HODLR_native(const DenseMatrix<scalar_t>& A,
+                  int argc, char* argv[]) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  using DenseM_t = DenseMatrix<scalar_t>;
+  int m = A.rows(), nrhs = 5;
+  HODLROptions<scalar_t> opts;
+  opts.set_verbose(false);
+  opts.set_leaf_size(32);
+  opts.set_rel_tol(1e-6);
+  opts.set_from_command_line(argc, argv);
+  structured::ClusterTree tree(m);
+  tree.refine(opts.leaf_size());
+
+  auto Aelem = [&](const std::vector<std::size_t>& I,
+                   const std::vector<std::size_t>& J, DenseM_t& B) {
+    for (std::size_t j=0; j<J.size(); j++)
+      for (std::size_t i=0; i<I.size(); i++)
+        B(i, j) = A(I[i], J[j]);
+  };
+  int nmult = 0;
+  auto Amult = [&](Trans op, const DenseM_t& R, DenseM_t& S) {
+    nmult += R.cols();
+    gemm(op, Trans::N, scalar_t(1.), A, R, scalar_t(0.), S);
+  };
+  auto check = [&](const HODLRMatrixNative<scalar_t>& H,
+                   const std::string& name) {
+    auto E = H.dense();
+    E.scaled_add(scalar_t(-1.), A);
+    auto cerr = E.normF() / A.normF();
+    DenseM_t X(m, nrhs), Y(m, nrhs), Yh(m, nrhs);
+    X.random();
+    gemm(Trans::N, Trans::N, scalar_t(1.), A, X, scalar_t(0.), Y);
+    H.mult(Trans::N, X, Yh);
+    Yh.scaled_add(scalar_t(-1.), Y);
+    auto merr = Yh.normF() / Y.normF();
+    cout << "# " << name << ": levels = " << H.levels()
+         << ", rank = " << H.rank() << ", memory = "
+         << 100. * H.memory() / A.memory() << "% of dense"
+         << ", compression error = " << cerr
+         << ", mult error = " << merr << endl;
+    auto tol = ERROR_TOLERANCE * max(opts.rel_tol(), opts.abs_tol());
+    if (cerr > tol || merr > tol) {
+      cout << "ERROR: " << name << " compression error too big!!" << endl;
+      return 1;
+    }
+    if (H.levels() < 2) {
+      cout << "ERROR: " << name << " is a single dense block!!" << endl;
+      return 1;
+    }
+    return 0;
+  };
+  auto check_solve = [&](HODLRMatrixNative<scalar_t>& H,
+                         const std::string& name) {
+    H.factor();
+    if (!H.factored()) {
+      cout << "ERROR: " << name << " is not factored!!" << endl;
+      return 1;
+    }
+    DenseM_t X(m, nrhs), B(m, nrhs);
+    X.random();
+    H.mult(Trans::N, X, B);
+    H.solve(B);
+    B.scaled_add(scalar_t(-1.), X);
+    auto err = B.normF() / X.normF();
+    cout << "# " << name << ": relative error = ||X-H\\(H*X)||_F/||X||_F = "
+         << err << endl;
+    if (err > real_t(SOLVE_TOLERANCE)) {
+      cout << "ERROR: " << name << " solve error too big!!" << endl;
+      return 1;
+    }
+    return 0;
+  };
+
+  HODLRMatrixNative<scalar_t> Hd(tree, A, opts);
+  if (check(Hd, "dense") || check_solve(Hd, "dense")) return 1;
+  HODLRMatrixNative<scalar_t> He(tree, Aelem, opts);
+  if (check(He, "elements") || check_solve(He, "elements")) return 1;
+  HODLRMatrixNative<scalar_t> Hm(tree, Amult, opts);
+  cout << "# matrix-vector products: " << nmult << endl;
+  if (check(Hm, "matvec") || check_solve(Hm, "matvec")) return 1;
+  if (nmult >= m) {
+    cout << "ERROR: peeling used as many products as a dense "
+         << "extraction!!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  int m = 1000;
+  if (argc > 1) m = stoi(argv[1]);
+  if (argc <= 1 || m < 0) {
+    cout << "# Usage:\n"
+         << "#     OMP_NUM_THREADS=4 ./test_HODLR_native_seq m "
+         << "[HODLR Options]\n";
+    return 1;
+  }
+  // Toeplitz matrix, and a complex version with a diagonal scaling,
+  // so that the off-diagonal blocks have the same ranks
+  DenseMatrix<double> A(m, m);
+  DenseMatrix<std::complex<double>> Ac(m, m);
+  for (int j=0; j<m; j++)
+    for (int i=0; i<m; i++) {
+      A(i, j) = (i==j) ? 2. : 1./(1+abs(i-j));
+      Ac(i, j) = A(i, j) * std::polar(1., .1 * (i - j));
+    }
+  int ierr = test_HODLR_native(A, argc, argv);
+  ierr += test_HODLR_native(Ac, argc, argv);
+  return ierr ? 1 : 0;
+}
@@ -32,6 +32,7 @@ using namespace std;
 
 #include "dense/DenseMatrix.hpp"
 #include "HSS/HSSMatrix.hpp"
+#include "HSS/HSSMatrixFrozen.hpp"
 using namespace strumpack;
 using namespace strumpack::HSS;
 
@@ -249,6 +250,140 @@ int run(int argc, char* argv[]) {
     return 1;
   }
 
+  cout << "# solving with reused workspace .." << endl;
+  WorkSolveLevels<double> wsolve;
+  for (int nrhs : {4, 1, 2}) {
+    DenseMatrix<double> Bi(m, nrhs), Ci(m, nrhs);
+    Bi.random();
+    Ci.copy(Bi);
+    H.solve(Ci, wsolve);
+    auto Bicheck = H.apply(Ci);
+    Bicheck.scaled_add(-1., Bi);
+    if (Bicheck.normF() / Bi.normF() > SOLVE_TOLERANCE) {
+      cout << "ERROR: ULV solve with reused workspace, "
+           << "relative error too big!!" << endl;
+      return 1;
+    }
+  }
+
+  cout << "# checking frozen HSS matrix .." << endl;
+  HSSMatrixFrozen<double> F(H);
+  if (!F.factored()) {
+    cout << "ERROR: frozen HSS matrix is not factored!!" << endl;
+    return 1;
+  }
+  {
+    int nrhs = 3;
+    DenseMatrix<double> X(m, nrhs), Y(m, nrhs);
+    X.random();
+    for (auto op : {Trans::N, Trans::C}) {
+      F.mult(op, X, Y);
+      auto Ycheck = (op == Trans::N) ? H.apply(X) : H.applyC(X);
+      Ycheck.scaled_add(-1., Y);
+      if (Ycheck.normF() / Y.normF() > SOLVE_TOLERANCE) {
+        cout << "ERROR: frozen HSS product differs!!" << endl;
+        return 1;
+      }
+    }
+    // concurrent solves, each with its own work array
+    int nsolves = 4, err = 0, team = 1;
+    std::vector<DenseMatrix<double>> Bs(nsolves), Xs(nsolves);
+    std::vector<std::vector<double>> work(nsolves);
+    for (int s=0; s<nsolves; s++) {
+      Bs[s] = DenseMatrix<double>(m, s+1);
+      Bs[s].random();
+      Xs[s] = Bs[s];
+      work[s].resize(F.work_size(s+1));
+    }
+    auto solves = [&]() {
+      team = omp_get_num_threads();
+#pragma omp taskloop default(shared)
+      for (int s=0; s<nsolves; s++)
+        F.solve(Xs[s], work[s].data());
+    };
+    // run is called from a single region in main, a parallel
+    // region is only needed when it is called outside of one
+    if (omp_in_parallel()) solves();
+    else {
+#pragma omp parallel
+#pragma omp single
+      solves();
+    }
+    if (omp_get_max_threads() > 1 && team < 2) {
+      cout << "ERROR: concurrent frozen HSS solves ran on "
+           << team << " thread!!" << endl;
+      return 1;
+    }
+    for (int s=0; s<nsolves; s++) {
+      DenseMatrix<double> R(m, s+1);
+      F.mult(Trans::N, Xs[s], R);
+      R.scaled_add(-1., Bs[s]);
+      if (R.normF() / Bs[s].normF() > SOLVE_TOLERANCE) err++;
+    }
+    if (err) {
+      cout << "ERROR: frozen HSS solve relative error too big!!" << endl;
+      return 1;
+    }
+  }
+
+  if (hss_opts.storage_precision() != StoragePrecision::FULL) {
+    cout << "# solving with reduced precision generators .." << endl;
+    HSSMatrix<double> Hr(A, hss_opts);
+    Hr.factor();
+    auto mem = Hr.memory();
+    Hr.reduce_precision(hss_opts.rel_tol(), hss_opts.abs_tol(),
+                        hss_opts.storage_precision());
+    cout << "# memory(H) = " << mem / 1.e6 << " MB, reduced = "
+         << Hr.memory() / 1.e6 << " MB" << endl;
+    // each generator is rounded with error below the compression
+    // tolerance
+    auto tol = max(hss_opts.rel_tol(), hss_opts.abs_tol());
+    DenseMatrix<double> X(B), R(m, n);
+    Hr.solve(X);
+    F.mult(Trans::N, X, R);
+    R.scaled_add(-1., B);
+    cout << "# relative error = ||B-H*(Hr\\B)||_F/||B||_F = "
+         << R.normF() / B.normF() << endl;
+    if (R.normF() / B.normF() > tol) {
+      cout << "ERROR: reduced precision solve relative error too big!!"
+           << endl;
+      return 1;
+    }
+    WorkSolve<double> w;
+    X.copy(B);
+    Hr.forward_solve(w, X, false);
+    Hr.backward_solve(w, X);
+    F.mult(Trans::N, X, R);
+    R.scaled_add(-1., B);
+    if (R.normF() / B.normF() > tol) {
+      cout << "ERROR: reduced precision forward/backward solve "
+           << "relative error too big!!" << endl;
+      return 1;
+    }
+    // the frozen copy decodes the reduced precision generators, so
+    // it should match Hr up to round-off
+    HSSMatrixFrozen<double> Fr(Hr);
+    for (auto op : {Trans::N, Trans::C}) {
+      Fr.mult(op, X, R);
+      auto Rcheck = (op == Trans::N) ? Hr.apply(X) : Hr.applyC(X);
+      Rcheck.scaled_add(-1., R);
+      if (Rcheck.normF() / R.normF() > SOLVE_TOLERANCE) {
+        cout << "ERROR: frozen reduced precision HSS product differs!!"
+             << endl;
+        return 1;
+      }
+    }
+    X.copy(B);
+    Fr.solve(X);
+    DenseMatrix<double> Xr(B);
+    Hr.solve(Xr);
+    Xr.scaled_add(-1., X);
+    if (Xr.normF() / X.normF() > SOLVE_TOLERANCE) {
+      cout << "ERROR: frozen reduced precision HSS solve differs!!" << endl;
+      return 1;
+    }
+  }
+
   if (!H.leaf()) {
     H.partial_factor();
     cout << "# Computing Schur update .." << endl;
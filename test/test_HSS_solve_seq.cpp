@@ -0,0 +1,125 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+using namespace std;
+
+#include "dense/DenseMatrix.hpp"
+#include "HSS/HSSMatrix.hpp"
+using namespace strumpack;
+using namespace strumpack::HSS;
+
+#define SOLVE_TOLERANCE 1e-12
+
+/**
+ * Solve with H, reusing the workspace w, for several numbers of
+ * right-hand sides, and compare with a solve using a fresh
+ * workspace. Also check the residual. The first solve has the
+ * largest number of right-hand sides, so the later ones should not
+ * grow the workspace.
+ */
+int check_solves(const HSSMatrix<double>& H, WorkSolveLevels<double>& w) {
+  auto m = H.rows();
+  std::size_t mem = 0;
+  for (int nrhs : {4, 1, 3, 4}) {
+    DenseMatrix<double> B(m, nrhs), X(m, nrhs), Xf(m, nrhs);
+    B.random();
+    X.copy(B);
+    Xf.copy(B);
+    H.solve(X, w);
+    H.solve(Xf);
+    if (!mem) mem = w.memory();
+    else if (w.memory() != mem) {
+      cout << "ERROR: repeated solves grew the workspace!!" << endl;
+      return 1;
+    }
+    auto R = H.apply(X);
+    R.scaled_add(-1., B);
+    Xf.scaled_add(-1., X);
+    if (R.normF() / B.normF() > SOLVE_TOLERANCE ||
+        Xf.normF() / X.normF() > SOLVE_TOLERANCE) {
+      cout << "ERROR: solve with reused workspace, relative error "
+           << R.normF() / B.normF() << ", difference with a fresh "
+           << "workspace " << Xf.normF() / X.normF() << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  int m = 1000;
+  if (argc > 1) m = stoi(argv[1]);
+  if (argc <= 1 || m < 0) {
+    cout << "# Usage:\n"
+         << "#     OMP_NUM_THREADS=4 ./test_HSS_solve_seq m [HSS Options]\n";
+    return 1;
+  }
+  HSSOptions<double> opts;
+  opts.set_verbose(false);
+  opts.set_leaf_size(16);
+  opts.set_rel_tol(1e-2);
+  opts.set_from_command_line(argc, argv);
+  DenseMatrix<double> A(m, m);
+  for (int j=0; j<m; j++)
+    for (int i=0; i<m; i++)
+      A(i,j) = (i==j) ? 1. : 1./(1+abs(i-j));
+
+  WorkSolveLevels<double> w;
+  HSSMatrix<double> H(A, opts);
+  H.factor();
+  auto id = H.factor_id();
+  auto rank = H.rank();
+  cout << "# rank(H) = " << rank << endl;
+  if (check_solves(H, w)) return 1;
+
+  cout << "# refactor, same compression .." << endl;
+  H.factor();
+  if (H.factor_id() == id) {
+    cout << "ERROR: refactorization did not change factor_id!!" << endl;
+    return 1;
+  }
+  id = H.factor_id();
+  if (check_solves(H, w)) return 1;
+
+  // recompress with a different tolerance in the same object, so the
+  // HSS tree has other ranks (and nodes), and refactor: the layout of
+  // the workspace is no longer valid
+  cout << "# recompress and refactor .." << endl;
+  opts.set_rel_tol(opts.rel_tol() * 1e-6);
+  H = HSSMatrix<double>(A, opts);
+  H.factor();
+  cout << "# rank(H) = " << H.rank() << endl;
+  if (H.rank() == rank || H.factor_id() == id) {
+    cout << "ERROR: recompression did not change the HSS matrix!!" << endl;
+    return 1;
+  }
+  if (check_solves(H, w)) return 1;
+  cout << "# exiting" << endl;
+  return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <stdexcept>
+using namespace std;
+
+#include "dense/DenseMatrix.hpp"
+#include "BLR/BLRMatrix.hpp"
+#include "BLR/MBLRTile.hpp"
+#include "structured/ClusterTree.hpp"
+using namespace strumpack;
+using namespace strumpack::BLR;
+
+#define ERROR_TOLERANCE 1e2
+
+/**
+ * Check that the diagonal tiles of B which are large enough are
+ * MBLRTiles, and that their nested BLR matrices are themselves
+ * nested, down to a single level. Returns the number of nested
+ * tiles, on all levels, or -1 if a tile is not nested as it should.
+ */
+int check_nested(const BLRMatrix<double>& B, const BLROptions<double>& opts) {
+  int nested = 0;
+  for (std::size_t i=0; i<B.rowblocks(); i++) {
+    auto t = dynamic_cast<const MBLRTile<double>*>(&B.tile(i, i));
+    if (MBLRTile<double>::is_nested(B.tilerows(i), opts) != bool(t))
+      return -1;
+    if (!t) continue;
+    auto nopts = opts;
+    nopts.set_MBLR_levels(opts.MBLR_levels()-1);
+    auto n = check_nested(t->BLR(), nopts);
+    if (n < 0) return -1;
+    nested += 1 + n;
+  }
+  return nested;
+}
+
+/**
+ * Compress and factor a Toeplitz matrix as a BLRMatrix with
+ * MBLR_levels() levels, check the nesting of the diagonal tiles,
+ * the accuracy of the solve, and that the operations which do not
+ * apply to a factored diagonal tile throw.
+ */
+int test_MBLR(int m, int levels, int argc, char* argv[]) {
+  BLROptions<double> opts;
+  opts.set_verbose(false);
+  opts.set_rel_tol(1e-6);
+  opts.set_leaf_size(16);
+  opts.set_from_command_line(argc, argv);
+  opts.set_MBLR_levels(levels);
+  DenseMatrix<double> A(m, m);
+  for (int j=0; j<m; j++)
+    for (int i=0; i<m; i++)
+      A(i,j) = (i==j) ? 1. : 1./(1+abs(i-j));
+  auto tiles = structured::ClusterTree(m).refine
+    (opts.MBLR_leaf_size()).template leaf_sizes<std::size_t>();
+  std::size_t nt = tiles.size();
+  DenseMatrix<bool> adm(nt, nt);
+  adm.fill(true);
+  for (std::size_t t=0; t<nt; t++)
+    adm(t, t) = false;
+  DenseMatrix<double> Y(m, 10), X(m, 10);
+  X.random();
+  gemm(Trans::N, Trans::N, 1., A, X, 0., Y);
+  BLRMatrix<double> B(m, tiles, m, tiles);
+  B.compress_and_factor(A, adm, opts);
+  auto nested = check_nested(B, opts);
+  cout << "# " << levels << " levels, outer tile size "
+       << opts.MBLR_leaf_size() << ": " << nested << " nested tiles, "
+       << "memory " << 100. * B.memory() / A.memory() << "% of dense"
+       << endl;
+  if (nested < 0 || (levels > 1 && nested < levels - 1)) {
+    cout << "ERROR: diagonal tiles are not nested!" << endl;
+    return 1;
+  }
+  B.solve(Y);
+  auto Xnorm = X.normF();
+  X.scaled_add(-1., Y);
+  auto err = X.normF() / Xnorm;
+  cout << "# relative error = ||X-B\\(A*X)||_F/||X||_F = " << err << endl;
+  if (err > ERROR_TOLERANCE * max(opts.rel_tol(), opts.abs_tol())) {
+    cout << "ERROR: MBLR solve error too big!" << endl;
+    return 1;
+  }
+  if (nested) {
+    auto& t = B.tile(0, 0);
+    try {
+      t.laswp(std::vector<int>(t.rows(), 1), true);
+      cout << "ERROR: laswp on an MBLRTile did not throw!" << endl;
+      return 1;
+    } catch (std::logic_error&) { }
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  int m = 1000;
+  if (argc > 1) m = stoi(argv[1]);
+  if (argc <= 1 || m < 0) {
+    cout << "# Usage:\n"
+         << "#     ./test_MBLR_seq m [BLR Options]\n";
+    return 1;
+  }
+  int ierr = 0;
+  for (int levels : {1, 2, 3})
+    ierr += test_MBLR(m, levels, argc, argv);
+  return ierr ? 1 : 0;
+}
@@ -0,0 +1,161 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e2
+
+/**
+ * Compute the Schur complement S = A_II - A_IR A_RR^{-1} A_RI on a
+ * set of interface unknowns I with
+ * StrumpackSparseSolver::Schur_complement, and compare it with a
+ * dense computation. Also check that a solve after computing S is
+ * correct, and that the matching is refused with an interface.
+ */
+template<typename scalar_t,typename integer_t> int
+test_Schur(int argc, const char* const argv[],
+           const CSRMatrix<scalar_t,integer_t>& A) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  using DenseM_t = DenseMatrix<scalar_t>;
+  integer_t N = A.size(), nI = std::min(N, integer_t(20));
+  vector<integer_t> I(nI);
+  for (integer_t k=0; k<nI; k++) I[k] = (N-1) - k * (N / nI);
+
+  StrumpackSparseSolver<scalar_t,integer_t> sps;
+  sps.options().set_from_command_line(argc, argv);
+  sps.options().set_verbose(false);
+  sps.set_matrix(A);
+
+  // the matching would permute the interface columns
+  sps.options().set_matching(MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING);
+  if (sps.set_interface(I) != ReturnCode::REORDERING_ERROR) {
+    cout << "MATCHING SHOULD NOT BE ALLOWED WITH AN INTERFACE!" << endl;
+    return 1;
+  }
+  sps.options().set_matching(MatchingJob::NONE);
+  DenseM_t S;
+  if (sps.set_interface(I) != ReturnCode::SUCCESS ||
+      sps.Schur_complement(S) != ReturnCode::SUCCESS) {
+    cout << "problem computing the Schur complement." << endl;
+    return 1;
+  }
+
+  // dense reference
+  vector<integer_t> R, pos(N, -1);
+  for (integer_t k=0; k<nI; k++) pos[I[k]] = k;
+  for (integer_t i=0; i<N; i++)
+    if (pos[i] < 0) { pos[i] = R.size(); R.push_back(i); }
+  integer_t nR = R.size();
+  DenseM_t ARR(nR, nR), ARI(nR, nI), AIR(nI, nR), Sref(nI, nI);
+  ARR.zero(); ARI.zero(); AIR.zero(); Sref.zero();
+  std::vector<bool> inI(N, false);
+  for (auto i : I) inI[i] = true;
+  for (integer_t r=0; r<N; r++)
+    for (integer_t j=A.ptr(r); j<A.ptr(r+1); j++) {
+      auto c = A.ind(j);
+      auto v = A.val(j);
+      if (inI[r]) {
+        if (inI[c]) Sref(pos[r], pos[c]) = v;
+        else AIR(pos[r], pos[c]) = v;
+      } else {
+        if (inI[c]) ARI(pos[r], pos[c]) = v;
+        else ARR(pos[r], pos[c]) = v;
+      }
+    }
+  std::vector<int> piv;
+  ARR.LU(piv);
+  auto X = ARR.solve(ARI, piv);
+  gemm(Trans::N, Trans::N, scalar_t(-1.), AIR, X, scalar_t(1.), Sref);
+  DenseM_t dS(S);
+  dS.scaled_add(scalar_t(-1.), Sref);
+  auto eS = dS.normF() / Sref.normF();
+  // with compression, S is only as accurate as the compressed fronts
+  auto tol = sps.options().compression() == CompressionType::NONE ?
+    ERROR_TOLERANCE*sps.options().rel_tol() : real_t(1e-2);
+  cout << "# SCHUR COMPLEMENT ERROR = " << eS << endl;
+  if (eS > tol) {
+    cout << "SCHUR COMPLEMENT ERROR TOO LARGE!" << endl;
+    return 1;
+  }
+
+  // a solve after the Schur complement refactors the matrix: check
+  // that S * z_I = y, with z the solution of A z = [0; y]
+  DenseM_t y(nI, 1), zI(nI, 1), Sz(nI, 1);
+  y.random();
+  vector<scalar_t> e(N, scalar_t(0.)), z(N);
+  for (integer_t k=0; k<nI; k++) e[I[k]] = y(k, 0);
+  sps.solve(e.data(), z.data());
+  for (integer_t k=0; k<nI; k++) zI(k, 0) = z[I[k]];
+  gemm(Trans::N, Trans::N, scalar_t(1.), S, zI, scalar_t(0.), Sz);
+  Sz.scaled_add(scalar_t(-1.), y);
+  cout << "# SCHUR COMPLEMENT SOLVE ERROR = "
+       << Sz.normF() / y.normF() << endl;
+  if (Sz.normF() / y.normF() > tol) {
+    cout << "SCHUR COMPLEMENT SOLVE ERROR TOO LARGE!" << endl;
+    return 1;
+  }
+
+  // enabling the matching after set_interface is also refused
+  StrumpackSparseSolver<scalar_t,integer_t> sps2;
+  sps2.options().set_verbose(false);
+  sps2.options().set_matching(MatchingJob::NONE);
+  sps2.set_matrix(A);
+  sps2.set_interface(I);
+  sps2.options().set_matching(MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING);
+  if (sps2.Schur_complement(S) != ReturnCode::REORDERING_ERROR) {
+    cout << "MATCHING SHOULD NOT BE ALLOWED WITH AN INTERFACE!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout << "Compute a Schur complement of a sparse matrix.\n\n"
+         << "Usage: \n\t./test_Schur_complement_seq pde900.mtx" << endl;
+    return 1;
+  }
+  CSRMatrix<double,int> A;
+  if (A.read_matrix_market(argv[1])) {
+    cerr << "Could not read matrix from file." << endl;
+    return 1;
+  }
+  int ierr = test_Schur(argc, argv, A);
+  if (ierr) return ierr;
+  CSRMatrix<double,long long int> Al;
+  Al.read_matrix_market(argv[1]);
+  return test_Schur(argc, argv, Al);
+}
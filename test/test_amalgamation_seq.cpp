@@ -0,0 +1,174 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+#include "StrumpackParameters.hpp"
+#include "sparse/CSRMatrix.hpp"
+#include "sparse/SeparatorTree.hpp"
+#include "sparse/ordering/minimum_degree/AMDReordering.hpp"
+
+using namespace strumpack;
+
+/**
+ * Number of entries in all fronts of the separator tree, with
+ * d_s*d_s + 2*d_s*d_u entries for a front with separator size d_s
+ * and update size d_u. The update sets are computed with a symbolic
+ * factorization, independent of the one in relaxed_amalgamation.
+ */
+template<typename integer_t> long long
+front_entries(const SeparatorTree<integer_t>& tree,
+              const integer_t* ptr, const integer_t* ind,
+              const vector<integer_t>& perm,
+              const vector<integer_t>& iperm) {
+  integer_t ns = tree.separators();
+  vector<vector<integer_t>> upd(ns);
+  long long entries = 0;
+  // children always have a smaller number than their parent
+  for (integer_t s=0; s<ns; s++) {
+    auto lo = tree.sizes[s], hi = tree.sizes[s+1];
+    vector<integer_t> u;
+    for (integer_t r=lo; r<hi; r++)
+      for (integer_t j=ptr[iperm[r]]; j<ptr[iperm[r]+1]; j++)
+        if (perm[ind[j]] >= hi) u.push_back(perm[ind[j]]);
+    for (auto c : {tree.lch[s], tree.rch[s]}) {
+      if (c == -1) continue;
+      for (auto i : upd[c]) if (i >= hi) u.push_back(i);
+      upd[c] = vector<integer_t>();
+    }
+    sort(u.begin(), u.end());
+    u.erase(unique(u.begin(), u.end()), u.end());
+    long long ds = hi - lo, du = u.size();
+    entries += ds*ds + 2*ds*du;
+    upd[s] = std::move(u);
+  }
+  return entries;
+}
+
+/**
+ * Number of non-empty separators, the binary tree can also contain
+ * empty separators, added when a node in the elimination tree has
+ * more than 2 children.
+ */
+template<typename integer_t> integer_t
+nonempty_separators(const SeparatorTree<integer_t>& tree) {
+  integer_t ns = 0;
+  for (integer_t s=0; s<tree.separators(); s++)
+    if (tree.sizes[s+1] > tree.sizes[s]) ns++;
+  return ns;
+}
+
+/**
+ * Check that tree is a valid separator tree for perm/iperm: perm is
+ * a permutation with inverse iperm, the separators cover 0..n, every
+ * node has 0 or 2 children, the children come before their parent
+ * and a single root is reachable from all nodes.
+ */
+template<typename integer_t> bool
+valid_tree(const SeparatorTree<integer_t>& tree, integer_t n,
+           const vector<integer_t>& perm, const vector<integer_t>& iperm) {
+  for (integer_t i=0; i<n; i++)
+    if (perm[i] < 0 || perm[i] >= n || iperm[perm[i]] != i) return false;
+  integer_t ns = tree.separators(), roots = 0;
+  if (tree.sizes[0] != 0 || tree.sizes[ns] != n) return false;
+  for (integer_t s=0; s<ns; s++) {
+    if (tree.sizes[s+1] < tree.sizes[s]) return false;
+    if ((tree.lch[s] == -1) != (tree.rch[s] == -1)) return false;
+    for (auto c : {tree.lch[s], tree.rch[s]})
+      if (c != -1 && (c >= s || tree.parent[c] != s)) return false;
+    if (tree.parent[s] == -1) roots++;
+    else if (tree.parent[s] <= s) return false;
+  }
+  return roots == 1;
+}
+
+template<typename integer_t>
+int test_amalgamation(const CSRMatrix<double,integer_t>& A) {
+  integer_t n = A.size();
+  vector<integer_t> perm0(n), iperm0(n);
+  auto tree0 = ordering::amd_reordering(A, perm0, iperm0);
+  auto ns0 = nonempty_separators(tree0);
+  auto fill0 = front_entries(tree0, A.ptr(), A.ind(), perm0, iperm0);
+  if (!valid_tree(tree0, n, perm0, iperm0)) {
+    cout << "AMD SEPARATOR TREE IS NOT VALID" << endl;
+    return 1;
+  }
+  integer_t ns_prev = ns0;
+  for (double tol : {0., 0.1, 0.3, 1.}) {
+    auto perm = perm0, iperm = iperm0;
+    long long before, after;
+    auto tree = relaxed_amalgamation
+      (tree0, A.ptr(), A.ind(), perm, iperm, tol, before, after);
+    auto fill = front_entries(tree, A.ptr(), A.ind(), perm, iperm);
+    cout << "# fill_tol = " << tol << ": non-empty separators " << ns0
+         << " -> " << nonempty_separators(tree) << ", front entries "
+         << before << " -> " << after << " (recomputed "
+         << fill0 << " -> " << fill << ")" << endl;
+    if (!valid_tree(tree, n, perm, iperm)) {
+      cout << "AMALGAMATED SEPARATOR TREE IS NOT VALID" << endl;
+      return 1;
+    }
+    if (before != fill0 || after != fill) {
+      cout << "FILL ESTIMATE DOES NOT MATCH THE SYMBOLIC FACTORIZATION"
+           << endl;
+      return 1;
+    }
+    auto ns = nonempty_separators(tree);
+    if (ns > ns_prev || (tol > 0 && ns >= ns0)) {
+      cout << "NUMBER OF SEPARATORS DID NOT DROP" << endl;
+      return 1;
+    }
+    if (fill < fill0 || fill - fill0 > tol * fill) {
+      cout << "FILL IS NOT WITHIN fill_tol" << endl;
+      return 1;
+    }
+    ns_prev = ns;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  cout << "# Running with:\n# ";
+  for (int i=0; i<argc; i++)
+    cout << argv[i] << " ";
+  cout << endl;
+  if (argc < 2) {
+    cout << "Test relaxed amalgamation of the AMD separator tree.\n\n"
+         << "Usage: \n\t./test_amalgamation_seq pde900.mtx" << std::endl;
+    return 1;
+  }
+  CSRMatrix<double,int> A;
+  if (A.read_matrix_market(argv[1])) {
+    cerr << "Could not read matrix from file." << endl;
+    return 1;
+  }
+  return test_amalgamation(A);
+}
@@ -0,0 +1,134 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cstring>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+/**
+ * Factor with the front assembly maps, update the matrix values
+ * (same sparsity pattern) and refactor, so the fronts are assembled
+ * by scattering the new values through the maps. Check that the maps
+ * were used, and that the solution is bit for bit the same as with a
+ * fresh factorization of the new matrix without the maps. Should be
+ * run with a single thread, so that the floating point operations
+ * are done in the same order.
+ */
+template<typename scalar_t,typename integer_t> int
+test_assembly_maps(int argc, const char* const argv[],
+                   const CSRMatrix<scalar_t,integer_t>& A,
+                   CompressionType front_compression) {
+  integer_t N = A.size();
+  // new values: the off-diagonal entries are scaled by a random
+  // factor in [0.8,1]
+  auto A2 = A;
+  {
+    mt19937 gen(1234);
+    uniform_real_distribution<double> u(0.8, 1.);
+    auto ptr = A2.ptr();
+    auto ind = A2.ind();
+    auto val = A2.val();
+    for (integer_t i=0; i<N; i++)
+      for (integer_t k=ptr[i]; k<ptr[i+1]; k++)
+        if (ind[k] != i) val[k] *= scalar_t(u(gen));
+  }
+  vector<scalar_t> b(N, scalar_t(1.)), x(N), x2(N);
+  auto set_options = [&](SPOptions<scalar_t>& opts, bool maps) {
+    opts.set_from_command_line(argc, argv);
+    opts.set_verbose(false);
+    opts.set_Krylov_solver(KrylovSolver::DIRECT);
+    opts.set_compression(front_compression);
+    opts.set_compression_min_sep_size(10);
+    if (maps) opts.enable_assembly_maps();
+    else opts.disable_assembly_maps();
+  };
+  StrumpackSparseSolver<scalar_t,integer_t> sps;
+  set_options(sps.options(), true);
+  sps.set_matrix(A);
+  if (sps.factor() != ReturnCode::SUCCESS) {
+    cout << "problem with the factorization." << endl;
+    return 1;
+  }
+  sps.update_matrix_values(A2);
+  if (sps.factor() != ReturnCode::SUCCESS ||
+      sps.solve(b.data(), x.data()) != ReturnCode::SUCCESS) {
+    cout << "problem with the refactorization or solve." << endl;
+    return 1;
+  }
+  auto map_fronts = params::assembly_map_fronts.load();
+  {
+    StrumpackSparseSolver<scalar_t,integer_t> fresh;
+    set_options(fresh.options(), false);
+    fresh.set_matrix(A2);
+    if (fresh.factor() != ReturnCode::SUCCESS ||
+        fresh.solve(b.data(), x2.data()) != ReturnCode::SUCCESS) {
+      cout << "problem with the fresh factorization or solve." << endl;
+      return 1;
+    }
+    if (params::assembly_map_fronts) {
+      cout << "ASSEMBLY MAPS USED WHILE DISABLED!" << endl;
+      return 1;
+    }
+  }
+  cout << "# " << get_name(front_compression) << " fronts, "
+       << map_fronts << " fronts assembled with the maps" << endl;
+  if (!map_fronts) {
+    cout << "THE ASSEMBLY MAPS WERE NOT USED!" << endl;
+    return 1;
+  }
+  if (std::memcmp(x.data(), x2.data(), N*sizeof(scalar_t))) {
+    cout << "REFACTORIZATION WITH THE ASSEMBLY MAPS DIFFERS FROM "
+         << "A FRESH FACTORIZATION!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout << "Refactor through the front assembly maps."
+         << "\n\nUsage: \n\t./test_assembly_maps_seq pde900.mtx" << endl;
+    return 1;
+  }
+  CSRMatrix<double,int> A;
+  if (A.read_matrix_market(argv[1])) {
+    cerr << "Could not read matrix from file." << endl;
+    return 1;
+  }
+  int ierr = 0;
+  for (auto c : {CompressionType::NONE, CompressionType::BLR})
+    ierr += test_assembly_maps(argc, argv, A, c);
+  return ierr ? 1 : 0;
+}
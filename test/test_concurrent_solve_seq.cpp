@@ -0,0 +1,143 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <random>
+#include <set>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+/**
+ * Factor once, then solve concurrently from all threads of an OpenMP
+ * parallel region, each thread with its own SolveContext and its
+ * own right-hand sides, both with the single vector and with the
+ * multiple right-hand side solve. Every solution is compared with
+ * the solution computed beforehand, sequentially, with the
+ * (non-const) solve. Should be run with more than one thread.
+ */
+template<typename scalar_t,typename integer_t> int
+test_concurrent_solve(int argc, const char* const argv[],
+                      const CSRMatrix<scalar_t,integer_t>& A,
+                      CompressionType compression) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  integer_t N = A.size();
+  int nrhs = 3, nsolves = 8;
+  StrumpackSparseSolver<scalar_t,integer_t> sps;
+  sps.options().set_from_command_line(argc, argv);
+  sps.options().set_verbose(false);
+  sps.options().set_compression(compression);
+  sps.options().set_compression_min_sep_size(10);
+  sps.set_matrix(A);
+  if (sps.factor() != ReturnCode::SUCCESS) {
+    cout << "problem with the factorization." << endl;
+    return 1;
+  }
+  // right-hand sides and reference solutions, with all nrhs columns,
+  // and with only the first column (with a Krylov solver, the
+  // iterates for a single vector differ from those for a block)
+  vector<DenseMatrix<scalar_t>> B(nsolves), X(nsolves), X1(nsolves);
+  for (int s=0; s<nsolves; s++) {
+    B[s] = DenseMatrix<scalar_t>(N, nrhs);
+    X[s] = DenseMatrix<scalar_t>(N, nrhs);
+    X1[s] = DenseMatrix<scalar_t>(N, 1);
+    B[s].random();
+    if (sps.solve(B[s], X[s]) != ReturnCode::SUCCESS ||
+        sps.solve(B[s].data(), X1[s].data()) != ReturnCode::SUCCESS) {
+      cout << "problem with the solve." << endl;
+      return 1;
+    }
+  }
+  auto differs = [&](const DenseMatrix<scalar_t>& x,
+                     const DenseMatrix<scalar_t>& xref) {
+    auto d = x;
+    d.scaled_add(scalar_t(-1.), xref);
+    return d.normF() > real_t(1e-10) * xref.normF();
+  };
+  int failed = 0, team = 1;
+  set<int> threads;
+#pragma omp parallel reduction(+:failed)
+  {
+#if defined(_OPENMP)
+#pragma omp single
+    team = omp_get_num_threads();
+#endif
+    SolveContext<scalar_t> ctx;
+#pragma omp for schedule(static,1)
+    for (int s=0; s<nsolves; s++) {
+#if defined(_OPENMP)
+#pragma omp critical
+      threads.insert(omp_get_thread_num());
+#endif
+      DenseMatrix<scalar_t> x(N, nrhs), x1(N, 1);
+      if (sps.solve(B[s], x, ctx) != ReturnCode::SUCCESS ||
+          differs(x, X[s]))
+        failed++;
+      if (sps.solve(B[s].data(), x1.data(), ctx) != ReturnCode::SUCCESS ||
+          differs(x1, X1[s]))
+        failed++;
+    }
+  }
+  cout << "# " << get_name(compression) << " fronts, " << nsolves
+       << " concurrent solves on " << threads.size() << " of "
+       << team << " threads" << endl;
+#if defined(_OPENMP)
+  if (omp_get_max_threads() > 1 && threads.size() < 2) {
+    cout << "SOLVES DID NOT RUN CONCURRENTLY!" << endl;
+    return 1;
+  }
+#endif
+  if (failed) {
+    cout << "CONCURRENT SOLVE FAILED!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout << "Solve concurrently with a single factorization."
+         << "\n\nUsage: \n\tOMP_NUM_THREADS=4 ./test_concurrent_solve_seq "
+         << "pde900.mtx" << endl;
+    return 1;
+  }
+  CSRMatrix<double,int> A;
+  if (A.read_matrix_market(argv[1])) {
+    cerr << "Could not read matrix from file." << endl;
+    return 1;
+  }
+  int ierr = 0;
+  for (auto c : {CompressionType::NONE, CompressionType::BLR,
+        CompressionType::HSS})
+    ierr += test_concurrent_solve(argc, argv, A, c);
+  return ierr ? 1 : 0;
+}
@@ -0,0 +1,220 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <random>
+#include <complex>
+#include <algorithm>
+using namespace std;
+
+#include "dense/DistributedMatrix.hpp"
+
+using namespace strumpack;
+
+/**
+ * Collect a distributed matrix, and the global pivot vector from the
+ * local (ScaLAPACK format) pivot vector, on all processes.
+ */
+template<typename scalar_t> void
+collect(const DistributedMatrix<scalar_t>& F, const std::vector<int>& piv,
+        const MPIComm& comm, DenseMatrix<scalar_t>& Fg,
+        std::vector<int>& pg) {
+  int n = F.rows();
+  Fg = DenseMatrix<scalar_t>(n, n);
+  Fg.zero();
+  pg.assign(n, 0);
+  if (F.active()) {
+    for (int j=0; j<F.lcols(); j++)
+      for (int i=0; i<F.lrows(); i++)
+        Fg(F.rowl2g(i), F.coll2g(j)) = F(i, j);
+    for (int i=0; i<F.lrows(); i++)
+      pg[F.rowl2g(i)] = piv[i];
+  }
+  comm.all_reduce(Fg.data(), n*n, MPI_SUM);
+  comm.all_reduce(pg, MPI_MAX);
+}
+
+/**
+ * Compare DistributedMatrix::LU, which uses LU_tiled here, with
+ * ScaLAPACK pgetrf (DistributedMatrix::LU_scalapack). With a single process row, the tournament
+ * pivoting reduces to partial pivoting, so the pivots must be the
+ * same, and the factors the same up to rounding. With more process
+ * rows the pivots differ, and both factorizations are checked for
+ * ||PA - LU|| / ||A||, and for the solution of a linear system.
+ */
+template<typename scalar_t> int
+test_LU_tiled(const BLACSGrid& grid, int n, int nb) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  auto& comm = grid.Comm();
+  std::mt19937 gen(n);
+  std::uniform_real_distribution<real_t> u(-1., 1.);
+  DenseMatrix<scalar_t> Ad(n, n), bd(n, 1);
+  for (int j=0; j<n; j++)
+    for (int i=0; i<n; i++)
+      Ad(i, j) = scalar_t(u(gen));
+  for (int i=0; i<n; i++) bd(i, 0) = scalar_t(u(gen));
+  DistributedMatrix<scalar_t> A(&grid, n, n, nb, nb), b(&grid, n, 1, nb, nb);
+  A.fill([&](std::size_t i, std::size_t j) { return Ad(i, j); });
+  b.fill([&](std::size_t i, std::size_t j) { return bd(i, j); });
+
+  DistributedMatrix<scalar_t> Fs(A), Ft(A), Fd(A);
+  std::vector<int> ps, pt, pd;
+  int is = Fs.LU_scalapack(ps), it = Ft.LU_tiled(pt), id = Fd.LU(pd);
+  is = comm.all_reduce(is, MPI_MAX);
+  it = comm.all_reduce(it, MPI_MAX);
+  id = comm.all_reduce(id, MPI_MAX);
+  if (is || it || id) {
+    if (!comm.rank())
+      cout << "LU FAILED, info = " << is << ", " << it
+           << ", " << id << endl;
+    return 1;
+  }
+  // LU should dispatch to LU_tiled, which is deterministic
+  int dispatch = pd != pt;
+  for (int j=0; j<Ft.lcols(); j++)
+    for (int i=0; i<Ft.lrows(); i++)
+      if (Fd(i, j) != Ft(i, j)) dispatch = 1;
+  dispatch = comm.all_reduce(dispatch, MPI_MAX);
+  if (dispatch) {
+    if (!comm.rank())
+      cout << "DistributedMatrix::LU DID NOT USE LU_tiled" << endl;
+    return 1;
+  }
+  DenseMatrix<scalar_t> Fsg, Ftg;
+  std::vector<int> psg, ptg;
+  collect(Fs, ps, comm, Fsg, psg);
+  collect(Ft, pt, comm, Ftg, ptg);
+
+  // relative error ||P A - L U||_F / ||A||_F
+  auto LU_error = [&](const DenseMatrix<scalar_t>& F,
+                      const std::vector<int>& piv) {
+    DenseMatrix<scalar_t> L(n, n), U(n, n), PA(Ad);
+    L.zero();
+    U.zero();
+    for (int j=0; j<n; j++) {
+      for (int i=0; i<=j; i++) U(i, j) = F(i, j);
+      L(j, j) = scalar_t(1.);
+      for (int i=j+1; i<n; i++) L(i, j) = F(i, j);
+    }
+    PA.laswp(piv, true);
+    gemm(Trans::N, Trans::N, scalar_t(-1.), L, U, scalar_t(1.), PA);
+    return PA.normF() / Ad.normF();
+  };
+  auto es = LU_error(Fsg, psg), et = LU_error(Ftg, ptg);
+  int diff = 0;
+  for (int i=0; i<n; i++)
+    if (psg[i] != ptg[i]) diff++;
+  DenseMatrix<scalar_t> dF(Ftg);
+  dF.scaled_add(scalar_t(-1.), Fsg);
+  auto ef = dF.normF() / Fsg.normF();
+
+  auto xs = Fs.solve(b, ps), xt = Ft.solve(b, pt);
+  xt.scaled_add(scalar_t(-1.), xs);
+  auto ex = xt.normF() / xs.normF();
+
+  auto eps = blas::lamch<real_t>('E');
+  bool ok = et <= 100 * std::max(es, real_t(n) * eps) &&
+    ex <= real_t(1e4) * n * eps;
+  if (grid.nprows() == 1)
+    ok = ok && !diff && ef <= real_t(1e3) * n * eps;
+  if (!comm.rank())
+    cout << "# " << grid.nprows() << "x" << grid.npcols() << " grid, n = "
+         << n << ", nb = " << nb << ", pivots different from pgetrf = "
+         << diff << endl
+         << "#   ||PA-LU||/||A||: pgetrf = " << es << ", tiled = " << et
+         << ", ||F_tiled-F_pgetrf||/||F_pgetrf|| = " << ef
+         << ", ||x_tiled-x_pgetrf||/||x_pgetrf|| = " << ex << endl;
+  if (!ok && !comm.rank())
+    cout << "DISTRIBUTED TILED LU DOES NOT MATCH PGETRF" << endl;
+  // the norms are not available on ranks which are idle in the grid
+  int err = ok ? 0 : 1;
+  comm.broadcast(err);
+  return err;
+}
+
+/**
+ * With MB != NB, LU_tiled does not apply, and LU should fall back to
+ * pgetrf.
+ */
+template<typename scalar_t> int
+test_LU_fallback(const BLACSGrid& grid, int n) {
+  auto& comm = grid.Comm();
+  std::mt19937 gen(n);
+  std::uniform_real_distribution<double> u(-1., 1.);
+  DistributedMatrix<scalar_t> A(&grid, n, n, 16, 8);
+  A.fill([&](std::size_t, std::size_t) { return scalar_t(u(gen)); });
+  DistributedMatrix<scalar_t> Fs(A), Fd(A);
+  std::vector<int> ps, pd;
+  Fs.LU_scalapack(ps);
+  Fd.LU(pd);
+  int diff = ps != pd;
+  for (int j=0; j<Fs.lcols(); j++)
+    for (int i=0; i<Fs.lrows(); i++)
+      if (Fd(i, j) != Fs(i, j)) diff = 1;
+  diff = comm.all_reduce(diff, MPI_MAX);
+  if (diff && !comm.rank())
+    cout << "DistributedMatrix::LU DID NOT FALL BACK TO PGETRF" << endl;
+  return diff;
+}
+
+/**
+ * The row and column communicators used by LU_tiled are created
+ * once per grid.
+ */
+int test_grid_comms(const BLACSGrid& grid) {
+  if (!grid.active()) return 0;
+  auto& r = grid.row_comm();
+  auto& c = grid.col_comm();
+  int err = &r != &grid.row_comm() || &c != &grid.col_comm() ||
+    r.size() != grid.npcols() || c.size() != grid.nprows() ||
+    r.rank() != grid.pcol() || c.rank() != grid.prow();
+  err = grid.Comm_active().all_reduce(err, MPI_MAX);
+  if (err && !grid.Comm().rank())
+    cout << "WRONG BLACSGrid ROW/COLUMN COMMUNICATORS" << endl;
+  return err;
+}
+
+int main(int argc, char* argv[]) {
+  MPI_Init(&argc, &argv);
+  int ierr = 0;
+  {
+    BLACSGrid grid(MPI_COMM_WORLD);
+    ierr += test_grid_comms(grid);
+    ierr += test_LU_fallback<double>(grid, 100);
+    // a size which is a multiple of the block size, and one which
+    // is not
+    for (int n : {320, 301}) {
+      ierr += test_LU_tiled<double>(grid, n, 16);
+      ierr += test_LU_tiled<std::complex<double>>(grid, n, 16);
+    }
+  }
+  scalapack::Cblacs_exit(1);
+  MPI_Finalize();
+  return ierr ? 1 : 0;
+}
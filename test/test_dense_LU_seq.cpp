@@ -0,0 +1,124 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <random>
+#include <complex>
+#include <algorithm>
+using namespace std;
+
+#include "StrumpackConfig.hpp"
+#include "StrumpackParameters.hpp"
+#include "dense/DenseMatrix.hpp"
+
+using namespace strumpack;
+
+/**
+ * Compare the tiled LU with tournament pivoting, DenseMatrix::LU_tiled,
+ * to the partial pivoting LU, DenseMatrix::LU (getrf). The matrix has
+ * at least 2*nb*threads rows, so that the row blocks of the panels
+ * are split over all threads and the pivots are selected with a
+ * reduction tree. The pivots differ in general, so this checks that
+ * both give P*L*U = A to about the same accuracy, and the same
+ * solution of a linear system.
+ */
+template<typename scalar_t> int test_LU_tiled(int n, int nb) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  DenseMatrix<scalar_t> A(n, n), b(n, 1);
+  mt19937 gen(n);
+  uniform_real_distribution<real_t> u(-1., 1.);
+  for (int j=0; j<n; j++)
+    for (int i=0; i<n; i++)
+      A(i, j) = scalar_t(u(gen));
+  for (int i=0; i<n; i++) b(i, 0) = scalar_t(u(gen));
+
+  // relative error ||P A - L U||_F / ||A||_F
+  auto LU_error = [&](const DenseMatrix<scalar_t>& F,
+                      const std::vector<int>& piv) {
+    DenseMatrix<scalar_t> L(n, n), U(n, n), PA(A);
+    L.zero();
+    U.zero();
+    for (int j=0; j<n; j++) {
+      for (int i=0; i<=j; i++) U(i, j) = F(i, j);
+      L(j, j) = scalar_t(1.);
+      for (int i=j+1; i<n; i++) L(i, j) = F(i, j);
+    }
+    PA.laswp(piv, true);
+    gemm(Trans::N, Trans::N, scalar_t(-1.), L, U, scalar_t(1.), PA);
+    return PA.normF() / A.normF();
+  };
+
+  DenseMatrix<scalar_t> Fg(A), Ft(A);
+  std::vector<int> pg, pt;
+  int ig = Fg.LU(pg), it = 0;
+#pragma omp parallel
+#pragma omp single nowait
+  it = Ft.LU_tiled(pt, nb);
+  if (ig || it) {
+    cout << "LU FAILED, info = " << ig << ", " << it << endl;
+    return 1;
+  }
+  int diff = 0;
+  for (int i=0; i<n; i++)
+    if (pg[i] != pt[i]) diff++;
+  auto eg = LU_error(Fg, pg), et = LU_error(Ft, pt);
+  auto xg = Fg.solve(b, pg), xt = Ft.solve(b, pt);
+  xt.scaled_add(scalar_t(-1.), xg);
+  auto ex = xt.normF() / xg.normF();
+  cout << "# n = " << n << ", nb = " << nb << ", threads = "
+       << params::num_threads << ", pivots different from getrf = "
+       << diff << endl
+       << "#   ||PA-LU||/||A||: getrf = " << eg << ", tiled = " << et
+       << ", ||x_tiled-x_getrf||/||x_getrf|| = " << ex << endl;
+  auto eps = blas::lamch<real_t>('E');
+  if (et > 100 * std::max(eg, real_t(n) * eps) ||
+      ex > real_t(1e4) * n * eps) {
+    cout << "TILED LU ERROR TOO LARGE" << endl;
+    return 1;
+  }
+#if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+  // with more than one thread, the pivots selected by the tournament
+  // differ from those of partial pivoting for a random matrix
+  if (params::num_threads > 1 && !diff) {
+    cout << "TOURNAMENT PIVOTING WAS NOT USED" << endl;
+    return 1;
+  }
+#endif
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  int ierr = 0, nb = 32, T = std::max(2, params::num_threads);
+  // m >= 2*nb*threads, and a size which is not a multiple of nb
+  for (int n : {4*nb*T, 2*nb*T+13}) {
+    ierr += test_LU_tiled<double>(n, nb);
+    ierr += test_LU_tiled<std::complex<double>>(n, nb);
+  }
+  return ierr ? 1 : 0;
+}
@@ -0,0 +1,141 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <string>
+#include <cstring>
+using namespace std;
+
+#include "StrumpackConfig.hpp"
+#include "sparse/fronts/LossyMatrix.hpp"
+
+using namespace strumpack;
+
+template<typename T> bool
+bit_equal(const DenseMatrix<T>& A, const DenseMatrix<T>& B) {
+  for (std::size_t j=0; j<A.cols(); j++)
+    if (std::memcmp(A.ptr(0, j), B.ptr(0, j), A.rows()*sizeof(T)))
+      return false;
+  return true;
+}
+
+/**
+ * Compress a matrix with a wide range of magnitudes, and check the
+ * error after decompression for each mode:
+ *  - accuracy mode (acc > 0): absolute error <= acc (ZFP and the
+ *    built-in codec), or <= acc times the value range of a panel
+ *    (SZ3),
+ *  - precision mode (acc <= 0, prec > 0), also with acc == 0: with
+ *    the built-in codec (also used with SZ3 in this mode) the
+ *    relative error of every entry is <= 2^-prec, with ZFP the error
+ *    is only checked to be small,
+ *  - lossless (acc <= 0, prec <= 0): exact, bit for bit.
+ * Both the full and the panel-wise decompression are checked.
+ */
+template<typename T> int
+test_lossy(std::size_t m, std::size_t n, int prec, double acc) {
+  DenseMatrix<T> A(m, n);
+  mt19937 gen(1357);
+  uniform_real_distribution<double> u(-1., 1.), e(-6., 2.);
+  for (std::size_t j=0; j<n; j++)
+    for (std::size_t i=0; i<m; i++)
+      A(i, j) = T(u(gen) * std::pow(10., e(gen)));
+  A(0, 0) = T(0.);
+  LossyMatrix<T> L(A, prec, acc);
+  auto B = L.decompress();
+  DenseMatrix<T> Bp(m, n);
+  for (std::size_t p=0; p<L.panels(); p++)
+    L.decompress_panel(p, Bp.ptr(0, L.panel_begin(p)), Bp.ld());
+  double abs_err = 0., rel_err = 0., range = 0., panel_diff = 0.;
+  for (std::size_t j=0; j<n; j++)
+    for (std::size_t i=0; i<m; i++) {
+      double a = A(i, j), d = std::abs(double(B(i, j)) - a);
+      abs_err = std::max(abs_err, d);
+      if (a != 0.) rel_err = std::max(rel_err, d / std::abs(a));
+      range = std::max(range, std::abs(a));
+      panel_diff = std::max(panel_diff, std::abs(double(B(i, j) - Bp(i, j))));
+    }
+  bool lossless = acc <= 0 && prec <= 0, ok = panel_diff == 0.;
+  double bound = 0.;
+  std::string mode;
+  if (acc > 0) {
+#if defined(STRUMPACK_USE_SZ3)
+    mode = "relative accuracy";
+    bound = acc * 2 * range;
+#else
+    mode = "accuracy";
+    bound = acc;
+#endif
+    ok = ok && abs_err <= bound;
+  } else if (lossless) {
+    mode = "lossless";
+    ok = ok && bit_equal(A, B);
+  } else {
+    mode = "precision";
+#if defined(STRUMPACK_USE_ZFP) && !defined(STRUMPACK_USE_SZ3)
+    // ZFP bit planes are relative to the largest value in a block
+    bound = std::pow(2., 2 - prec) * range;
+    ok = ok && abs_err <= bound;
+#else
+    bound = std::pow(2., -prec);
+    ok = ok && rel_err <= bound;
+#endif
+  }
+  cout << "# " << m << "x" << n << " " << (sizeof(T) == 4 ? "float" : "double")
+       << ", " << L.panels() << " panel(s), " << mode << " mode, prec = "
+       << prec << ", acc = " << acc << ": abs err = " << abs_err
+       << ", rel err = " << rel_err << ", bound = " << bound
+       << ", compression = " << double(L.compressed_size())
+    / (m * n * sizeof(T)) << endl;
+  if (!ok) cout << "LOSSY COMPRESSION ERROR TOO LARGE" << endl;
+  return ok ? 0 : 1;
+}
+
+template<typename T> int test_modes(std::size_t m, std::size_t n) {
+  int ierr = 0;
+  ierr += test_lossy<T>(m, n, 16, 1e-4);  // accuracy
+  ierr += test_lossy<T>(m, n, 16, 1e-9);  // accuracy
+  ierr += test_lossy<T>(m, n, 12, -1.);   // precision
+  ierr += test_lossy<T>(m, n, 12, 0.);    // precision, acc == 0
+  ierr += test_lossy<T>(m, n, 0, -1.);    // lossless
+  ierr += test_lossy<T>(m, n, 0, 0.);     // lossless, acc == 0
+  return ierr;
+}
+
+int main(int argc, char* argv[]) {
+  int ierr = 0;
+  // a single panel, and many panels
+  ierr += test_modes<double>(50, 70);
+  ierr += test_modes<double>(1500, 300);
+  ierr += test_modes<float>(50, 70);
+  ierr += test_modes<float>(3000, 150);
+  return ierr ? 1 : 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+#include "sparse/fronts/LossyMatrix.hpp"
+
+using namespace strumpack;
+
+/**
+ * Factor with lossless compressed fronts, for several widths of the
+ * compressed column panels, and solve, with 1 and with 3 right-hand
+ * sides. The solve decompresses the factors one panel at a time.
+ * Since the compression is lossless, the solution should match the
+ * solution with uncompressed fronts, which use the fully decoded
+ * factors, up to rounding. A width of 7 does not divide most
+ * separator sizes, so the last panel of a front is narrower. The
+ * factor memory includes a header per panel, so it should change
+ * with the panel width, which shows that the panels were used.
+ */
+template<typename scalar_t,typename integer_t> int
+test_lossy_solve(int argc, const char* const argv[],
+                 const CSRMatrix<scalar_t,integer_t>& A) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  integer_t N = A.size();
+  int nrhs = 3;
+  DenseMatrix<scalar_t> B(N, nrhs), Xref(N, nrhs), X1ref(N, 1);
+  B.random();
+  auto solve = [&](CompressionType c, int pcols, DenseMatrix<scalar_t>& X,
+                   DenseMatrix<scalar_t>& X1, long long& fnnz) {
+    StrumpackSparseSolver<scalar_t,integer_t> sps;
+    sps.options().set_from_command_line(argc, argv);
+    sps.options().set_verbose(false);
+    sps.options().set_Krylov_solver(KrylovSolver::DIRECT);
+    sps.options().set_compression(c);
+    sps.options().set_compression_min_sep_size(10);
+    sps.options().set_lossy_panel_cols(pcols);
+    sps.set_matrix(A);
+    if (sps.factor() != ReturnCode::SUCCESS) return false;
+    fnnz = sps.factor_nonzeros();
+    return sps.solve(B, X) == ReturnCode::SUCCESS &&
+      sps.solve(B.data(), X1.data()) == ReturnCode::SUCCESS;
+  };
+  auto differs = [](const DenseMatrix<scalar_t>& X,
+                    const DenseMatrix<scalar_t>& Xref) {
+    auto D = X;
+    D.scaled_add(scalar_t(-1.), Xref);
+    return D.normF() / Xref.normF();
+  };
+  long long fnnz_ref, fnnz_prev = -1;
+  if (!solve(CompressionType::NONE, 0, Xref, X1ref, fnnz_ref)) {
+    cout << "problem with the factorization or solve." << endl;
+    return 1;
+  }
+  for (int pcols : {1, 7, 0}) {
+    DenseMatrix<scalar_t> X(N, nrhs), X1(N, 1);
+    long long fnnz;
+    if (!solve(CompressionType::LOSSLESS, pcols, X, X1, fnnz)) {
+      cout << "problem with the lossless factorization or solve." << endl;
+      return 1;
+    }
+    auto d = differs(X, Xref), d1 = differs(X1, X1ref);
+    cout << "# panel width " << pcols << ": factor nonzeros "
+         << fnnz << " (uncompressed " << fnnz_ref << ")"
+         << ", difference with the full decode " << d
+         << ", single rhs " << d1 << endl;
+    if (d > real_t(1e3) * blas::lamch<real_t>('E') ||
+        d1 > real_t(1e3) * blas::lamch<real_t>('E')) {
+      cout << "PANEL-WISE SOLVE DIFFERS FROM THE FULL DECODE!" << endl;
+      return 1;
+    }
+    if (fnnz == fnnz_prev) {
+      cout << "THE PANEL WIDTH WAS NOT USED!" << endl;
+      return 1;
+    }
+    fnnz_prev = fnnz;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout << "Solve with panel-wise decompression of lossless fronts."
+         << "\n\nUsage: \n\t./test_lossy_solve_seq pde900.mtx" << endl;
+    return 1;
+  }
+  // the panels of a matrix with 30 columns
+  LossyMatrix<double> L(DenseMatrix<double>(50, 30), 0, 0., 7);
+  if (L.panels() != 5 || L.panel_end(4) != 30 || L.panel_begin(4) != 28) {
+    cout << "WRONG PANELS FOR A PANEL WIDTH OF 7!" << endl;
+    return 1;
+  }
+  CSRMatrix<double,int> A;
+  if (A.read_matrix_market(argv[1])) {
+    cerr << "Could not read matrix from file." << endl;
+    return 1;
+  }
+  int ierr = test_lossy_solve(argc, argv, A);
+  CSRMatrix<float,int> Af;
+  Af.read_matrix_market(argv[1]);
+  ierr += test_lossy_solve(argc, argv, Af);
+  return ierr ? 1 : 0;
+}
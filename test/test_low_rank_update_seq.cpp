@@ -0,0 +1,178 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <numeric>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e2
+
+/**
+ * Sparse low-rank updates of A, a few columns at a time, with a solve of
+ * (A + U V^T) X = B at the end. The updates are merged in the sparse
+ * matrix as soon as N r > factor_nonzeros(), with r the rank, if U
+ * and V together do not add more nonzeros than A has, and except with
+ * the geometric reordering or a user supplied permutation p. The rank
+ * at which this happens is computed from factor_nonzeros(), so it
+ * does not depend on the quality of the reordering.
+ */
+template<typename scalar_t,typename integer_t> int
+test_sparse_updates(int argc, const char* const argv[],
+                    const CSRMatrix<scalar_t,integer_t>& A,
+                    const DenseMatrix<scalar_t>& X, const int* p) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  integer_t N = A.size();
+  StrumpackSparseSolver<scalar_t,integer_t> sps;
+  sps.options().set_from_command_line(argc, argv);
+  sps.options().set_verbose(false);
+  auto tol = sps.options().compression() == CompressionType::NONE ?
+    ERROR_TOLERANCE*sps.options().rel_tol() : real_t(1e-2);
+  sps.set_matrix(A);
+  if ((p ? sps.reorder(p) : sps.reorder()) != ReturnCode::SUCCESS ||
+      sps.factor() != ReturnCode::SUCCESS) {
+    cout << "problem with the factorization of the matrix." << endl;
+    return 1;
+  }
+  // sparse updates of rank b, until the rank r is such that N r >
+  // factor_nonzeros, the rows of U, and of V, are all different
+  const integer_t b = 8;
+  integer_t kmax = b * (sps.factor_nonzeros() / (N * b) + 1);
+  bool merge = !p && sps.options().reordering_method() !=
+    ReorderingStrategy::GEOMETRIC && kmax * kmax <= A.nnz();
+  DenseMatrix<scalar_t> B(N, 1), U(N, b), V(N, b), Xlr(N, 1);
+  A.spmv(X, B);
+  for (integer_t k=0; k<kmax; k+=b) {
+    U.zero(); V.zero();
+    for (integer_t j=0; j<b; j++) {
+      integer_t i = ((k + j) * 7) % N, l = ((k + j) * 13 + 1) % N;
+      U(i, j) = scalar_t(.5);
+      V(l, j) = scalar_t(.5);
+      B(i, 0) += scalar_t(.25) * X(l, 0);
+    }
+    if (sps.add_low_rank_update(U, V) != ReturnCode::SUCCESS) {
+      cout << "problem with the low-rank update." << endl;
+      return 1;
+    }
+    auto r = (k + b < kmax) ? k + b : (merge ? 0 : kmax);
+    if (sps.low_rank_update_rank() != std::size_t(r)) {
+      cout << "LOW-RANK UPDATE OF RANK " << k + b << " "
+           << (r ? "" : "NOT ") << "MERGED IN THE SPARSE MATRIX!" << endl;
+      return 1;
+    }
+  }
+  cout << "# sparse low-rank update of rank " << kmax << ", "
+       << (merge ? "merged" : "not merged")
+       << (p ? ", user permutation" : "") << endl;
+  sps.solve(B, Xlr);
+  Xlr.scaled_add(scalar_t(-1.), X);
+  cout << "# SPARSE LOW-RANK UPDATE RELATIVE ERROR = "
+       << Xlr.normF() / X.normF() << endl;
+  if (Xlr.normF() / X.normF() > tol) {
+    cout << "SPARSE LOW-RANK UPDATE ERROR TOO LARGE!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Low-rank update A + U V^T, first a dense update which is handled
+ * with Sherman-Morrison-Woodbury, then sparse rank-1 updates, see
+ * test_sparse_updates, with the reordering from the command line and
+ * with a user supplied (natural) ordering.
+ */
+template<typename scalar_t,typename integer_t> int
+test_low_rank_update(int argc, const char* const argv[],
+                     const CSRMatrix<scalar_t,integer_t>& A) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  integer_t N = A.size();
+  DenseMatrix<scalar_t> X(N, 1);
+  X.random();
+  {
+    StrumpackSparseSolver<scalar_t,integer_t> sps;
+    sps.options().set_from_command_line(argc, argv);
+    sps.options().set_verbose(false);
+    auto tol = sps.options().compression() == CompressionType::NONE ?
+      ERROR_TOLERANCE*sps.options().rel_tol() : real_t(1e-2);
+    sps.set_matrix(A);
+    DenseMatrix<scalar_t> U(N, 3), V(N, 3), B(N, 1), VX(3, 1), Xlr(N, 1);
+    U.random(); V.random();
+    for (integer_t i=0; i<N; i++)
+      for (int j=0; j<3; j++)
+        U(i, j) /= scalar_t(N);
+    A.spmv(X, B);
+    gemm(Trans::T, Trans::N, scalar_t(1.), V, X, scalar_t(0.), VX);
+    gemm(Trans::N, Trans::N, scalar_t(1.), U, VX, scalar_t(1.), B);
+    if (sps.set_low_rank_update(U, V) != ReturnCode::SUCCESS) {
+      cout << "problem with the low-rank update." << endl;
+      return 1;
+    }
+    sps.solve(B, Xlr);
+    Xlr.scaled_add(scalar_t(-1.), X);
+    cout << "# LOW-RANK UPDATE RELATIVE ERROR = "
+         << Xlr.normF() / X.normF() << endl;
+    if (Xlr.normF() / X.normF() > tol) {
+      cout << "LOW-RANK UPDATE ERROR TOO LARGE!" << endl;
+      return 1;
+    }
+    sps.clear_low_rank_update();
+    if (sps.low_rank_update_rank()) {
+      cout << "LOW-RANK UPDATE NOT CLEARED!" << endl;
+      return 1;
+    }
+  }
+  int ierr = test_sparse_updates<scalar_t,integer_t>
+    (argc, argv, A, X, nullptr);
+  if (ierr) return ierr;
+  vector<int> p(N);
+  iota(p.begin(), p.end(), 0);
+  return test_sparse_updates<scalar_t,integer_t>(argc, argv, A, X, p.data());
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout << "Solve with low-rank updates of a sparse matrix.\n\n"
+         << "Usage: \n\t./test_low_rank_update_seq pde900.mtx" << endl;
+    return 1;
+  }
+  CSRMatrix<double,int> A;
+  if (A.read_matrix_market(argv[1])) {
+    cerr << "Could not read matrix from file." << endl;
+    return 1;
+  }
+  int ierr = test_low_rank_update(argc, argv, A);
+  if (ierr) return ierr;
+  CSRMatrix<double,long long int> Al;
+  Al.read_matrix_market(argv[1]);
+  return test_low_rank_update(argc, argv, Al);
+}
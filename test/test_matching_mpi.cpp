@@ -0,0 +1,177 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+using namespace std;
+
+#include "sparse/CSRMatrix.hpp"
+#include "sparse/AuctionMatchingMPI.hpp"
+
+using namespace strumpack;
+
+/**
+ * Randomly permute the rows, and scale rows and columns, of A, so
+ * that the matching is not trivial. Every rank generates the same
+ * matrix.
+ */
+template<typename scalar_t,typename integer_t> CSRMatrix<scalar_t,integer_t>
+scramble(const CSRMatrix<scalar_t,integer_t>& A) {
+  auto n = A.size();
+  auto ptr = A.ptr();
+  auto ind = A.ind();
+  auto val = A.val();
+  mt19937 gen(1234);
+  uniform_real_distribution<double> e(-3., 3.);
+  vector<integer_t> perm(n), sptr(n+1, 0), sind;
+  vector<scalar_t> sval;
+  vector<double> sr(n), sc(n);
+  iota(perm.begin(), perm.end(), 0);
+  shuffle(perm.begin(), perm.end(), gen);
+  for (auto& s : sr) s = pow(10., e(gen));
+  for (auto& s : sc) s = pow(10., e(gen));
+  for (integer_t i=0; i<n; i++) {
+    auto r = perm[i];
+    for (integer_t k=ptr[r]; k<ptr[r+1]; k++) {
+      sind.push_back(ind[k]);
+      sval.push_back(val[k] * scalar_t(sr[i] * sc[ind[k]]));
+    }
+    sptr[i+1] = sind.size();
+  }
+  return CSRMatrix<scalar_t,integer_t>
+    (n, sptr.data(), sind.data(), sval.data());
+}
+
+template<typename scalar_t,typename integer_t>
+int test_matching(CSRMatrix<scalar_t,integer_t>& A) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  MPIComm comm;
+  int P = comm.size(), rank = comm.rank();
+  integer_t n = A.size();
+  auto ptr = A.ptr();
+  auto ind = A.ind();
+  auto val = A.val();
+  auto a = [&](integer_t i, integer_t j) {
+    for (integer_t k=ptr[i]; k<ptr[i+1]; k++)
+      if (ind[k] == j) return double(std::abs(val[k]));
+    return 0.;
+  };
+
+  // sequential MC64 on every rank, as a reference
+  auto M = A.matching(MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING, false);
+  double logprod_mc64 = 0.;
+  for (integer_t i=0; i<n; i++)
+    logprod_mc64 += std::log(a(i, M.Q[i]));
+
+  // block row distribution of A
+  vector<integer_t> dist(P+1);
+  for (int p=0; p<=P; p++) dist[p] = integer_t((long long)(n) * p / P);
+  auto brow = dist[rank], lrows = dist[rank+1] - brow;
+  vector<integer_t> Q;
+  vector<real_t> R, C;
+  int info = AuctionMatchingMPI
+    (comm, dist, ptr+brow, ind, val, Q, R, C);
+  if (info) {
+    if (!rank) cout << "AUCTION MATCHING FAILED, info = " << info << endl;
+    return 1;
+  }
+
+  // Q should be a permutation, with matched entries scaled to 1,
+  // and all others bounded by exp(eps) = exp(1e-3)
+  vector<bool> mark(n, false);
+  for (auto q : Q) {
+    if (q < 0 || q >= n || mark[q]) {
+      if (!rank) cout << "AUCTION MATCHING IS NOT A PERMUTATION" << endl;
+      return 1;
+    }
+    mark[q] = true;
+  }
+  double logprod = 0., diag_err = 0., offdiag = 0.;
+  for (integer_t r=0; r<lrows; r++) {
+    auto i = brow + r;
+    logprod += std::log(a(i, Q[i]));
+    for (integer_t k=ptr[i]; k<ptr[i+1]; k++) {
+      auto s = std::abs(val[k]) * R[r] * C[ind[k]];
+      if (ind[k] == Q[i]) diag_err = std::max(diag_err, std::abs(s - 1.));
+      else offdiag = std::max(offdiag, double(s));
+    }
+  }
+  logprod = comm.all_reduce(logprod, MPI_SUM);
+  diag_err = comm.all_reduce(diag_err, MPI_MAX);
+  offdiag = comm.all_reduce(offdiag, MPI_MAX);
+  if (!rank)
+    cout << "# log(prod diag) MC64 = " << logprod_mc64
+         << ", auction = " << logprod << endl
+         << "# scaled diagonal error = " << diag_err
+         << ", max scaled off-diagonal = " << offdiag << endl;
+  // MC64 is optimal, the auction is optimal up to n*eps
+  if (logprod > logprod_mc64 + 1e-8 * n ||
+      logprod < logprod_mc64 - 1e-3 * n) {
+    if (!rank) cout << "AUCTION MATCHING PRODUCT DIFFERS FROM MC64" << endl;
+    return 1;
+  }
+  if (diag_err > 1e-8 || offdiag > std::exp(1e-3) + 1e-8) {
+    if (!rank) cout << "AUCTION MATCHING SCALING TOO LARGE" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  MPI_Init(&argc, &argv);
+  int rank, P;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &P);
+  if (!rank) {
+    cout << "# Running with:\n# mpirun -n " << P << " ";
+    for (int i=0; i<argc; i++)
+      cout << argv[i] << " ";
+    cout << endl;
+  }
+  if (argc < 2) {
+    if (!rank)
+      cout << "Compare the distributed auction matching with MC64.\n\n"
+           << "Usage: \n\tmpirun -n 4 ./test_matching_mpi pde900.mtx"
+           << std::endl;
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+  int ierr = 0;
+  {
+    CSRMatrix<double,int> A;
+    if (A.read_matrix_market(argv[1])) {
+      cerr << "Could not read matrix from file." << endl;
+      MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    auto As = scramble(A);
+    ierr = test_matching(As);
+  }
+  MPI_Finalize();
+  return ierr;
+}
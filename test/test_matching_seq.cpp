@@ -0,0 +1,157 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+using namespace std;
+
+#include "StrumpackParameters.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+/**
+ * Randomly permute the rows, and scale rows and columns, of A, so
+ * that the matching is not trivial.
+ */
+template<typename scalar_t,typename integer_t> CSRMatrix<scalar_t,integer_t>
+scramble(const CSRMatrix<scalar_t,integer_t>& A) {
+  auto n = A.size();
+  auto ptr = A.ptr();
+  auto ind = A.ind();
+  auto val = A.val();
+  mt19937 gen(1234);
+  uniform_real_distribution<double> e(-3., 3.);
+  vector<integer_t> perm(n), sptr(n+1, 0), sind;
+  vector<scalar_t> sval;
+  vector<double> sr(n), sc(n);
+  iota(perm.begin(), perm.end(), 0);
+  shuffle(perm.begin(), perm.end(), gen);
+  for (auto& s : sr) s = pow(10., e(gen));
+  for (auto& s : sc) s = pow(10., e(gen));
+  for (integer_t i=0; i<n; i++) {
+    auto r = perm[i];
+    for (integer_t k=ptr[r]; k<ptr[r+1]; k++) {
+      sind.push_back(ind[k]);
+      sval.push_back(val[k] * scalar_t(sr[i] * sc[ind[k]]));
+    }
+    sptr[i+1] = sind.size();
+  }
+  return CSRMatrix<scalar_t,integer_t>
+    (n, sptr.data(), sind.data(), sval.data());
+}
+
+template<typename scalar_t,typename integer_t>
+int test_matching(CSRMatrix<scalar_t,integer_t>& A) {
+  integer_t n = A.size();
+  auto ptr = A.ptr();
+  auto ind = A.ind();
+  auto val = A.val();
+  auto a = [&](integer_t i, integer_t j) {
+    for (integer_t k=ptr[i]; k<ptr[i+1]; k++)
+      if (ind[k] == j) return double(std::abs(val[k]));
+    return 0.;
+  };
+  auto job = MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING;
+  auto M = A.matching(job, false);
+  auto Ma = A.matching(job, false, true);
+  if (M.auction || !Ma.auction) {
+    cout << "THE AUCTION DID NOT PRODUCE THE AUCTION MATCHING" << endl;
+    return 1;
+  }
+
+  // both should be permutations, with matched entries scaled to 1,
+  // and all others bounded by 1 (MC64) or exp(eps) = exp(1e-3)
+  // (auction)
+  auto check = [&](const MatchingData<scalar_t,integer_t>& M,
+                   const std::string& name, double bound) {
+    vector<bool> mark(n, false);
+    for (auto q : M.Q) {
+      if (q < 0 || q >= n || mark[q]) {
+        cout << name << " MATCHING IS NOT A PERMUTATION" << endl;
+        return 1;
+      }
+      mark[q] = true;
+    }
+    double logprod = 0., diag_err = 0., offdiag = 0.;
+    for (integer_t i=0; i<n; i++) {
+      logprod += std::log(a(i, M.Q[i]));
+      for (integer_t k=ptr[i]; k<ptr[i+1]; k++) {
+        auto s = std::abs(val[k]) * M.R[i] * M.C[ind[k]];
+        if (ind[k] == M.Q[i]) diag_err = std::max(diag_err, std::abs(s - 1.));
+        else offdiag = std::max(offdiag, double(s));
+      }
+    }
+    cout << "# " << name << ": log(prod diag) = " << logprod
+         << ", scaled diagonal error = " << diag_err
+         << ", max scaled off-diagonal = " << offdiag << endl;
+    if (diag_err > 1e-8 || offdiag > bound + 1e-8) {
+      cout << name << " MATCHING SCALING TOO LARGE" << endl;
+      return 1;
+    }
+    return 0;
+  };
+  if (check(M, "MC64", 1.) || check(Ma, "AUCTION", std::exp(1e-3)))
+    return 1;
+  double logprod = 0., logprod_mc64 = 0.;
+  for (integer_t i=0; i<n; i++) {
+    logprod += std::log(a(i, Ma.Q[i]));
+    logprod_mc64 += std::log(a(i, M.Q[i]));
+  }
+  // MC64 is optimal, the auction is optimal up to n*eps
+  if (logprod > logprod_mc64 + 1e-8 * n ||
+      logprod < logprod_mc64 - 1e-3 * n) {
+    cout << "AUCTION MATCHING PRODUCT DIFFERS FROM MC64" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  cout << "# Running with:\n# ";
+#if defined(_OPENMP)
+  cout << "OMP_NUM_THREADS=" << omp_get_max_threads() << " ";
+#endif
+  for (int i=0; i<argc; i++)
+    cout << argv[i] << " ";
+  cout << endl;
+  if (argc < 2) {
+    cout << "Compare the multithreaded auction matching with MC64.\n\n"
+         << "Usage: \n\t./test_matching_seq pde900.mtx" << std::endl;
+    return 1;
+  }
+  CSRMatrix<double,int> A;
+  if (A.read_matrix_market(argv[1])) {
+    cerr << "Could not read matrix from file." << endl;
+    return 1;
+  }
+  auto As = scramble(A);
+  return test_matching(As);
+}
@@ -0,0 +1,185 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+using namespace std;
+
+#include "StrumpackParameters.hpp"
+#include "sparse/CSRMatrix.hpp"
+#include "sparse/SeparatorTree.hpp"
+#include "sparse/ordering/MultilevelND.hpp"
+#include "sparse/ordering/spectral/SpectralReordering.hpp"
+
+using namespace strumpack;
+
+/**
+ * Check that tree is a valid separator tree for perm/iperm: perm is
+ * a permutation with inverse iperm, the separators cover 0..n, every
+ * node has 0 or 2 children, the children come before their parent
+ * and there is a single root.
+ */
+template<typename integer_t> bool
+valid_tree(const SeparatorTree<integer_t>& tree, integer_t n,
+           const vector<integer_t>& perm, const vector<integer_t>& iperm) {
+  if (integer_t(perm.size()) != n || integer_t(iperm.size()) != n)
+    return false;
+  for (integer_t i=0; i<n; i++)
+    if (perm[i] < 0 || perm[i] >= n || iperm[perm[i]] != i) return false;
+  integer_t ns = tree.separators(), roots = 0;
+  if (ns == 0 || tree.sizes[0] != 0 || tree.sizes[ns] != n) return false;
+  for (integer_t s=0; s<ns; s++) {
+    if (tree.sizes[s+1] < tree.sizes[s]) return false;
+    if ((tree.lch[s] == -1) != (tree.rch[s] == -1)) return false;
+    for (auto c : {tree.lch[s], tree.rch[s]})
+      if (c != -1 && (c >= s || tree.parent[c] != s)) return false;
+    if (tree.parent[s] == -1) roots++;
+    else if (tree.parent[s] <= s) return false;
+  }
+  tree.check();
+  return roots == 1;
+}
+
+/**
+ * Check that the separators really separate: for every edge (u,v)
+ * of the graph, the separator containing u must be an ancestor of
+ * the separator containing v, or the other way around. Otherwise u
+ * and v are in the two different subgraphs of a common ancestor,
+ * which then does not separate them.
+ */
+template<typename integer_t> bool
+separates(const SeparatorTree<integer_t>& tree, integer_t n,
+          const integer_t* ptr, const integer_t* ind,
+          const vector<integer_t>& perm) {
+  vector<integer_t> node(n);
+  for (integer_t s=0; s<tree.separators(); s++)
+    for (integer_t i=tree.sizes[s]; i<tree.sizes[s+1]; i++)
+      node[i] = s;
+  for (integer_t u=0; u<n; u++)
+    for (integer_t j=ptr[u]; j<ptr[u+1]; j++) {
+      auto a = node[perm[u]], b = node[perm[ind[j]]];
+      if (a > b) std::swap(a, b);
+      // ancestors have a larger number
+      while (a != -1 && a < b) a = tree.parent[a];
+      if (a != b) return false;
+    }
+  return true;
+}
+
+/**
+ * 5 or 7 point stencil on an nx x ny x nz grid, including the
+ * diagonal, and, if copies > 1, several disconnected copies of it.
+ */
+template<typename integer_t> void
+grid_graph(int nx, int ny, int nz, int copies,
+           vector<integer_t>& ptr, vector<integer_t>& ind) {
+  integer_t m = nx*ny*nz;
+  ptr.assign(1, 0);
+  ind.clear();
+  for (int c=0; c<copies; c++)
+    for (int z=0; z<nz; z++)
+      for (int y=0; y<ny; y++)
+        for (int x=0; x<nx; x++) {
+          integer_t v = c*m + x + nx*(y + ny*z);
+          ind.push_back(v);
+          if (x > 0) ind.push_back(v-1);
+          if (x < nx-1) ind.push_back(v+1);
+          if (y > 0) ind.push_back(v-nx);
+          if (y < ny-1) ind.push_back(v+nx);
+          if (z > 0) ind.push_back(v-nx*ny);
+          if (z < nz-1) ind.push_back(v+nx*ny);
+          ptr.push_back(ind.size());
+        }
+}
+
+template<typename integer_t> int
+test_nd(const string& name, integer_t n, const integer_t* ptr,
+        const integer_t* ind, double max_root_sep) {
+  const int leaf = 8;
+  int ierr = 0;
+  for (auto method : {"MLND", "SPECTRAL"}) {
+    vector<integer_t> perm, iperm;
+    auto tree = (string(method) == "MLND") ?
+      ordering::multilevel_nd(n, ptr, ind, perm, iperm, leaf) :
+      ordering::spectral_nd(n, ptr, ind, perm, iperm, leaf);
+    auto ns = tree.separators();
+    auto root = tree.root();
+    integer_t root_sep = tree.sizes[root+1] - tree.sizes[root];
+    cout << "# " << name << ", " << method << ": n = " << n
+         << ", separators = " << ns << ", levels = " << tree.levels()
+         << ", root separator = " << root_sep << endl;
+    if (!valid_tree(tree, n, perm, iperm)) {
+      cout << "SEPARATOR TREE IS NOT VALID" << endl;
+      ierr = 1;
+    } else if (!separates(tree, n, ptr, ind, perm)) {
+      cout << "SEPARATORS DO NOT SEPARATE" << endl;
+      ierr = 1;
+    } else if (ns < n / leaf / 4 || root_sep > max_root_sep) {
+      // the graph has to be dissected, down to small subgraphs,
+      // with a small top separator
+      cout << "GRAPH WAS NOT PROPERLY DISSECTED" << endl;
+      ierr = 1;
+    }
+  }
+  return ierr;
+}
+
+int main(int argc, char* argv[]) {
+  cout << "# Running with:\n# ";
+  for (int i=0; i<argc; i++)
+    cout << argv[i] << " ";
+  cout << endl;
+  if (argc < 2) {
+    cout << "Test the built-in nested dissection codes.\n\n"
+         << "Usage: \n\t./test_nested_dissection_seq pde900.mtx"
+         << std::endl;
+    return 1;
+  }
+  CSRMatrix<double,int> A;
+  if (A.read_matrix_market(argv[1])) {
+    cerr << "Could not read matrix from file." << endl;
+    return 1;
+  }
+  int ierr = 0;
+  ierr += test_nd<int>
+    (argv[1], A.size(), A.ptr(), A.ind(), 2*std::sqrt(A.size()));
+  vector<long long int> ptr, ind;
+  grid_graph(15, 15, 15, 1, ptr, ind);
+  ierr += test_nd<long long int>
+    ("15^3 grid", ptr.size()-1, ptr.data(), ind.data(), 2*15*15);
+  // 3 components cannot be split in 2 balanced parts, one of the
+  // grids needs a separator
+  grid_graph(20, 20, 1, 3, ptr, ind);
+  ierr += test_nd<long long int>
+    ("3 disconnected 20^2 grids", ptr.size()-1, ptr.data(), ind.data(),
+     2*20);
+  return ierr ? 1 : 0;
+}
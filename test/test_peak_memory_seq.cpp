@@ -0,0 +1,159 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <random>
+#include <memory>
+#include <algorithm>
+using namespace std;
+
+#include "sparse/fronts/FrontDense.hpp"
+
+using namespace strumpack;
+
+/**
+ * Dense front with access to its children, only the sizes of the
+ * separator and update sets matter here.
+ */
+class TestFront : public FrontDense<double,int> {
+public:
+  TestFront(int dsep, int dupd)
+    : FrontDense<double,int>(0, 0, dsep, upd_tmp(dupd)) {}
+  TestFront* lch() const { return static_cast<TestFront*>(lchild_.get()); }
+  TestFront* rch() const { return static_cast<TestFront*>(rchild_.get()); }
+  void swap_children() { std::swap(lchild_, rchild_); }
+  long long cb() const { return (long long)(dim_upd()) * dim_upd(); }
+  long long front() const { return (long long)(dim_blk()) * dim_blk(); }
+
+  /**
+   * Simulate the multifrontal traversal, left child first, with a
+   * stack of contribution blocks. Returns the peak of frontal
+   * matrix plus contribution block stack.
+   */
+  long long simulate(long long stack) const {
+    long long peak = 0;
+    if (lch()) {
+      peak = std::max(peak, lch()->simulate(stack));
+      stack += lch()->cb();
+    }
+    if (rch()) {
+      peak = std::max(peak, rch()->simulate(stack));
+      stack += rch()->cb();
+    }
+    return std::max(peak, stack + front());
+  }
+
+  /** collect all fronts with two children */
+  void internal_nodes(std::vector<TestFront*>& nodes) {
+    if (lch() && rch()) nodes.push_back(this);
+    if (lch()) lch()->internal_nodes(nodes);
+    if (rch()) rch()->internal_nodes(nodes);
+  }
+
+  /** check that the children are in Liu's order */
+  bool liu_ordered() const {
+    if (!lch() || !rch()) return true;
+    auto pl = lch()->simulate(0), pr = rch()->simulate(0);
+    return pl - lch()->cb() >= pr - rch()->cb() &&
+      lch()->liu_ordered() && rch()->liu_ordered();
+  }
+
+private:
+  static std::vector<int>& upd_tmp(int dupd) {
+    static std::vector<int> upd;
+    upd.resize(dupd);
+    return upd;
+  }
+};
+
+std::unique_ptr<TestFront>
+random_tree(std::mt19937& gen, int levels, int dupd) {
+  std::uniform_int_distribution<int> s(1, 40);
+  std::uniform_int_distribution<int> d(0, 3);
+  auto dsep = s(gen);
+  std::unique_ptr<TestFront> f(new TestFront(dsep, dupd));
+  if (levels > 0) {
+    // children have an update set of at most dsep + dupd
+    auto nch = d(gen);  // 0: leaf, 1: only left, else both
+    if (nch >= 1)
+      f->set_lchild(random_tree(gen, levels-1, std::min(s(gen), dsep+dupd)));
+    if (nch >= 2)
+      f->set_rchild(random_tree(gen, levels-1, std::min(s(gen), dsep+dupd)));
+  }
+  return f;
+}
+
+int main(int argc, char* argv[]) {
+  std::mt19937 gen(2468);
+  int ierr = 0;
+  for (int t=0; t<200; t++) {
+    auto root = random_tree(gen, 6, 0);
+    auto before = root->simulate(0);
+    auto pred = root->order_children_peak_memory();
+    auto after = root->simulate(0);
+    // the prediction should match the actual traversal
+    if (pred != after) {
+      cout << "PREDICTED PEAK " << pred << " != SIMULATED PEAK "
+           << after << endl;
+      ierr++;
+    }
+    if (after > before || !root->liu_ordered()) {
+      cout << "REORDERING DID NOT REDUCE PEAK MEMORY, " << before
+           << " -> " << after << endl;
+      ierr++;
+    }
+    // calling it again should not change anything
+    if (root->order_children_peak_memory() != pred ||
+        root->simulate(0) != after) {
+      cout << "REORDERING IS NOT STABLE" << endl;
+      ierr++;
+    }
+    // for small trees, compare with all possible child orderings
+    std::vector<TestFront*> nodes;
+    root->internal_nodes(nodes);
+    if (nodes.size() <= 12) {
+      long long best = after;
+      for (long s=1; s<(1L << nodes.size()); s++) {
+        // gray code, flip one node at a time
+        auto flip = (s ^ (s >> 1)) ^ ((s-1) ^ ((s-1) >> 1));
+        std::size_t i = 0;
+        while (!((flip >> i) & 1)) i++;
+        nodes[i]->swap_children();
+        best = std::min(best, root->simulate(0));
+      }
+      if (best < after) {
+        cout << "REORDERING IS NOT OPTIMAL, " << after
+             << " > " << best << endl;
+        ierr++;
+      }
+    }
+  }
+  cout << "# peak memory reordering: " << ierr << " errors" << endl;
+  return ierr ? 1 : 0;
+}
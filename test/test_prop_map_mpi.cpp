@@ -0,0 +1,182 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+using namespace std;
+
+#include "StrumpackOptions.hpp"
+#include "sparse/CSRMatrix.hpp"
+#include "sparse/CSRMatrixMPI.hpp"
+#include "sparse/EliminationTreeMPIDist.hpp"
+#include "sparse/ordering/MatrixReorderingMPI.hpp"
+
+using namespace strumpack;
+
+/**
+ * Every rank sends to a few random ranks, possibly including itself,
+ * messages of different sizes. All ranks use the same random
+ * generator, so they all know the pattern and can check what they
+ * receive. This is repeated, since consecutive calls alternate
+ * between two tags.
+ */
+int test_sparse_exchange(const MPIComm& comm) {
+  int rank = comm.rank(), P = comm.size(), err = 0;
+  auto msg = [P](int src, int dest) {
+    return std::vector<int>(1 + (src + dest) % 4, src*P + dest);
+  };
+  for (int round=0; round<4; round++) {
+    std::mt19937 gen(round);
+    std::uniform_int_distribution<int> u(0, P-1);
+    std::vector<std::vector<int>> dests(P);
+    for (int p=0; p<P; p++) {
+      int k = u(gen) % 4;
+      for (int i=0; i<k; i++) dests[p].push_back(u(gen));
+      std::sort(dests[p].begin(), dests[p].end());
+      dests[p].erase(std::unique(dests[p].begin(), dests[p].end()),
+                     dests[p].end());
+    }
+    std::vector<std::pair<int,std::vector<int>>> sbuf;
+    for (auto d : dests[rank])
+      sbuf.emplace_back(d, msg(rank, d));
+    auto rbuf = comm.sparse_exchange(sbuf, 0);
+    std::vector<int> expected;
+    for (int p=0; p<P; p++)
+      if (std::binary_search(dests[p].begin(), dests[p].end(), rank)) {
+        auto m = msg(p, rank);
+        expected.insert(expected.end(), m.begin(), m.end());
+      }
+    // messages can arrive in any order
+    std::sort(rbuf.begin(), rbuf.end());
+    std::sort(expected.begin(), expected.end());
+    if (rbuf != expected) err = 1;
+  }
+  err = comm.all_reduce(err, MPI_MAX);
+  if (err && !rank)
+    cout << "MPIComm::sparse_exchange DID NOT DELIVER THE EXPECTED DATA"
+         << endl;
+  return err;
+}
+
+/**
+ * Check the front each row is mapped to after the symbolic
+ * factorization and proportional mapping. Every process looks up the
+ * rows of its part of the matrix, and the column indices of its
+ * nonzeros, which can be in fronts of other processes. These lookups
+ * should agree with the lookup of the same row on the process which
+ * owns that row, and with the local subtrees of the processes.
+ */
+template<typename scalar_t,typename integer_t> int
+test_row_fronts(int argc, char* argv[],
+                const CSRMatrix<scalar_t,integer_t>& A,
+                const MPIComm& comm) {
+  int rank = comm.rank(), P = comm.size(), err = 0;
+  SPOptions<scalar_t> opts;
+  opts.set_from_command_line(argc, argv);
+  CSRMatrixMPI<scalar_t,integer_t> Adist(&A, comm, true);
+  MatrixReorderingMPI<scalar_t,integer_t> nd(Adist.size(), comm);
+  nd.nested_dissection(opts, Adist, 1, 1, 1, 1, 1);
+  EliminationTreeMPIDist<scalar_t,integer_t> et(opts, Adist, nd, comm);
+
+  integer_t n = Adist.size(), lo = Adist.begin_row(),
+    lrows = Adist.local_rows();
+  const auto& perm = nd.perm();
+  auto ptr = Adist.ptr();
+  auto ind = Adist.ind();
+  // first process and number of processes for each row, as found by
+  // the process owning the row
+  std::vector<int> f0(n, 0), fP(n, 0);
+  for (integer_t r=0; r<lrows; r++) {
+    auto i = perm[r+lo];
+    auto d = et.get_sparse_mapped_destination(Adist, r, r+lo, i, i, true);
+    f0[i] = std::get<0>(d);
+    fP[i] = std::get<1>(d);
+  }
+  comm.all_reduce(f0, MPI_SUM);
+  comm.all_reduce(fP, MPI_SUM);
+  std::vector<integer_t> ranges(2*P, 0);
+  ranges[2*rank] = et.local_range().first;
+  ranges[2*rank+1] = et.local_range().second;
+  comm.all_reduce(ranges, MPI_SUM);
+  auto in_local_range = [&](integer_t i, int p) {
+    return i >= ranges[2*p] && i < ranges[2*p+1];
+  };
+  for (integer_t i=0; i<n; i++) {
+    if (fP[i] < 1 || f0[i] < 0 || f0[i] + fP[i] > P) err = 1;
+    else if (fP[i] == 1) {
+      // in the local subtree of process f0[i]
+      if (!in_local_range(i, f0[i])) err = 1;
+    } else {
+      // in a distributed front, not in any local subtree
+      for (int p=0; p<P; p++)
+        if (in_local_range(i, p)) err = 1;
+    }
+  }
+  for (integer_t r=0; r<lrows; r++) {
+    auto i = perm[r+lo];
+    for (integer_t k=ptr[r]-ptr[0]; k<ptr[r+1]-ptr[0]; k++) {
+      auto j = perm[ind[k]];
+      // an entry goes to the local subtree of its row or column, or
+      // else to the front of min(i,j), which comes first
+      auto e = fP[i] == 1 ? i : (fP[j] == 1 ? j : std::min(i, j));
+      auto d = et.get_sparse_mapped_destination
+        (Adist, r, ind[k], i, j, true);
+      if (std::get<0>(d) != f0[e] || std::get<1>(d) != fP[e]) err = 1;
+    }
+  }
+  err = comm.all_reduce(err, MPI_MAX);
+  if (err && !rank)
+    cout << "ROWS ARE NOT MAPPED TO THE CORRECT FRONTS" << endl;
+  return err;
+}
+
+int main(int argc, char* argv[]) {
+  MPI_Init(&argc, &argv);
+  int ierr = 0;
+  {
+    MPIComm comm;
+    ierr += test_sparse_exchange(comm);
+    if (argc < 2) {
+      if (!comm.rank())
+        cout << "Usage: \n\tmpirun -n 4 ./test_prop_map_mpi pde900.mtx"
+             << endl;
+      MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    CSRMatrix<double,int> A;
+    if (!comm.rank() && A.read_matrix_market(argv[1])) {
+      cerr << "Could not read matrix from file." << endl;
+      MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    ierr += test_row_fronts(argc, argv, A, comm);
+  }
+  scalapack::Cblacs_exit(1);
+  MPI_Finalize();
+  return ierr ? 1 : 0;
+}
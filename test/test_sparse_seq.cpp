@@ -79,6 +79,40 @@ test_sparse_solver(int argc, const char* const argv[],
     cout << "RESIDUAL TOO LARGE!" << endl;
     return 1;
   }
+
+  // concurrent solves, each thread with its own SolveContext
+  int nsolves = 4, failed = 0;
+#pragma omp parallel for reduction(+:failed)
+  for (int s=0; s<nsolves; s++) {
+    SolveContext<scalar_t> ctx;
+    vector<scalar_t> xs(N);
+    if (spss.solve(b.data(), xs.data(), ctx) != ReturnCode::SUCCESS ||
+        A.max_scaled_residual(xs.data(), b.data()) >
+        ERROR_TOLERANCE*spss.options().rel_tol())
+      failed++;
+  }
+  if (failed) {
+    cout << "CONCURRENT SOLVE FAILED!" << endl;
+    return 1;
+  }
+
+  // value-only refactorization, reusing the symbolic analysis (and
+  // the assembly maps with --sp_enable_assembly_maps)
+  auto A2(A);
+  for (integer_t i=0; i<A2.nnz(); i++)
+    A2.val()[i] *= scalar_t(2.);
+  spss.update_matrix_values(A2);
+  if (spss.factor() != ReturnCode::SUCCESS) {
+    cout << "problem during refactorization of the matrix." << endl;
+    return 1;
+  }
+  A2.spmv(x_exact.data(), b.data());
+  spss.solve(b.data(), x.data());
+  if (A2.max_scaled_residual(x.data(), b.data()) >
+      ERROR_TOLERANCE*spss.options().rel_tol()) {
+    cout << "RESIDUAL TOO LARGE AFTER REFACTORIZATION!" << endl;
+    return 1;
+  }
   return 0;
 }
 
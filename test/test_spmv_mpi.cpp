@@ -0,0 +1,136 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <random>
+using namespace std;
+
+#include "sparse/CSRMatrix.hpp"
+#include "sparse/CSRMatrixMPI.hpp"
+
+using namespace strumpack;
+
+void abort_MPI(MPI_Comm *c, int *error, ...) {
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  cout << "rank = " << rank << " ABORTING!!!!!" << endl;
+  abort();
+}
+
+/**
+ * Compare the distributed sparse matrix-vector product with the
+ * sequential one, for a varying number of right hand sides. This
+ * alternates between different nrhs, which use different (cached)
+ * persistent requests, and also checks a copy of the distributed
+ * matrix.
+ */
+template<typename scalar_t,typename integer_t>
+int test_spmv(const CSRMatrix<scalar_t,integer_t>& A) {
+  using DenseM_t = DenseMatrix<scalar_t>;
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  // every process has the full matrix A
+  CSRMatrixMPI<scalar_t,integer_t> Adist(&A, MPI_COMM_WORLD, false);
+  auto N = A.size();
+  auto brow = Adist.begin_row(), lrows = Adist.local_rows();
+  mt19937 gen(5678);
+  uniform_real_distribution<double> u(-1., 1.);
+  auto check = [&](const CSRMatrixMPI<scalar_t,integer_t>& B,
+                   std::size_t nrhs) {
+    DenseM_t x(N, nrhs), y(N, nrhs), xl(lrows, nrhs), yl(lrows, nrhs);
+    for (std::size_t c=0; c<nrhs; c++)
+      for (integer_t i=0; i<N; i++)
+        x(i, c) = u(gen);
+    A.spmv(x, y);
+    for (std::size_t c=0; c<nrhs; c++)
+      for (integer_t i=0; i<lrows; i++)
+        xl(i, c) = x(brow+i, c);
+    if (nrhs == 1) B.spmv(xl.data(), yl.data());
+    else B.spmv(xl, yl);
+    double err = 0., nrm = 0.;
+    for (std::size_t c=0; c<nrhs; c++)
+      for (integer_t i=0; i<lrows; i++) {
+        err = std::max(err, double(std::abs(yl(i, c) - y(brow+i, c))));
+        nrm = std::max(nrm, double(std::abs(y(brow+i, c))));
+      }
+    err = Adist.Comm().all_reduce(err, MPI_MAX);
+    nrm = Adist.Comm().all_reduce(nrm, MPI_MAX);
+    if (!rank)
+      cout << "# nrhs = " << nrhs << ", SpMV relative error = "
+           << err / nrm << endl;
+    return err > 1e-13 * nrm;
+  };
+  int ierr = 0;
+  for (std::size_t nrhs : {1, 3, 1, 3, 8, 1})
+    ierr += check(Adist, nrhs);
+  // the copy starts without buffers or requests
+  auto Acopy = Adist;
+  for (std::size_t nrhs : {3, 1})
+    ierr += check(Acopy, nrhs);
+  ierr += check(Adist, 3);
+  if (ierr && !rank) cout << "SPMV FAILED" << endl;
+  return ierr;
+}
+
+int main(int argc, char* argv[]) {
+  int thread_level, rank, P;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &thread_level);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &P);
+  if (!rank) {
+    cout << "# Running with:\n# mpirun -n " << P << " ";
+    for (int i=0; i<argc; i++)
+      cout << argv[i] << " ";
+    cout << endl;
+  }
+  if (argc < 2) {
+    if (!rank)
+      cout << "Test the distributed sparse matrix-vector product.\n\n"
+           << "Usage: \n\tmpirun -n 4 ./test_spmv_mpi pde900.mtx"
+           << std::endl;
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+
+  MPI_Errhandler eh;
+  MPI_Comm_create_errhandler(abort_MPI, &eh);
+  MPI_Comm_set_errhandler(MPI_COMM_WORLD, eh);
+
+  int ierr = 0;
+  {
+    CSRMatrix<double,int> A;
+    if (A.read_matrix_market(argv[1])) {
+      cerr << "Could not read matrix from file." << endl;
+      MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    ierr = test_spmv(A);
+  }
+  MPI_Errhandler_free(&eh);
+  MPI_Finalize();
+  return ierr;
+}
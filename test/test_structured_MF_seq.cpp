@@ -0,0 +1,129 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li,.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <cmath>
+#include <stdexcept>
+using namespace std;
+
+#include "structured/StructuredMatrix.hpp"
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e1
+// constant in the bound on the number of products with A
+#define PRODUCTS_CONSTANT 8
+
+/**
+ * Fully matrix-free construction, by randomized peeling, of the
+ * sequential HSS, HODLR and BLR matrices, see
+ * structured::construct_matrix_free and
+ * structured::construct_and_factor_matrix_free. Checks that the
+ * number of products with A is O(r log n), with r the HODLR rank of
+ * A, the compression error and the factorization and solve.
+ */
+template<typename scalar_t> int
+test_matrix_free(int argc, char* argv[], int n) {
+  structured::StructuredOptions<scalar_t> opts;
+  opts.set_verbose(false);
+  opts.set_from_command_line(argc, argv);
+  DenseMatrix<scalar_t> A
+    (n, n, [](int i, int j) { return scalar_t(1. / (1. + abs(i-j))); });
+  std::size_t nmv = 0;
+  auto Amult =
+    [&A, &nmv](Trans t, const DenseMatrix<scalar_t>& R,
+               DenseMatrix<scalar_t>& S) {
+      nmv += R.cols();
+      gemm(t, Trans::N, scalar_t(1.), A, R, scalar_t(0.), S);
+    };
+  for (auto type : {structured::Type::HSS, structured::Type::HODLR,
+                    structured::Type::BLR}) {
+    opts.set_type(type);
+    // HSS and BLR are recompressed from a HODLR matrix, peeled with
+    // a 10x smaller tolerance, see structured::construct_matrix_free
+    auto ref_opts = opts;
+    ref_opts.set_type(structured::Type::HODLR);
+    if (type != structured::Type::HODLR) {
+      ref_opts.set_rel_tol(opts.rel_tol() / 10);
+      ref_opts.set_abs_tol(opts.abs_tol() / 10);
+    }
+    auto r = structured::construct_from_dense(A, ref_opts)->rank();
+    // randomized peeling: per level of the HODLR tree O(r) products
+    // (plus oversampling), and the leaf_size products for the
+    // diagonal blocks
+    auto maxnmv = PRODUCTS_CONSTANT * (r + 5) * std::ceil(std::log2(n))
+      + opts.leaf_size();
+    nmv = 0;
+    auto H = structured::construct_matrix_free<scalar_t>
+      (n, n, Amult, opts);
+    DenseMatrix<scalar_t> id(n, n), Hdense(n, n);
+    id.eye();
+    H->mult(Trans::N, id, Hdense);
+    auto err = Hdense.sub(A).normF() / A.normF();
+    cout << "# " << get_name(type) << ", n = " << n
+         << ", products with A = " << nmv << " (bound " << maxnmv
+         << ", HODLR rank " << r << "), rank = " << H->rank()
+         << ", ||A-H||_F/||A||_F = " << err << endl;
+    if (nmv > maxnmv || nmv >= std::size_t(n)) {
+      cout << "TOO MANY PRODUCTS WITH A!" << endl;
+      return 1;
+    }
+    if (err > ERROR_TOLERANCE * opts.rel_tol()) {
+      cout << "COMPRESSION ERROR TOO LARGE!" << endl;
+      return 1;
+    }
+    nmv = 0;
+    auto F = structured::construct_and_factor_matrix_free<scalar_t>
+      (n, n, Amult, opts);
+    if (nmv > maxnmv) {
+      cout << "TOO MANY PRODUCTS WITH A (FACTOR)!" << endl;
+      return 1;
+    }
+    DenseMatrix<scalar_t> B(n, 1), X(n, 1);
+    X.random();
+    gemm(Trans::N, Trans::N, scalar_t(1.), A, X, scalar_t(0.), B);
+    F->solve(B);
+    auto serr = B.sub(X).normF() / X.normF();
+    cout << "#   products with A = " << nmv
+         << ", ||X-F\\(A*X)||_F/||X||_F = " << serr << endl;
+    // A is well conditioned, the solve error is of the order of the
+    // compression error
+    if (serr > ERROR_TOLERANCE * opts.rel_tol()) {
+      cout << "SOLVE ERROR TOO LARGE!" << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  int n = 3000;
+  if (argc > 1) n = stoi(argv[1]);
+  int ierr = test_matrix_free<double>(argc, argv, n);
+  if (ierr) return ierr;
+  return test_matrix_free<float>(argc, argv, n);
+}